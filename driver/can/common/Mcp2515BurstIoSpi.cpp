@@ -0,0 +1,163 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "Mcp2515BurstIoSpi.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::can
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr INSTR_WRITE          = 0x02;
+static uint8_t constexpr INSTR_READ           = 0x03;
+static uint8_t constexpr INSTR_BIT_MODIFY     = 0x05;
+static uint8_t constexpr INSTR_LOAD_TX_BUFFER = 0x40; /* 0100 0abc */
+static uint8_t constexpr INSTR_RTS            = 0x80; /* 1000 0nnn */
+static uint8_t constexpr INSTR_READ_RX_BUFFER = 0x90; /* 1001 0nm0 */
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+Mcp2515BurstIoSpi::Mcp2515BurstIoSpi(hal::interface::SpiMasterControl & spi_master,
+                                     hal::interface::DigitalOutPin    & cs)
+: _spi_master(spi_master),
+  _cs        (cs        )
+{
+
+}
+
+Mcp2515BurstIoSpi::~Mcp2515BurstIoSpi()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint8_t Mcp2515BurstIoSpi::readRegister(uint8_t const reg_addr)
+{
+  uint8_t data = 0;
+  readRegisters(reg_addr, &data, 1);
+  return data;
+}
+
+void Mcp2515BurstIoSpi::writeRegister(uint8_t const reg_addr, uint8_t const data)
+{
+  writeRegisters(reg_addr, &data, 1);
+}
+
+void Mcp2515BurstIoSpi::bitModify(uint8_t const reg_addr, uint8_t const mask, uint8_t const data)
+{
+  _cs.clr();
+  _spi_master.exchange(INSTR_BIT_MODIFY);
+  _spi_master.exchange(reg_addr);
+  _spi_master.exchange(mask);
+  _spi_master.exchange(data);
+  _cs.set();
+}
+
+void Mcp2515BurstIoSpi::readRegisters(uint8_t const reg_addr, uint8_t * data, uint8_t const num_bytes)
+{
+  _cs.clr();
+  _spi_master.exchange(INSTR_READ);
+  _spi_master.exchange(reg_addr);
+  for(uint8_t i = 0; i < num_bytes; i++) {
+    data[i] = _spi_master.exchange(0);
+  }
+  _cs.set();
+}
+
+void Mcp2515BurstIoSpi::writeRegisters(uint8_t const reg_addr, uint8_t const * data, uint8_t const num_bytes)
+{
+  _cs.clr();
+  _spi_master.exchange(INSTR_WRITE);
+  _spi_master.exchange(reg_addr);
+  for(uint8_t i = 0; i < num_bytes; i++) {
+    _spi_master.exchange(data[i]);
+  }
+  _cs.set();
+}
+
+void Mcp2515BurstIoSpi::readRxBuffer(Mcp2515RxBuffer const rx_buffer, uint8_t * data, uint8_t const num_bytes)
+{
+  read(INSTR_READ_RX_BUFFER | (static_cast<uint8_t>(rx_buffer) << 2), data, num_bytes);
+}
+
+void Mcp2515BurstIoSpi::loadTxBuffer(Mcp2515TxBuffer const tx_buffer, uint8_t const * data, uint8_t const num_bytes)
+{
+  write(INSTR_LOAD_TX_BUFFER | (static_cast<uint8_t>(tx_buffer) << 1), data, num_bytes);
+}
+
+void Mcp2515BurstIoSpi::readRxBufferData(Mcp2515RxBuffer const rx_buffer, uint8_t * data, uint8_t const num_bytes)
+{
+  read(INSTR_READ_RX_BUFFER | (static_cast<uint8_t>(rx_buffer) << 2) | 0x02, data, num_bytes);
+}
+
+void Mcp2515BurstIoSpi::loadTxBufferData(Mcp2515TxBuffer const tx_buffer, uint8_t const * data, uint8_t const num_bytes)
+{
+  write(INSTR_LOAD_TX_BUFFER | (static_cast<uint8_t>(tx_buffer) << 1) | 0x01, data, num_bytes);
+}
+
+void Mcp2515BurstIoSpi::requestToSend(Mcp2515TxBuffer const tx_buffer)
+{
+  _cs.clr();
+  _spi_master.exchange(INSTR_RTS | (1 << static_cast<uint8_t>(tx_buffer)));
+  _cs.set();
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void Mcp2515BurstIoSpi::read(uint8_t const instruction, uint8_t * data, uint8_t const num_bytes)
+{
+  _cs.clr();
+  _spi_master.exchange(instruction);
+  for(uint8_t i = 0; i < num_bytes; i++) {
+    data[i] = _spi_master.exchange(0);
+  }
+  _cs.set();
+}
+
+void Mcp2515BurstIoSpi::write(uint8_t const instruction, uint8_t const * data, uint8_t const num_bytes)
+{
+  _cs.clr();
+  _spi_master.exchange(instruction);
+  for(uint8_t i = 0; i < num_bytes; i++) {
+    _spi_master.exchange(data[i]);
+  }
+  _cs.set();
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::can */
@@ -0,0 +1,119 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_CAN_COMMON_MCP2515BURSTIOSPI_H_
+#define EXAMPLES_DRIVER_CAN_COMMON_MCP2515BURSTIOSPI_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+#include <snowfox/hal/interface/spi/SpiMasterControl.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::can
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+enum class Mcp2515RxBuffer : uint8_t
+{
+  RXB0 = 0,
+  RXB1 = 1
+};
+
+enum class Mcp2515TxBuffer : uint8_t
+{
+  TXB0 = 0,
+  TXB1 = 1,
+  TXB2 = 2
+};
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* SIDH, SIDL, EID8, EID0, DLC, D0 ... D7 */
+static uint8_t constexpr MCP2515_BUFFER_SIZE        = 13;
+static uint8_t constexpr MCP2515_BUFFER_HEADER_SIZE = 5;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Burst access to the MCP2515: consecutive registers are read/written with
+ * a single READ/WRITE instruction, RX and TX buffers are accessed with the
+ * READ RX BUFFER/LOAD TX BUFFER instructions which address the buffer with
+ * the instruction byte itself. READ RX BUFFER additionally clears the
+ * corresponding RXnIF flag when CS is released, saving the BIT MODIFY which
+ * would otherwise follow. A received frame is therefore fetched within one
+ * transaction of 14 bytes instead of 13 READ and one BIT MODIFY transactions
+ * of 3 - 4 bytes each.
+ */
+class Mcp2515BurstIoSpi
+{
+
+public:
+
+           Mcp2515BurstIoSpi(hal::interface::SpiMasterControl & spi_master,
+                             hal::interface::DigitalOutPin    & cs);
+  virtual ~Mcp2515BurstIoSpi();
+
+
+  uint8_t readRegister    (uint8_t const reg_addr);
+  void    writeRegister   (uint8_t const reg_addr, uint8_t const data);
+  void    bitModify       (uint8_t const reg_addr, uint8_t const mask, uint8_t const data);
+
+  void    readRegisters   (uint8_t const reg_addr, uint8_t       * data, uint8_t const num_bytes);
+  void    writeRegisters  (uint8_t const reg_addr, uint8_t const * data, uint8_t const num_bytes);
+
+  /* Start at SIDH (header + data) */
+  void    readRxBuffer    (Mcp2515RxBuffer const rx_buffer, uint8_t       * data, uint8_t const num_bytes);
+  void    loadTxBuffer    (Mcp2515TxBuffer const tx_buffer, uint8_t const * data, uint8_t const num_bytes);
+
+  /* Start at D0 (data only) */
+  void    readRxBufferData(Mcp2515RxBuffer const rx_buffer, uint8_t       * data, uint8_t const num_bytes);
+  void    loadTxBufferData(Mcp2515TxBuffer const tx_buffer, uint8_t const * data, uint8_t const num_bytes);
+
+  void    requestToSend   (Mcp2515TxBuffer const tx_buffer);
+
+private:
+
+  hal::interface::SpiMasterControl & _spi_master;
+  hal::interface::DigitalOutPin    & _cs;
+
+  void read (uint8_t const instruction, uint8_t       * data, uint8_t const num_bytes);
+  void write(uint8_t const instruction, uint8_t const * data, uint8_t const num_bytes);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::can */
+
+#endif /* EXAMPLES_DRIVER_CAN_COMMON_MCP2515BURSTIOSPI_H_ */
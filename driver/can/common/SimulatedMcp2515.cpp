@@ -0,0 +1,162 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedMcp2515.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::can
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr INSTR_WRITE              = 0x02;
+static uint8_t constexpr INSTR_READ               = 0x03;
+static uint8_t constexpr INSTR_BIT_MODIFY         = 0x05;
+
+static uint8_t constexpr RX_BUFFER_START[4]       = {0x61, 0x66, 0x71, 0x76};
+static uint8_t constexpr TX_BUFFER_START[6]       = {0x31, 0x36, 0x41, 0x46, 0x51, 0x56};
+
+static uint8_t constexpr TXBnCTRL_TXREQ_bm        = (1<<3);
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedMcp2515::SimulatedMcp2515()
+: _state               (State::Deselected),
+  _instruction         (0                ),
+  _reg_ptr             (0                ),
+  _bit_modify_mask     (0                ),
+  _clear_on_deselect_bm(0                ),
+  _num_transactions    (0                ),
+  _num_bytes           (0                )
+{
+  memset(_reg, 0, sizeof(_reg));
+}
+
+SimulatedMcp2515::~SimulatedMcp2515()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedMcp2515::resetCounters()
+{
+  _num_transactions = 0;
+  _num_bytes        = 0;
+}
+
+uint8_t SimulatedMcp2515::exchange(uint8_t const data)
+{
+  _num_bytes++;
+
+  switch(_state)
+  {
+  case State::Deselected:
+  case State::Ignore:
+    return 0xFF;
+
+  case State::Instruction:
+    _instruction = data;
+    if(data == INSTR_READ || data == INSTR_WRITE || data == INSTR_BIT_MODIFY) {
+      _state = State::Address;
+    }
+    else if((data & 0xF9) == 0x90) { /* READ RX BUFFER 1001 0nm0 */
+      _reg_ptr              = RX_BUFFER_START[(data >> 1) & 0x03];
+      _clear_on_deselect_bm = (data & 0x04) ? 0x02 : 0x01;
+      _state                = State::Read;
+    }
+    else if((data & 0xF8) == 0x40 && (data & 0x07) < 6) { /* LOAD TX BUFFER 0100 0abc */
+      _reg_ptr = TX_BUFFER_START[data & 0x07];
+      _state   = State::Write;
+    }
+    else if((data & 0xF8) == 0x80) { /* RTS 1000 0nnn */
+      for(uint8_t b = 0; b < 3; b++) {
+        if(data & (1 << b)) reg(REG_TXB0CTRL + 0x10 * b) |= TXBnCTRL_TXREQ_bm;
+      }
+      _state = State::Ignore;
+    }
+    else {
+      _state = State::Ignore;
+    }
+    return 0xFF;
+
+  case State::Address:
+    _reg_ptr = data;
+    if     (_instruction == INSTR_READ ) _state = State::Read;
+    else if(_instruction == INSTR_WRITE) _state = State::Write;
+    else                                 _state = State::BitModifyMask;
+    return 0xFF;
+
+  case State::BitModifyMask:
+    _bit_modify_mask = data;
+    _state           = State::BitModifyData;
+    return 0xFF;
+
+  case State::BitModifyData:
+    reg(_reg_ptr) = (reg(_reg_ptr) & ~_bit_modify_mask) | (data & _bit_modify_mask);
+    _state        = State::Ignore;
+    return 0xFF;
+
+  case State::Read:
+    return reg(_reg_ptr++);
+
+  case State::Write:
+    reg(_reg_ptr++) = data;
+    return 0xFF;
+  }
+
+  return 0xFF;
+}
+
+void SimulatedMcp2515::set()
+{
+  if(_state == State::Deselected) return;
+
+  reg(REG_CANINTF) &= ~_clear_on_deselect_bm;
+  _clear_on_deselect_bm = 0;
+  _state                = State::Deselected;
+}
+
+void SimulatedMcp2515::clr()
+{
+  if(_state != State::Deselected) return;
+
+  _num_transactions++;
+  _state = State::Instruction;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::can */
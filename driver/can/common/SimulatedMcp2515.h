@@ -0,0 +1,107 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_CAN_COMMON_SIMULATEDMCP2515_H_
+#define EXAMPLES_DRIVER_CAN_COMMON_SIMULATEDMCP2515_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+#include <snowfox/hal/interface/spi/SpiMasterControl.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::can
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Register level model of the MCP2515 SPI interface (READ, WRITE, BIT MODIFY,
+ * READ RX BUFFER, LOAD TX BUFFER, RTS) for running MCP2515 code on a Linux
+ * host. It acts as SPI master and CS pin at the same time and counts the
+ * number of transactions (CS assertions) and transferred bytes.
+ */
+class SimulatedMcp2515 : public hal::interface::SpiMasterControl,
+                         public hal::interface::DigitalOutPin
+{
+
+public:
+
+  static uint8_t constexpr NUM_REGISTERS = 128;
+
+  static uint8_t constexpr REG_CANINTF   = 0x2C;
+  static uint8_t constexpr REG_TXB0CTRL  = 0x30;
+  static uint8_t constexpr REG_RXB0SIDH  = 0x61;
+  static uint8_t constexpr REG_RXB1SIDH  = 0x71;
+
+
+           SimulatedMcp2515();
+  virtual ~SimulatedMcp2515();
+
+
+  uint8_t & reg            (uint8_t const reg_addr) { return _reg[reg_addr % NUM_REGISTERS]; }
+  void      resetCounters  ();
+  uint32_t  numTransactions() const { return _num_transactions; }
+  uint32_t  numBytes       () const { return _num_bytes; }
+
+
+  virtual uint8_t exchange(uint8_t const data) override;
+
+  virtual void    set() override;
+  virtual void    clr() override;
+
+private:
+
+  enum class State
+  {
+    Deselected,
+    Instruction,
+    Address,
+    BitModifyMask,
+    BitModifyData,
+    Read,
+    Write,
+    Ignore
+  };
+
+  uint8_t  _reg[NUM_REGISTERS];
+  State    _state;
+  uint8_t  _instruction,
+           _reg_ptr,
+           _bit_modify_mask,
+           _clear_on_deselect_bm;
+  uint32_t _num_transactions,
+           _num_bytes;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::can */
+
+#endif /* EXAMPLES_DRIVER_CAN_COMMON_SIMULATEDMCP2515_H_ */
@@ -0,0 +1,243 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Write throughput of the AT45DB DataFlash with and without ping-pong buffering.
+ *
+ * 64 pages of an AT45DB161 are written as a stream of 64 byte chunks - the
+ * access pattern of a data logger - and read back for verification:
+ *
+ *   - the pipelined writer which fills one SRAM buffer while the other one
+ *     is programmed, with built-in erase and into pre-erased pages,
+ *   - the same buffer write / program / wait sequence without overlap.
+ *
+ * Throughput is derived from the simulated time at 1 MHz and 8 MHz SCK.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-at45dbx-pipelined-writer-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/SpiNorIo.h"
+#include "../memory/common/AT45DBXBufferIo.h"
+#include "../memory/common/AT45DBXPipelinedWriter.h"
+#include "../memory/common/SimulatedAT45DBX.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+enum class Mode
+{
+  PipelinedErase,
+  PipelinedNoErase,
+  SerialNoErase
+};
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t  const AT45DB161_DENSITY = 0x0B;
+static uint16_t const FIRST_PAGE        = 16;
+static uint16_t const NUM_PAGES         = 64;
+static uint16_t const CHUNK_SIZE        = 64;
+static uint16_t const MAX_PAGE_SIZE     = 528;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+static uint8_t stream[NUM_PAGES * MAX_PAGE_SIZE];
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint8_t pattern(uint32_t const pos)
+{
+  return static_cast<uint8_t>((pos * 13) ^ (pos >> 8) ^ 0x5A);
+}
+
+static bool verify(memory::SimulatedAT45DBX & flash, uint32_t const addr, uint8_t const * expected, uint32_t const size)
+{
+  return (memcmp(flash.data() + addr, expected, size) == 0);
+}
+
+static void streamSerial(memory::AT45DBXBufferIo & at45, uint16_t const page_size)
+{
+  for(uint16_t p = 0; p < NUM_PAGES; p++)
+  {
+    for(uint16_t offset = 0; offset < page_size; offset += CHUNK_SIZE) {
+      uint16_t const len = ((page_size - offset) < CHUNK_SIZE) ? (page_size - offset) : CHUNK_SIZE;
+      at45.writeBuffer(0, offset, stream + p * page_size + offset, len);
+    }
+    at45.programBuffer(0, FIRST_PAGE + p, false);
+    at45.waitReady();
+  }
+}
+
+static void run(char const * name, Mode const mode, uint32_t const spi_clock_Hz)
+{
+  memory::SimulatedAT45DBX flash(spi_clock_Hz, AT45DB161_DENSITY, false);
+  memory::SpiNorIo         io   (flash, flash);
+  memory::AT45DBXBufferIo  at45 (io, flash);
+
+  if(!at45.readGeometry()) {
+    check(name, false);
+    return;
+  }
+
+  uint16_t const page_size = at45.geometry().page_size;
+  uint32_t const size      = static_cast<uint32_t>(NUM_PAGES) * page_size;
+
+  /* Pages programmed without built-in erase start out erased, old contents otherwise */
+  if(mode == Mode::PipelinedErase) {
+    memset(flash.data() + FIRST_PAGE * page_size, 0x00, size);
+  }
+
+  flash.resetCounters();
+  uint64_t const start_ns = flash.now_ns();
+
+  memory::AT45DBXPipelinedWriter writer(at45, mode == Mode::PipelinedErase);
+
+  switch(mode)
+  {
+  case Mode::PipelinedErase:
+  case Mode::PipelinedNoErase:
+  {
+    writer.begin(FIRST_PAGE);
+    for(uint32_t pos = 0; pos < size; pos += CHUNK_SIZE) {
+      writer.write(stream + pos, ((size - pos) < CHUNK_SIZE) ? (size - pos) : CHUNK_SIZE);
+    }
+    writer.sync();
+  }
+  break;
+  case Mode::SerialNoErase:
+  {
+    streamSerial(at45, page_size);
+  }
+  break;
+  }
+
+  uint64_t const duration_ns = flash.now_ns() - start_ns;
+
+  printf("  %-40s %7.1f ms | %6.1f kB/s\n",
+         name,
+         duration_ns / 1e6,
+         (size / 1024.0) / (duration_ns / 1e9));
+
+  check(name, verify(flash, FIRST_PAGE * page_size, stream, size) &&
+              (flash.numPagePrograms() == NUM_PAGES) &&
+              (flash.numBufferConflicts() == 0));
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  for(uint32_t pos = 0; pos < sizeof(stream); pos++) stream[pos] = pattern(pos);
+
+  uint32_t const spi_clock_Hz[] = {1000000UL, 8000000UL};
+
+  for(uint32_t const clock_Hz : spi_clock_Hz)
+  {
+    printf("AT45DB161, %u pages @ %u MHz SCK:\n", NUM_PAGES, static_cast<unsigned int>(clock_Hz / 1000000UL));
+    run("ping-pong, buffer to page with erase",  Mode::PipelinedErase,   clock_Hz);
+    run("serial, buffer to page w/o erase",      Mode::SerialNoErase,    clock_Hz);
+    run("ping-pong, buffer to page w/o erase",   Mode::PipelinedNoErase, clock_Hz);
+  }
+
+  /* Partial page, end of flash and buffer conflicts ********************************/
+  {
+    memory::SimulatedAT45DBX flash(8000000UL, AT45DB161_DENSITY, false);
+    memory::SpiNorIo         io   (flash, flash);
+    memory::AT45DBXBufferIo  at45 (io, flash);
+
+    check("geometry AT45DB161", at45.readGeometry() && (at45.geometry().num_pages == 4096) && (at45.geometry().page_size == 528));
+
+    memset(flash.data(), 0x00, 2 * 528);
+
+    memory::AT45DBXPipelinedWriter writer(at45, true);
+    writer.begin(0);
+    writer.write(stream, 528 + 100);
+    writer.sync();
+
+    uint8_t expected[2 * 528];
+    memcpy(expected, stream, 528 + 100);
+    memset(expected + 528 + 100, 0xFF, 528 - 100);
+    check("partial page padded with 0xFF on sync", verify(flash, 0, expected, sizeof(expected)) && (writer.nextPage() == 2));
+
+    writer.begin(4095);
+    check("write stops at end of flash", (writer.write(stream, 1000) == 528) && (writer.nextPage() == 4096));
+    writer.sync();
+    check("last page", verify(flash, 4095 * 528, stream, 528));
+
+    uint8_t read_back[528 + 100];
+    at45.read(0, 0, read_back, sizeof(read_back));
+    check("read across page boundary", memcmp(read_back, stream, sizeof(read_back)) == 0);
+
+    /* Writing the buffer being programmed is detected by the model */
+    flash.resetCounters();
+    at45.writeBuffer(0, 0, stream, 16);
+    at45.programBuffer(0, 10, true);
+    at45.writeBuffer(1, 0, stream, 16);
+    at45.writeBuffer(0, 0, stream, 16);
+    at45.waitReady();
+    check("buffer conflict detected", flash.numBufferConflicts() == 1);
+  }
+
+  /* Binary page size ***************************************************************/
+  {
+    memory::SimulatedAT45DBX flash(8000000UL, AT45DB161_DENSITY, true);
+    memory::SpiNorIo         io   (flash, flash);
+    memory::AT45DBXBufferIo  at45 (io, flash);
+
+    check("binary page size", at45.readGeometry() && (at45.geometry().page_size == 512) && (at45.geometry().num_pages == 4096));
+
+    memory::AT45DBXPipelinedWriter writer(at45, true);
+    writer.begin(100);
+    writer.write(stream, 4 * 512);
+    writer.sync();
+    check("binary page size data", verify(flash, 100 * 512, stream, 4 * 512));
+
+    uint8_t read_back[512];
+    at45.read(101, 256, read_back, sizeof(read_back));
+    check("binary page size read", memcmp(read_back, stream + 512 + 256, sizeof(read_back)) == 0);
+  }
+
+  return checkResult();
+}
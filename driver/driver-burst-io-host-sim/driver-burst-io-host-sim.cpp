@@ -0,0 +1,217 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../../hal/common/CountingI2cMaster.h"
+#include "../../hal/common/SimulatedI2cMaster.h"
+
+#include "../sensor/common/StSensorIoI2c.h"
+#include "../sensor/common/SimulatedStSensor.h"
+
+#include "../can/common/Mcp2515BurstIoSpi.h"
+#include "../can/common/SimulatedMcp2515.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t const L3GD20_I2C_ADDR      = (0x6B << 1);
+static uint8_t const LIS3DSH_I2C_ADDR     = (0x1D << 1);
+static uint8_t const LIS3DSH_REG_CTRL_REG4 = 0x20;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static void report(char const * name, uint32_t const single_transactions, uint32_t const single_bytes, uint32_t const burst_transactions, uint32_t const burst_bytes)
+{
+  printf("  %-28s single: %3u transactions %4u bytes | burst: %3u transactions %4u bytes\n",
+         name, single_transactions, single_bytes, burst_transactions, burst_bytes);
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  hal::i2c::SimulatedI2cMaster sim_i2c;
+  hal::i2c::CountingI2cMaster  i2c_master(sim_i2c);
+
+  sensor::SimulatedStSensor    l3gd20_sim (L3GD20_I2C_ADDR,  sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB);
+  sensor::SimulatedStSensor    lis3dsh_sim(LIS3DSH_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_ADD_INC);
+
+  sim_i2c.attach(l3gd20_sim);
+  sim_i2c.attach(lis3dsh_sim);
+
+  sensor::StSensorIoI2c        l3gd20_io  (L3GD20_I2C_ADDR,  sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, i2c_master);
+  sensor::StSensorIoI2c        lis3dsh_io (LIS3DSH_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_ADD_INC, i2c_master);
+
+  /* L3GD20 XYZ sample - one register per transaction vs. burst */
+  {
+    int16_t const xyz_expected[3] = {-2, 1234, -32768};
+    memcpy(&l3gd20_sim.reg(sensor::ST_SENSOR_REG_OUT_X_L), xyz_expected, sizeof(xyz_expected));
+
+    i2c_master.reset();
+    uint8_t out[6];
+    bool success = true;
+    for(uint8_t r = 0; r < 6; r++) {
+      success &= l3gd20_io.readRegister(sensor::ST_SENSOR_REG_OUT_X_L + r, out + r);
+    }
+    uint32_t const single_transactions = i2c_master.numTransactions(), single_bytes = i2c_master.numBytes();
+
+    i2c_master.reset();
+    int16_t xyz[3] = {0};
+    success &= l3gd20_io.readXYZ(xyz);
+    uint32_t const burst_transactions = i2c_master.numTransactions(), burst_bytes = i2c_master.numBytes();
+
+    check("L3GD20 single register reads", success && memcmp(out, xyz_expected, sizeof(out)) == 0);
+    check("L3GD20 burst XYZ read",        memcmp(xyz, xyz_expected, sizeof(xyz)) == 0);
+    check("L3GD20 burst uses fewer transactions", burst_transactions < single_transactions);
+    report("L3GD20 read XYZ", single_transactions, single_bytes, burst_transactions, burst_bytes);
+  }
+
+  /* Without the sub-address MSB the L3GD20 does not auto-increment */
+  {
+    uint8_t out[2] = {0};
+    l3gd20_sim.reg(0x0F) = 0xD4;
+    l3gd20_sim.reg(0x10) = 0x00;
+    sensor::StSensorIoI2c l3gd20_io_no_inc(L3GD20_I2C_ADDR, 0x00, i2c_master);
+    l3gd20_io_no_inc.readRegisters(0x0F, out, 2);
+    check("L3GD20 without auto-increment bit re-reads the same register", out[0] == 0xD4 && out[1] == 0xD4);
+  }
+
+  /* LIS3DSH configuration (CTRL_REG4 ... CTRL_REG6) via ADD_INC auto-increment */
+  {
+    uint8_t const ctrl[3] = {0x67, 0x00, 0x10};
+
+    i2c_master.reset();
+    for(uint8_t r = 0; r < 3; r++) {
+      lis3dsh_io.writeRegister(LIS3DSH_REG_CTRL_REG4 + r, ctrl[r]);
+    }
+    uint32_t const single_transactions = i2c_master.numTransactions(), single_bytes = i2c_master.numBytes();
+
+    memset(&lis3dsh_sim.reg(LIS3DSH_REG_CTRL_REG4), 0, 3);
+
+    i2c_master.reset();
+    lis3dsh_io.writeRegisters(LIS3DSH_REG_CTRL_REG4, ctrl, 3);
+    uint32_t const burst_transactions = i2c_master.numTransactions(), burst_bytes = i2c_master.numBytes();
+
+    uint8_t readback[3] = {0};
+    lis3dsh_io.readRegisters(LIS3DSH_REG_CTRL_REG4, readback, 3);
+
+    check("LIS3DSH burst register write", memcmp(readback, ctrl, 3) == 0);
+    report("LIS3DSH write CTRL_REG4..6", single_transactions, single_bytes, burst_transactions, burst_bytes);
+  }
+
+  /* A NACKed register address is terminated with a STOP */
+  {
+    uint8_t out[2] = {0};
+
+    sim_i2c.nackNextWrite();
+    bool const single_failed = !l3gd20_io.readRegister(0x0F, out);
+    check("NACK on register address releases the bus (single read)", single_failed && sim_i2c.isIdle());
+
+    sim_i2c.nackNextWrite();
+    bool const burst_failed = !l3gd20_io.readRegisters(0x0F, out, 2);
+    check("NACK on register address releases the bus (burst read)", burst_failed && sim_i2c.isIdle());
+
+    check("bus usable after NACK", l3gd20_io.readRegister(0x0F, out) && (out[0] == 0xD4));
+  }
+
+  /* MCP2515 - fetch a received frame from RXB1 */
+  {
+    can::SimulatedMcp2515  mcp2515_sim;
+    can::Mcp2515BurstIoSpi mcp2515_io(mcp2515_sim, mcp2515_sim);
+
+    uint8_t const frame[can::MCP2515_BUFFER_SIZE] = {0x24, 0x60, 0x00, 0x00, 0x08, 0xDE, 0xAD, 0xBE, 0xEF, 0xCA, 0xFE, 0x01, 0x02};
+
+    memcpy(&mcp2515_sim.reg(can::SimulatedMcp2515::REG_RXB1SIDH), frame, sizeof(frame));
+    mcp2515_sim.reg(can::SimulatedMcp2515::REG_CANINTF) = 0x03;
+
+    mcp2515_sim.resetCounters();
+    uint8_t single[can::MCP2515_BUFFER_SIZE];
+    for(uint8_t r = 0; r < can::MCP2515_BUFFER_SIZE; r++) {
+      single[r] = mcp2515_io.readRegister(can::SimulatedMcp2515::REG_RXB1SIDH + r);
+    }
+    mcp2515_io.bitModify(can::SimulatedMcp2515::REG_CANINTF, 0x02, 0x00);
+    uint32_t const single_transactions = mcp2515_sim.numTransactions(), single_bytes = mcp2515_sim.numBytes();
+
+    check("MCP2515 single register reads", memcmp(single, frame, sizeof(frame)) == 0 && mcp2515_sim.reg(can::SimulatedMcp2515::REG_CANINTF) == 0x01);
+
+    mcp2515_sim.reg(can::SimulatedMcp2515::REG_CANINTF) = 0x03;
+
+    mcp2515_sim.resetCounters();
+    uint8_t burst[can::MCP2515_BUFFER_SIZE];
+    mcp2515_io.readRxBuffer(can::Mcp2515RxBuffer::RXB1, burst, sizeof(burst));
+    uint32_t const burst_transactions = mcp2515_sim.numTransactions(), burst_bytes = mcp2515_sim.numBytes();
+
+    check("MCP2515 READ RX BUFFER", memcmp(burst, frame, sizeof(frame)) == 0);
+    check("MCP2515 READ RX BUFFER clears RX1IF only", mcp2515_sim.reg(can::SimulatedMcp2515::REG_CANINTF) == 0x01);
+    report("MCP2515 read RX frame", single_transactions, single_bytes, burst_transactions, burst_bytes);
+
+    uint8_t data[8] = {0};
+    mcp2515_io.readRxBufferData(can::Mcp2515RxBuffer::RXB1, data, sizeof(data));
+    check("MCP2515 READ RX BUFFER (D0)", memcmp(data, frame + can::MCP2515_BUFFER_HEADER_SIZE, sizeof(data)) == 0);
+  }
+
+  /* MCP2515 - load a frame into TXB2 and request transmission */
+  {
+    can::SimulatedMcp2515  mcp2515_sim;
+    can::Mcp2515BurstIoSpi mcp2515_io(mcp2515_sim, mcp2515_sim);
+
+    uint8_t const frame[can::MCP2515_BUFFER_SIZE] = {0x12, 0x20, 0x00, 0x00, 0x04, 0x11, 0x22, 0x33, 0x44, 0, 0, 0, 0};
+    uint8_t const TXB2SIDH = 0x51, TXB2CTRL = 0x50;
+
+    mcp2515_sim.resetCounters();
+    for(uint8_t r = 0; r < can::MCP2515_BUFFER_SIZE; r++) {
+      mcp2515_io.writeRegister(TXB2SIDH + r, frame[r]);
+    }
+    mcp2515_io.bitModify(TXB2CTRL, 0x08, 0x08);
+    uint32_t const single_transactions = mcp2515_sim.numTransactions(), single_bytes = mcp2515_sim.numBytes();
+
+    memset(&mcp2515_sim.reg(TXB2SIDH), 0, sizeof(frame));
+    mcp2515_sim.reg(TXB2CTRL) = 0;
+
+    mcp2515_sim.resetCounters();
+    mcp2515_io.loadTxBuffer (can::Mcp2515TxBuffer::TXB2, frame, can::MCP2515_BUFFER_HEADER_SIZE + 4);
+    mcp2515_io.requestToSend(can::Mcp2515TxBuffer::TXB2);
+    uint32_t const burst_transactions = mcp2515_sim.numTransactions(), burst_bytes = mcp2515_sim.numBytes();
+
+    check("MCP2515 LOAD TX BUFFER + RTS", memcmp(&mcp2515_sim.reg(TXB2SIDH), frame, can::MCP2515_BUFFER_HEADER_SIZE + 4) == 0 && mcp2515_sim.reg(TXB2CTRL) == 0x08);
+    report("MCP2515 transmit frame", single_transactions, single_bytes, burst_transactions, burst_bytes);
+  }
+
+  return checkResult();
+}
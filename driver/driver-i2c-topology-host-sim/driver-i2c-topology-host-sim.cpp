@@ -0,0 +1,259 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../../hal/common/SimulatedI2cMaster.h"
+
+#include "../ioexpander/common/I2cBusTopology.h"
+#include "../ioexpander/common/SimulatedPca9547.h"
+
+#include "../sensor/common/StSensorIoI2c.h"
+#include "../sensor/common/SimulatedStSensor.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t const PCA9547_A_I2C_ADDR = (0x70 << 1);
+static uint8_t const PCA9547_B_I2C_ADDR = (0x71 << 1);
+static uint8_t const PCA9547_C_I2C_ADDR = (0x72 << 1);
+static uint8_t const L3GD20_I2C_ADDR    = (0x6B << 1);
+static uint8_t const LIS3MDL_I2C_ADDR   = (0x1E << 1);
+static uint8_t const LIS3MDL_I2C_ADDR_2 = (0x1C << 1);
+static uint8_t const ST_SENSOR_REG_STATUS = 0x27;
+
+static size_t  const NUM_DEVICES        = 7;
+static size_t  const NUM_ROUNDS         = 10;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static void report(char const * name, uint32_t const num_transactions, uint32_t const num_select_always, uint32_t const num_switches, uint32_t const num_avoided)
+{
+  printf("  %-26s %3u transactions | select always: %3u mux writes | cached: %3u mux writes, %3u avoided\n",
+         name, num_transactions, num_select_always, num_switches, num_avoided);
+}
+
+static uint8_t depthOf(ioexpander::I2cMuxedDevice const & device)
+{
+  uint8_t depth = 0;
+  for(ioexpander::Pca9547Mux const * mux = device.mux(); mux; mux = mux->parent()) {
+    depth++;
+  }
+  return depth;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  /* Bus model:
+   *
+   *   MCU -+- LIS3MDL
+   *        +- PCA9547 A -+- CH0 -+- L3GD20
+   *        |             |       +- LIS3MDL (SDO low)
+   *        |             +- CH1 --- L3GD20
+   *        |             +- CH2 --- PCA9547 C - CH5 - L3GD20
+   *        +- PCA9547 B --- CH0 -+- L3GD20
+   *                              +- LIS3MDL (SDO low)
+   */
+  hal::i2c::SimulatedI2cMaster         sim_i2c;
+
+  ioexpander::SimulatedPca9547         mux_a_sim(PCA9547_A_I2C_ADDR);
+  ioexpander::SimulatedPca9547         mux_b_sim(PCA9547_B_I2C_ADDR);
+  ioexpander::SimulatedPca9547         mux_c_sim(PCA9547_C_I2C_ADDR, mux_a_sim, 2);
+
+  sensor::SimulatedStSensor            sensor_sim[NUM_DEVICES] =
+  {
+    {LIS3MDL_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB},
+    {LIS3MDL_I2C_ADDR_2, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB},
+    {LIS3MDL_I2C_ADDR_2, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB}
+  };
+
+  ioexpander::SimulatedPca9547Channel  a0_l3gd20_sim (mux_a_sim, 0, sensor_sim[1]);
+  ioexpander::SimulatedPca9547Channel  a0_lis3mdl_sim(mux_a_sim, 0, sensor_sim[2]);
+  ioexpander::SimulatedPca9547Channel  a1_l3gd20_sim (mux_a_sim, 1, sensor_sim[3]);
+  ioexpander::SimulatedPca9547Channel  c5_l3gd20_sim (mux_c_sim, 5, sensor_sim[4]);
+  ioexpander::SimulatedPca9547Channel  b0_l3gd20_sim (mux_b_sim, 0, sensor_sim[5]);
+  ioexpander::SimulatedPca9547Channel  b0_lis3mdl_sim(mux_b_sim, 0, sensor_sim[6]);
+
+  sim_i2c.attach(mux_a_sim);
+  sim_i2c.attach(mux_b_sim);
+  sim_i2c.attach(mux_c_sim);
+  sim_i2c.attach(sensor_sim[0]);
+  sim_i2c.attach(a0_l3gd20_sim);
+  sim_i2c.attach(a0_lis3mdl_sim);
+  sim_i2c.attach(a1_l3gd20_sim);
+  sim_i2c.attach(c5_l3gd20_sim);
+  sim_i2c.attach(b0_l3gd20_sim);
+  sim_i2c.attach(b0_lis3mdl_sim);
+
+  for(size_t d = 0; d < NUM_DEVICES; d++) {
+    int16_t const xyz[3] = {static_cast<int16_t>(100 * d), static_cast<int16_t>(-100 * d), static_cast<int16_t>(d)};
+    memcpy(&sensor_sim[d].reg(sensor::ST_SENSOR_REG_OUT_X_L), xyz, sizeof(xyz));
+  }
+
+  /* Topology as seen by the drivers */
+  ioexpander::Pca9547Mux     mux_a(PCA9547_A_I2C_ADDR);
+  ioexpander::Pca9547Mux     mux_b(PCA9547_B_I2C_ADDR);
+  ioexpander::Pca9547Mux     mux_c(PCA9547_C_I2C_ADDR, mux_a, 2);
+
+  ioexpander::I2cBusTopology topology(sim_i2c);
+
+  topology.attach(mux_a);
+  topology.attach(mux_b);
+  topology.attach(mux_c);
+
+  ioexpander::I2cMuxedDevice device[NUM_DEVICES] =
+  {
+    {topology},
+    {topology, &mux_a, 0},
+    {topology, &mux_a, 0},
+    {topology, &mux_a, 1},
+    {topology, &mux_c, 5},
+    {topology, &mux_b, 0},
+    {topology, &mux_b, 0}
+  };
+
+  sensor::StSensorIoI2c      sensor_io[NUM_DEVICES] =
+  {
+    {LIS3MDL_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[0]},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[1]},
+    {LIS3MDL_I2C_ADDR_2, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[2]},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[3]},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[4]},
+    {L3GD20_I2C_ADDR,    sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[5]},
+    {LIS3MDL_I2C_ADDR_2, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, device[6]}
+  };
+
+  auto num_mux_writes = [&]() { return mux_a_sim.numControlWrites() + mux_b_sim.numControlWrites() + mux_c_sim.numControlWrites(); };
+
+  /* Without the topology the L3GD20 are not reachable, they share one address */
+  {
+    sensor::StSensorIoI2c l3gd20_io(L3GD20_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, sim_i2c);
+    int16_t xyz[3] = {0};
+    check("L3GD20 behind a mux not reachable without channel selection", !l3gd20_io.readXYZ(xyz));
+  }
+
+  /* Every device is addressed through its channel path */
+  {
+    bool success = true;
+    for(size_t d = 0; d < NUM_DEVICES; d++)
+    {
+      int16_t xyz[3] = {0};
+      success &= sensor_io[d].readXYZ(xyz);
+      success &= memcmp(xyz, &sensor_sim[d].reg(sensor::ST_SENSOR_REG_OUT_X_L), sizeof(xyz)) == 0;
+    }
+    check("read XYZ of devices with the same address on different channels", success);
+    check("mux A disconnected while accessing a channel of mux B", mux_a_sim.control() == 0 && mux_b_sim.isChannelConnected(0));
+  }
+
+  /* Consecutive transactions on the active channel do not write the mux */
+  {
+    uint32_t const mux_writes = num_mux_writes();
+    int16_t xyz[3] = {0};
+    sensor_io[4].readXYZ(xyz);
+    uint32_t const mux_writes_first = num_mux_writes();
+    for(size_t r = 0; r < NUM_ROUNDS; r++) {
+      sensor_io[4].readXYZ(xyz);
+      sensor_io[0].readXYZ(xyz);
+    }
+    check("channel switch only if the active channel differs", (mux_writes_first > mux_writes) && (num_mux_writes() == mux_writes_first));
+  }
+
+  /* Polling all devices (STATUS + XYZ) - interleaved vs. ordered by channel */
+  {
+    ioexpander::I2cMuxedDevice * order[NUM_DEVICES] = {&device[1], &device[5], &device[2], &device[3], &device[6], &device[0], &device[4]};
+    size_t                       index[NUM_DEVICES] = {1, 5, 2, 3, 6, 0, 4};
+    uint32_t                     select_always = 0;
+
+    auto poll = [&](char const * name)
+    {
+      topology.deselectAll();
+      topology.resetStatistics();
+      uint32_t const mux_writes = num_mux_writes();
+
+      bool success = true;
+      for(size_t r = 0; r < NUM_ROUNDS; r++) {
+        for(size_t d = 0; d < NUM_DEVICES; d++) {
+          uint8_t status = 0;
+          int16_t xyz[3] = {0};
+          success &= sensor_io[index[d]].readRegister(ST_SENSOR_REG_STATUS, &status);
+          success &= sensor_io[index[d]].readXYZ(xyz);
+        }
+      }
+
+      /* Selecting the path before each transaction costs one mux write per level */
+      select_always = 0;
+      for(size_t d = 0; d < NUM_DEVICES; d++) {
+        select_always += 2 * NUM_ROUNDS * depthOf(*order[d]);
+      }
+
+      check(name, success && (topology.numChannelSwitches() == (num_mux_writes() - mux_writes)));
+      report(name, 2 * NUM_ROUNDS * NUM_DEVICES, select_always, topology.numChannelSwitches(), topology.numSwitchesAvoided());
+      return topology.numChannelSwitches();
+    };
+
+    uint32_t const interleaved_switches = poll("interleaved");
+
+    topology.orderByChannel(order, NUM_DEVICES);
+    for(size_t d = 0; d < NUM_DEVICES; d++) {
+      index[d] = order[d] - device;
+    }
+    bool is_ordered = true;
+    for(size_t d = 0; d < NUM_DEVICES; d++) {
+      is_ordered &= (index[d] == d);
+    }
+    check("order by channel path", is_ordered);
+
+    uint32_t const ordered_switches = poll("ordered by channel");
+
+    check("ordering by channel reduces channel switches", ordered_switches < interleaved_switches);
+    check("cached channel switches below select always", ordered_switches < select_always);
+  }
+
+  /* Disconnect all channels */
+  {
+    check("deselect all", topology.deselectAll() && mux_a_sim.control() == 0 && mux_b_sim.control() == 0 && mux_c_sim.control() == 0);
+  }
+
+  return checkResult();
+}
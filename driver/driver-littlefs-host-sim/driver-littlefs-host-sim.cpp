@@ -0,0 +1,353 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Benchmark and power-fail test of littlefs on driver::memory::LittleFsBlockDevice
+ * backed by a file backed NOR flash image (256 blocks of 4 kB, the N25Q256A
+ * subsector size). Place the image on a tmpfs (e.g. /dev/shm) to run it
+ * from RAM.
+ *
+ * Several sensor logs are appended with fixed size records, every log is
+ * synced after a number of records and rotated (removed) once it has grown
+ * beyond a maximum size. Afterwards the same workload is interrupted by
+ * random power failures, after every reboot all logs must contain either
+ * the state before or after the interrupted operation.
+ *
+ * The flash access time is estimated from the recorded accesses assuming a
+ * N25Q256A at 8 MHz SPI clock: 1 us per transferred byte plus 5 bytes of
+ * command overhead per read/prog, 0.5 ms per prog (page program) and
+ * 250 ms per erase (subsector erase).
+ *
+ * littlefs is not part of snowfox, it is fetched at the release pinned within
+ * CMakeLists.txt (or taken from -DLITTLEFS_DIR=<path to littlefs>). Build and run:
+ *   cmake -S . -B build && cmake --build build
+ *   ./build/driver-littlefs-host-sim [image file]
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/FileNorFlash.h"
+#include "../memory/common/LittleFsBlockDevice.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const PROG_SIZE         = 16;
+static uint32_t const ERASE_SIZE        = 4096;
+static uint32_t const NUM_BLOCKS        = 256;
+static uint32_t const CACHE_BUFFER_SIZE = 256;
+static uint32_t const LOOKAHEAD_SIZE    = 32;
+static int32_t  const BLOCK_CYCLES      = 500;
+
+static uint16_t const NUM_LOGS          = 4;
+static uint16_t const RECORD_SIZE       = 16;
+static uint16_t const SYNC_INTERVAL     = 16;
+static uint32_t const MAX_LOG_SIZE      = 32 * 1024;
+static uint32_t const NUM_RECORDS       = 40000;
+static uint16_t const NUM_POWER_FAILS   = 200;
+
+static double   const BYTE_TIME_us      = 1.0;
+static double   const CMD_OVERHEAD_us   = 5.0 * BYTE_TIME_us;
+static double   const PROG_TIME_us      = 500.0;
+static double   const ERASE_TIME_us     = 250000.0;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+static uint32_t rnd_state    = 12345;
+
+static uint8_t  read_buffer     [CACHE_BUFFER_SIZE];
+static uint8_t  prog_buffer     [CACHE_BUFFER_SIZE];
+static uint8_t  file_buffer     [CACHE_BUFFER_SIZE];
+static uint32_t lookahead_buffer[LOOKAHEAD_SIZE / sizeof(uint32_t)];
+
+/* Size of every log as last seen on the flash, -1 = log does not exist */
+static int32_t  log_size[NUM_LOGS];
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint32_t rnd()
+{
+  rnd_state = rnd_state * 1103515245UL + 12345UL;
+  return rnd_state >> 8;
+}
+
+static double accessTime_ms(memory::FileNorFlash const & flash)
+{
+  double const read_us  = flash.numReads()  * CMD_OVERHEAD_us + flash.numReadBytes() * BYTE_TIME_us;
+  double const prog_us  = flash.numProgs()  * (CMD_OVERHEAD_us + BYTE_TIME_us + PROG_TIME_us) + flash.numProgBytes() * BYTE_TIME_us;
+  double const erase_us = flash.numErases() * (CMD_OVERHEAD_us + BYTE_TIME_us + ERASE_TIME_us);
+  return (read_us + prog_us + erase_us) / 1000.0;
+}
+
+static void nameOf(uint16_t const l, char * name)
+{
+  snprintf(name, 32, "log/sensor%u.bin", l);
+}
+
+/* The content of every log is a function of its index and the file position */
+static uint8_t patternOf(uint16_t const l, uint32_t const pos)
+{
+  return static_cast<uint8_t>(l * 67 + pos * 13 + (pos >> 8));
+}
+
+static int openLog(lfs_t & lfs, lfs_file_t & file, uint16_t const l, int const flags)
+{
+  static lfs_file_config file_cfg;
+  memset(&file_cfg, 0, sizeof(file_cfg));
+  file_cfg.buffer = file_buffer;
+
+  char name[32];
+  nameOf(l, name);
+  return lfs_file_opencfg(&lfs, &file, name, flags, &file_cfg);
+}
+
+static bool appendLog(lfs_t & lfs, uint16_t const l, uint32_t const size)
+{
+  lfs_file_t file;
+  if(openLog(lfs, file, l, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND) != LFS_ERR_OK) return false;
+
+  uint32_t const pos = (log_size[l] < 0) ? 0 : log_size[l];
+  uint8_t        buf[CACHE_BUFFER_SIZE];
+  bool           is_ok = true;
+
+  for(uint32_t done = 0; (done < size) && is_ok; )
+  {
+    uint32_t const chunk = ((size - done) < sizeof(buf)) ? (size - done) : sizeof(buf);
+    for(uint32_t i = 0; i < chunk; i++) buf[i] = patternOf(l, pos + done + i);
+    is_ok = (lfs_file_write(&lfs, &file, buf, chunk) == static_cast<lfs_ssize_t>(chunk));
+    done += chunk;
+  }
+
+  is_ok &= (lfs_file_close(&lfs, &file) == LFS_ERR_OK);
+  return is_ok;
+}
+
+static bool removeLog(lfs_t & lfs, uint16_t const l)
+{
+  char name[32];
+  nameOf(l, name);
+  return (lfs_remove(&lfs, name) == LFS_ERR_OK);
+}
+
+/* Returns the size of the log or -1 if it does not exist, -2 if its content is corrupted */
+static int32_t verifyLog(lfs_t & lfs, uint16_t const l)
+{
+  lfs_file_t file;
+  if(openLog(lfs, file, l, LFS_O_RDONLY) != LFS_ERR_OK) return -1;
+
+  uint8_t     buf[CACHE_BUFFER_SIZE];
+  uint32_t    pos = 0;
+  bool        is_ok = true;
+  lfs_ssize_t bytes_read;
+
+  while(is_ok && (bytes_read = lfs_file_read(&lfs, &file, buf, sizeof(buf))) > 0)
+  {
+    for(lfs_ssize_t i = 0; i < bytes_read; i++) {
+      if(buf[i] != patternOf(l, pos + i)) is_ok = false;
+    }
+    pos += bytes_read;
+  }
+
+  is_ok &= (bytes_read == 0);
+  lfs_file_close(&lfs, &file);
+  return is_ok ? static_cast<int32_t>(pos) : -2;
+}
+
+static bool verifyAll(lfs_t & lfs)
+{
+  for(uint16_t l = 0; l < NUM_LOGS; l++) {
+    if(verifyLog(lfs, l) != log_size[l]) return false;
+  }
+  return true;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main(int argc, char ** argv)
+{
+  char const * file_name = (argc > 1) ? argv[1] : "littlefs-host-sim.bin";
+  unlink(file_name);
+
+  printf("  littlefs v%u.%u, disk version %u.%u\n",
+         LFS_VERSION_MAJOR, LFS_VERSION_MINOR, LFS_DISK_VERSION_MAJOR, LFS_DISK_VERSION_MINOR);
+
+  memory::FileNorFlash flash(file_name, PROG_SIZE, ERASE_SIZE, NUM_BLOCKS, memory::FileNorFlash::NO_PAGE_WRAP);
+  check("flash image opened", flash.isOpen());
+  if(!flash.isOpen()) return 1;
+
+  memory::LittleFsBlockDevice bd(flash, 0, NUM_BLOCKS, read_buffer, prog_buffer, CACHE_BUFFER_SIZE, lookahead_buffer, LOOKAHEAD_SIZE, BLOCK_CYCLES);
+  check("block device configuration", bd.isValid() && (bd.config()->cache_size == CACHE_BUFFER_SIZE) && (bd.config()->lookahead_size == LOOKAHEAD_SIZE));
+  if(!bd.isValid()) return 1;
+
+  for(uint16_t l = 0; l < NUM_LOGS; l++) log_size[l] = -1;
+
+  /* FORMAT ***************************************************************************/
+  {
+    lfs_t lfs;
+    check("format and mount empty image", bd.mount(lfs, true) == LFS_ERR_OK);
+    check("create log directory", lfs_mkdir(&lfs, "log") == LFS_ERR_OK);
+    lfs_unmount(&lfs);
+  }
+
+  /* SENSOR LOGS **********************************************************************/
+  {
+    lfs_t lfs;
+    check("mount", bd.mount(lfs, false) == LFS_ERR_OK);
+
+    flash.resetCounters();
+    uint32_t num_rotations = 0;
+    bool     is_ok         = true;
+
+    for(uint32_t n = 0; (n < NUM_RECORDS) && is_ok; n += SYNC_INTERVAL)
+    {
+      uint16_t const l = (n / SYNC_INTERVAL) % NUM_LOGS;
+      if(log_size[l] >= static_cast<int32_t>(MAX_LOG_SIZE)) {
+        is_ok &= removeLog(lfs, l);
+        log_size[l] = -1;
+        num_rotations++;
+      }
+      is_ok &= appendLog(lfs, l, SYNC_INTERVAL * RECORD_SIZE);
+      log_size[l] = ((log_size[l] < 0) ? 0 : log_size[l]) + SYNC_INTERVAL * RECORD_SIZE;
+    }
+
+    double   const time_ms    = accessTime_ms(flash);
+    uint64_t const user_bytes = static_cast<uint64_t>(NUM_RECORDS) * RECORD_SIZE;
+
+    uint32_t min_erase = 0xFFFFFFFF, max_erase = 0;
+    for(uint32_t b = 0; b < NUM_BLOCKS; b++) {
+      if(flash.eraseCount(b) < min_erase) min_erase = flash.eraseCount(b);
+      if(flash.eraseCount(b) > max_erase) max_erase = flash.eraseCount(b);
+    }
+
+    printf("  %u records of %u bytes (sync every %u records, %u rotations): %u progs, %u erases\n",
+           NUM_RECORDS, RECORD_SIZE, SYNC_INTERVAL, num_rotations, flash.numProgs(), flash.numErases());
+    printf("  write amplification %.2f, %.3f ms/record (est.), %.1f kB/s (est.)\n",
+           static_cast<double>(flash.numProgBytes()) / user_bytes, time_ms / NUM_RECORDS, user_bytes / time_ms);
+    printf("  erase count per block: min %u, max %u\n", min_erase, max_erase);
+
+    check("sensor logs written", is_ok);
+    check("sensor logs verified", verifyAll(lfs));
+    lfs_unmount(&lfs);
+  }
+
+  /* MOUNT/READ ***********************************************************************/
+  {
+    lfs_t lfs;
+    flash.resetCounters();
+    bool const is_mounted = (bd.mount(lfs, false) == LFS_ERR_OK);
+    printf("  mount: %u reads, %u bytes, %.1f ms (est.)\n",
+           flash.numReads(), static_cast<unsigned int>(flash.numReadBytes()), accessTime_ms(flash));
+    check("mount after sensor logs", is_mounted);
+
+    flash.resetCounters();
+    bool     is_ok      = is_mounted && verifyAll(lfs);
+    uint64_t user_bytes = 0;
+    for(uint16_t l = 0; l < NUM_LOGS; l++) {
+      if(log_size[l] > 0) user_bytes += log_size[l];
+    }
+    printf("  read back %u bytes: %u reads, read amplification %.2f, %.1f kB/s (est.)\n",
+           static_cast<unsigned int>(user_bytes), flash.numReads(),
+           static_cast<double>(flash.numReadBytes()) / user_bytes, user_bytes / accessTime_ms(flash));
+    check("sensor logs persist", is_ok);
+
+    if(is_mounted) lfs_unmount(&lfs);
+  }
+
+  /* POWER FAILURE ********************************************************************/
+  {
+    bool     is_ok         = true;
+    uint32_t num_committed = 0;
+    uint32_t num_rolled    = 0;
+
+    for(uint16_t n = 0; (n < NUM_POWER_FAILS) && is_ok; n++)
+    {
+      lfs_t lfs;
+      if(bd.mount(lfs, false) != LFS_ERR_OK) { is_ok = false; break; }
+
+      flash.failAfter(1 + rnd() % 16000);
+
+      /* Operate until the power fails */
+      uint16_t l      = 0;
+      int32_t  before = 0,
+               after  = 0;
+      for(;;)
+      {
+        l      = rnd() % NUM_LOGS;
+        before = log_size[l];
+        if(log_size[l] >= static_cast<int32_t>(MAX_LOG_SIZE)) {
+          after = -1;
+          if(!removeLog(lfs, l)) break;
+        } else {
+          uint32_t const size = RECORD_SIZE * (1 + rnd() % (4 * SYNC_INTERVAL));
+          after = ((before < 0) ? 0 : before) + size;
+          if(!appendLog(lfs, l, size)) break;
+        }
+        log_size[l] = after;
+      }
+
+      flash.failAfter(memory::FileNorFlash::NO_FAILURE);
+
+      /* After the reboot the interrupted operation is either complete or absent,
+       * creating a log is committed before its first record.
+       */
+      lfs_t rebooted;
+      if(bd.mount(rebooted, false) != LFS_ERR_OK) { is_ok = false; break; }
+
+      int32_t const size = verifyLog(rebooted, l);
+      if(size == after) {
+        num_committed++;
+      } else if((size == before) || ((before < 0) && (size == 0))) {
+        num_rolled++;
+      } else {
+        is_ok = false;
+      }
+      log_size[l] = size;
+
+      is_ok &= verifyAll(rebooted);
+      lfs_unmount(&rebooted);
+    }
+
+    printf("  %u power failures: %u interrupted operations committed, %u rolled back\n", NUM_POWER_FAILS, num_committed, num_rolled);
+    check("power failure", is_ok);
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,261 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Latency benchmark of driver::memory::N25Q256AEraseScheduler and
+ * driver::memory::N25Q256AErasePool on the simulated N25Q256A (8 MHz SPI
+ * clock, typical subsector erase time of 250 ms, erase suspend latency of
+ * 15 us).
+ *
+ * READS DURING ERASE: a 64 byte read is issued every millisecond while a
+ * subsector is being erased, once waiting for the erase to complete before
+ * each read (the behaviour of the blocking N25Q256A::erase()) and once
+ * suspending the erase for each read.
+ *
+ * LOGGING: a record of 256 bytes is appended every 20 ms to a circular log
+ * of 16 subsectors, once erasing each subsector when the log enters it and
+ * once with a pool of 4 subsectors erased in the background.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-n25q256a-erase-scheduler-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/SpiNorIo.h"
+#include "../memory/common/N25Q256AFastPath.h"
+#include "../memory/common/N25Q256AErasePool.h"
+#include "../memory/common/N25Q256AEraseScheduler.h"
+#include "../memory/common/SimulatedN25Q256A.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const SPI_CLOCK_Hz       = 8000000UL;
+static uint64_t const MS_ns              = 1000000ULL;
+
+static uint32_t const READ_SIZE          = 64;
+static uint32_t const READ_BLOCK         = 100;
+
+static uint32_t const LOG_FIRST_BLOCK    = 16;
+static uint32_t const LOG_NUM_BLOCKS     = 16;
+static uint16_t const LOG_NUM_PRE_ERASED = 4;
+static uint32_t const LOG_RECORD_SIZE    = memory::N25Q256A_PAGE_SIZE;
+static uint64_t const LOG_INTERVAL_ns    = 20 * MS_ns;
+static uint32_t const LOG_NUM_RECORDS    = 3 * LOG_NUM_BLOCKS * (memory::N25Q256A_SUBSECTOR_SIZE / LOG_RECORD_SIZE);
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint8_t pattern(uint32_t const record, uint32_t const pos)
+{
+  return static_cast<uint8_t>((record * 31) ^ pos);
+}
+
+static bool isErased(memory::SimulatedN25Q256A & flash, uint32_t const addr, uint32_t const size)
+{
+  for(uint32_t i = 0; i < size; i++) {
+    if(flash.data()[addr + i] != 0xFF) return false;
+  }
+  return true;
+}
+
+/* Reads every millisecond during the erase of block 0, returns the maximum read latency */
+static uint64_t readsDuringErase(memory::SimulatedN25Q256A & flash, memory::N25Q256AEraseScheduler & eraser, bool const is_blocking, uint32_t & num_reads, bool & is_ok)
+{
+  uint32_t const read_addr = READ_BLOCK * eraser.eraseSize();
+  uint8_t        buf[READ_SIZE];
+  uint64_t       max_latency_ns = 0;
+
+  for(uint32_t i = 0; i < READ_SIZE; i++) flash.data()[read_addr + i] = static_cast<uint8_t>(i);
+  memset(flash.data(), 0x00, eraser.eraseSize());
+
+  is_ok     = eraser.eraseAsync(0);
+  num_reads = 0;
+
+  while(eraser.poll() != memory::N25Q256AEraseScheduler::NO_BLOCK)
+  {
+    uint64_t const start_ns = flash.now_ns();
+    if(is_blocking) eraser.waitIdle();
+    is_ok &= (eraser.read(read_addr, buf, sizeof(buf)) == sizeof(buf));
+    uint64_t const latency_ns = flash.now_ns() - start_ns;
+
+    for(uint32_t i = 0; i < READ_SIZE; i++) is_ok &= (buf[i] == static_cast<uint8_t>(i));
+    if(latency_ns > max_latency_ns) max_latency_ns = latency_ns;
+    num_reads++;
+
+    flash.advance(MS_ns);
+  }
+
+  is_ok &= eraser.waitIdle() && isErased(flash, 0, eraser.eraseSize());
+  return max_latency_ns;
+}
+
+/* Appends LOG_NUM_RECORDS records, returns the maximum latency of appending a record */
+static uint64_t logging(memory::SimulatedN25Q256A & flash, memory::N25Q256AEraseScheduler & eraser, memory::N25Q256AErasePool * pool, uint32_t & num_waits, bool & is_ok)
+{
+  uint32_t const records_per_block = eraser.eraseSize() / LOG_RECORD_SIZE;
+  uint8_t        record[LOG_RECORD_SIZE];
+  uint32_t       block          = 0;
+  uint64_t       max_latency_ns = 0;
+
+  memset(flash.data() + LOG_FIRST_BLOCK * eraser.eraseSize(), 0x00, LOG_NUM_BLOCKS * eraser.eraseSize());
+
+  is_ok     = true;
+  num_waits = 0;
+
+  /* The pool is filled during start-up */
+  while(pool && (pool->numErased() < LOG_NUM_PRE_ERASED)) {
+    pool->service();
+    flash.advance(MS_ns);
+  }
+
+  for(uint32_t r = 0; r < LOG_NUM_RECORDS; r++)
+  {
+    for(uint32_t i = 0; i < LOG_RECORD_SIZE; i++) record[i] = pattern(r, i);
+
+    uint64_t const start_ns = flash.now_ns();
+
+    if((r % records_per_block) == 0)
+    {
+      if(pool) {
+        is_ok &= pool->take(block);
+      } else {
+        block = LOG_FIRST_BLOCK + (r / records_per_block) % LOG_NUM_BLOCKS;
+        is_ok &= eraser.eraseAsync(block) && eraser.waitIdle();
+        num_waits++;
+      }
+    }
+
+    uint32_t const addr = block * eraser.eraseSize() + (r % records_per_block) * LOG_RECORD_SIZE;
+    is_ok &= (eraser.prog(addr, record, sizeof(record)) == sizeof(record));
+
+    uint64_t const latency_ns = flash.now_ns() - start_ns;
+    if(latency_ns > max_latency_ns) max_latency_ns = latency_ns;
+
+    /* Idle time until the next record */
+    for(uint64_t t = 0; t < LOG_INTERVAL_ns; t += MS_ns) {
+      if(pool) pool->service();
+      flash.advance(MS_ns);
+    }
+  }
+
+  if(pool) num_waits = pool->numTakeWaits();
+  is_ok &= eraser.waitIdle();
+
+  /* The last pass over the log is complete, except for the blocks ahead
+   * of the write position which have already been erased by the pool.
+   */
+  uint32_t const num_log_records   = LOG_NUM_BLOCKS * records_per_block;
+  uint32_t const num_valid_records = (pool ? (LOG_NUM_BLOCKS - LOG_NUM_PRE_ERASED) : LOG_NUM_BLOCKS) * records_per_block;
+  for(uint32_t r = LOG_NUM_RECORDS - num_valid_records; r < LOG_NUM_RECORDS; r++)
+  {
+    uint32_t const addr = (LOG_FIRST_BLOCK * records_per_block + r % num_log_records) * LOG_RECORD_SIZE;
+    for(uint32_t i = 0; i < LOG_RECORD_SIZE; i++) is_ok &= (flash.data()[addr + i] == pattern(r, i));
+  }
+
+  return max_latency_ns;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  memory::SimulatedN25Q256A      flash    (SPI_CLOCK_Hz, memory::N25Q256A_FLASH_SIZE);
+  memory::SpiNorIo               io       (flash, flash);
+  memory::N25Q256AFastPath       fast_path(io, memory::N25Q256AReadMode::FastRead);
+  memory::N25Q256AEraseScheduler eraser   (io, fast_path, flash, memory::N25Q256AEraseSize::Subsector);
+
+  /* READS DURING ERASE ***************************************************************/
+  {
+    uint32_t num_reads = 0;
+    bool     is_ok     = false;
+
+    printf("Reads during a subsector erase (1 read per ms):\n");
+
+    flash.resetCounters(); eraser.resetStatistics();
+    uint64_t start_ns = flash.now_ns();
+    uint64_t const blocking_ns = readsDuringErase(flash, eraser, true, num_reads, is_ok);
+    printf("  %-24s %4u reads | max. latency %9.3f ms | erase %6.1f ms\n", "wait for erase", num_reads, blocking_ns / 1.0E6, (flash.now_ns() - start_ns) / 1.0E6);
+    check("wait for erase", is_ok);
+
+    flash.resetCounters(); eraser.resetStatistics();
+    start_ns = flash.now_ns();
+    uint64_t const suspend_ns = readsDuringErase(flash, eraser, false, num_reads, is_ok);
+    printf("  %-24s %4u reads | max. latency %9.3f ms | erase %6.1f ms | %u suspends\n", "suspend erase", num_reads, suspend_ns / 1.0E6, (flash.now_ns() - start_ns) / 1.0E6, eraser.numSuspends());
+    check("suspend erase", is_ok && (eraser.numSuspends() == flash.numSuspends()) && (eraser.numSuspends() > 0));
+    check("suspend erase, read latency < 1 ms", suspend_ns < MS_ns);
+  }
+
+  /* READ/PROG OF THE BLOCK BEING ERASED **********************************************/
+  {
+    uint8_t buf[16];
+    eraser.resetStatistics();
+    bool is_ok = eraser.eraseAsync(1);
+    is_ok &= (eraser.read(eraser.eraseSize() + 100, buf, sizeof(buf)) == sizeof(buf));
+    is_ok &= (eraser.poll() == memory::N25Q256AEraseScheduler::NO_BLOCK) && (eraser.numEraseWaits() == 1);
+    is_ok &= isErased(flash, eraser.eraseSize(), eraser.eraseSize());
+    check("read of the block being erased waits", is_ok);
+
+    check("second erase rejected", eraser.eraseAsync(2) && !eraser.eraseAsync(3) && eraser.waitIdle());
+  }
+
+  /* LOGGING **************************************************************************/
+  {
+    uint32_t num_waits = 0;
+    bool     is_ok     = false;
+
+    printf("Logging %u records of %u bytes every %u ms to %u subsectors:\n",
+           LOG_NUM_RECORDS, LOG_RECORD_SIZE, static_cast<unsigned int>(LOG_INTERVAL_ns / MS_ns), LOG_NUM_BLOCKS);
+
+    flash.resetCounters(); eraser.resetStatistics();
+    uint64_t const on_demand_ns = logging(flash, eraser, nullptr, num_waits, is_ok);
+    printf("  %-24s %4u waits for erase | max. latency %9.3f ms\n", "erase on demand", num_waits, on_demand_ns / 1.0E6);
+    check("erase on demand", is_ok);
+
+    memory::N25Q256AErasePool pool(eraser, LOG_FIRST_BLOCK, LOG_NUM_BLOCKS, LOG_NUM_PRE_ERASED);
+
+    flash.resetCounters(); eraser.resetStatistics();
+    uint64_t const pool_ns = logging(flash, eraser, &pool, num_waits, is_ok);
+    printf("  %-24s %4u waits for erase | max. latency %9.3f ms | %u suspends\n", "pre-erase pool", num_waits, pool_ns / 1.0E6, eraser.numSuspends());
+    check("pre-erase pool", is_ok);
+    check("pre-erase pool, no waits for erase", num_waits == 0);
+    check("pre-erase pool, append latency < 5 ms", pool_ns < 5 * MS_ns);
+  }
+
+  return checkResult();
+}
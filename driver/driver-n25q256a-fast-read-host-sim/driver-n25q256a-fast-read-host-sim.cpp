@@ -0,0 +1,182 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Benchmark of sequential N25Q256A scans on the simulated device.
+ *
+ * The SPI clock is set to 8 MHz (F_CPU / 2 on a 16 MHz ATMEGA328P, the
+ * fastest clock the AVR SPI provides). Throughput is derived from the
+ * simulated bus time, i.e. it is the upper limit for a CPU which keeps
+ * the SPI busy all the time.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-n25q256a-fast-read-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/SpiNorIo.h"
+#include "../memory/common/N25Q256AFastPath.h"
+#include "../memory/common/SimulatedN25Q256A.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const SPI_CLOCK_Hz   = 8000000UL;
+static uint32_t const MAX_CHUNK_SIZE = 64UL * 1024UL;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+static uint8_t chunk_buf[MAX_CHUNK_SIZE];
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint8_t pattern(uint32_t const addr)
+{
+  return static_cast<uint8_t>(addr ^ (addr >> 8) ^ (addr >> 16) ^ (addr >> 24));
+}
+
+static bool verify(uint32_t const addr, uint8_t const * buf, uint32_t const size)
+{
+  for(uint32_t i = 0; i < size; i++) {
+    if(buf[i] != pattern(addr + i)) return false;
+  }
+  return true;
+}
+
+static void report(char const * name, memory::SimulatedN25Q256A const & flash, uint64_t const start_ns, uint32_t const payload)
+{
+  double const duration_s = static_cast<double>(flash.now_ns() - start_ns) / 1.0E9;
+  printf("  %-34s %5u MB | %7u transactions | %.3f SPI bytes/byte | %6.1f s | %.3f MB/s\n",
+         name,
+         static_cast<unsigned int>(payload / (1024UL * 1024UL)),
+         flash.numTransactions(),
+         static_cast<double>(flash.numBytes()) / payload,
+         duration_s,
+         payload / duration_s / 1.0E6);
+}
+
+/* Scans [0, limit) in chunks of chunk_size using one raw command per chunk */
+static bool scanRaw(memory::SpiNorIo & io, uint8_t const instr, uint8_t const addr_bytes, uint8_t const dummy_cycles, uint32_t const limit, uint32_t const chunk_size)
+{
+  bool is_valid = true;
+  for(uint32_t addr = 0; addr < limit; addr += chunk_size) {
+    io.read(instr, addr, addr_bytes, dummy_cycles, chunk_buf, chunk_size);
+    is_valid &= verify(addr, chunk_buf, chunk_size);
+  }
+  return is_valid;
+}
+
+static bool scanFastPath(memory::N25Q256AFastPath & fast_path, uint32_t const chunk_size)
+{
+  bool is_valid = true;
+  for(uint32_t addr = 0; addr < memory::N25Q256A_FLASH_SIZE; addr += chunk_size) {
+    is_valid &= (fast_path.read(addr, chunk_buf, chunk_size) == chunk_size);
+    is_valid &= verify(addr, chunk_buf, chunk_size);
+  }
+  return is_valid;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  memory::SimulatedN25Q256A flash(SPI_CLOCK_Hz, memory::N25Q256A_FLASH_SIZE);
+  memory::SpiNorIo          io   (flash, flash);
+
+  for(uint32_t addr = 0; addr < memory::N25Q256A_FLASH_SIZE; addr++) {
+    flash.data()[addr] = pattern(addr);
+  }
+
+  memory::N25Q256AFastPath read_path     (io, memory::N25Q256AReadMode::Read);
+  memory::N25Q256AFastPath fast_read_path(io, memory::N25Q256AReadMode::FastRead);
+
+  printf("Sequential scan @ %u MHz SPI clock:\n", static_cast<unsigned int>(SPI_CLOCK_Hz / 1000000UL));
+
+  uint64_t start_ns = 0;
+
+  /* READ (3-byte address) with 16 byte chunks - the access pattern of the
+   * driver-n25q256a-spi-atmega328p example, limited to the lower 16 MB.
+   */
+  flash.resetCounters(); start_ns = flash.now_ns();
+  bool const is_read_3_byte_valid = scanRaw(io, memory::SPI_NOR_CMD_READ, 3, 0, memory::N25Q256A_3_BYTE_ADDR_LIMIT, 16);
+  report("READ 3-byte addr, 16 B chunks", flash, start_ns, memory::N25Q256A_3_BYTE_ADDR_LIMIT);
+
+  flash.resetCounters(); start_ns = flash.now_ns();
+  bool const is_read_4_byte_valid = scanRaw(io, memory::SPI_NOR_CMD_4_BYTE_READ, 4, 0, memory::N25Q256A_FLASH_SIZE, 16);
+  report("4-BYTE READ, 16 B chunks", flash, start_ns, memory::N25Q256A_FLASH_SIZE);
+
+  flash.resetCounters(); start_ns = flash.now_ns();
+  bool const is_fast_read_256_valid = scanFastPath(fast_read_path, 256);
+  report("4-BYTE FAST READ, 256 B chunks", flash, start_ns, memory::N25Q256A_FLASH_SIZE);
+
+  flash.resetCounters(); start_ns = flash.now_ns();
+  bool const is_fast_read_64k_valid = scanFastPath(fast_read_path, MAX_CHUNK_SIZE);
+  report("4-BYTE FAST READ, 64 KB chunks", flash, start_ns, memory::N25Q256A_FLASH_SIZE);
+
+  check("enter 4-byte address mode", fast_read_path.enter4ByteAddressMode() && fast_read_path.is4ByteAddressMode());
+
+  flash.resetCounters(); start_ns = flash.now_ns();
+  bool const is_fast_read_4_byte_mode_valid = scanFastPath(fast_read_path, MAX_CHUNK_SIZE);
+  report("4-byte mode FAST READ, 64 KB chunks", flash, start_ns, memory::N25Q256A_FLASH_SIZE);
+
+  flash.resetCounters(); start_ns = flash.now_ns();
+  bool const is_read_4_byte_mode_valid = scanFastPath(read_path, MAX_CHUNK_SIZE);
+  report("4-byte mode READ, 64 KB chunks", flash, start_ns, memory::N25Q256A_FLASH_SIZE);
+
+  check("READ 3-byte address data",           is_read_3_byte_valid);
+  check("4-BYTE READ data",                   is_read_4_byte_valid);
+  check("4-BYTE FAST READ 256 B data",        is_fast_read_256_valid);
+  check("4-BYTE FAST READ 64 KB data",        is_fast_read_64k_valid);
+  check("4-byte mode FAST READ data",         is_fast_read_4_byte_mode_valid);
+  check("4-byte mode READ data",              is_read_4_byte_mode_valid);
+
+  /* A single read across the 16 MB boundary */
+  uint32_t const cross_addr = memory::N25Q256A_3_BYTE_ADDR_LIMIT - 128;
+  check("read across 16 MB boundary", (fast_read_path.read(cross_addr, chunk_buf, 256) == 256) && verify(cross_addr, chunk_buf, 256));
+
+  check("read beyond end of flash rejected",  fast_read_path.read(memory::N25Q256A_FLASH_SIZE - 16, chunk_buf, 32) == 0);
+  check("read at end of flash rejected",      fast_read_path.read(memory::N25Q256A_FLASH_SIZE, chunk_buf, 1) == 0);
+
+  check("exit 4-byte address mode", fast_read_path.exit4ByteAddressMode() && !fast_read_path.is4ByteAddressMode());
+  check("READ after exit", (read_path.read(cross_addr, chunk_buf, 256) == 256) && verify(cross_addr, chunk_buf, 256));
+
+  return checkResult();
+}
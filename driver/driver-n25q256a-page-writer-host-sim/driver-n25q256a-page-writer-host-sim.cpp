@@ -0,0 +1,192 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Benchmark of N25Q256A programming on the simulated device.
+ *
+ * 64 kB are written in small chunks, once with one PAGE PROGRAM per chunk
+ * followed by busy-polling of the status register (the behaviour of the
+ * N25Q256A driver) and once via driver::memory::N25Q256APageWriter. The
+ * simulation applies the typical page program time of 0.5 ms to every
+ * PAGE PROGRAM regardless of the number of bytes, the rated throughput is
+ * one full page per page program time.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-n25q256a-page-writer-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/SpiNorIo.h"
+#include "../memory/common/N25Q256APageWriter.h"
+#include "../memory/common/SimulatedN25Q256A.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const SPI_CLOCK_Hz = 8000000UL;
+static uint32_t const REGION_SIZE  = 64UL * 1024UL;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint8_t pattern(uint32_t const addr)
+{
+  return static_cast<uint8_t>((addr * 7) ^ (addr >> 8));
+}
+
+static bool verify(memory::SimulatedN25Q256A & flash, uint32_t const addr, uint32_t const size)
+{
+  for(uint32_t i = 0; i < size; i++) {
+    if(flash.data()[addr + i] != pattern(addr + i)) return false;
+  }
+  return true;
+}
+
+static void report(char const * name, memory::SimulatedN25Q256A & flash, uint64_t const start_ns)
+{
+  double const duration_s = static_cast<double>(flash.now_ns() - start_ns) / 1.0E9;
+  double const rated_s    = static_cast<double>(REGION_SIZE / memory::N25Q256A_PAGE_SIZE) * memory::SimulatedN25Q256A::PAGE_PROGRAM_TIME_ns / 1.0E9;
+  printf("  %-32s %5u page programs | %6u status reads | %7u SPI bytes | %7.1f ms | %6.1f kB/s | %5.1f %% of rated\n",
+         name,
+         flash.numPrograms(),
+         flash.numStatusReads(),
+         static_cast<unsigned int>(flash.numBytes()),
+         duration_s * 1.0E3,
+         REGION_SIZE / duration_s / 1.0E3,
+         100.0 * rated_s / duration_s);
+}
+
+/* One PAGE PROGRAM per call, the status register is polled back-to-back */
+static void progPerCall(memory::SpiNorIo & io, uint32_t const addr, uint8_t const * buf, uint32_t const size)
+{
+  io.command(memory::SPI_NOR_CMD_WRITE_ENABLE);
+  io.write  (memory::SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM, addr, 4, buf, size);
+  while(io.readStatusRegister() & memory::SPI_NOR_STATUS_REG_WIP_bm) { }
+}
+
+static void writeRegion(uint32_t const base, uint32_t const chunk_size, memory::SpiNorIo * io, memory::N25Q256APageWriter * writer)
+{
+  uint8_t chunk[memory::N25Q256A_PAGE_SIZE];
+
+  for(uint32_t addr = base; addr < (base + REGION_SIZE); addr += chunk_size)
+  {
+    uint32_t const size = ((base + REGION_SIZE - addr) < chunk_size) ? (base + REGION_SIZE - addr) : chunk_size;
+    for(uint32_t i = 0; i < size; i++) {
+      chunk[i] = pattern(addr + i);
+    }
+    if(writer) writer->prog(addr, chunk, size);
+    else       progPerCall(*io, addr, chunk, size);
+  }
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  memory::SimulatedN25Q256A  flash (SPI_CLOCK_Hz, memory::N25Q256A_FLASH_SIZE);
+  memory::SpiNorIo           io    (flash, flash);
+  memory::N25Q256APageWriter writer(io, flash);
+
+  printf("Programming %u kB @ %u MHz SPI clock:\n", static_cast<unsigned int>(REGION_SIZE / 1024UL), static_cast<unsigned int>(SPI_CLOCK_Hz / 1000000UL));
+
+  uint64_t start_ns = 0;
+  uint32_t base     = 0;
+
+  /* 16 byte chunks as in driver-n25q256a-spi-atmega328p */
+  flash.resetCounters(); start_ns = flash.now_ns();
+  writeRegion(base, 16, &io, nullptr);
+  report("prog per call, 16 B", flash, start_ns);
+  check("prog per call, 16 B data", verify(flash, base, REGION_SIZE));
+  base += REGION_SIZE;
+
+  /* Whole pages, the best case for a caller doing its own buffering */
+  flash.resetCounters(); start_ns = flash.now_ns();
+  writeRegion(base, memory::N25Q256A_PAGE_SIZE, &io, nullptr);
+  report("prog per call, 256 B", flash, start_ns);
+  check("prog per call, 256 B data", verify(flash, base, REGION_SIZE));
+  base += REGION_SIZE;
+
+  flash.resetCounters(); writer.resetStatistics(); start_ns = flash.now_ns();
+  writeRegion(base, 16, nullptr, &writer);
+  bool const is_sync_16_ok = writer.sync();
+  report("page writer, 16 B", flash, start_ns);
+  check("page writer, 16 B sync", is_sync_16_ok);
+  check("page writer, 16 B data", verify(flash, base, REGION_SIZE));
+  check("page writer, 16 B one program per page", writer.numPagePrograms() == (REGION_SIZE / memory::N25Q256A_PAGE_SIZE));
+  base += REGION_SIZE;
+
+  /* Chunks crossing page boundaries, starting in the middle of a page */
+  flash.resetCounters(); writer.resetStatistics(); start_ns = flash.now_ns();
+  writeRegion(base + 100, 20, nullptr, &writer);
+  bool const is_sync_20_ok = writer.sync();
+  report("page writer, 20 B unaligned", flash, start_ns);
+  check("page writer, 20 B unaligned sync", is_sync_20_ok);
+  check("page writer, 20 B unaligned data", verify(flash, base + 100, REGION_SIZE));
+  check("page writer, 20 B unaligned programs", writer.numPagePrograms() == (REGION_SIZE / memory::N25Q256A_PAGE_SIZE) + 1);
+  check("page writer, 20 B unaligned leaves neighbours erased", (flash.data()[base + 99] == 0xFF) && (flash.data()[base + 100 + REGION_SIZE] == 0xFF));
+  base += 2 * REGION_SIZE;
+
+  /* Gaps within a page keep the data programmed before */
+  uint8_t const old_data[4] = {0x11, 0x22, 0x33, 0x44};
+  uint8_t const new_data[4] = {0xA0, 0xA1, 0xA2, 0xA3};
+  writer.prog(base + 4, old_data, sizeof(old_data));
+  writer.sync();
+  writer.prog(base + 0, new_data, sizeof(new_data));
+  writer.prog(base + 8, new_data, sizeof(new_data));
+  writer.sync();
+  check("gap keeps data", (memcmp(flash.data() + base + 4, old_data, 4) == 0) && (memcmp(flash.data() + base, new_data, 4) == 0) && (memcmp(flash.data() + base + 8, new_data, 4) == 0));
+
+  /* Repeated writes to the same byte before a flush behave like NOR programming */
+  uint8_t const first  = 0xF0;
+  uint8_t const second = 0x3C;
+  writer.prog(base + 32, &first,  1);
+  writer.prog(base + 32, &second, 1);
+  writer.sync();
+  check("repeated write ANDs", flash.data()[base + 32] == (first & second));
+
+  /* Data is not in the flash before flush()/sync() */
+  uint8_t const pending = 0x55;
+  writer.prog(base + 64, &pending, 1);
+  check("pending data buffered", flash.data()[base + 64] == 0xFF);
+  writer.sync();
+  check("pending data programmed after sync", flash.data()[base + 64] == pending);
+
+  check("write beyond end of flash rejected", writer.prog(memory::N25Q256A_FLASH_SIZE - 2, new_data, sizeof(new_data)) == 0);
+
+  return checkResult();
+}
@@ -0,0 +1,392 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Benchmark and power-fail test of driver::memory::NorKvStore on a file
+ * backed NOR flash image (64 blocks of 4 kB, the N25Q256A subsector size).
+ *
+ * The flash access time is estimated from the recorded accesses assuming a
+ * N25Q256A at 8 MHz SPI clock: 1 us per transferred byte plus 5 bytes of
+ * command overhead per read/prog, 0.5 ms per prog (page program) and
+ * 250 ms per erase (subsector erase).
+ *
+ * The page wrap test uses a 256 byte program page (the N25Q256A page size)
+ * and checks that NorFlashDriverAdapter splits records crossing a page.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-nor-kv-store-host-sim [image file]
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/NorKvStore.h"
+#include "../memory/common/FileNorFlash.h"
+#include "../memory/common/NorFlashDriverAdapter.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const ERASE_SIZE      = 4096;
+static uint16_t const NUM_BLOCKS      = 64;
+static uint16_t const INDEX_CAPACITY  = 256;
+
+static uint16_t const NUM_KEYS        = 100;
+static uint16_t const NUM_HOT_KEYS    = 10;
+static uint16_t const MAX_VALUE_SIZE  = 64;
+static uint32_t const NUM_UPDATES     = 20000;
+static uint16_t const NUM_POWER_FAILS = 500;
+static uint32_t const PAGE_SIZE       = 256;
+
+static double   const BYTE_TIME_us    = 1.0;
+static double   const CMD_OVERHEAD_us = 5.0 * BYTE_TIME_us;
+static double   const PROG_TIME_us    = 500.0;
+static double   const ERASE_TIME_us   = 250000.0;
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+typedef struct
+{
+  int16_t size; /* -1 = key does not exist */
+  uint8_t value[MAX_VALUE_SIZE];
+} ShadowEntry;
+
+typedef struct
+{
+  uint32_t read_size;
+  uint32_t prog_size;
+  uint32_t erase_size;
+  uint32_t block_count;
+} FlashInfo;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Mimics the memory driver interface wrapped by NorFlashDriverAdapter
+ * (read/prog return the number of bytes transferred or -1).
+ */
+class FileNorDriver
+{
+public:
+  FileNorDriver(memory::FileNorFlash & flash) : _flash(flash) { }
+
+  int32_t read (uint32_t const block, uint32_t const off, uint8_t       * buf, uint32_t const size) { return _flash.read(block, off, buf, size) ? static_cast<int32_t>(size) : -1; }
+  int32_t prog (uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size) { return _flash.prog(block, off, buf, size) ? static_cast<int32_t>(size) : -1; }
+  bool    erase(uint32_t const block) { return _flash.erase(block); }
+
+private:
+  memory::FileNorFlash & _flash;
+};
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+static uint32_t               rnd_state    = 12345;
+static ShadowEntry            shadow[NUM_KEYS];
+static memory::NorKvIndexEntry index_buf[INDEX_CAPACITY];
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint32_t rnd()
+{
+  rnd_state = rnd_state * 1103515245UL + 12345UL;
+  return rnd_state >> 8;
+}
+
+static void keyOf(uint16_t const k, char * key)
+{
+  snprintf(key, 16, "cfg/%03u", k);
+}
+
+static double accessTime_ms(memory::FileNorFlash const & flash)
+{
+  double const read_us  = flash.numReads()  * CMD_OVERHEAD_us + flash.numReadBytes() * BYTE_TIME_us;
+  double const prog_us  = flash.numProgs()  * (CMD_OVERHEAD_us + BYTE_TIME_us + PROG_TIME_us) + flash.numProgBytes() * BYTE_TIME_us;
+  double const erase_us = flash.numErases() * (CMD_OVERHEAD_us + BYTE_TIME_us + ERASE_TIME_us);
+  return (read_us + prog_us + erase_us) / 1000.0;
+}
+
+static bool putRandom(memory::NorKvStore & kv, uint16_t const k, ShadowEntry & pending)
+{
+  char key[16];
+  keyOf(k, key);
+
+  pending.size = static_cast<int16_t>(8 + rnd() % (MAX_VALUE_SIZE - 8 + 1));
+  for(int16_t i = 0; i < pending.size; i++) pending.value[i] = static_cast<uint8_t>(rnd());
+
+  return kv.put(key, pending.value, pending.size);
+}
+
+static bool matches(memory::NorKvStore & kv, uint16_t const k, ShadowEntry const & expected)
+{
+  char    key[16];
+  uint8_t value[MAX_VALUE_SIZE];
+  keyOf(k, key);
+
+  int32_t const size = kv.get(key, value, sizeof(value));
+  if(expected.size < 0) return (size < 0);
+  return (size == expected.size) && (memcmp(value, expected.value, size) == 0);
+}
+
+static bool verifyAll(memory::NorKvStore & kv)
+{
+  for(uint16_t k = 0; k < NUM_KEYS; k++) {
+    if(!matches(kv, k, shadow[k])) return false;
+  }
+  return true;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main(int argc, char ** argv)
+{
+  char const * file_name = (argc > 1) ? argv[1] : "nor-kv-store-host-sim.bin";
+  unlink(file_name);
+
+  memory::FileNorFlash flash(file_name, 1, ERASE_SIZE, NUM_BLOCKS, memory::FileNorFlash::NO_PAGE_WRAP);
+  check("flash image opened", flash.isOpen());
+  if(!flash.isOpen()) return 1;
+
+  for(uint16_t k = 0; k < NUM_KEYS; k++) shadow[k].size = -1;
+
+  /* FILL *****************************************************************************/
+  {
+    memory::NorKvStore kv(flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+    check("mount empty image", kv.mount() && (kv.numKeys() == 0));
+
+    bool is_ok = true;
+    for(uint16_t k = 0; k < NUM_KEYS; k++) {
+      ShadowEntry pending;
+      is_ok &= putRandom(kv, k, pending);
+      shadow[k] = pending;
+    }
+    check("fill", is_ok && (kv.numKeys() == NUM_KEYS) && verifyAll(kv));
+    printf("  capacity %u bytes, live %u bytes\n", kv.capacity(), kv.liveBytes());
+  }
+
+  /* UPDATES **************************************************************************/
+  {
+    memory::NorKvStore kv(flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+    check("mount after fill", kv.mount() && (kv.numKeys() == NUM_KEYS) && verifyAll(kv));
+
+    flash.resetCounters();
+    uint64_t user_bytes = 0;
+    bool     is_ok      = true;
+
+    for(uint32_t n = 0; n < NUM_UPDATES; n++)
+    {
+      /* 90 % of the updates hit 10 % of the keys */
+      uint16_t const k = ((rnd() % 10) != 0) ? (rnd() % NUM_HOT_KEYS) : (NUM_HOT_KEYS + rnd() % (NUM_KEYS - NUM_HOT_KEYS));
+      ShadowEntry pending;
+      is_ok &= putRandom(kv, k, pending);
+      shadow[k]   = pending;
+      user_bytes += 7 + pending.size;
+    }
+    is_ok &= verifyAll(kv);
+
+    uint32_t min_erase = 0xFFFFFFFF, max_erase = 0;
+    for(uint16_t b = 0; b < NUM_BLOCKS; b++) {
+      if(flash.eraseCount(b) < min_erase) min_erase = flash.eraseCount(b);
+      if(flash.eraseCount(b) > max_erase) max_erase = flash.eraseCount(b);
+    }
+
+    double const time_ms = accessTime_ms(flash);
+    printf("  %u updates: %u progs, %u erases, %u compactions, write amplification %.2f, %.2f ms/update (est.)\n",
+           NUM_UPDATES, flash.numProgs(), flash.numErases(), kv.numCompactions(),
+           static_cast<double>(flash.numProgBytes()) / user_bytes, time_ms / NUM_UPDATES);
+    printf("  erase count per block: min %u, max %u\n", min_erase, max_erase);
+
+    check("updates", is_ok);
+    check("wear leveling (erase count spread <= 1)", (max_erase - min_erase) <= 1);
+  }
+
+  /* MOUNT ****************************************************************************/
+  {
+    memory::NorKvStore kv(flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+    flash.resetCounters();
+    bool const is_mounted = kv.mount();
+    printf("  mount: %u reads, %u bytes, %.1f ms (est.)\n",
+           flash.numReads(), static_cast<unsigned int>(flash.numReadBytes()), accessTime_ms(flash));
+    check("mount after updates", is_mounted && (kv.numKeys() == NUM_KEYS) && verifyAll(kv));
+
+    char key[16];
+    keyOf(0, key);
+    check("remove", kv.remove(key) && (kv.get(key, nullptr, 0) < 0) && !kv.remove(key));
+    shadow[0].size = -1;
+  }
+
+  {
+    memory::NorKvStore kv(flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+    check("remove persists", kv.mount() && (kv.numKeys() == (NUM_KEYS - 1)) && verifyAll(kv));
+  }
+
+  /* POWER FAILURE ********************************************************************/
+  {
+    bool     is_ok         = true;
+    uint32_t num_committed = 0;
+    uint32_t num_rolled    = 0;
+
+    for(uint16_t n = 0; (n < NUM_POWER_FAILS) && is_ok; n++)
+    {
+      memory::NorKvStore kv(flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+      if(!kv.mount() || !verifyAll(kv)) { is_ok = false; break; }
+
+      flash.failAfter(1 + rnd() % 4000);
+
+      /* Operate until the power fails */
+      uint16_t    k = 0;
+      ShadowEntry pending;
+      for(;;)
+      {
+        k = rnd() % NUM_KEYS;
+        if((rnd() % 8) == 0) {
+          char key[16];
+          keyOf(k, key);
+          pending.size = -1;
+          if(shadow[k].size >= 0 && !kv.remove(key)) break;
+        } else {
+          if(!putRandom(kv, k, pending)) break;
+        }
+        shadow[k] = pending;
+      }
+
+      flash.failAfter(memory::FileNorFlash::NO_FAILURE);
+
+      /* After the reboot the interrupted operation is either complete or absent */
+      memory::NorKvStore rebooted(flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+      if(!rebooted.mount()) { is_ok = false; break; }
+
+      if(matches(rebooted, k, pending)) {
+        shadow[k] = pending;
+        num_committed++;
+      } else if(matches(rebooted, k, shadow[k])) {
+        num_rolled++;
+      } else {
+        is_ok = false;
+      }
+      is_ok &= verifyAll(rebooted);
+    }
+
+    printf("  %u power failures: %u interrupted operations committed, %u rolled back\n", NUM_POWER_FAILS, num_committed, num_rolled);
+    check("power failure", is_ok);
+  }
+
+  /* PROG SIZE 16 *********************************************************************/
+  {
+    char aligned_file_name[256];
+    snprintf(aligned_file_name, sizeof(aligned_file_name), "%s.16", file_name);
+    unlink(aligned_file_name);
+
+    memory::FileNorFlash aligned_flash(aligned_file_name, 16, ERASE_SIZE, NUM_BLOCKS, memory::FileNorFlash::NO_PAGE_WRAP);
+    for(uint16_t k = 0; k < NUM_KEYS; k++) shadow[k].size = -1;
+
+    bool is_ok = true;
+    {
+      memory::NorKvStore kv(aligned_flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+      is_ok &= kv.mount();
+      for(uint32_t n = 0; n < NUM_UPDATES; n++) {
+        uint16_t const k = rnd() % NUM_KEYS;
+        ShadowEntry pending;
+        is_ok &= putRandom(kv, k, pending);
+        shadow[k] = pending;
+      }
+    }
+
+    memory::NorKvStore kv(aligned_flash, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+    check("16 byte program granularity", is_ok && kv.mount() && verifyAll(kv));
+
+    unlink(aligned_file_name);
+  }
+
+  /* PAGE WRAP ************************************************************************/
+  {
+    char paged_file_name[256];
+    snprintf(paged_file_name, sizeof(paged_file_name), "%s.page", file_name);
+
+    /* A program running past the end of a page wraps around to its start */
+    {
+      unlink(paged_file_name);
+      memory::FileNorFlash paged_flash(paged_file_name, 1, ERASE_SIZE, NUM_BLOCKS, PAGE_SIZE);
+
+      uint8_t data[16], page[PAGE_SIZE];
+      memset(data, 0x00, sizeof(data));
+      bool const is_ok = paged_flash.prog(0, PAGE_SIZE - 8, data, sizeof(data)) && paged_flash.read(0, 0, page, sizeof(page));
+      check("page program wraps around", is_ok && (page[0] == 0x00) && (page[7] == 0x00) && (page[8] == 0xFF) && (page[PAGE_SIZE - 9] == 0xFF) && (page[PAGE_SIZE - 1] == 0x00));
+    }
+
+    /* NorKvStore appends records regardless of page boundaries */
+    for(uint8_t split = 0; split < 2; split++)
+    {
+      unlink(paged_file_name);
+      FlashInfo const flash_info = {1, 1, ERASE_SIZE, NUM_BLOCKS};
+
+      memory::FileNorFlash          paged_flash(paged_file_name, 1, ERASE_SIZE, NUM_BLOCKS, PAGE_SIZE);
+      FileNorDriver                 driver     (paged_flash);
+      memory::NorFlashDriverAdapter adapter    (driver, flash_info, PAGE_SIZE);
+      memory::interface::NorFlash & flash_used = split ? static_cast<memory::interface::NorFlash &>(adapter) : paged_flash;
+
+      for(uint16_t k = 0; k < NUM_KEYS; k++) shadow[k].size = -1;
+
+      bool is_ok = true;
+      {
+        memory::NorKvStore kv(flash_used, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+        is_ok &= kv.mount();
+        for(uint32_t n = 0; n < NUM_UPDATES / 4; n++) {
+          uint16_t const k = rnd() % NUM_KEYS;
+          ShadowEntry pending;
+          is_ok &= putRandom(kv, k, pending);
+          shadow[k] = pending;
+        }
+      }
+
+      memory::NorKvStore kv(flash_used, 0, NUM_BLOCKS, index_buf, INDEX_CAPACITY);
+      is_ok = is_ok && kv.mount() && verifyAll(kv);
+
+      if(split) check("records crossing a page, split by NorFlashDriverAdapter", is_ok);
+      else      check("records crossing a page, unsplit (corrupted by page wrap)", !is_ok);
+    }
+
+    unlink(paged_file_name);
+  }
+
+  return checkResult();
+}
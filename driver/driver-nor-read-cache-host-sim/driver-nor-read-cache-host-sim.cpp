@@ -0,0 +1,235 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Benchmark and coherence test of driver::memory::NorReadCache on a file
+ * backed NOR flash image (64 blocks of 4 kB, the N25Q256A subsector size).
+ *
+ * Every workload is run once directly on the flash and once through the
+ * cache (8 lines of 64 bytes, 3 lines read-ahead), the flash access time is
+ * estimated from the recorded accesses assuming a N25Q256A at 8 MHz SPI
+ * clock: 1 us per transferred byte plus 5 bytes of command overhead per
+ * read.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-nor-read-cache-host-sim [image file]
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/NorReadCache.h"
+#include "../memory/common/FileNorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const ERASE_SIZE        = 4096;
+static uint16_t const NUM_BLOCKS        = 64;
+
+static uint16_t const NUM_LINES         = 8;
+static uint16_t const LINE_SIZE         = 64;
+static uint16_t const PREFETCH_LINES    = 3;
+
+static uint32_t const NUM_CONFIG_READS  = 10000;
+static uint32_t const CONFIG_AREA_SIZE  = 256;
+static uint16_t const SCAN_FIRST_BLOCK  = 2;
+static uint16_t const SCAN_NUM_BLOCKS   = 16;
+static uint16_t const SCAN_RECORD_SIZE  = 32;
+static uint32_t const NUM_COHERENCE_OPS = 50000;
+
+static double   const BYTE_TIME_us      = 1.0;
+static double   const CMD_OVERHEAD_us   = 5.0 * BYTE_TIME_us;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+static uint32_t                rnd_state    = 12345;
+static uint8_t                 line_buffer[NUM_LINES * LINE_SIZE];
+static memory::NorReadCacheTag tags[NUM_LINES];
+static uint8_t                 shadow[NUM_BLOCKS * ERASE_SIZE];
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint32_t rnd()
+{
+  rnd_state = rnd_state * 1103515245UL + 12345UL;
+  return rnd_state >> 8;
+}
+
+static double readTime_ms(memory::FileNorFlash const & flash)
+{
+  return (flash.numReads() * CMD_OVERHEAD_us + flash.numReadBytes() * BYTE_TIME_us) / 1000.0;
+}
+
+/* Re-reads fields of 4 to 32 bytes of two configuration areas located at the start of block 0 and 1 */
+static bool configReads(memory::interface::NorFlash & flash)
+{
+  uint8_t buf[32];
+  bool    is_ok = true;
+
+  rnd_state = 4711;
+  for(uint32_t n = 0; n < NUM_CONFIG_READS; n++)
+  {
+    uint32_t const block = rnd() % 2;
+    uint32_t const size  = 4 + rnd() % 29;
+    uint32_t const off   = rnd() % (CONFIG_AREA_SIZE - size + 1);
+    is_ok &= flash.read(block, off, buf, size) && (memcmp(buf, shadow + block * ERASE_SIZE + off, size) == 0);
+  }
+  return is_ok;
+}
+
+/* Reads all records of the scan area in ascending order */
+static bool scan(memory::interface::NorFlash & flash)
+{
+  uint8_t buf[SCAN_RECORD_SIZE];
+  bool    is_ok = true;
+
+  for(uint32_t block = SCAN_FIRST_BLOCK; block < (SCAN_FIRST_BLOCK + SCAN_NUM_BLOCKS); block++) {
+    for(uint32_t off = 0; off < ERASE_SIZE; off += SCAN_RECORD_SIZE) {
+      is_ok &= flash.read(block, off, buf, sizeof(buf)) && (memcmp(buf, shadow + block * ERASE_SIZE + off, sizeof(buf)) == 0);
+    }
+  }
+  return is_ok;
+}
+
+static void report(char const * name, memory::FileNorFlash const & flash, double const direct_ms)
+{
+  double const time_ms = readTime_ms(flash);
+  printf("  %-22s %6u flash reads, %8u bytes, %8.1f ms (est.)", name, flash.numReads(), static_cast<unsigned int>(flash.numReadBytes()), time_ms);
+  if(direct_ms > 0.0) printf(", speedup %.2f", direct_ms / time_ms);
+  printf("\n");
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main(int argc, char ** argv)
+{
+  char const * file_name = (argc > 1) ? argv[1] : "nor-read-cache-host-sim.bin";
+  unlink(file_name);
+
+  memory::FileNorFlash flash(file_name, 1, ERASE_SIZE, NUM_BLOCKS, memory::FileNorFlash::NO_PAGE_WRAP);
+  check("flash image opened", flash.isOpen());
+  if(!flash.isOpen()) return 1;
+
+  for(uint32_t i = 0; i < sizeof(shadow); i++) shadow[i] = static_cast<uint8_t>(rnd());
+  for(uint16_t b = 0; b < NUM_BLOCKS; b++) flash.prog(b, 0, shadow + b * ERASE_SIZE, ERASE_SIZE);
+
+  memory::NorReadCache cache(flash, line_buffer, tags, NUM_LINES, LINE_SIZE, PREFETCH_LINES);
+
+  /* CONFIGURATION RE-READS ***********************************************************/
+  {
+    flash.resetCounters();
+    bool const is_direct_ok = configReads(flash);
+    double const direct_ms  = readTime_ms(flash);
+    report("config (direct)", flash, 0.0);
+
+    cache.invalidate();
+    cache.resetCounters();
+    flash.resetCounters();
+    bool const is_cached_ok = configReads(cache);
+    report("config (cached)", flash, direct_ms);
+    printf("  %-22s %u hits, %u misses\n", "", cache.numHits(), cache.numMisses());
+
+    check("configuration re-reads", is_direct_ok && is_cached_ok);
+    check("configuration areas stay cached", cache.numMisses() == (2 * CONFIG_AREA_SIZE / LINE_SIZE));
+  }
+
+  /* SEQUENTIAL SCAN ******************************************************************/
+  {
+    flash.resetCounters();
+    bool const is_direct_ok = scan(flash);
+    double const direct_ms  = readTime_ms(flash);
+    report("scan (direct)", flash, 0.0);
+
+    cache.invalidate();
+    cache.resetCounters();
+    flash.resetCounters();
+    bool const is_cached_ok = scan(cache);
+    report("scan (cached)", flash, direct_ms);
+    printf("  %-22s %u hits, %u misses, %u lines prefetched\n", "", cache.numHits(), cache.numMisses(), cache.numPrefetchedLines());
+
+    uint32_t const num_scan_lines = SCAN_NUM_BLOCKS * ERASE_SIZE / LINE_SIZE;
+    check("sequential scan", is_direct_ok && is_cached_ok);
+    check("read-ahead (one flash read per prefetch window)", cache.numFlashReads() <= (num_scan_lines / (1 + PREFETCH_LINES) + SCAN_NUM_BLOCKS));
+  }
+
+  /* COHERENCE ************************************************************************/
+  {
+    bool     is_ok = true;
+    uint8_t  buf[NUM_LINES * LINE_SIZE];
+
+    rnd_state = 815;
+    for(uint32_t n = 0; (n < NUM_COHERENCE_OPS) && is_ok; n++)
+    {
+      uint32_t const block = rnd() % 4;
+      uint32_t const op    = rnd() % 100;
+
+      if(op < 1)
+      {
+        is_ok &= cache.erase(block);
+        memset(shadow + block * ERASE_SIZE, 0xFF, ERASE_SIZE);
+      }
+      else if(op < 30)
+      {
+        uint32_t const size = 1 + rnd() % 64;
+        uint32_t const off  = rnd() % (ERASE_SIZE - size + 1);
+        for(uint32_t i = 0; i < size; i++) {
+          buf[i] = static_cast<uint8_t>(rnd() | rnd());
+          shadow[block * ERASE_SIZE + off + i] &= buf[i];
+        }
+        is_ok &= cache.prog(block, off, buf, size);
+      }
+      else
+      {
+        /* Sequential reads now and then to exercise the read-ahead */
+        uint32_t const size = 1 + rnd() % sizeof(buf);
+        uint32_t const off  = rnd() % (ERASE_SIZE - size + 1);
+        is_ok &= cache.read(block, off, buf, size) && (memcmp(buf, shadow + block * ERASE_SIZE + off, size) == 0);
+        if(is_ok && ((off + 2 * size) <= ERASE_SIZE) && ((rnd() % 2) == 0)) {
+          is_ok &= cache.read(block, off + size, buf, size) && (memcmp(buf, shadow + block * ERASE_SIZE + off + size, size) == 0);
+        }
+      }
+    }
+
+    check("coherence with prog() and erase()", is_ok);
+  }
+
+  return checkResult();
+}
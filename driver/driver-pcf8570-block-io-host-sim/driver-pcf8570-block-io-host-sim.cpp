@@ -0,0 +1,200 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Bus load of PCF8570 accesses on the simulated I2C bus.
+ *
+ * Writing and reading the whole RAM as 64 chunks of 4 bytes - the access
+ * pattern of the driver-pcf8570-i2c-atmega328p example - is compared
+ * against a single block transfer. A record which is updated field by
+ * field is written through directly and via the write-back shadow copy.
+ * Bus occupation is counted in bytes including the address bytes, the
+ * duration assumes 9 SCL cycles per byte at 100 kHz.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-pcf8570-block-io-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../../hal/common/CountingI2cMaster.h"
+#include "../../hal/common/SimulatedI2cMaster.h"
+
+#include "../memory/common/PCF8570BlockIo.h"
+#include "../memory/common/PCF8570Shadow.h"
+#include "../memory/common/SimulatedPCF8570.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t  const PCF8570_I2C_ADDR = (0x50 << 1);
+static uint8_t  const CHUNK_SIZE       = 4;
+static uint32_t const I2C_CLOCK_Hz     = 100000UL;
+static uint8_t  const RECORD_ADDR      = 0x40;
+static uint8_t  const RECORD_SIZE      = 32;
+static uint8_t  const NUM_FIELDS       = 3;
+static uint8_t  const NUM_UPDATES      = 8;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint8_t pattern(uint16_t const addr)
+{
+  return static_cast<uint8_t>((addr * 7) ^ 0xA5);
+}
+
+static void report(char const * name, hal::i2c::CountingI2cMaster const & i2c_master)
+{
+  printf("  %-38s %3u transactions | %4u bytes | %6.2f ms\n",
+         name,
+         static_cast<unsigned int>(i2c_master.numTransactions()),
+         static_cast<unsigned int>(i2c_master.numBytes()),
+         i2c_master.numBytes() * 9 * 1000.0 / I2C_CLOCK_Hz);
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  hal::i2c::SimulatedI2cMaster sim_i2c;
+  hal::i2c::CountingI2cMaster  i2c_master(sim_i2c);
+  memory::SimulatedPCF8570     pcf8570_sim(PCF8570_I2C_ADDR);
+
+  sim_i2c.attach(pcf8570_sim);
+
+  memory::PCF8570BlockIo pcf8570_io(PCF8570_I2C_ADDR, i2c_master);
+
+  uint8_t buf[memory::PCF8570_SIZE];
+  for(uint16_t addr = 0; addr < memory::PCF8570_SIZE; addr++) buf[addr] = pattern(addr);
+
+  printf("PCF8570 @ %u kHz I2C clock:\n", static_cast<unsigned int>(I2C_CLOCK_Hz / 1000UL));
+
+  /* 256 bytes: 64 x 4 byte chunks vs. one block ************************************/
+  {
+    bool success = true;
+
+    i2c_master.reset();
+    for(uint16_t addr = 0; addr < memory::PCF8570_SIZE; addr += CHUNK_SIZE) {
+      success &= pcf8570_io.write(static_cast<uint8_t>(addr), buf + addr, CHUNK_SIZE);
+    }
+    report("write 256 B in 4 B chunks", i2c_master);
+    check("chunked write", success && (memcmp(&pcf8570_sim.mem(0), buf, memory::PCF8570_SIZE) == 0));
+
+    memset(&pcf8570_sim.mem(0), 0, memory::PCF8570_SIZE);
+
+    i2c_master.reset();
+    success = pcf8570_io.write(0, buf, memory::PCF8570_SIZE);
+    report("write 256 B as one block", i2c_master);
+    check("block write", success && (memcmp(&pcf8570_sim.mem(0), buf, memory::PCF8570_SIZE) == 0));
+    check("block write is one transaction", i2c_master.numTransactions() == 1);
+
+    uint8_t readback[memory::PCF8570_SIZE];
+
+    memset(readback, 0, sizeof(readback));
+    success = true;
+    i2c_master.reset();
+    for(uint16_t addr = 0; addr < memory::PCF8570_SIZE; addr += CHUNK_SIZE) {
+      success &= pcf8570_io.read(static_cast<uint8_t>(addr), readback + addr, CHUNK_SIZE);
+    }
+    report("read 256 B in 4 B chunks", i2c_master);
+    check("chunked read", success && (memcmp(readback, buf, sizeof(readback)) == 0));
+
+    memset(readback, 0, sizeof(readback));
+    i2c_master.reset();
+    success = pcf8570_io.read(0, readback, memory::PCF8570_SIZE);
+    report("read 256 B as one block", i2c_master);
+    check("block read", success && (memcmp(readback, buf, sizeof(readback)) == 0));
+
+    check("range beyond end of RAM rejected", !pcf8570_io.write(0xF0, buf, 32) && !pcf8570_io.read(0x01, readback, memory::PCF8570_SIZE));
+    check("write up to end of RAM",           pcf8570_io.write(0xF0, buf, 16) && (memcmp(&pcf8570_sim.mem(0xF0), buf, 16) == 0));
+
+    sim_i2c.nackNextWrite();
+    check("NACK on word address releases the bus", !pcf8570_io.read(0x00, readback, 16) && sim_i2c.isIdle());
+    check("read after NACK", pcf8570_io.read(0x00, readback, 16) && (memcmp(readback, buf, 16) == 0));
+  }
+
+  /* Record updated field by field: write-through vs. shadow ************************/
+  {
+    /* Each update changes one of the first NUM_FIELDS 2 byte fields of the record */
+    uint8_t record[RECORD_SIZE];
+    memset(record, 0, sizeof(record));
+    memset(&pcf8570_sim.mem(RECORD_ADDR), 0, RECORD_SIZE);
+
+    i2c_master.reset();
+    for(uint8_t u = 0; u < NUM_UPDATES; u++)
+    {
+      uint8_t const field = u % NUM_FIELDS;
+      record[2 * field]     = u + 1;
+      record[2 * field + 1] = 0x80 | u;
+      pcf8570_io.write(RECORD_ADDR + 2 * field, record + 2 * field, 2);
+    }
+    report("8 updates of 3 fields, write-through", i2c_master);
+    check("write-through record", memcmp(&pcf8570_sim.mem(RECORD_ADDR), record, RECORD_SIZE) == 0);
+
+    memset(record, 0, sizeof(record));
+    memset(&pcf8570_sim.mem(RECORD_ADDR), 0, RECORD_SIZE);
+
+    memory::PCF8570Shadow shadow(pcf8570_io);
+    check("shadow load", shadow.load());
+
+    i2c_master.reset();
+    for(uint8_t u = 0; u < NUM_UPDATES; u++)
+    {
+      uint8_t const field = u % NUM_FIELDS;
+      record[2 * field]     = u + 1;
+      record[2 * field + 1] = 0x80 | u;
+      shadow.write(RECORD_ADDR + 2 * field, record + 2 * field, 2);
+    }
+    check("shadow defers writes", shadow.isDirty() && (i2c_master.numTransactions() == 0));
+    check("shadow flush", shadow.flush() && !shadow.isDirty());
+    report("8 updates of 3 fields, shadow + flush", i2c_master);
+    check("shadow flush is one transaction", i2c_master.numTransactions() == 1);
+    check("shadow record", memcmp(&pcf8570_sim.mem(RECORD_ADDR), record, RECORD_SIZE) == 0);
+
+    uint8_t readback[RECORD_SIZE];
+    check("shadow read", shadow.read(RECORD_ADDR, readback, RECORD_SIZE) && (memcmp(readback, record, RECORD_SIZE) == 0));
+
+    /* Writing unchanged data does not dirty the shadow */
+    i2c_master.reset();
+    shadow.write(RECORD_ADDR, record, RECORD_SIZE);
+    check("unchanged write stays clean", !shadow.isDirty() && shadow.flush() && (i2c_master.numTransactions() == 0));
+
+    check("shadow range beyond end of RAM rejected", !shadow.write(0xFF, record, 2) && !shadow.read(0xFF, readback, 2));
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,288 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Host test of the SFDP based serial NOR flash driver.
+ *
+ * The simulated N25Q256A is presented with different SFDP tables: its own
+ * (JESD216 rev 1.0, no 4-byte address instruction table), a rev B table
+ * with 4-byte address instruction table and a rev 1.0 table of a 16 MB
+ * device. For each of them the discovered geometry and the selected
+ * commands are checked and data is programmed, read back and erased.
+ * Finally erasing 1 MB with the smallest erase type is compared against
+ * eraseRange() which picks the largest erase type fitting at each position.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/driver-sfdp-nor-flash-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../memory/common/SpiNorIo.h"
+#include "../memory/common/SfdpNorFlash.h"
+#include "../memory/common/SimulatedN25Q256A.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const SPI_CLOCK_Hz      = 8000000UL;
+static uint32_t const SIZE_16_MB        = 16UL * 1024UL * 1024UL;
+static uint32_t const SFDP_BFPT_PTR     = 0x18;
+static uint32_t const SFDP_TABLE_SIZE   = 0x80;
+static uint32_t const TEST_SIZE         = 600; /* Spans 3 pages */
+static uint32_t const ERASE_RANGE_SIZE  = 1024UL * 1024UL;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+static uint8_t buf[TEST_SIZE];
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint8_t pattern(uint32_t const addr)
+{
+  return static_cast<uint8_t>(addr ^ (addr >> 8) ^ (addr >> 16) ^ (addr >> 24));
+}
+
+static void putDword(uint8_t * sfdp, uint32_t const addr, uint32_t const dword)
+{
+  for(uint8_t b = 0; b < 4; b++) {
+    sfdp[addr + b] = static_cast<uint8_t>(dword >> (8 * b));
+  }
+}
+
+/* SFDP of a device with the N25Q256A command set: 4 kB (20h) and 64 kB (D8h)
+ * erase, 256 byte pages. Rev B tables have 16 DWORDs and announce that
+ * ENTER 4-BYTE ADDRESS MODE requires WRITE ENABLE.
+ */
+static void buildSfdp(uint8_t * sfdp, uint32_t const flash_size, bool const is_rev_b, bool const has_4_byte_addr_instr_table)
+{
+  uint8_t  const num_bfpt_dwords = is_rev_b ? 16 : 9;
+  uint32_t const four_bait_ptr   = SFDP_BFPT_PTR + 4 * num_bfpt_dwords;
+
+  memset(sfdp, 0xFF, SFDP_TABLE_SIZE);
+
+  /* SFDP header */
+  memcpy(sfdp, "SFDP", 4);
+  sfdp[4] = is_rev_b ? 0x06 : 0x00;
+  sfdp[5] = 0x01;
+  sfdp[6] = has_4_byte_addr_instr_table ? 1 : 0;
+
+  /* Parameter header 0: basic flash parameter table */
+  uint8_t const bfpt_header[] = {0x00, static_cast<uint8_t>(is_rev_b ? 0x06 : 0x00), 0x01, num_bfpt_dwords, SFDP_BFPT_PTR, 0x00, 0x00, 0xFF};
+  memcpy(sfdp + 0x08, bfpt_header, sizeof(bfpt_header));
+
+  /* Parameter header 1: 4-byte address instruction table */
+  if(has_4_byte_addr_instr_table) {
+    uint8_t const four_bait_header[] = {0x84, 0x00, 0x01, 0x02, static_cast<uint8_t>(four_bait_ptr), 0x00, 0x00, 0xFF};
+    memcpy(sfdp + 0x10, four_bait_header, sizeof(four_bait_header));
+  }
+
+  uint32_t const addr_bytes = (flash_size > SIZE_16_MB) ? (1UL<<17) : 0;
+
+  putDword(sfdp, SFDP_BFPT_PTR +  0, 0xFFF120E5 | addr_bytes);
+  putDword(sfdp, SFDP_BFPT_PTR +  4, flash_size * 8 - 1);
+  putDword(sfdp, SFDP_BFPT_PTR +  8, 0x6B08EB29);
+  putDword(sfdp, SFDP_BFPT_PTR + 12, 0xBB273B08);
+  putDword(sfdp, SFDP_BFPT_PTR + 16, 0xFFFFFFFF);
+  putDword(sfdp, SFDP_BFPT_PTR + 20, 0xBB08FFFF);
+  putDword(sfdp, SFDP_BFPT_PTR + 24, 0xEB0AFFFF);
+  putDword(sfdp, SFDP_BFPT_PTR + 28, 0xD810200C);
+  putDword(sfdp, SFDP_BFPT_PTR + 32, 0x00000000);
+
+  if(is_rev_b) {
+    for(uint8_t d = 9; d < 16; d++) putDword(sfdp, SFDP_BFPT_PTR + 4 * d, 0x00000000);
+    putDword(sfdp, SFDP_BFPT_PTR + 40, 0x00000080); /* DWORD11: 256 byte pages    */
+    putDword(sfdp, SFDP_BFPT_PTR + 60, 0x02000000); /* DWORD16: 06h + B7h         */
+  }
+
+  if(has_4_byte_addr_instr_table) {
+    putDword(sfdp, four_bait_ptr + 0, 0x00000642);  /* 0Ch, 12h, erase type 1 + 2 */
+    putDword(sfdp, four_bait_ptr + 4, 0x0000DC21);
+  }
+}
+
+static bool isErased(memory::SimulatedN25Q256A & flash, uint32_t const addr, uint32_t const size)
+{
+  for(uint32_t i = 0; i < size; i++) {
+    if(flash.data()[addr + i] != 0xFF) return false;
+  }
+  return true;
+}
+
+/* Programs TEST_SIZE bytes across page boundaries at addr, reads them back and erases the block */
+static void testDataPath(char const * name, memory::SimulatedN25Q256A & flash, memory::SfdpNorFlash & nor, uint32_t const addr)
+{
+  char label[128];
+
+  uint32_t const block = addr / nor.eraseSize();
+  uint32_t const off   = addr % nor.eraseSize();
+
+  for(uint32_t i = 0; i < TEST_SIZE; i++) buf[i] = pattern(addr + i);
+
+  snprintf(label, sizeof(label), "%s: prog", name);
+  check(label, nor.prog(block, off, buf, TEST_SIZE) && (memcmp(flash.data() + addr, buf, TEST_SIZE) == 0));
+
+  memset(buf, 0, TEST_SIZE);
+  snprintf(label, sizeof(label), "%s: read", name);
+  check(label, nor.read(block, off, buf, TEST_SIZE) && (memcmp(flash.data() + addr, buf, TEST_SIZE) == 0));
+
+  snprintf(label, sizeof(label), "%s: erase", name);
+  check(label, nor.erase(block) && isErased(flash, block * nor.eraseSize(), nor.eraseSize()));
+
+  snprintf(label, sizeof(label), "%s: read beyond end of flash rejected", name);
+  check(label, !nor.read(nor.blockCount() - 1, nor.eraseSize() - 16, buf, 32));
+}
+
+static void report(char const * name, memory::SimulatedN25Q256A const & flash, uint64_t const start_ns, uint32_t const num_erase_commands)
+{
+  printf("  %-26s %4u erase commands | %6.2f s\n",
+         name,
+         static_cast<unsigned int>(num_erase_commands),
+         static_cast<double>(flash.now_ns() - start_ns) / 1.0E9);
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  /* N25Q256A: rev 1.0, 32 MB, no 4-byte address instruction table */
+  {
+    memory::SimulatedN25Q256A flash(SPI_CLOCK_Hz, memory::N25Q256A_FLASH_SIZE);
+    memory::SpiNorIo          io   (flash, flash);
+    memory::SfdpNorFlash      nor  (io, flash);
+
+    check("N25Q256A: open", nor.open());
+
+    memory::SfdpNorFlashInfo const & info = nor.info();
+    check("N25Q256A: SFDP rev 1.0",            (info.sfdp_major_rev == 1) && (info.sfdp_minor_rev == 0));
+    check("N25Q256A: 32 MB",                   info.flash_size == memory::N25Q256A_FLASH_SIZE);
+    check("N25Q256A: 256 byte pages",          info.page_size == 256);
+    check("N25Q256A: erase types 4 kB + 64 kB", (info.num_erase_types == 2) &&
+                                               (info.erase_type[0].size ==  4096) && (info.erase_type[0].instr == memory::SPI_NOR_CMD_SUBSECTOR_ERASE) &&
+                                               (info.erase_type[1].size == 65536) && (info.erase_type[1].instr == memory::SPI_NOR_CMD_SECTOR_ERASE));
+    check("N25Q256A: multi I/O read modes",    info.read_modes == (memory::SFDP_READ_1_1_2_bm | memory::SFDP_READ_1_2_2_bm | memory::SFDP_READ_1_4_4_bm | memory::SFDP_READ_1_1_4_bm));
+    check("N25Q256A: 4-byte address mode",     (info.addr_bytes == 4) && info.is_4_byte_addr_mode && flash.is4ByteAddrMode());
+    check("N25Q256A: FAST READ, PAGE PROGRAM", (info.read_instr == memory::SPI_NOR_CMD_FAST_READ) && (info.prog_instr == memory::SPI_NOR_CMD_PAGE_PROGRAM));
+    check("N25Q256A: NorFlash geometry",       (nor.eraseSize() == 4096) && (nor.blockCount() == 8192));
+
+    testDataPath("N25Q256A", flash, nor, 24UL * 1024UL * 1024UL + 200);
+  }
+
+  /* Rev B, 32 MB, with 4-byte address instruction table */
+  {
+    static uint8_t sfdp[SFDP_TABLE_SIZE];
+    buildSfdp(sfdp, memory::N25Q256A_FLASH_SIZE, true, true);
+
+    memory::SimulatedN25Q256A flash(SPI_CLOCK_Hz, memory::N25Q256A_FLASH_SIZE);
+    memory::SpiNorIo          io   (flash, flash);
+    memory::SfdpNorFlash      nor  (io, flash);
+    flash.setSfdp(sfdp, sizeof(sfdp));
+
+    check("rev B: open", nor.open());
+
+    memory::SfdpNorFlashInfo const & info = nor.info();
+    check("rev B: SFDP rev 1.6",                    (info.sfdp_major_rev == 1) && (info.sfdp_minor_rev == 6));
+    check("rev B: 4-byte instructions",             (info.addr_bytes == 4) && !info.is_4_byte_addr_mode && !flash.is4ByteAddrMode());
+    check("rev B: 4-BYTE FAST READ, PAGE PROGRAM",  (info.read_instr == memory::SPI_NOR_CMD_4_BYTE_FAST_READ) && (info.prog_instr == memory::SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM));
+    check("rev B: 4-BYTE erase instructions",       (info.erase_type[0].instr == memory::SPI_NOR_CMD_4_BYTE_SUBSECTOR_ERASE) && (info.erase_type[1].instr == memory::SPI_NOR_CMD_4_BYTE_SECTOR_ERASE));
+
+    testDataPath("rev B", flash, nor, memory::N25Q256A_FLASH_SIZE - 4096 + 100);
+
+    /* Erase 1 MB with the smallest erase type vs. eraseRange() */
+    printf("Erase of %u kB @ %u MHz SPI clock:\n", static_cast<unsigned int>(ERASE_RANGE_SIZE / 1024UL), static_cast<unsigned int>(SPI_CLOCK_Hz / 1000000UL));
+
+    memset(flash.data(), 0x00, 2 * ERASE_RANGE_SIZE);
+
+    uint32_t num_erase_commands = nor.numEraseCommands();
+    uint64_t start_ns           = flash.now_ns();
+    for(uint32_t block = 0; block < (ERASE_RANGE_SIZE / nor.eraseSize()); block++) {
+      nor.erase(block);
+    }
+    report("erase() per 4 kB block", flash, start_ns, nor.numEraseCommands() - num_erase_commands);
+    check("erase() per block: range erased", isErased(flash, 0, ERASE_RANGE_SIZE));
+
+    /* Unaligned to 64 kB at both ends */
+    uint32_t const range_addr = ERASE_RANGE_SIZE + 3 * 4096;
+
+    num_erase_commands = nor.numEraseCommands();
+    start_ns           = flash.now_ns();
+    check("eraseRange()", nor.eraseRange(range_addr, ERASE_RANGE_SIZE - 4 * 4096));
+    uint32_t const num_range_erase_commands = nor.numEraseCommands() - num_erase_commands;
+    report("eraseRange()", flash, start_ns, num_range_erase_commands);
+
+    check("eraseRange(): range erased",           isErased(flash, range_addr, ERASE_RANGE_SIZE - 4 * 4096));
+    check("eraseRange(): neighbours untouched",   (flash.data()[range_addr - 1] == 0x00) && (flash.data()[range_addr + ERASE_RANGE_SIZE - 4 * 4096] == 0x00));
+    check("eraseRange(): 4 kB at the ends only",  num_range_erase_commands == (13 + 14 + 15));
+    check("eraseRange(): unaligned rejected",     !nor.eraseRange(100, 4096));
+  }
+
+  /* Rev 1.0, 16 MB */
+  {
+    static uint8_t sfdp[SFDP_TABLE_SIZE];
+    buildSfdp(sfdp, SIZE_16_MB, false, false);
+
+    memory::SimulatedN25Q256A flash(SPI_CLOCK_Hz, SIZE_16_MB);
+    memory::SpiNorIo          io   (flash, flash);
+    memory::SfdpNorFlash      nor  (io, flash);
+    flash.setSfdp(sfdp, sizeof(sfdp));
+
+    check("16 MB: open", nor.open());
+
+    memory::SfdpNorFlashInfo const & info = nor.info();
+    check("16 MB: size",                 info.flash_size == SIZE_16_MB);
+    check("16 MB: 3-byte addressing",    (info.addr_bytes == 3) && !flash.is4ByteAddrMode());
+    check("16 MB: FAST READ",            info.read_instr == memory::SPI_NOR_CMD_FAST_READ);
+
+    testDataPath("16 MB", flash, nor, SIZE_16_MB - 8192 + 300);
+  }
+
+  /* No SFDP */
+  {
+    memory::SimulatedN25Q256A flash(SPI_CLOCK_Hz, SIZE_16_MB);
+    memory::SpiNorIo          io   (flash, flash);
+    memory::SfdpNorFlash      nor  (io, flash);
+    flash.setSfdp(nullptr, 0);
+
+    check("no SFDP: open fails",      !nor.open());
+    check("no SFDP: access rejected", !nor.read(0, 0, buf, 1) && (nor.blockCount() == 0));
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,170 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Two L3GD20 with the same I2C address are connected to channel 0 and 1 of
+ * a PCA9547, a LIS3MDL is connected to channel 0 as well. The devices are
+ * polled in the order of their channel path, hence the mux is only written
+ * twice per loop instead of before every single transaction. The statistics
+ * of the topology manager are printed once per loop.
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/I2cMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/I2cBusTopology.h"
+#include "../../../sensor/common/StSensorIoI2c.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * GLOBAL CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const UART_RX_BUFFER_SIZE = 0;
+static uint16_t const UART_TX_BUFFER_SIZE = 64;
+
+static uint8_t  const PCA9547_I2C_ADDR    = (0x70 << 1);
+static uint8_t  const L3GD20_I2C_ADDR     = (0x6B << 1);
+static uint8_t  const LIS3MDL_I2C_ADDR    = (0x1E << 1);
+
+static size_t   const NUM_SENSORS         = 3;
+static uint32_t const LOOP_DELAY_ms       = 1000; /* 1 s */
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl    (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  blox::ATMEGA328P::I2cMaster     i2c_master  (&TWCR,
+                                               &TWDR,
+                                               &TWSR,
+                                               &TWBR,
+                                               int_ctrl,
+                                               hal::interface::I2cClock::F_100_kHz);
+
+  blox::ATMEGA328P::UART0         uart0       (&UDR0,
+                                               &UCSR0A,
+                                               &UCSR0B,
+                                               &UCSR0C,
+                                               &UBRR0,
+                                               int_ctrl,
+                                               F_CPU);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart   serial(crit_sec,
+                            uart0(),
+                            UART_RX_BUFFER_SIZE,
+                            UART_TX_BUFFER_SIZE,
+                            serial::interface::SerialBaudRate::B115200,
+                            serial::interface::SerialParity::None,
+                            serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output,trace::Level::Debug);
+
+  /* I2C TOPOLOGY *********************************************************************/
+  ioexpander::Pca9547Mux     pca9547 (PCA9547_I2C_ADDR);
+  ioexpander::I2cBusTopology topology(i2c_master());
+
+  topology.attach(pca9547);
+
+  ioexpander::I2cMuxedDevice l3gd20_ch0_dev (topology, &pca9547, 0);
+  ioexpander::I2cMuxedDevice l3gd20_ch1_dev (topology, &pca9547, 1);
+  ioexpander::I2cMuxedDevice lis3mdl_ch0_dev(topology, &pca9547, 0);
+
+  /* SENSORS **************************************************************************/
+  sensor::StSensorIoI2c      l3gd20_ch0_io (L3GD20_I2C_ADDR,  sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, l3gd20_ch0_dev );
+  sensor::StSensorIoI2c      l3gd20_ch1_io (L3GD20_I2C_ADDR,  sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, l3gd20_ch1_dev );
+  sensor::StSensorIoI2c      lis3mdl_ch0_io(LIS3MDL_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, lis3mdl_ch0_dev);
+
+  /* L3GD20 CTRL_REG1: PD = Zen = Yen = Xen = 1, LIS3MDL CTRL_REG3: continuous conversion */
+  l3gd20_ch0_io.writeRegister (0x20, 0x0F);
+  l3gd20_ch1_io.writeRegister (0x20, 0x0F);
+  lis3mdl_ch0_io.writeRegister(0x22, 0x00);
+
+  /* The sensors are listed in the order of their channel path so that all
+   * transactions of a channel are batched, device lists which are built at
+   * runtime can be sorted via I2cBusTopology::orderByChannel.
+   */
+  sensor::StSensorIoI2c * sensor_io[NUM_SENSORS] = {&l3gd20_ch0_io, &lis3mdl_ch0_io, &l3gd20_ch1_io};
+  char const            * name     [NUM_SENSORS] = {"L3GD20  CH0",  "LIS3MDL CH0",   "L3GD20  CH1" };
+
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  for(;;)
+  {
+    for(size_t d = 0; d < NUM_SENSORS; d++)
+    {
+      int16_t xyz[3] = {0};
+      if(!sensor_io[d]->readXYZ(xyz)) {
+        trace.println(trace::Level::Error, "[ERR] %s read XYZ", name[d]);
+      } else {
+        trace.println(trace::Level::Info, "%s X = %6d, Y = %6d, Z = %6d", name[d], xyz[0], xyz[1], xyz[2]);
+      }
+    }
+
+    trace.println(trace::Level::Debug, "PCA9547 channel switches = %lu, avoided = %lu", topology.numChannelSwitches(), topology.numSwitchesAvoided());
+
+    delay.delay_ms(LOOP_DELAY_ms);
+  }
+
+  return 0;
+}
@@ -0,0 +1,277 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "I2cBusTopology.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::ioexpander
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+Pca9547Mux::Pca9547Mux(uint8_t const i2c_address)
+: _i2c_address   (i2c_address    ),
+  _parent        (nullptr        ),
+  _parent_channel(0              ),
+  _active_channel(UNKNOWN_CHANNEL)
+{
+
+}
+
+Pca9547Mux::Pca9547Mux(uint8_t const i2c_address, Pca9547Mux & parent, uint8_t const parent_channel)
+: _i2c_address   (i2c_address    ),
+  _parent        (&parent        ),
+  _parent_channel(parent_channel ),
+  _active_channel(UNKNOWN_CHANNEL)
+{
+
+}
+
+Pca9547Mux::~Pca9547Mux()
+{
+
+}
+
+I2cBusTopology::I2cBusTopology(hal::interface::I2cMaster & i2c_master)
+: _i2c_master          (i2c_master),
+  _num_muxes           (0         ),
+  _num_channel_switches(0         ),
+  _num_switches_avoided(0         )
+{
+
+}
+
+I2cBusTopology::~I2cBusTopology()
+{
+
+}
+
+I2cMuxedDevice::I2cMuxedDevice(I2cBusTopology & topology)
+: I2cMuxedDevice(topology, nullptr, 0)
+{
+
+}
+
+I2cMuxedDevice::I2cMuxedDevice(I2cBusTopology & topology, Pca9547Mux * mux, uint8_t const channel)
+: _topology             (topology),
+  _mux                  (mux     ),
+  _channel              (channel ),
+  _is_transaction_active(false   )
+{
+
+}
+
+I2cMuxedDevice::~I2cMuxedDevice()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool I2cBusTopology::attach(Pca9547Mux & mux)
+{
+  if(_num_muxes == MAX_NUM_MUXES) return false;
+  _mux[_num_muxes++] = &mux;
+  return true;
+}
+
+bool I2cBusTopology::select(Pca9547Mux * mux, uint8_t const channel)
+{
+  if(!mux) return true;
+
+  if(!select(mux->parent(), mux->parentChannel())) return false;
+
+  /* Two muxes on the same upstream channel with enabled channels
+   * would merge their downstream channels into one bus segment.
+   */
+  for(uint8_t m = 0; m < _num_muxes; m++)
+  {
+    Pca9547Mux & sibling = *_mux[m];
+
+    bool const is_sibling = (&sibling != mux) && (sibling.parent() == mux->parent()) && (sibling.parentChannel() == mux->parentChannel());
+    if(is_sibling && (sibling.activeChannel() != Pca9547Mux::NO_CHANNEL)) {
+      if(!writeChannel(sibling, Pca9547Mux::NO_CHANNEL)) return false;
+    }
+  }
+
+  if(mux->activeChannel() == channel) {
+    _num_switches_avoided++;
+    return true;
+  }
+
+  return writeChannel(*mux, channel);
+}
+
+bool I2cBusTopology::deselectAll()
+{
+  /* Muxes downstream of a disconnected channel are no longer reachable,
+   * hence the muxes are disconnected starting with the deepest ones.
+   */
+  bool success = true;
+  for(uint8_t depth = MAX_NUM_MUXES; depth > 0; depth--)
+  {
+    for(uint8_t m = 0; m < _num_muxes; m++)
+    {
+      Pca9547Mux & mux = *_mux[m];
+      if((depthOf(mux) != (depth - 1)) || (mux.activeChannel() == Pca9547Mux::NO_CHANNEL)) continue;
+      success &= select(mux.parent(), mux.parentChannel()) && writeChannel(mux, Pca9547Mux::NO_CHANNEL);
+    }
+  }
+  return success;
+}
+
+void I2cBusTopology::orderByChannel(I2cMuxedDevice * device[], size_t const num_devices) const
+{
+  for(size_t i = 1; i < num_devices; i++)
+  {
+    I2cMuxedDevice * d = device[i];
+    size_t j = i;
+    for(; (j > 0) && (comparePath(*device[j - 1], *d) > 0); j--) {
+      device[j] = device[j - 1];
+    }
+    device[j] = d;
+  }
+}
+
+void I2cBusTopology::resetStatistics()
+{
+  _num_channel_switches = 0;
+  _num_switches_avoided = 0;
+}
+
+void I2cMuxedDevice::setI2cClock(hal::interface::I2cClock const i2c_clock)
+{
+  _topology.i2cMaster().setI2cClock(i2c_clock);
+}
+
+bool I2cMuxedDevice::begin(uint8_t const address, bool const is_repeated_start)
+{
+  if(!is_repeated_start || !_is_transaction_active) {
+    _is_transaction_active = false;
+    if(!_topology.select(_mux, _channel)) return false;
+  }
+
+  _is_transaction_active = _topology.i2cMaster().begin(address, is_repeated_start);
+  return _is_transaction_active;
+}
+
+void I2cMuxedDevice::end()
+{
+  _topology.i2cMaster().end();
+  _is_transaction_active = false;
+}
+
+bool I2cMuxedDevice::write(uint8_t const data)
+{
+  return _topology.i2cMaster().write(data);
+}
+
+bool I2cMuxedDevice::requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes)
+{
+  /* A read following begin()/write() continues the transaction with a
+   * repeated START, the mux must not be written in between.
+   */
+  if(!_is_transaction_active) {
+    if(!_topology.select(_mux, _channel)) return false;
+  }
+
+  _is_transaction_active = false;
+  return _topology.i2cMaster().requestFrom(address, data, num_bytes);
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool I2cBusTopology::writeChannel(Pca9547Mux & mux, uint8_t const channel)
+{
+  uint8_t const control = (channel == Pca9547Mux::NO_CHANNEL) ? 0x00 : (PCA9547_CHANNEL_ENABLE_bm | (channel % PCA9547_NUM_CHANNELS));
+
+  bool const success = _i2c_master.begin(mux.address(), false) && _i2c_master.write(control);
+  _i2c_master.end();
+
+  mux.setActiveChannel(success ? channel : Pca9547Mux::UNKNOWN_CHANNEL);
+  if(success) _num_channel_switches++;
+
+  return success;
+}
+
+/* Stores the channel path from the MCU down to channel of mux, each
+ * level encoded as (index of mux << 8) | channel. Returns the depth.
+ */
+uint8_t I2cBusTopology::pathOf(Pca9547Mux * mux, uint8_t const channel, uint16_t * path) const
+{
+  uint8_t depth = 0;
+  for(uint8_t ch = channel; mux && (depth < MAX_NUM_MUXES); ch = mux->parentChannel(), mux = mux->parent()) {
+    path[depth++] = (static_cast<uint16_t>(indexOf(mux)) << 8) | ch;
+  }
+
+  for(uint8_t l = 0, r = depth; l + 1 < r; l++, r--) {
+    uint16_t const tmp = path[l]; path[l] = path[r - 1]; path[r - 1] = tmp;
+  }
+
+  return depth;
+}
+
+int I2cBusTopology::comparePath(I2cMuxedDevice const & lhs, I2cMuxedDevice const & rhs) const
+{
+  uint16_t lhs_path[MAX_NUM_MUXES], rhs_path[MAX_NUM_MUXES];
+
+  uint8_t const lhs_depth = pathOf(lhs.mux(), lhs.channel(), lhs_path);
+  uint8_t const rhs_depth = pathOf(rhs.mux(), rhs.channel(), rhs_path);
+
+  for(uint8_t l = 0; (l < lhs_depth) && (l < rhs_depth); l++) {
+    if(lhs_path[l] != rhs_path[l]) return (lhs_path[l] < rhs_path[l]) ? -1 : 1;
+  }
+
+  return static_cast<int>(lhs_depth) - static_cast<int>(rhs_depth);
+}
+
+uint8_t I2cBusTopology::depthOf(Pca9547Mux const & mux)
+{
+  uint8_t depth = 0;
+  for(Pca9547Mux const * m = mux.parent(); m && (depth < MAX_NUM_MUXES); m = m->parent()) {
+    depth++;
+  }
+  return depth;
+}
+
+uint8_t I2cBusTopology::indexOf(Pca9547Mux const * mux) const
+{
+  for(uint8_t m = 0; m < _num_muxes; m++) {
+    if(_mux[m] == mux) return m;
+  }
+  return MAX_NUM_MUXES;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::ioexpander */
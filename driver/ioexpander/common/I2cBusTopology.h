@@ -0,0 +1,196 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_IOEXPANDER_COMMON_I2CBUSTOPOLOGY_H_
+#define EXAMPLES_DRIVER_IOEXPANDER_COMMON_I2CBUSTOPOLOGY_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <snowfox/hal/interface/i2c/I2cMaster.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::ioexpander
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* PCA9547 control register: B3 enables the channel selected by B2..B0,
+ * writing 0x00 disconnects all downstream channels.
+ */
+static uint8_t constexpr PCA9547_NUM_CHANNELS      = 8;
+static uint8_t constexpr PCA9547_CHANNEL_ENABLE_bm = 0x08;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* A PCA9547 either sits on the I2C bus of the MCU or on a channel of
+ * another PCA9547. The channel last written to the mux is cached, it is
+ * unknown until the first channel switch.
+ */
+class Pca9547Mux
+{
+
+public:
+
+  static uint8_t constexpr NO_CHANNEL      = 0xFE;
+  static uint8_t constexpr UNKNOWN_CHANNEL = 0xFF;
+
+
+           Pca9547Mux(uint8_t const i2c_address);
+           Pca9547Mux(uint8_t const i2c_address, Pca9547Mux & parent, uint8_t const parent_channel);
+  virtual ~Pca9547Mux();
+
+
+  inline uint8_t      address      () const { return _i2c_address; }
+  inline Pca9547Mux * parent       () const { return _parent; }
+  inline uint8_t      parentChannel() const { return _parent_channel; }
+  inline uint8_t      activeChannel() const { return _active_channel; }
+
+  inline void         setActiveChannel(uint8_t const channel) { _active_channel = channel; }
+
+private:
+
+  uint8_t      _i2c_address;
+  Pca9547Mux * _parent;
+  uint8_t      _parent_channel,
+               _active_channel;
+
+};
+
+class I2cMuxedDevice;
+
+/* Keeps track of the channels selected on all PCA9547 muxes of an I2C
+ * bus. Drivers of devices behind a mux are constructed with a
+ * I2cMuxedDevice instead of the I2cMaster, i.e.
+ *
+ *   I2cMuxedDevice l3gd20_dev(topology, &mux, 3);
+ *   L3GD20_IoI2c   l3gd20_io_i2c(L3GD20_I2C_ADDR, l3gd20_dev);
+ *
+ * and the channel path of the device is selected at the beginning of
+ * each of its transactions - but a mux is only written if its cached
+ * channel differs. Muxes attached to the same upstream channel are
+ * disconnected before one of them is switched to a channel, therefore
+ * devices with the same address can live on different channels. A
+ * device on a channel must not share its address with a device upstream
+ * of its mux. All devices must be accessed from the same execution
+ * context.
+ */
+class I2cBusTopology
+{
+
+public:
+
+  static uint8_t constexpr MAX_NUM_MUXES = 8;
+
+
+           I2cBusTopology(hal::interface::I2cMaster & i2c_master);
+  virtual ~I2cBusTopology();
+
+
+  bool attach(Pca9547Mux & mux);
+
+  /* Selects the channel path up to and including channel of mux, a
+   * nullptr mux denotes the I2C bus of the MCU.
+   */
+  bool select(Pca9547Mux * mux, uint8_t const channel);
+
+  /* Disconnects all downstream channels, e.g. before handing the bus
+   * over to code which is not aware of the muxes.
+   */
+  bool deselectAll();
+
+  /* Sorts devices by their channel path (stable), polling them in this
+   * order batches all transactions of a channel.
+   */
+  void orderByChannel(I2cMuxedDevice * device[], size_t const num_devices) const;
+
+
+  inline hal::interface::I2cMaster & i2cMaster() { return _i2c_master; }
+
+  void     resetStatistics   ();
+  uint32_t numChannelSwitches() const { return _num_channel_switches; }
+  uint32_t numSwitchesAvoided() const { return _num_switches_avoided; }
+
+private:
+
+  hal::interface::I2cMaster & _i2c_master;
+  Pca9547Mux                * _mux[MAX_NUM_MUXES];
+  uint8_t                     _num_muxes;
+  uint32_t                    _num_channel_switches,
+                              _num_switches_avoided;
+
+  bool    writeChannel (Pca9547Mux & mux, uint8_t const channel);
+  uint8_t pathOf       (Pca9547Mux * mux, uint8_t const channel, uint16_t * path) const;
+  int     comparePath  (I2cMuxedDevice const & lhs, I2cMuxedDevice const & rhs) const;
+  uint8_t indexOf      (Pca9547Mux const * mux) const;
+
+  static uint8_t depthOf(Pca9547Mux const & mux);
+
+};
+
+/* I2cMaster of a single device within the topology, forwards all calls
+ * to the I2cMaster of the topology after selecting the channel path.
+ */
+class I2cMuxedDevice : public hal::interface::I2cMaster
+{
+
+public:
+
+           I2cMuxedDevice(I2cBusTopology & topology);
+           I2cMuxedDevice(I2cBusTopology & topology, Pca9547Mux * mux, uint8_t const channel);
+  virtual ~I2cMuxedDevice();
+
+
+  inline Pca9547Mux * mux    () const { return _mux; }
+  inline uint8_t      channel() const { return _channel; }
+
+
+  virtual void setI2cClock(hal::interface::I2cClock const i2c_clock) override;
+
+  virtual bool begin      (uint8_t const address, bool const is_repeated_start) override;
+  virtual void end        () override;
+  virtual bool write      (uint8_t const data) override;
+  virtual bool requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes) override;
+
+private:
+
+  I2cBusTopology & _topology;
+  Pca9547Mux     * _mux;
+  uint8_t          _channel;
+  bool             _is_transaction_active;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::ioexpander */
+
+#endif /* EXAMPLES_DRIVER_IOEXPANDER_COMMON_I2CBUSTOPOLOGY_H_ */
@@ -0,0 +1,117 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedPca9547.h"
+
+#include "I2cBusTopology.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::ioexpander
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedPca9547::SimulatedPca9547(uint8_t const i2c_address)
+: _i2c_address       (i2c_address),
+  _parent            (nullptr    ),
+  _parent_channel    (0          ),
+  _control           (0x00       ),
+  _num_control_writes(0          )
+{
+
+}
+
+SimulatedPca9547::SimulatedPca9547(uint8_t const i2c_address, SimulatedPca9547 & parent, uint8_t const parent_channel)
+: _i2c_address       (i2c_address   ),
+  _parent            (&parent       ),
+  _parent_channel    (parent_channel),
+  _control           (0x00          ),
+  _num_control_writes(0             )
+{
+
+}
+
+SimulatedPca9547::~SimulatedPca9547()
+{
+
+}
+
+SimulatedPca9547Channel::SimulatedPca9547Channel(SimulatedPca9547 & mux, uint8_t const channel, hal::i2c::interface::SimulatedI2cSlave & slave)
+: _mux    (mux    ),
+  _channel(channel),
+  _slave  (slave  )
+{
+
+}
+
+SimulatedPca9547Channel::~SimulatedPca9547Channel()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool SimulatedPca9547::isChannelConnected(uint8_t const channel) const
+{
+  bool const is_enabled = (_control & PCA9547_CHANNEL_ENABLE_bm) != 0;
+  return isConnected() && is_enabled && ((_control % PCA9547_NUM_CHANNELS) == channel);
+}
+
+bool SimulatedPca9547::isConnected() const
+{
+  return (_parent == nullptr) || _parent->isChannelConnected(_parent_channel);
+}
+
+void SimulatedPca9547::onStart(bool const /* is_read */)
+{
+
+}
+
+bool SimulatedPca9547::onWrite(uint8_t const data)
+{
+  _control = data & (PCA9547_CHANNEL_ENABLE_bm | (PCA9547_NUM_CHANNELS - 1));
+  _num_control_writes++;
+  return true;
+}
+
+uint8_t SimulatedPca9547::onRead()
+{
+  return _control;
+}
+
+void SimulatedPca9547::onStop()
+{
+
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::ioexpander */
@@ -0,0 +1,107 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_IOEXPANDER_COMMON_SIMULATEDPCA9547_H_
+#define EXAMPLES_DRIVER_IOEXPANDER_COMMON_SIMULATEDPCA9547_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "../../../hal/common/SimulatedI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::ioexpander
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* PCA9547 with its single control register, optionally connected to a
+ * channel of another PCA9547. Slaves behind a channel are attached to the
+ * SimulatedI2cMaster via a SimulatedPca9547Channel.
+ */
+class SimulatedPca9547 : public hal::i2c::interface::SimulatedI2cSlave
+{
+
+public:
+
+           SimulatedPca9547(uint8_t const i2c_address);
+           SimulatedPca9547(uint8_t const i2c_address, SimulatedPca9547 & parent, uint8_t const parent_channel);
+  virtual ~SimulatedPca9547();
+
+
+  bool     isChannelConnected(uint8_t const channel) const;
+  uint8_t  control           () const { return _control; }
+  uint32_t numControlWrites  () const { return _num_control_writes; }
+
+
+  virtual uint8_t address    () const override { return _i2c_address; }
+  virtual bool    isConnected() const override;
+
+  virtual void    onStart(bool const is_read) override;
+  virtual bool    onWrite(uint8_t const data) override;
+  virtual uint8_t onRead () override;
+  virtual void    onStop () override;
+
+private:
+
+  uint8_t            _i2c_address;
+  SimulatedPca9547 * _parent;
+  uint8_t            _parent_channel;
+  uint8_t            _control;
+  uint32_t           _num_control_writes;
+
+};
+
+class SimulatedPca9547Channel : public hal::i2c::interface::SimulatedI2cSlave
+{
+
+public:
+
+           SimulatedPca9547Channel(SimulatedPca9547 & mux, uint8_t const channel, hal::i2c::interface::SimulatedI2cSlave & slave);
+  virtual ~SimulatedPca9547Channel();
+
+
+  virtual uint8_t address    () const override { return _slave.address(); }
+  virtual bool    isConnected() const override { return _mux.isChannelConnected(_channel) && _slave.isConnected(); }
+
+  virtual void    onStart(bool const is_read) override { _slave.onStart(is_read); }
+  virtual bool    onWrite(uint8_t const data) override { return _slave.onWrite(data); }
+  virtual uint8_t onRead () override                   { return _slave.onRead(); }
+  virtual void    onStop () override                   { _slave.onStop(); }
+
+private:
+
+  SimulatedPca9547                       & _mux;
+  uint8_t                                  _channel;
+  hal::i2c::interface::SimulatedI2cSlave & _slave;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::ioexpander */
+
+#endif /* EXAMPLES_DRIVER_IOEXPANDER_COMMON_SIMULATEDPCA9547_H_ */
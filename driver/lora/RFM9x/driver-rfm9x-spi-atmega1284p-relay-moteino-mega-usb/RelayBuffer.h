@@ -0,0 +1,77 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_LORA_RFM9X_DRIVER_RFM9X_SPI_ATMEGA1284P_RELAY_MOTEINO_MEGA_USB_RELAYBUFFER_H_
+#define EXAMPLES_DRIVER_LORA_RFM9X_DRIVER_RFM9X_SPI_ATMEGA1284P_RELAY_MOTEINO_MEGA_USB_RELAYBUFFER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include "../../../serial/common/UartTransmitCompleteCallback.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::lora::RFM9x
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Holds a received LoRa message while it is transmitted via UART, the
+ * buffer is released again by the UART transmit complete interrupt.
+ */
+class RelayBuffer : public serial::interface::UartTransmitCompleteCallback
+{
+
+public:
+
+  static uint16_t constexpr SIZE = 64;
+
+
+           RelayBuffer();
+  virtual ~RelayBuffer();
+
+
+  inline uint8_t * data  ()       { return _data;       }
+  inline bool      isFree() const { return !_in_flight; }
+
+  void markInFlight();
+
+
+  virtual void onTransmitComplete() override;
+
+private:
+
+  uint8_t          _data[SIZE];
+  bool    volatile _in_flight;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::lora::RFM9x */
+
+#endif /* EXAMPLES_DRIVER_LORA_RFM9X_DRIVER_RFM9X_SPI_ATMEGA1284P_RELAY_MOTEINO_MEGA_USB_RELAYBUFFER_H_ */
@@ -0,0 +1,281 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and an AT45DB
+ * DataFlash (e.g. AT45DB161) breakout board.
+ *
+ * A data stream is written in 32 byte chunks to 16 consecutive pages twice:
+ * via driver::memory::AT45DBXPipelinedWriter, which fills one SRAM buffer
+ * while the content of the other one is programmed into the main memory,
+ * and via one SRAM buffer that is written, programmed and waited for one
+ * page after the other:
+ *
+ *   [AT45DBX] <num pages> pages x <page size> bytes
+ *   [ping-pong] <TIMER1 ticks> ticks, <n> busy waits
+ *   [serial]    <TIMER1 ticks> ticks
+ *
+ * The page geometry is taken from the status register. Afterwards both
+ * page ranges are read back via continuous array read and compared against
+ * the stream.
+ *
+ * ATTENTION: The AT45DB must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   AT45DB ~CS  = D10 = PB2
+ *   AT45DB SO   = D12 = PB4
+ *   AT45DB SI   = D11 = PB3
+ *   AT45DB SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-at45dbx-spi-atmega328p
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/SpiNorIo.h"
+#include "../../common/AT45DBXBufferIo.h"
+#include "../../common/AT45DBXPipelinedWriter.h"
+
+#include "../../../../trace/common/AvrTimer1TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE    = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE    = 64;
+
+static hal::interface::SpiMode     const AT45DBX_SPI_MODE       = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const AT45DBX_SPI_BIT_ORDER  = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const AT45DBX_SPI_PRESCALER  = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+
+static uint16_t                    const CHUNK_SIZE             = 32;
+static uint16_t                    const NUM_PAGES              = 16;
+static uint16_t                    const PING_PONG_FIRST_PAGE   = 0;
+static uint16_t                    const SERIAL_FIRST_PAGE      = PING_PONG_FIRST_PAGE + NUM_PAGES;
+
+/* Writing 16 pages takes less than one TIMER1 period (4.2 s) */
+static trace::AvrTimer1Prescaler   const TIMER1_PRESCALER       = trace::AvrTimer1Prescaler::P_1024; /* 16 MHz / 1024 = 15.625 kHz */
+
+/**************************************************************************************
+ * FUNCTION DECLARATION
+ **************************************************************************************/
+
+uint8_t pattern(uint32_t const pos);
+void    fill   (uint8_t * buf, uint32_t const pos, uint16_t const size);
+bool    verify (memory::AT45DBXBufferIo & at45dbx, uint16_t const first_page, uint32_t const size);
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       at45dbx_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       at45dbx_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        at45dbx_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       at45dbx_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  at45dbx_cs.set();
+  at45dbx_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             AT45DBX_SPI_MODE,
+                                             AT45DBX_SPI_BIT_ORDER,
+                                             AT45DBX_SPI_PRESCALER);
+
+  /* TIMER1 as timestamp source *******************************************************/
+  trace::AvrTimer1TimestampSource timestamp_source(&TCCR1A, &TCCR1B, &TCNT1, F_CPU, TIMER1_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* AT45DBX **************************************************************************/
+  memory::SpiNorIo               at45dbx_io    (spi_master(), at45dbx_cs);
+  memory::AT45DBXBufferIo        at45dbx_buf   (at45dbx_io, delay);
+  memory::AT45DBXPipelinedWriter at45dbx_writer(at45dbx_buf, true);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!at45dbx_buf.readGeometry()) {
+    trace.println(trace::Level::Error, "[ERR] AT45DBXBufferIo::readGeometry()");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  uint16_t const page_size   = at45dbx_buf.geometry().page_size;
+  uint32_t const stream_size = static_cast<uint32_t>(NUM_PAGES) * page_size;
+
+  trace.println(trace::Level::Info, "[AT45DBX] %u pages x %u bytes", at45dbx_buf.geometry().num_pages, page_size);
+
+  uint8_t buf[CHUNK_SIZE];
+
+  /* PING-PONG ************************************************************************/
+
+  at45dbx_writer.resetStatistics();
+
+  uint32_t start = timestamp_source.now();
+
+  at45dbx_writer.begin(PING_PONG_FIRST_PAGE);
+  for(uint32_t pos = 0; pos < stream_size; pos += CHUNK_SIZE)
+  {
+    uint16_t const len = ((stream_size - pos) < CHUNK_SIZE) ? static_cast<uint16_t>(stream_size - pos) : CHUNK_SIZE;
+    fill(buf, pos, len);
+    at45dbx_writer.write(buf, len);
+  }
+  at45dbx_writer.sync();
+
+  trace.println(trace::Level::Info,
+                "[ping-pong] %lu ticks, %lu busy waits",
+                timestamp_source.now() - start,
+                at45dbx_writer.numBusyWaits());
+
+  /* SERIAL ***************************************************************************/
+
+  start = timestamp_source.now();
+
+  for(uint16_t p = 0; p < NUM_PAGES; p++)
+  {
+    for(uint16_t offset = 0; offset < page_size; offset += CHUNK_SIZE)
+    {
+      uint16_t const len = ((page_size - offset) < CHUNK_SIZE) ? (page_size - offset) : CHUNK_SIZE;
+      fill(buf, static_cast<uint32_t>(p) * page_size + offset, len);
+      at45dbx_buf.writeBuffer(0, offset, buf, len);
+    }
+    at45dbx_buf.programBuffer(0, SERIAL_FIRST_PAGE + p, true);
+    at45dbx_buf.waitReady();
+  }
+
+  trace.println(trace::Level::Info, "[serial]    %lu ticks", timestamp_source.now() - start);
+
+  /* VERIFY ***************************************************************************/
+
+  bool const is_verify_ok = verify(at45dbx_buf, PING_PONG_FIRST_PAGE, stream_size) &&
+                            verify(at45dbx_buf, SERIAL_FIRST_PAGE,    stream_size);
+
+  trace.println(is_verify_ok ? trace::Level::Info : trace::Level::Error, is_verify_ok ? "[OK] VERIFY" : "[ERR] VERIFY");
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
+
+/**************************************************************************************
+ * FUNCTION IMPLEMENTATION
+ **************************************************************************************/
+
+uint8_t pattern(uint32_t const pos)
+{
+  return static_cast<uint8_t>((pos * 13) ^ (pos >> 8) ^ 0x5A);
+}
+
+void fill(uint8_t * buf, uint32_t const pos, uint16_t const size)
+{
+  for(uint16_t i = 0; i < size; i++) buf[i] = pattern(pos + i);
+}
+
+bool verify(memory::AT45DBXBufferIo & at45dbx, uint16_t const first_page, uint32_t const size)
+{
+  uint16_t const page_size = at45dbx.geometry().page_size;
+  uint8_t        buf[CHUNK_SIZE];
+
+  for(uint32_t pos = 0; pos < size; pos += CHUNK_SIZE)
+  {
+    uint16_t const len = ((size - pos) < CHUNK_SIZE) ? static_cast<uint16_t>(size - pos) : CHUNK_SIZE;
+
+    /* Continuous array read wraps into the next page */
+    at45dbx.read(first_page + pos / page_size, pos % page_size, buf, len);
+    for(uint16_t i = 0; i < len; i++) {
+      if(buf[i] != pattern(pos + i)) return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,229 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * A 256 byte page is read via the interrupt-driven hal::spi::AsyncSpiMaster
+ * while the main loop keeps counting, afterwards the same page is read via
+ * the blocking N25Q256A driver and both results are compared. The number of
+ * loop iterations during the asynchronous read shows how much CPU time is
+ * available for the application instead of being spent busy-waiting on SPIF.
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-n25q256a-spi-atmega328p-async
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <string.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Flash.h>
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../../../hal/common/AvrSpiPort.h"
+#include "../../../../hal/common/AsyncSpiMaster.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE    = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE    = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE      = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+
+static uint8_t                     const N25Q256A_CMD_READ_4_BYTE_ADDR = 0x13;
+static uint16_t                    const N25Q256A_PAGE_SIZE            = 256;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Flash               flash;
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* ASYNC SPI ************************************************************************/
+  spi::AvrSpiPort                 spi_port  (&SPDR);
+  spi::AsyncSpiMaster             spi_engine(spi_port, crit_sec);
+
+  int_ctrl.registerInterruptCallback(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::SPI_SERIAL_TRANSFER_COMPLETE), &spi_engine);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_cs);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!n25q256a.open()) {
+    trace.println(trace::Level::Error, "N25Q256A::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  /* ASYNC READ *********************************************************************/
+
+  /* READ 4-BYTE ADDRESS works independent of the current addressing mode, the
+   * command header is sent with CS kept asserted and the page is clocked in
+   * directly into the caller's buffer by the second transaction.
+   */
+  uint8_t const read_cmd[5] = {N25Q256A_CMD_READ_4_BYTE_ADDR, 0x00, 0x00, 0x00, 0x00};
+  uint8_t       async_buf   [N25Q256A_PAGE_SIZE];
+  uint8_t       blocking_buf[N25Q256A_PAGE_SIZE];
+
+  spi::SpiTransaction read_cmd_transaction  = {&n25q256a_cs, read_cmd, nullptr,   sizeof(read_cmd),   true,  nullptr};
+  spi::SpiTransaction read_data_transaction = {&n25q256a_cs, nullptr,  async_buf, N25Q256A_PAGE_SIZE, false, nullptr};
+
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::SPI_SERIAL_TRANSFER_COMPLETE));
+
+  uint32_t loop_cnt = 0;
+  spi_engine.submit(read_cmd_transaction);
+  spi_engine.submit(read_data_transaction);
+  while(!read_data_transaction.complete) {
+    loop_cnt++;
+  }
+
+  /* Blocking transfers must not take place while the SPI interrupt is enabled */
+  int_ctrl.disableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::SPI_SERIAL_TRANSFER_COMPLETE));
+
+  trace.println(trace::Level::Info, "[OK] ASYNC READ (%d bytes), %lu loop iterations during transfer", N25Q256A_PAGE_SIZE, loop_cnt);
+
+  /* BLOCKING READ ******************************************************************/
+  if(n25q256a.read(0, 0, blocking_buf, N25Q256A_PAGE_SIZE) != N25Q256A_PAGE_SIZE) {
+    trace.println(trace::Level::Error, "[ERR] BLOCKING READ");
+  } else if(memcmp(async_buf, blocking_buf, N25Q256A_PAGE_SIZE) != 0) {
+    trace.println(trace::Level::Error, "[ERR] ASYNC READ != BLOCKING READ");
+  } else {
+    trace.println(trace::Level::Info, "[OK] ASYNC READ == BLOCKING READ");
+  }
+
+  /************************************************************************************
+   * CLEANUP
+   ************************************************************************************/
+
+  n25q256a.close();
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
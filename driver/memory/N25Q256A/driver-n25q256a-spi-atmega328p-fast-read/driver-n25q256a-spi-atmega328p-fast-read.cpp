@@ -0,0 +1,269 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * The first 64 kB of the flash are scanned twice, first via the N25Q256A
+ * driver with 16 byte reads (as in driver-n25q256a-spi-atmega328p) at the
+ * 1 MHz SPI clock used by all other examples, then via
+ * driver::memory::N25Q256AFastPath (4-BYTE FAST READ, one command per
+ * 512 byte chunk) at 8 MHz, the fastest SPI clock of the ATMEGA328P:
+ *
+ *   [READ      16 B @ 1 MHz] 65536 bytes in <TIMER1 ticks> = <kB/s>
+ *   [FAST READ 512 B @ 8 MHz] 65536 bytes in <TIMER1 ticks> = <kB/s>
+ *
+ * Finally a chunk above 16 MB - not reachable with 3 byte addresses - is
+ * read to demonstrate access to the full 32 MB.
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-n25q256a-spi-atmega328p-fast-read
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/SpiNorIo.h"
+#include "../../common/N25Q256AFastPath.h"
+
+#include "../../../../trace/common/AvrTimer1TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE      = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE      = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE        = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER   = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER   = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+
+/* The SPI clock is switched to f_cpu / 2 = 8 MHz for the fast path (SPR1 = SPR0 = 0, SPI2X = 1) */
+static uint8_t                     const SPCR_SPR_bm              = (1<<SPR1) | (1<<SPR0);
+static uint8_t                     const SPSR_SPI2X_bm            = (1<<SPI2X);
+
+static uint32_t                    const SCAN_SIZE                = 64UL * 1024UL;
+static uint16_t                    const READ_CHUNK_SIZE          = 16;
+static uint16_t                    const FAST_READ_CHUNK_SIZE     = 512;
+
+/* Each timed chunk takes less than one TIMER1 period (262 ms) */
+static trace::AvrTimer1Prescaler   const TIMER1_PRESCALER         = trace::AvrTimer1Prescaler::P_64; /* 16 MHz / 64 = 250 kHz */
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* TIMER1 as timestamp source *******************************************************/
+  trace::AvrTimer1TimestampSource timestamp_source(&TCCR1A, &TCCR1B, &TCNT1, F_CPU, TIMER1_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_cs);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+  /* The 4-BYTE (FAST) READ commands do not depend on the addressing mode
+   * selected by the N25Q256A driver, both can be used side by side.
+   */
+  memory::SpiNorIo                         n25q256a_io     (spi_master(), n25q256a_cs);
+  memory::N25Q256AFastPath                 n25q256a_fast   (n25q256a_io, memory::N25Q256AReadMode::FastRead);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!n25q256a.open()) {
+    trace.println(trace::Level::Error, "N25Q256A::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  uint8_t buf[FAST_READ_CHUNK_SIZE];
+
+  /* READ, 16 B @ 1 MHz *************************************************************/
+  {
+    uint32_t num_ticks = 0;
+    bool     is_error  = false;
+
+    for(uint32_t offset = 0; offset < SCAN_SIZE; offset += READ_CHUNK_SIZE)
+    {
+      uint32_t const start = timestamp_source.now();
+      if(n25q256a.read(0, offset, buf, READ_CHUNK_SIZE) != READ_CHUNK_SIZE) {
+        is_error = true;
+      }
+      num_ticks += timestamp_source.now() - start;
+    }
+
+    trace.println(trace::Level::Info,
+                  "[READ      16 B @ 1 MHz] %lu bytes in %lu ticks = %lu kB/s%s",
+                  SCAN_SIZE,
+                  num_ticks,
+                  (SCAN_SIZE * (timestamp_source.tickFreqHz() / 1000UL)) / num_ticks,
+                  is_error ? " [ERR] READ" : "");
+  }
+
+  /* FAST READ, 512 B @ 8 MHz *******************************************************/
+  SPCR &= ~SPCR_SPR_bm;
+  SPSR |=  SPSR_SPI2X_bm;
+
+  {
+    uint32_t num_ticks = 0;
+    bool     is_error  = false;
+
+    for(uint32_t addr = 0; addr < SCAN_SIZE; addr += FAST_READ_CHUNK_SIZE)
+    {
+      uint32_t const start = timestamp_source.now();
+      if(n25q256a_fast.read(addr, buf, FAST_READ_CHUNK_SIZE) != FAST_READ_CHUNK_SIZE) {
+        is_error = true;
+      }
+      num_ticks += timestamp_source.now() - start;
+    }
+
+    trace.println(trace::Level::Info,
+                  "[FAST READ 512 B @ 8 MHz] %lu bytes in %lu ticks = %lu kB/s%s",
+                  SCAN_SIZE,
+                  num_ticks,
+                  (SCAN_SIZE * (timestamp_source.tickFreqHz() / 1000UL)) / num_ticks,
+                  is_error ? " [ERR] FAST READ" : "");
+  }
+
+  /* 4-BYTE ADDRESS *****************************************************************/
+  uint32_t const upper_addr = memory::N25Q256A_3_BYTE_ADDR_LIMIT + SCAN_SIZE;
+
+  if(n25q256a_fast.read(upper_addr, buf, FAST_READ_CHUNK_SIZE) != FAST_READ_CHUNK_SIZE) {
+    trace.println(trace::Level::Error, "[ERR] FAST READ @ %08lX", upper_addr);
+  } else {
+    trace.println(trace::Level::Info, "[OK] FAST READ @ %08lX = %02X %02X %02X %02X", upper_addr, buf[0], buf[1], buf[2], buf[3]);
+  }
+
+  /************************************************************************************
+   * CLEANUP
+   ************************************************************************************/
+
+  SPSR &= ~SPSR_SPI2X_bm;
+  SPCR |=  (1<<SPR0); /* Back to f_cpu / 16 */
+
+  n25q256a.close();
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
@@ -0,0 +1,244 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * The first erase blocks of the flash are used for a driver::memory::NorKvStore
+ * holding persistent configuration. On every start the boot counter stored
+ * under the key "sys/boot_cnt" is incremented, the device name is written
+ * once. Resetting the board shows the counter surviving power cycles:
+ *
+ *   N25Q256A prog block size: <prog_size>
+ *   [OK] NorKvStore mounted, 2 keys, 56 of <capacity> bytes used
+ *   [OK] sys/boot_cnt = 42
+ *
+ * NorKvStore supports a program granularity (NorFlashInfo::prog_size) of at
+ * most NorKvStore::MAX_PROG_SIZE bytes, the value reported by the N25Q256A
+ * driver is printed and checked before mounting. Records are appended at
+ * arbitrary offsets, NorFlashDriverAdapter splits them at the 256 byte
+ * program pages of the N25Q256A.
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-n25q256a-spi-atmega328p-kv-store
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/NorKvStore.h"
+#include "../../common/NorFlashDriverAdapter.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE      = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE      = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE        = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER   = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER   = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+static uint32_t                    const N25Q256A_PAGE_SIZE       = 256;      /* A page program wraps around at the end of a page */
+
+static uint32_t                    const KV_STORE_FIRST_BLOCK     = 0;
+static uint16_t                    const KV_STORE_NUM_BLOCKS      = 4;
+static uint16_t                    const KV_STORE_INDEX_CAPACITY  = 8;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_cs);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!n25q256a.open()) {
+    trace.println(trace::Level::Error, "N25Q256A::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  memory::NorFlashInfo n25q256a_flash_info;
+  if(!n25q256a.ioctl(memory::IOCTL_GET_FLASH_INFO, reinterpret_cast<void*>(&n25q256a_flash_info))) {
+    trace.println(trace::Level::Error, "N25Q256A::ioctl(IOCTL_GET_FLASH_INFO) failed");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  trace.println(trace::Level::Info, "N25Q256A prog block size: %d", n25q256a_flash_info.prog_size);
+
+  if(n25q256a_flash_info.prog_size > memory::NorKvStore::MAX_PROG_SIZE) {
+    trace.println(trace::Level::Error, "[ERR] prog block size exceeds NorKvStore::MAX_PROG_SIZE (%u)", memory::NorKvStore::MAX_PROG_SIZE);
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  /* KEY-VALUE STORE ****************************************************************/
+  memory::NorFlashDriverAdapter n25q256a_flash(n25q256a, n25q256a_flash_info, N25Q256A_PAGE_SIZE);
+  memory::NorKvIndexEntry       kv_index[KV_STORE_INDEX_CAPACITY];
+  memory::NorKvStore            kv(n25q256a_flash, KV_STORE_FIRST_BLOCK, KV_STORE_NUM_BLOCKS, kv_index, KV_STORE_INDEX_CAPACITY);
+
+  /* An unused region mounts as an empty store, mounting only fails if the
+   * flash geometry is not supported or the index is too small.
+   */
+  if(!kv.mount()) {
+    trace.println(trace::Level::Error, "[ERR] NorKvStore::mount()");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  trace.println(trace::Level::Info, "[OK] NorKvStore mounted, %u keys, %lu of %lu bytes used", kv.numKeys(), kv.liveBytes(), kv.capacity());
+
+  uint32_t boot_cnt = 0;
+  kv.get("sys/boot_cnt", &boot_cnt, sizeof(boot_cnt));
+  boot_cnt++;
+
+  if(!kv.put("sys/boot_cnt", &boot_cnt, sizeof(boot_cnt))) {
+    trace.println(trace::Level::Error, "[ERR] NorKvStore::put(\"sys/boot_cnt\")");
+  } else {
+    trace.println(trace::Level::Info, "[OK] sys/boot_cnt = %lu", boot_cnt);
+  }
+
+  char          device_name[16];
+  int32_t const device_name_size = kv.get("sys/name", device_name, sizeof(device_name) - 1);
+  if(device_name_size < 0) {
+    static char const DEFAULT_DEVICE_NAME[] = "snowfox-node";
+    kv.put("sys/name", DEFAULT_DEVICE_NAME, sizeof(DEFAULT_DEVICE_NAME) - 1);
+    trace.println(trace::Level::Info, "[OK] sys/name initialised");
+  } else {
+    int32_t const max_size = static_cast<int32_t>(sizeof(device_name) - 1);
+    device_name[(device_name_size < max_size) ? device_name_size : max_size] = '\0';
+    trace.println(trace::Level::Info, "[OK] sys/name = %s", device_name);
+  }
+
+  /************************************************************************************
+   * CLEANUP
+   ************************************************************************************/
+
+  n25q256a.close();
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
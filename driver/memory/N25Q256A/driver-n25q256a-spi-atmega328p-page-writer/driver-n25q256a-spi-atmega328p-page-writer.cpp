@@ -0,0 +1,294 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * The first erase block is erased, then 2 kB are programmed in 16 byte
+ * chunks twice: via N25Q256A::prog() (one PAGE PROGRAM per call, as in
+ * driver-n25q256a-spi-atmega328p) and via driver::memory::N25Q256APageWriter
+ * which combines the chunks into full pages and polls the status register
+ * with a back-off:
+ *
+ *   [prog()      16 B] 2048 bytes in <TIMER1 ticks> = <kB/s>
+ *   [page writer 16 B] 2048 bytes in <TIMER1 ticks> = <kB/s>, <n> page programs, <n> status polls
+ *
+ * Both regions are read back and compared against the written pattern.
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-n25q256a-spi-atmega328p-page-writer
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/SpiNorIo.h"
+#include "../../common/N25Q256APageWriter.h"
+
+#include "../../../../trace/common/AvrTimer1TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE      = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE      = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE        = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER   = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER   = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+
+static uint16_t                    const REGION_SIZE              = 2048;
+static uint16_t                    const CHUNK_SIZE               = 16;
+
+/* Each timed chunk takes less than one TIMER1 period (262 ms) */
+static trace::AvrTimer1Prescaler   const TIMER1_PRESCALER         = trace::AvrTimer1Prescaler::P_64; /* 16 MHz / 64 = 250 kHz */
+
+/**************************************************************************************
+ * FUNCTION DECLARATION
+ **************************************************************************************/
+
+uint8_t pattern(uint32_t const addr);
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* TIMER1 as timestamp source *******************************************************/
+  trace::AvrTimer1TimestampSource timestamp_source(&TCCR1A, &TCCR1B, &TCNT1, F_CPU, TIMER1_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_cs);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+  /* The page writer uses 4-BYTE PAGE PROGRAM which does not depend on the
+   * addressing mode selected by the N25Q256A driver.
+   */
+  memory::SpiNorIo                         n25q256a_io     (spi_master(), n25q256a_cs);
+  memory::N25Q256APageWriter               n25q256a_writer (n25q256a_io, delay);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!n25q256a.open()) {
+    trace.println(trace::Level::Error, "N25Q256A::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  if(!n25q256a.erase(0)) {
+    trace.println(trace::Level::Error, "[ERR] ERASE");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  uint8_t buf[CHUNK_SIZE];
+
+  /* N25Q256A::prog() ***************************************************************/
+  {
+    uint32_t num_ticks = 0;
+    bool     is_error  = false;
+
+    for(uint16_t offset = 0; offset < REGION_SIZE; offset += CHUNK_SIZE)
+    {
+      for(uint16_t i = 0; i < CHUNK_SIZE; i++) buf[i] = pattern(offset + i);
+
+      uint32_t const start = timestamp_source.now();
+      if(n25q256a.prog(0, offset, buf, CHUNK_SIZE) != CHUNK_SIZE) {
+        is_error = true;
+      }
+      num_ticks += timestamp_source.now() - start;
+    }
+
+    trace.println(trace::Level::Info,
+                  "[prog()      16 B] %u bytes in %lu ticks = %lu kB/s%s",
+                  REGION_SIZE,
+                  num_ticks,
+                  (static_cast<uint32_t>(REGION_SIZE) * (timestamp_source.tickFreqHz() / 1000UL)) / num_ticks,
+                  is_error ? " [ERR] PROG" : "");
+  }
+
+  /* N25Q256APageWriter *************************************************************/
+  {
+    uint32_t num_ticks = 0;
+    bool     is_error  = false;
+
+    for(uint16_t offset = REGION_SIZE; offset < (2 * REGION_SIZE); offset += CHUNK_SIZE)
+    {
+      for(uint16_t i = 0; i < CHUNK_SIZE; i++) buf[i] = pattern(offset + i);
+
+      uint32_t const start = timestamp_source.now();
+      if(n25q256a_writer.prog(offset, buf, CHUNK_SIZE) != CHUNK_SIZE) {
+        is_error = true;
+      }
+      num_ticks += timestamp_source.now() - start;
+    }
+
+    uint32_t const start = timestamp_source.now();
+    if(!n25q256a_writer.sync()) {
+      is_error = true;
+    }
+    num_ticks += timestamp_source.now() - start;
+
+    trace.println(trace::Level::Info,
+                  "[page writer 16 B] %u bytes in %lu ticks = %lu kB/s, %lu page programs, %lu status polls%s",
+                  REGION_SIZE,
+                  num_ticks,
+                  (static_cast<uint32_t>(REGION_SIZE) * (timestamp_source.tickFreqHz() / 1000UL)) / num_ticks,
+                  n25q256a_writer.numPagePrograms(),
+                  n25q256a_writer.numStatusPolls(),
+                  is_error ? " [ERR] PROG" : "");
+  }
+
+  /* VERIFY *************************************************************************/
+  bool is_verify_ok = true;
+  for(uint16_t offset = 0; offset < (2 * REGION_SIZE); offset += CHUNK_SIZE)
+  {
+    if(n25q256a.read(0, offset, buf, CHUNK_SIZE) != CHUNK_SIZE) {
+      is_verify_ok = false;
+    }
+    for(uint16_t i = 0; i < CHUNK_SIZE; i++) {
+      if(buf[i] != pattern(offset + i)) is_verify_ok = false;
+    }
+  }
+
+  trace.println(is_verify_ok ? trace::Level::Info : trace::Level::Error, is_verify_ok ? "[OK] VERIFY" : "[ERR] VERIFY");
+
+  /************************************************************************************
+   * CLEANUP
+   ************************************************************************************/
+
+  n25q256a.close();
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
+
+/**************************************************************************************
+ * FUNCTION IMPLEMENTATION
+ **************************************************************************************/
+
+uint8_t pattern(uint32_t const addr)
+{
+  return static_cast<uint8_t>((addr * 7) ^ (addr >> 8));
+}
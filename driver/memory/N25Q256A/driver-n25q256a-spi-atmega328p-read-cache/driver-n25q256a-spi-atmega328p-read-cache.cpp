@@ -0,0 +1,231 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * A driver::memory::NorReadCache (4 lines of 64 bytes, 256 bytes of RAM)
+ * is placed in front of the N25Q256A. The configuration fields located at
+ * the start of block 0 are read repeatedly, then block 1 is scanned in
+ * records of 16 bytes. The cache statistics show how many of those reads
+ * required a SPI transfer:
+ *
+ *   [OK] config: 1000 reads, 2 flash reads
+ *   [OK] scan: <erase size / 16> reads, <about 1/12 of that> flash reads, ...
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-n25q256a-spi-atmega328p-read-cache
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/NorReadCache.h"
+#include "../../common/NorFlashDriverAdapter.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE      = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE      = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE        = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER   = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER   = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+static uint32_t                    const N25Q256A_PAGE_SIZE       = 256;      /* A page program wraps around at the end of a page */
+
+static uint16_t                    const CACHE_NUM_LINES          = 4;
+static uint16_t                    const CACHE_LINE_SIZE          = 64;
+static uint16_t                    const CACHE_PREFETCH_LINES     = 2;
+
+static uint32_t                    const CONFIG_BLOCK             = 0;
+static uint16_t                    const CONFIG_NUM_READS         = 1000;
+static uint32_t                    const SCAN_BLOCK               = 1;
+static uint16_t                    const SCAN_RECORD_SIZE         = 16;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_cs);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!n25q256a.open()) {
+    trace.println(trace::Level::Error, "N25Q256A::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  memory::NorFlashInfo n25q256a_flash_info;
+  if(!n25q256a.ioctl(memory::IOCTL_GET_FLASH_INFO, reinterpret_cast<void*>(&n25q256a_flash_info))) {
+    trace.println(trace::Level::Error, "N25Q256A::ioctl(IOCTL_GET_FLASH_INFO) failed");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  /* READ CACHE *********************************************************************/
+  memory::NorFlashDriverAdapter n25q256a_flash(n25q256a, n25q256a_flash_info, N25Q256A_PAGE_SIZE);
+  uint8_t                       cache_lines[CACHE_NUM_LINES * CACHE_LINE_SIZE];
+  memory::NorReadCacheTag       cache_tags [CACHE_NUM_LINES];
+  memory::NorReadCache          cache(n25q256a_flash, cache_lines, cache_tags, CACHE_NUM_LINES, CACHE_LINE_SIZE, CACHE_PREFETCH_LINES);
+
+  /* Configuration fields are re-read over and over again, both 64 byte lines
+   * of the configuration area stay cached.
+   */
+  uint8_t config_field[8];
+  bool    is_ok = true;
+  for(uint16_t n = 0; n < CONFIG_NUM_READS; n++) {
+    is_ok &= cache.read(CONFIG_BLOCK, (n % 16) * sizeof(config_field), config_field, sizeof(config_field));
+  }
+
+  if(!is_ok) trace.println(trace::Level::Error, "[ERR] config: NorReadCache::read()");
+  else       trace.println(trace::Level::Info,  "[OK] config: %u reads, %lu flash reads", CONFIG_NUM_READS, cache.numFlashReads());
+
+  /* A sequential scan of records is detected and the following lines are
+   * read ahead within the same SPI transfer.
+   */
+  cache.resetCounters();
+
+  uint8_t  record[SCAN_RECORD_SIZE];
+  uint16_t num_records = 0;
+  for(uint32_t off = 0; (off + SCAN_RECORD_SIZE) <= n25q256a_flash_info.erase_size && is_ok; off += SCAN_RECORD_SIZE, num_records++) {
+    is_ok &= cache.read(SCAN_BLOCK, off, record, sizeof(record));
+  }
+
+  if(!is_ok) trace.println(trace::Level::Error, "[ERR] scan: NorReadCache::read()");
+  else       trace.println(trace::Level::Info,  "[OK] scan: %u reads, %lu flash reads, %lu lines prefetched", num_records, cache.numFlashReads(), cache.numPrefetchedLines());
+
+  /************************************************************************************
+   * CLEANUP
+   ************************************************************************************/
+
+  n25q256a.close();
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
@@ -0,0 +1,245 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * The geometry and the commands of the flash are discovered from its SFDP
+ * tables via driver::memory::SfdpNorFlash instead of a device specific
+ * driver, the discovered parameters are printed:
+ *
+ *   SFDP rev 1.0
+ *   Size: 33554432 bytes, page size: 256 bytes
+ *   Erase type 0: 4096 bytes, instr 0x20
+ *   ...
+ *
+ * Afterwards the last erase block of the flash is erased, programmed with
+ * a test pattern spanning several pages, read back and erased again.
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-n25q256a-spi-atmega328p-sfdp
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/SpiNorIo.h"
+#include "../../common/SfdpNorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE      = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE      = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE        = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER   = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER   = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+
+static uint16_t                    const TEST_SIZE                = 600; /* Spans 3 pages */
+static uint16_t                    const CHUNK_SIZE               = 64;
+
+/**************************************************************************************
+ * FUNCTION DECLARATION
+ **************************************************************************************/
+
+uint8_t pattern(uint32_t const addr);
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::SpiNorIo     n25q256a_io(spi_master(), n25q256a_cs);
+  memory::SfdpNorFlash nor_flash  (n25q256a_io, delay);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!nor_flash.open()) {
+    trace.println(trace::Level::Error, "SfdpNorFlash::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  memory::SfdpNorFlashInfo const & info = nor_flash.info();
+
+  trace.println(trace::Level::Info, "SFDP rev %d.%d", info.sfdp_major_rev, info.sfdp_minor_rev);
+  trace.println(trace::Level::Info, "Size: %lu bytes, page size: %d bytes", info.flash_size, info.page_size);
+  for(uint8_t t = 0; t < info.num_erase_types; t++) {
+    trace.println(trace::Level::Info, "Erase type %d: %lu bytes, instr 0x%02X", t, info.erase_type[t].size, info.erase_type[t].instr);
+  }
+  trace.println(trace::Level::Info, "Multi I/O read modes: 0x%02X", info.read_modes);
+  trace.println(trace::Level::Info, "Read instr 0x%02X, prog instr 0x%02X, %d address bytes%s",
+                info.read_instr,
+                info.prog_instr,
+                info.addr_bytes,
+                info.is_4_byte_addr_mode ? " (4-byte address mode)" : "");
+
+  /* PROG/READ/ERASE ******************************************************************/
+
+  uint32_t const block = nor_flash.blockCount() - 1;
+  uint8_t        buf[CHUNK_SIZE];
+
+  if(!nor_flash.erase(block)) {
+    trace.println(trace::Level::Error, "[ERR] ERASE");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  bool is_prog_ok = true;
+  for(uint16_t offset = 0; offset < TEST_SIZE; offset += CHUNK_SIZE)
+  {
+    uint16_t const len = ((TEST_SIZE - offset) < CHUNK_SIZE) ? (TEST_SIZE - offset) : CHUNK_SIZE;
+    for(uint16_t i = 0; i < len; i++) buf[i] = pattern(offset + i);
+    if(!nor_flash.prog(block, offset, buf, len)) is_prog_ok = false;
+  }
+  trace.println(is_prog_ok ? trace::Level::Info : trace::Level::Error, is_prog_ok ? "[OK] PROG" : "[ERR] PROG");
+
+  bool is_verify_ok = true;
+  for(uint16_t offset = 0; offset < TEST_SIZE; offset += CHUNK_SIZE)
+  {
+    uint16_t const len = ((TEST_SIZE - offset) < CHUNK_SIZE) ? (TEST_SIZE - offset) : CHUNK_SIZE;
+    if(!nor_flash.read(block, offset, buf, len)) is_verify_ok = false;
+    for(uint16_t i = 0; i < len; i++) {
+      if(buf[i] != pattern(offset + i)) is_verify_ok = false;
+    }
+  }
+  trace.println(is_verify_ok ? trace::Level::Info : trace::Level::Error, is_verify_ok ? "[OK] VERIFY" : "[ERR] VERIFY");
+
+  bool is_erase_ok = nor_flash.erase(block);
+  for(uint16_t offset = 0; offset < TEST_SIZE; offset += CHUNK_SIZE)
+  {
+    uint16_t const len = ((TEST_SIZE - offset) < CHUNK_SIZE) ? (TEST_SIZE - offset) : CHUNK_SIZE;
+    if(!nor_flash.read(block, offset, buf, len)) is_erase_ok = false;
+    for(uint16_t i = 0; i < len; i++) {
+      if(buf[i] != 0xFF) is_erase_ok = false;
+    }
+  }
+  trace.println(is_erase_ok ? trace::Level::Info : trace::Level::Error, is_erase_ok ? "[OK] ERASE" : "[ERR] ERASE");
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
+
+/**************************************************************************************
+ * FUNCTION IMPLEMENTATION
+ **************************************************************************************/
+
+uint8_t pattern(uint32_t const addr)
+{
+  return static_cast<uint8_t>((addr * 7) ^ (addr >> 8));
+}
@@ -0,0 +1,123 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <string.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/I2cMaster.h>
+
+#include "../../common/PCF8570BlockIo.h"
+#include "../../common/PCF8570Shadow.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * GLOBAL CONSTANTS
+ **************************************************************************************/
+
+static uint8_t const PCF8570_I2C_ADDR = (0x50 << 1);
+static uint8_t const RECORD_ADDR      = 0x00;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::InterruptController int_ctrl    (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  blox::ATMEGA328P::I2cMaster     i2c_master  (&TWCR,
+                                               &TWDR,
+                                               &TWSR,
+                                               &TWBR,
+                                               int_ctrl,
+                                               hal::interface::I2cClock::F_100_kHz);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* PCF8570 **************************************************************************/
+  memory::PCF8570BlockIo pcf8570_io    (PCF8570_I2C_ADDR, i2c_master());
+  memory::PCF8570Shadow  pcf8570_shadow(pcf8570_io                    );
+
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  /* Whole RAM within one write and one read transaction */
+  {
+    uint8_t buffer[memory::PCF8570_SIZE];
+
+    for(uint16_t address = 0; address < memory::PCF8570_SIZE; address += 4)
+    {
+      buffer[address + 0] = 0xBE;
+      buffer[address + 1] = 0xEF;
+      buffer[address + 2] = 0xCA;
+      buffer[address + 3] = 0xFE;
+    }
+    pcf8570_io.write(0, buffer, memory::PCF8570_SIZE);
+
+    memset(buffer, 0, sizeof(buffer));
+    pcf8570_io.read(0, buffer, memory::PCF8570_SIZE);
+  }
+
+  /* A boot counter and an uptime counter kept in the shadow copy, every
+   * flush() writes the changed bytes of both within one transaction.
+   */
+  pcf8570_shadow.load();
+
+  uint16_t boot_count = 0;
+  pcf8570_shadow.read (RECORD_ADDR, reinterpret_cast<uint8_t *>(&boot_count), sizeof(boot_count));
+  boot_count++;
+  pcf8570_shadow.write(RECORD_ADDR, reinterpret_cast<uint8_t const *>(&boot_count), sizeof(boot_count));
+
+  for(uint32_t uptime = 0; ; uptime++)
+  {
+    pcf8570_shadow.write(RECORD_ADDR + sizeof(boot_count), reinterpret_cast<uint8_t const *>(&uptime), sizeof(uptime));
+    if((uptime % 16) == 0) {
+      pcf8570_shadow.flush();
+    }
+  }
+
+  return 0;
+}
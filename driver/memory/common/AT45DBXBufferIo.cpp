@@ -0,0 +1,131 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AT45DBXBufferIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AT45DBXBufferIo::AT45DBXBufferIo(SpiNorIo & io, hal::interface::Delay & delay)
+: _io      (io   ),
+  _delay   (delay),
+  _geometry(     )
+{
+
+}
+
+AT45DBXBufferIo::~AT45DBXBufferIo()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool AT45DBXBufferIo::readGeometry()
+{
+  return geometryFromStatus(readStatusRegister(), _geometry);
+}
+
+void AT45DBXBufferIo::read(uint16_t const page, uint16_t const offset, uint8_t * buf, uint32_t const size)
+{
+  _io.read(AT45DBX_CMD_CONTINUOUS_ARRAY_READ, deviceAddress(page, offset), 3, 8, buf, size);
+}
+
+void AT45DBXBufferIo::writeBuffer(uint8_t const buffer, uint16_t const offset, uint8_t const * buf, uint16_t const size)
+{
+  _io.write((buffer == 0) ? AT45DBX_CMD_BUFFER_1_WRITE : AT45DBX_CMD_BUFFER_2_WRITE, offset, 3, buf, size);
+}
+
+void AT45DBXBufferIo::programBuffer(uint8_t const buffer, uint16_t const page, bool const is_erase)
+{
+  uint8_t instr = 0;
+  if(is_erase) instr = (buffer == 0) ? AT45DBX_CMD_BUFFER_1_TO_PAGE_WITH_ERASE : AT45DBX_CMD_BUFFER_2_TO_PAGE_WITH_ERASE;
+  else         instr = (buffer == 0) ? AT45DBX_CMD_BUFFER_1_TO_PAGE_NO_ERASE   : AT45DBX_CMD_BUFFER_2_TO_PAGE_NO_ERASE;
+
+  _io.commandAddress(instr, deviceAddress(page, 0), 3);
+}
+
+bool AT45DBXBufferIo::isReady()
+{
+  return (readStatusRegister() & AT45DBX_STATUS_REG_RDY_bm) != 0;
+}
+
+void AT45DBXBufferIo::waitReady()
+{
+  for(uint16_t backoff_us = INITIAL_BACKOFF_us; !isReady(); )
+  {
+    _delay.delay_us(backoff_us);
+    if(backoff_us < MAX_BACKOFF_us) backoff_us *= 2;
+  }
+}
+
+bool AT45DBXBufferIo::geometryFromStatus(uint8_t const status, AT45DBXGeometry & geometry)
+{
+  uint8_t const density = (status & AT45DBX_STATUS_REG_DENSITY_bm) >> AT45DBX_STATUS_REG_DENSITY_bp;
+
+  switch(density)
+  {
+  case 0x03: geometry = { 512,  264,  9}; break; /* AT45DB011 */
+  case 0x05: geometry = {1024,  264,  9}; break; /* AT45DB021 */
+  case 0x07: geometry = {2048,  264,  9}; break; /* AT45DB041 */
+  case 0x09: geometry = {4096,  264,  9}; break; /* AT45DB081 */
+  case 0x0B: geometry = {4096,  528, 10}; break; /* AT45DB161 */
+  case 0x0D: geometry = {8192,  528, 10}; break; /* AT45DB321 */
+  case 0x0F: geometry = {8192, 1056, 11}; break; /* AT45DB642 */
+  default  : return false;
+  }
+
+  /* Binary page size: 256/512/1024 bytes, the page address follows the byte address directly */
+  if(status & AT45DBX_STATUS_REG_PAGE_SIZE_bm) {
+    geometry.page_addr_shift--;
+    geometry.page_size = 1U << geometry.page_addr_shift;
+  }
+
+  return true;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint8_t AT45DBXBufferIo::readStatusRegister()
+{
+  uint8_t status = 0;
+  _io.readData(AT45DBX_CMD_STATUS_REG_READ, &status, 1);
+  return status;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
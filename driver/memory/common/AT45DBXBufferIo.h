@@ -0,0 +1,137 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_AT45DBXBUFFERIO_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_AT45DBXBUFFERIO_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/delay/Delay.h>
+
+#include "SpiNorIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr AT45DBX_CMD_CONTINUOUS_ARRAY_READ         = 0x0B; /* 1 dummy byte */
+static uint8_t constexpr AT45DBX_CMD_BUFFER_1_WRITE                = 0x84;
+static uint8_t constexpr AT45DBX_CMD_BUFFER_2_WRITE                = 0x87;
+static uint8_t constexpr AT45DBX_CMD_BUFFER_1_TO_PAGE_WITH_ERASE   = 0x83;
+static uint8_t constexpr AT45DBX_CMD_BUFFER_2_TO_PAGE_WITH_ERASE   = 0x86;
+static uint8_t constexpr AT45DBX_CMD_BUFFER_1_TO_PAGE_NO_ERASE     = 0x88;
+static uint8_t constexpr AT45DBX_CMD_BUFFER_2_TO_PAGE_NO_ERASE     = 0x89;
+static uint8_t constexpr AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_1 = 0x82;
+static uint8_t constexpr AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_2 = 0x85;
+static uint8_t constexpr AT45DBX_CMD_PAGE_ERASE                    = 0x81;
+static uint8_t constexpr AT45DBX_CMD_STATUS_REG_READ               = 0xD7;
+
+static uint8_t constexpr AT45DBX_STATUS_REG_RDY_bm                 = (1<<7);
+static uint8_t constexpr AT45DBX_STATUS_REG_COMP_bm                = (1<<6);
+static uint8_t constexpr AT45DBX_STATUS_REG_DENSITY_bm             = 0x3C;
+static uint8_t constexpr AT45DBX_STATUS_REG_DENSITY_bp             = 2;
+static uint8_t constexpr AT45DBX_STATUS_REG_PAGE_SIZE_bm           = (1<<0); /* Binary (power of 2) page size */
+
+static uint8_t constexpr AT45DBX_MANUFACTURER_ID                   = 0x1F;
+static uint8_t constexpr AT45DBX_FAMILY_CODE                       = 0x01; /* Device ID byte 1, bits 7:5 */
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+typedef struct
+{
+  uint16_t num_pages;
+  uint16_t page_size;
+  uint8_t  page_addr_shift; /* Device address = (page << page_addr_shift) | byte */
+} AT45DBXGeometry;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* SRAM buffer commands of the Adesto/Atmel AT45DB DataFlash family
+ * (AT45DB011 ... AT45DB642). The two SRAM buffers are accessed individually
+ * - writeBuffer() and programBuffer() - so that one buffer can be written
+ * while the other one is being programmed to the main memory, see
+ * AT45DBXPipelinedWriter. read() reads the main memory via continuous
+ * array read.
+ *
+ * The geometry - standard (264/528/1056 byte) or binary (256/512/1024 byte)
+ * pages - is derived from the density and page size bits of the status
+ * register, it determines the page address within buffer program commands.
+ */
+class AT45DBXBufferIo
+{
+
+public:
+
+  static uint16_t constexpr INITIAL_BACKOFF_us = 16;
+  static uint16_t constexpr MAX_BACKOFF_us     = 128;
+
+
+           AT45DBXBufferIo(SpiNorIo & io, hal::interface::Delay & delay);
+  virtual ~AT45DBXBufferIo();
+
+
+  /* Returns false if the status register reports an unknown density */
+  bool                    readGeometry ();
+  AT45DBXGeometry const & geometry     () const { return _geometry; }
+
+  /* Reads across page boundaries, starting at the given page and offset */
+  void                    read         (uint16_t const page, uint16_t const offset, uint8_t * buf, uint32_t const size);
+
+  void                    writeBuffer  (uint8_t const buffer, uint16_t const offset, uint8_t const * buf, uint16_t const size);
+  /* Starts programming a SRAM buffer (0 or 1) to a page, without waiting for its completion */
+  void                    programBuffer(uint8_t const buffer, uint16_t const page, bool const is_erase);
+
+  bool                    isReady      ();
+  void                    waitReady    ();
+
+
+  /* Geometry described by the density and page size bits of the status register */
+  static bool geometryFromStatus(uint8_t const status, AT45DBXGeometry & geometry);
+
+private:
+
+  SpiNorIo              & _io;
+  hal::interface::Delay & _delay;
+  AT45DBXGeometry         _geometry;
+
+  inline uint32_t deviceAddress(uint16_t const page, uint16_t const offset) const { return (static_cast<uint32_t>(page) << _geometry.page_addr_shift) | offset; }
+
+  uint8_t readStatusRegister();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_AT45DBXBUFFERIO_H_ */
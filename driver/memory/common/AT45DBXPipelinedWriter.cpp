@@ -0,0 +1,133 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AT45DBXPipelinedWriter.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AT45DBXPipelinedWriter::AT45DBXPipelinedWriter(AT45DBXBufferIo & io, bool const is_erase)
+: _io      (io      ),
+  _is_erase(is_erase),
+  _page    (0       ),
+  _offset  (0       ),
+  _buffer  (0       )
+{
+  resetStatistics();
+}
+
+AT45DBXPipelinedWriter::~AT45DBXPipelinedWriter()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AT45DBXPipelinedWriter::begin(uint16_t const first_page)
+{
+  _page   = first_page;
+  _offset = 0;
+}
+
+uint32_t AT45DBXPipelinedWriter::write(uint8_t const * buf, uint32_t const size)
+{
+  uint16_t const page_size = _io.geometry().page_size;
+
+  uint32_t pos = 0;
+  while((pos < size) && (_page < _io.geometry().num_pages))
+  {
+    uint16_t const buffer_remaining = page_size - _offset;
+    uint16_t const len              = ((size - pos) < buffer_remaining) ? static_cast<uint16_t>(size - pos) : buffer_remaining;
+
+    /* The buffer being filled is never the one being programmed */
+    _io.writeBuffer(_buffer, _offset, buf + pos, len);
+    _offset += len;
+    pos     += len;
+
+    if(_offset == page_size) programPage();
+  }
+
+  return pos;
+}
+
+void AT45DBXPipelinedWriter::sync()
+{
+  if((_offset > 0) && (_page < _io.geometry().num_pages))
+  {
+    uint8_t const padding[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint16_t const page_size = _io.geometry().page_size;
+
+    while(_offset < page_size)
+    {
+      uint16_t const remaining = page_size - _offset;
+      uint16_t const len       = (remaining < sizeof(padding)) ? remaining : static_cast<uint16_t>(sizeof(padding));
+      _io.writeBuffer(_buffer, _offset, padding, len);
+      _offset += len;
+    }
+
+    programPage();
+  }
+
+  _io.waitReady();
+}
+
+void AT45DBXPipelinedWriter::resetStatistics()
+{
+  _num_page_programs = 0;
+  _num_busy_waits    = 0;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AT45DBXPipelinedWriter::programPage()
+{
+  /* The program of the other buffer must be complete before the next one can be started */
+  if(!_io.isReady()) {
+    _num_busy_waits++;
+    _io.waitReady();
+  }
+
+  _io.programBuffer(_buffer, _page, _is_erase);
+
+  _page++;
+  _offset = 0;
+  _buffer ^= 1;
+  _num_page_programs++;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
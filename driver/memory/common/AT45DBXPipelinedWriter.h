@@ -0,0 +1,94 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_AT45DBXPIPELINEDWRITER_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_AT45DBXPIPELINEDWRITER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AT45DBXBufferIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Sequential writer for the AT45DB DataFlash using its two SRAM buffers in
+ * ping-pong fashion: the data passed to write() is transferred directly
+ * into the current SRAM buffer - no page buffer in MCU RAM is required.
+ * Once the buffer holds a complete page its program to the main memory is
+ * started and the following data goes to the other buffer while the
+ * program is running. The writer only waits for the device before starting
+ * the next buffer program, i.e. the SPI transfer of a page is hidden behind
+ * the program time of the previous one.
+ *
+ * Pages are either programmed with built-in erase or - for pages which have
+ * been erased beforehand - without erase, which is considerably faster.
+ * sync() pads the last partial page with 0xFF, programs it and waits for
+ * completion.
+ */
+class AT45DBXPipelinedWriter
+{
+
+public:
+
+           AT45DBXPipelinedWriter(AT45DBXBufferIo & io, bool const is_erase);
+  virtual ~AT45DBXPipelinedWriter();
+
+
+  void     begin     (uint16_t const first_page);
+  /* Returns the number of bytes accepted, less than size once the end of the flash is reached */
+  uint32_t write     (uint8_t const * buf, uint32_t const size);
+  void     sync      ();
+
+  uint16_t nextPage  () const { return _page; }
+
+
+  void     resetStatistics ();
+  uint32_t numPagePrograms () const { return _num_page_programs; }
+  uint32_t numBusyWaits    () const { return _num_busy_waits; }
+
+private:
+
+  AT45DBXBufferIo & _io;
+  bool              _is_erase;
+  uint16_t          _page,
+                    _offset;
+  uint8_t           _buffer;
+  uint32_t          _num_page_programs,
+                    _num_busy_waits;
+
+  void programPage();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_AT45DBXPIPELINEDWRITER_H_ */
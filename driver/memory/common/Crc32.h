@@ -0,0 +1,67 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_CRC32_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_CRC32_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t constexpr CRC32_INIT = 0xFFFFFFFF;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+/* CRC-32 (reflected polynomial 0xEDB88320) without the final XOR so that it
+ * can be continued across several buffers, calculated bitwise in order to
+ * avoid spending 1 kB of flash on a lookup table.
+ */
+inline uint32_t crc32(uint32_t crc, uint8_t const * data, uint32_t const size)
+{
+  for(uint32_t i = 0; i < size; i++)
+  {
+    crc ^= data[i];
+    for(uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320UL) : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_CRC32_H_ */
@@ -0,0 +1,169 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "FileNorFlash.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+FileNorFlash::FileNorFlash(char const * file_name, uint32_t const prog_size, uint32_t const erase_size, uint32_t const block_count, uint32_t const page_size)
+: _mem        (nullptr                     ),
+  _prog_size  (prog_size                   ),
+  _erase_size (erase_size                  ),
+  _block_count(block_count                 ),
+  _page_size  (page_size                   ),
+  _erase_count(new uint32_t[block_count]   ),
+  _prog_budget(NO_FAILURE                  )
+{
+  memset(_erase_count, 0, block_count * sizeof(uint32_t));
+  resetCounters();
+
+  size_t const size = static_cast<size_t>(erase_size) * block_count;
+
+  int const fd = open(file_name, O_RDWR | O_CREAT, 0644);
+  if(fd < 0) return;
+
+  /* A new image starts out erased */
+  off_t const old_size = lseek(fd, 0, SEEK_END);
+  if((old_size < static_cast<off_t>(size)) && (ftruncate(fd, size) == 0))
+  {
+    void * mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(mem != MAP_FAILED) {
+      memset(static_cast<uint8_t *>(mem) + old_size, 0xFF, size - old_size);
+      _mem = static_cast<uint8_t *>(mem);
+    }
+  }
+  else if(old_size >= static_cast<off_t>(size))
+  {
+    void * mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(mem != MAP_FAILED) {
+      _mem = static_cast<uint8_t *>(mem);
+    }
+  }
+
+  close(fd);
+}
+
+FileNorFlash::~FileNorFlash()
+{
+  if(_mem) {
+    munmap(_mem, static_cast<size_t>(_erase_size) * _block_count);
+  }
+  delete[] _erase_count;
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool FileNorFlash::read(uint32_t const block, uint32_t const off, uint8_t * buf, uint32_t const size)
+{
+  if(!isInRange(block, off, size)) return false;
+
+  memcpy(buf, _mem + block * _erase_size + off, size);
+
+  _num_reads++;
+  _num_read_bytes += size;
+  return true;
+}
+
+bool FileNorFlash::prog(uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size)
+{
+  if(!isInRange(block, off, size)) return false;
+  if((off % _prog_size) != 0 || (size % _prog_size) != 0) return false;
+  if(_prog_budget == 0) return false;
+
+  uint32_t const num_bytes = (_prog_budget < size) ? _prog_budget : size;
+  uint8_t      * dst       = _mem + block * _erase_size;
+
+  if(_page_size == NO_PAGE_WRAP)
+  {
+    for(uint32_t i = 0; i < num_bytes; i++) {
+      dst[off + i] &= buf[i];
+    }
+  }
+  else
+  {
+    uint32_t const page_start = off - (off % _page_size);
+    for(uint32_t i = 0; i < num_bytes; i++) {
+      dst[page_start + ((off - page_start + i) % _page_size)] &= buf[i];
+    }
+  }
+
+  if(_prog_budget != NO_FAILURE) _prog_budget -= num_bytes;
+
+  _num_progs++;
+  _num_prog_bytes += num_bytes;
+  return (num_bytes == size);
+}
+
+bool FileNorFlash::erase(uint32_t const block)
+{
+  if(!isInRange(block, 0, _erase_size)) return false;
+  if(_prog_budget == 0) {
+    memset(_mem + block * _erase_size, 0xFF, _erase_size / 2);
+    return false;
+  }
+
+  memset(_mem + block * _erase_size, 0xFF, _erase_size);
+
+  _erase_count[block]++;
+  _num_erases++;
+  return true;
+}
+
+void FileNorFlash::resetCounters()
+{
+  _num_reads      = 0;
+  _num_read_bytes = 0;
+  _num_progs      = 0;
+  _num_prog_bytes = 0;
+  _num_erases     = 0;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool FileNorFlash::isInRange(uint32_t const block, uint32_t const off, uint32_t const size) const
+{
+  return (_mem != nullptr) && (block < _block_count) && (off <= _erase_size) && (size <= (_erase_size - off));
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
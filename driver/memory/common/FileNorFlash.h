@@ -0,0 +1,115 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_FILENORFLASH_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_FILENORFLASH_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "NorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* NOR flash backed by a memory mapped file on a Linux host (erase sets an
+ * erase block to 0xFF, prog can only clear bits). The file keeps its
+ * content across runs, i.e. it can be inspected or reused like a flash
+ * image. Accesses and erase counts per block are recorded for benchmarking.
+ *
+ * failAfter() simulates a power failure: once the given number of bytes
+ * has been programmed all further prog() and erase() calls fail. The prog()
+ * call hitting the limit is programmed only partially, an erase() issued
+ * afterwards sets only the first half of the block to 0xFF (interrupted
+ * erase), subsequent prog() calls do not change the image at all.
+ *
+ * With a page_size other than NO_PAGE_WRAP a prog() behaves like a page
+ * program of a serial NOR flash such as the N25Q256A: data running past the
+ * end of a page_size aligned page wraps around to the start of that page.
+ */
+class FileNorFlash : public interface::NorFlash
+{
+
+public:
+
+  static uint32_t constexpr NO_FAILURE   = 0xFFFFFFFF;
+  static uint32_t constexpr NO_PAGE_WRAP = 0;
+
+
+           FileNorFlash(char const * file_name, uint32_t const prog_size, uint32_t const erase_size, uint32_t const block_count, uint32_t const page_size);
+  virtual ~FileNorFlash();
+
+
+  bool     isOpen    () const { return _mem != nullptr; }
+
+  virtual uint32_t readSize  () const override { return 1; }
+  virtual uint32_t progSize  () const override { return _prog_size; }
+  virtual uint32_t eraseSize () const override { return _erase_size; }
+  virtual uint32_t blockCount() const override { return _block_count; }
+
+  virtual bool     read      (uint32_t const block, uint32_t const off, uint8_t       * buf, uint32_t const size) override;
+  virtual bool     prog      (uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size) override;
+  virtual bool     erase     (uint32_t const block) override;
+
+
+  void     failAfter     (uint32_t const num_prog_bytes) { _prog_budget = num_prog_bytes; }
+  bool     hasFailed     () const { return _prog_budget == 0; }
+
+  void     resetCounters ();
+  uint32_t numReads      () const { return _num_reads; }
+  uint64_t numReadBytes  () const { return _num_read_bytes; }
+  uint32_t numProgs      () const { return _num_progs; }
+  uint64_t numProgBytes  () const { return _num_prog_bytes; }
+  uint32_t numErases     () const { return _num_erases; }
+  uint32_t eraseCount    (uint32_t const block) const { return _erase_count[block]; }
+
+private:
+
+  uint8_t  * _mem;
+  uint32_t   _prog_size,
+             _erase_size,
+             _block_count,
+             _page_size;
+  uint32_t * _erase_count;
+  uint32_t   _prog_budget;
+  uint32_t   _num_reads;
+  uint64_t   _num_read_bytes;
+  uint32_t   _num_progs;
+  uint64_t   _num_prog_bytes;
+  uint32_t   _num_erases;
+
+  bool isInRange(uint32_t const block, uint32_t const off, uint32_t const size) const;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_FILENORFLASH_H_ */
@@ -0,0 +1,162 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "LittleFsBlockDevice.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+  while(b != 0) {
+    uint32_t const t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+LittleFsBlockDevice::LittleFsBlockDevice(interface::NorFlash       & flash,
+                                         uint32_t            const   first_block,
+                                         uint32_t            const   num_blocks,
+                                         uint8_t                   * read_buffer,
+                                         uint8_t                   * prog_buffer,
+                                         uint32_t            const   cache_buffer_size,
+                                         uint32_t                  * lookahead_buffer,
+                                         uint32_t            const   lookahead_buffer_size,
+                                         int32_t             const   block_cycles)
+: _flash      (flash      ),
+  _first_block(first_block),
+  _is_valid   (false      )
+{
+  memset(&_cfg, 0, sizeof(_cfg));
+
+  uint32_t const read_size  = _flash.readSize();
+  uint32_t const prog_size  = _flash.progSize();
+  uint32_t const erase_size = _flash.eraseSize();
+
+  /* Smallest cache size satisfying both the read and the program granularity */
+  uint32_t const unit = (read_size / gcd(read_size, prog_size)) * prog_size;
+
+  uint32_t cache_size = 0;
+  if((erase_size % unit) == 0) {
+    for(uint32_t size = (cache_buffer_size / unit) * unit; size >= unit; size -= unit) {
+      if((erase_size % size) == 0) {
+        cache_size = size;
+        break;
+      }
+    }
+  }
+
+  /* One bit per block is sufficient, littlefs requires a multiple of 8 bytes */
+  uint32_t const max_lookahead_size = ((num_blocks + 63) / 64) * 8;
+  uint32_t       lookahead_size     = lookahead_buffer_size & ~static_cast<uint32_t>(7);
+  if(lookahead_size > max_lookahead_size) lookahead_size = max_lookahead_size;
+
+  _cfg.context          = this;
+  _cfg.read             = LittleFsBlockDevice::read;
+  _cfg.prog             = LittleFsBlockDevice::prog;
+  _cfg.erase            = LittleFsBlockDevice::erase;
+  _cfg.sync             = LittleFsBlockDevice::sync;
+  _cfg.read_size        = read_size;
+  _cfg.prog_size        = prog_size;
+  _cfg.block_size       = erase_size;
+  _cfg.block_count      = num_blocks;
+  _cfg.block_cycles     = block_cycles;
+  _cfg.cache_size       = cache_size;
+  _cfg.lookahead_size   = lookahead_size;
+  _cfg.read_buffer      = read_buffer;
+  _cfg.prog_buffer      = prog_buffer;
+  _cfg.lookahead_buffer = lookahead_buffer;
+
+  _is_valid = (cache_size > 0) && (lookahead_size > 0) && ((first_block + num_blocks) <= _flash.blockCount());
+}
+
+LittleFsBlockDevice::~LittleFsBlockDevice()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+int LittleFsBlockDevice::mount(lfs_t & lfs, bool const format_on_error)
+{
+  if(!_is_valid) return LFS_ERR_INVAL;
+
+  int err = lfs_mount(&lfs, &_cfg);
+  if(err == LFS_ERR_OK || !format_on_error) return err;
+
+  err = lfs_format(&lfs, &_cfg);
+  if(err != LFS_ERR_OK) return err;
+
+  return lfs_mount(&lfs, &_cfg);
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+int LittleFsBlockDevice::read(lfs_config const * c, lfs_block_t block, lfs_off_t off, void * buffer, lfs_size_t size)
+{
+  LittleFsBlockDevice * this_ptr = static_cast<LittleFsBlockDevice *>(c->context);
+  return this_ptr->_flash.read(this_ptr->_first_block + block, off, static_cast<uint8_t *>(buffer), size) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+int LittleFsBlockDevice::prog(lfs_config const * c, lfs_block_t block, lfs_off_t off, void const * buffer, lfs_size_t size)
+{
+  LittleFsBlockDevice * this_ptr = static_cast<LittleFsBlockDevice *>(c->context);
+  return this_ptr->_flash.prog(this_ptr->_first_block + block, off, static_cast<uint8_t const *>(buffer), size) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+int LittleFsBlockDevice::erase(lfs_config const * c, lfs_block_t block)
+{
+  LittleFsBlockDevice * this_ptr = static_cast<LittleFsBlockDevice *>(c->context);
+  return this_ptr->_flash.erase(this_ptr->_first_block + block) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+int LittleFsBlockDevice::sync(lfs_config const * /* c */)
+{
+  /* interface::NorFlash::prog() returns after the data has been programmed */
+  return LFS_ERR_OK;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
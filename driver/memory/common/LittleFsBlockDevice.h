@@ -0,0 +1,106 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_LITTLEFSBLOCKDEVICE_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_LITTLEFSBLOCKDEVICE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <lfs.h>
+
+#include "NorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* littlefs (v2.x, https://github.com/littlefs-project/littlefs) block device
+ * on the erase blocks [first_block, first_block + num_blocks) of a NOR
+ * flash, lfs block 0 corresponds to first_block.
+ *
+ * The read/prog caches and the lookahead buffer are provided by the
+ * application. The cache size is derived from the flash geometry: the
+ * largest multiple of readSize() and progSize() which fits into the
+ * provided cache buffers and evenly divides eraseSize(). The lookahead size
+ * is rounded down to a multiple of 8 and limited to one bit per block.
+ * isValid() returns false if the buffers are too small for the geometry.
+ *
+ *   memory::LittleFsBlockDevice bd(flash, 0, 256, read_buf, prog_buf, sizeof(read_buf), lookahead_buf, sizeof(lookahead_buf), 500);
+ *   lfs_t lfs;
+ *   bd.mount(lfs, true);
+ *
+ * littlefs allocates the cache of every open file unless it is provided via
+ * lfs_file_opencfg(), fileCacheSize() returns the size required. Build
+ * littlefs with LFS_NO_MALLOC on targets without a heap.
+ */
+class LittleFsBlockDevice
+{
+
+public:
+
+           LittleFsBlockDevice(interface::NorFlash       & flash,
+                               uint32_t            const   first_block,
+                               uint32_t            const   num_blocks,
+                               uint8_t                   * read_buffer,
+                               uint8_t                   * prog_buffer,
+                               uint32_t            const   cache_buffer_size,
+                               uint32_t                  * lookahead_buffer,
+                               uint32_t            const   lookahead_buffer_size,
+                               int32_t             const   block_cycles);
+  virtual ~LittleFsBlockDevice();
+
+
+  inline bool               isValid      () const { return _is_valid; }
+  inline lfs_config const * config       () const { return &_cfg; }
+  inline uint32_t           fileCacheSize() const { return _cfg.cache_size; }
+
+  /* Mounts the filesystem, if mounting fails and format_on_error is set
+   * the blocks are formatted and mounted again. Returns a LFS_ERR_* code.
+   */
+  int                       mount        (lfs_t & lfs, bool const format_on_error);
+
+private:
+
+  interface::NorFlash & _flash;
+  uint32_t              _first_block;
+  bool                  _is_valid;
+  lfs_config            _cfg;
+
+  static int read (lfs_config const * c, lfs_block_t block, lfs_off_t off, void       * buffer, lfs_size_t size);
+  static int prog (lfs_config const * c, lfs_block_t block, lfs_off_t off, void const * buffer, lfs_size_t size);
+  static int erase(lfs_config const * c, lfs_block_t block);
+  static int sync (lfs_config const * c);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_LITTLEFSBLOCKDEVICE_H_ */
@@ -0,0 +1,126 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "N25Q256AErasePool.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+N25Q256AErasePool::N25Q256AErasePool(N25Q256AEraseScheduler       & eraser,
+                                     uint32_t               const   first_block,
+                                     uint32_t               const   num_blocks,
+                                     uint16_t               const   num_pre_erased)
+: _eraser          (eraser        ),
+  _first_block     (first_block   ),
+  _num_blocks      (num_blocks    ),
+  _num_pre_erased  (num_pre_erased),
+  _next_take       (0             ),
+  _num_erased      (0             ),
+  _is_erasing      (false         ),
+  _num_erase_errors(0             ),
+  _num_take_waits  (0             )
+{
+  /* The block handed out last is still being written */
+  if(_num_pre_erased >= _num_blocks) _num_pre_erased = static_cast<uint16_t>(_num_blocks - 1);
+}
+
+N25Q256AErasePool::~N25Q256AErasePool()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool N25Q256AErasePool::take(uint32_t & block)
+{
+  update();
+
+  if(_num_erased == 0)
+  {
+    _num_take_waits++;
+    if(!_is_erasing) {
+      _eraser.waitIdle();
+      startErase();
+    }
+    _eraser.waitIdle();
+    update();
+    if(_num_erased == 0) return false;
+  }
+
+  block = _first_block + _next_take;
+  _next_take = (_next_take + 1) % _num_blocks;
+  _num_erased--;
+
+  service();
+  return true;
+}
+
+void N25Q256AErasePool::service()
+{
+  update();
+
+  if(_is_erasing)                                        return;
+  if(_num_erased >= _num_pre_erased)                     return;
+  if(_eraser.poll() != N25Q256AEraseScheduler::NO_BLOCK) return;
+
+  startErase();
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool N25Q256AErasePool::startErase()
+{
+  _num_erase_errors = _eraser.numEraseErrors();
+  _is_erasing       = _eraser.eraseAsync(_first_block + nextErase());
+  return _is_erasing;
+}
+
+void N25Q256AErasePool::update()
+{
+  if(!_is_erasing)                                       return;
+  if(_eraser.poll() != N25Q256AEraseScheduler::NO_BLOCK) return;
+
+  _is_erasing = false;
+
+  /* A failed erase is retried by the next call to service()/take() */
+  if(_eraser.numEraseErrors() == _num_erase_errors) {
+    _num_erased++;
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
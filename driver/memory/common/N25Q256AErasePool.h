@@ -0,0 +1,95 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AERASEPOOL_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AERASEPOOL_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "N25Q256AEraseScheduler.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Keeps up to num_pre_erased blocks of a circular log within the blocks
+ * [first_block, first_block + num_blocks) erased ahead of the write
+ * position. take() hands out the blocks in circular order, service() -
+ * called periodically, e.g. from the idle loop - starts the background
+ * erase of the next block whenever the erase scheduler is idle. take()
+ * only waits for an erase if the log outruns the pool.
+ *
+ * The content of a block is lost as soon as it is among the next
+ * num_pre_erased blocks, i.e. the blocks ahead of the write position
+ * must not hold data which is still needed. The state of the pool is not
+ * persistent, after a restart all blocks are erased again once.
+ */
+class N25Q256AErasePool
+{
+
+public:
+
+           N25Q256AErasePool(N25Q256AEraseScheduler       & eraser,
+                             uint32_t               const   first_block,
+                             uint32_t               const   num_blocks,
+                             uint16_t               const   num_pre_erased);
+  virtual ~N25Q256AErasePool();
+
+
+  /* Returns the next block of the log in erased state, false if its erase failed */
+  bool     take        (uint32_t & block);
+  void     service     ();
+
+  uint16_t numErased   () const { return _num_erased; }
+  uint32_t numTakeWaits() const { return _num_take_waits; }
+
+private:
+
+  N25Q256AEraseScheduler & _eraser;
+  uint32_t                 _first_block,
+                           _num_blocks;
+  uint16_t                 _num_pre_erased;
+  uint32_t                 _next_take;
+  uint16_t                 _num_erased;
+  bool                     _is_erasing;
+  uint32_t                 _num_erase_errors;
+  uint32_t                 _num_take_waits;
+
+  inline uint32_t nextErase() const { return (_next_take + _num_erased) % _num_blocks; }
+
+  bool startErase();
+  void update    ();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AERASEPOOL_H_ */
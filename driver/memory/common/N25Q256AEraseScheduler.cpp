@@ -0,0 +1,243 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "N25Q256AEraseScheduler.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+N25Q256AEraseScheduler::N25Q256AEraseScheduler(SpiNorIo              & io,
+                                               N25Q256AFastPath      & fast_path,
+                                               hal::interface::Delay & delay,
+                                               N25Q256AEraseSize const erase_size)
+: _io           (io        ),
+  _fast_path    (fast_path ),
+  _delay        (delay     ),
+  _erase_size   (erase_size),
+  _erasing_block(NO_BLOCK  )
+{
+  resetStatistics();
+}
+
+N25Q256AEraseScheduler::~N25Q256AEraseScheduler()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t N25Q256AEraseScheduler::eraseSize() const
+{
+  return (_erase_size == N25Q256AEraseSize::Subsector) ? N25Q256A_SUBSECTOR_SIZE : N25Q256A_SECTOR_SIZE;
+}
+
+bool N25Q256AEraseScheduler::eraseAsync(uint32_t const block)
+{
+  if(block >= blockCount()) return false;
+  if(poll() != NO_BLOCK)    return false;
+
+  uint8_t const instr = (_erase_size == N25Q256AEraseSize::Subsector) ? SPI_NOR_CMD_4_BYTE_SUBSECTOR_ERASE : SPI_NOR_CMD_4_BYTE_SECTOR_ERASE;
+
+  _io.command       (SPI_NOR_CMD_WRITE_ENABLE);
+  _io.commandAddress(instr, block * eraseSize(), 4);
+
+  _erasing_block = block;
+  _num_erases++;
+  return true;
+}
+
+uint32_t N25Q256AEraseScheduler::poll()
+{
+  if(_erasing_block == NO_BLOCK) return NO_BLOCK;
+
+  if(_io.readStatusRegister() & SPI_NOR_STATUS_REG_WIP_bm) return _erasing_block;
+
+  complete();
+  return NO_BLOCK;
+}
+
+bool N25Q256AEraseScheduler::waitIdle()
+{
+  if(_erasing_block == NO_BLOCK) return true;
+
+  uint32_t const num_erase_errors = _num_erase_errors;
+
+  waitWhileBusy();
+  complete();
+
+  return (_num_erase_errors == num_erase_errors);
+}
+
+uint32_t N25Q256AEraseScheduler::read(uint32_t const addr, uint8_t * buf, uint32_t const size)
+{
+  if((addr >= N25Q256A_FLASH_SIZE) || (size > (N25Q256A_FLASH_SIZE - addr))) return 0;
+
+  bool is_suspended = false;
+
+  if(poll() != NO_BLOCK)
+  {
+    if(overlapsErase(addr, size)) {
+      _num_erase_waits++;
+      waitIdle();
+    } else {
+      is_suspended = suspend();
+    }
+  }
+
+  uint32_t const bytes_read = _fast_path.read(addr, buf, size);
+
+  if(is_suspended) resume();
+
+  return bytes_read;
+}
+
+uint32_t N25Q256AEraseScheduler::prog(uint32_t const addr, uint8_t const * buf, uint32_t const size)
+{
+  if((addr >= N25Q256A_FLASH_SIZE) || (size > (N25Q256A_FLASH_SIZE - addr))) return 0;
+
+  bool is_suspended = false;
+
+  if(poll() != NO_BLOCK)
+  {
+    if(overlapsErase(addr, size)) {
+      _num_erase_waits++;
+      waitIdle();
+    } else {
+      is_suspended = suspend();
+    }
+  }
+
+  progPages(addr, buf, size);
+
+  /* The program error flags are checked and cleared before resuming, the
+   * erase error flag is evaluated once the erase has completed.
+   */
+  uint8_t flag_status = 0;
+  _io.readData(N25Q256A_CMD_READ_FLAG_STATUS_REG, &flag_status, 1);
+
+  bool const is_prog_error = (flag_status & (N25Q256A_FLAG_STATUS_REG_PROG_bm | N25Q256A_FLAG_STATUS_REG_PROT_bm)) != 0;
+  if(is_prog_error) {
+    _io.command(N25Q256A_CMD_CLEAR_FLAG_STATUS_REG);
+  }
+
+  if(is_suspended) resume();
+
+  return is_prog_error ? 0 : size;
+}
+
+void N25Q256AEraseScheduler::resetStatistics()
+{
+  _num_erases       = 0;
+  _num_suspends     = 0;
+  _num_erase_waits  = 0;
+  _num_erase_errors = 0;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool N25Q256AEraseScheduler::overlapsErase(uint32_t const addr, uint32_t const size) const
+{
+  uint32_t const erase_addr = _erasing_block * eraseSize();
+  return (addr < (erase_addr + eraseSize())) && ((addr + size) > erase_addr);
+}
+
+bool N25Q256AEraseScheduler::suspend()
+{
+  _io.command(N25Q256A_CMD_PROGRAM_ERASE_SUSPEND);
+
+  /* The suspend latency is in the order of a few 10 us, the flag status
+   * register is therefore polled without delay.
+   */
+  uint8_t flag_status = 0;
+  do {
+    _io.readData(N25Q256A_CMD_READ_FLAG_STATUS_REG, &flag_status, 1);
+  } while(!(flag_status & N25Q256A_FLAG_STATUS_REG_READY_bm));
+
+  if(flag_status & N25Q256A_FLAG_STATUS_REG_ERASE_SUSP_bm) {
+    _num_suspends++;
+    return true;
+  }
+
+  /* The erase completed before it could be suspended */
+  complete();
+  return false;
+}
+
+void N25Q256AEraseScheduler::resume()
+{
+  _io.command(N25Q256A_CMD_PROGRAM_ERASE_RESUME);
+}
+
+void N25Q256AEraseScheduler::progPages(uint32_t const addr, uint8_t const * buf, uint32_t const size)
+{
+  for(uint32_t pos = 0; pos < size; )
+  {
+    uint32_t const page_remaining = N25Q256A_PAGE_SIZE - ((addr + pos) % N25Q256A_PAGE_SIZE);
+    uint32_t const len            = ((size - pos) < page_remaining) ? (size - pos) : page_remaining;
+
+    _io.command(SPI_NOR_CMD_WRITE_ENABLE);
+    _io.write  (SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM, addr + pos, 4, buf + pos, len);
+    waitWhileBusy();
+
+    pos += len;
+  }
+}
+
+void N25Q256AEraseScheduler::waitWhileBusy()
+{
+  for(uint16_t backoff_us = INITIAL_BACKOFF_us; _io.readStatusRegister() & SPI_NOR_STATUS_REG_WIP_bm; )
+  {
+    _delay.delay_us(backoff_us);
+    if(backoff_us < MAX_BACKOFF_us) backoff_us *= 2;
+  }
+}
+
+void N25Q256AEraseScheduler::complete()
+{
+  uint8_t flag_status = 0;
+  _io.readData(N25Q256A_CMD_READ_FLAG_STATUS_REG, &flag_status, 1);
+
+  if(flag_status & (N25Q256A_FLAG_STATUS_REG_ERASE_bm | N25Q256A_FLAG_STATUS_REG_PROT_bm)) {
+    _io.command(N25Q256A_CMD_CLEAR_FLAG_STATUS_REG);
+    _num_erase_errors++;
+  }
+
+  _erasing_block = NO_BLOCK;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,129 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AERASESCHEDULER_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AERASESCHEDULER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/delay/Delay.h>
+
+#include "SpiNorIo.h"
+#include "N25Q256AFastPath.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+enum class N25Q256AEraseSize
+{
+  Subsector, /*  4 kB, typ. 0.25 s */
+  Sector     /* 64 kB, typ. 0.7  s */
+};
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Non-blocking erase for the N25Q256A: eraseAsync() issues the erase and
+ * returns immediately, poll() reports its completion. read() and prog()
+ * may be called while an erase is in progress - outside of the block being
+ * erased they suspend the erase via PROGRAM/ERASE SUSPEND, access the flash
+ * and resume it again via PROGRAM/ERASE RESUME, accessing the block being
+ * erased waits for the erase to complete.
+ *
+ * The erase only makes progress while it is not suspended, an application
+ * accessing the flash back-to-back without pause delays the completion of
+ * the erase accordingly. Programs and erases use the 4-byte address
+ * commands and work in either address mode.
+ */
+class N25Q256AEraseScheduler
+{
+
+public:
+
+  static uint16_t constexpr INITIAL_BACKOFF_us = 16;
+  static uint16_t constexpr MAX_BACKOFF_us     = 64;
+  static uint32_t constexpr NO_BLOCK           = 0xFFFFFFFF;
+
+
+           N25Q256AEraseScheduler(SpiNorIo              & io,
+                                  N25Q256AFastPath      & fast_path,
+                                  hal::interface::Delay & delay,
+                                  N25Q256AEraseSize const erase_size);
+  virtual ~N25Q256AEraseScheduler();
+
+
+  uint32_t eraseSize () const;
+  uint32_t blockCount() const { return N25Q256A_FLASH_SIZE / eraseSize(); }
+
+  /* Starts the erase of a block, returns false if another erase is still in progress */
+  bool     eraseAsync(uint32_t const block);
+  /* Returns the block being erased or NO_BLOCK once the erase has completed */
+  uint32_t poll      ();
+  /* Waits until the erase has completed, returns false if it failed */
+  bool     waitIdle  ();
+
+  /* Return the number of bytes read/programmed, 0 if the range exceeds the flash */
+  uint32_t read      (uint32_t const addr, uint8_t       * buf, uint32_t const size);
+  uint32_t prog      (uint32_t const addr, uint8_t const * buf, uint32_t const size);
+
+
+  void     resetStatistics();
+  uint32_t numErases      () const { return _num_erases; }
+  uint32_t numSuspends    () const { return _num_suspends; }
+  uint32_t numEraseWaits  () const { return _num_erase_waits; }
+  uint32_t numEraseErrors () const { return _num_erase_errors; }
+
+private:
+
+  SpiNorIo              & _io;
+  N25Q256AFastPath      & _fast_path;
+  hal::interface::Delay & _delay;
+  N25Q256AEraseSize       _erase_size;
+  uint32_t                _erasing_block;
+  uint32_t                _num_erases,
+                          _num_suspends,
+                          _num_erase_waits,
+                          _num_erase_errors;
+
+  bool overlapsErase (uint32_t const addr, uint32_t const size) const;
+  bool suspend       ();
+  void resume        ();
+  void progPages     (uint32_t const addr, uint8_t const * buf, uint32_t const size);
+  void waitWhileBusy ();
+  void complete      ();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AERASESCHEDULER_H_ */
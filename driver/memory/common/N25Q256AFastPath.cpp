@@ -0,0 +1,108 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "N25Q256AFastPath.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+N25Q256AFastPath::N25Q256AFastPath(SpiNorIo & io, N25Q256AReadMode const read_mode)
+: _io                 (io       ),
+  _read_mode          (read_mode),
+  _is_4_byte_addr_mode(false    )
+{
+
+}
+
+N25Q256AFastPath::~N25Q256AFastPath()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool N25Q256AFastPath::enter4ByteAddressMode()
+{
+  return setAddressMode(SPI_NOR_CMD_ENTER_4_BYTE_ADDR, true);
+}
+
+bool N25Q256AFastPath::exit4ByteAddressMode()
+{
+  return setAddressMode(SPI_NOR_CMD_EXIT_4_BYTE_ADDR, false);
+}
+
+uint32_t N25Q256AFastPath::read(uint32_t const addr, uint8_t * buf, uint32_t const size)
+{
+  if((addr >= N25Q256A_FLASH_SIZE) || (size > (N25Q256A_FLASH_SIZE - addr))) return 0;
+
+  if(_read_mode == N25Q256AReadMode::FastRead)
+  {
+    uint8_t const instr = _is_4_byte_addr_mode ? SPI_NOR_CMD_FAST_READ : SPI_NOR_CMD_4_BYTE_FAST_READ;
+    _io.read(instr, addr, 4, N25Q256A_FAST_READ_DUMMY_CYCLES, buf, size);
+  }
+  else
+  {
+    uint8_t const instr = _is_4_byte_addr_mode ? SPI_NOR_CMD_READ : SPI_NOR_CMD_4_BYTE_READ;
+    _io.read(instr, addr, 4, 0, buf, size);
+  }
+
+  return size;
+}
+
+bool N25Q256AFastPath::isBusy()
+{
+  return (_io.readStatusRegister() & SPI_NOR_STATUS_REG_WIP_bm) != 0;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool N25Q256AFastPath::setAddressMode(uint8_t const instr, bool const is_4_byte_addr_mode)
+{
+  /* ENTER/EXIT 4-BYTE ADDRESS MODE require the write enable latch to be set */
+  _io.command(SPI_NOR_CMD_WRITE_ENABLE);
+  _io.command(instr);
+  _io.command(SPI_NOR_CMD_WRITE_DISABLE);
+
+  uint8_t flag_status = 0;
+  _io.readData(N25Q256A_CMD_READ_FLAG_STATUS_REG, &flag_status, 1);
+
+  _is_4_byte_addr_mode = (flag_status & N25Q256A_FLAG_STATUS_REG_4_BYTE_bm) != 0;
+  return (_is_4_byte_addr_mode == is_4_byte_addr_mode);
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
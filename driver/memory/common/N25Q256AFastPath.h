@@ -0,0 +1,121 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AFASTPATH_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AFASTPATH_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SpiNorIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+enum class N25Q256AReadMode
+{
+  Read,     /* READ,      f_SCK <=  54 MHz */
+  FastRead  /* FAST READ, f_SCK <= 108 MHz */
+};
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t constexpr N25Q256A_FLASH_SIZE                    = 32UL * 1024UL * 1024UL;
+static uint32_t constexpr N25Q256A_3_BYTE_ADDR_LIMIT             = 16UL * 1024UL * 1024UL;
+static uint32_t constexpr N25Q256A_SECTOR_SIZE                   = 64UL * 1024UL;
+static uint32_t constexpr N25Q256A_SUBSECTOR_SIZE                =  4UL * 1024UL;
+static uint16_t constexpr N25Q256A_PAGE_SIZE                     = 256;
+
+static uint8_t  constexpr N25Q256A_CMD_READ_FLAG_STATUS_REG      = 0x70;
+static uint8_t  constexpr N25Q256A_CMD_CLEAR_FLAG_STATUS_REG     = 0x50;
+static uint8_t  constexpr N25Q256A_CMD_PROGRAM_ERASE_SUSPEND     = 0x75;
+static uint8_t  constexpr N25Q256A_CMD_PROGRAM_ERASE_RESUME      = 0x7A;
+static uint8_t  constexpr N25Q256A_FLAG_STATUS_REG_READY_bm      = (1<<7);
+static uint8_t  constexpr N25Q256A_FLAG_STATUS_REG_ERASE_SUSP_bm = (1<<6);
+static uint8_t  constexpr N25Q256A_FLAG_STATUS_REG_ERASE_bm      = (1<<5);
+static uint8_t  constexpr N25Q256A_FLAG_STATUS_REG_PROG_bm       = (1<<4);
+static uint8_t  constexpr N25Q256A_FLAG_STATUS_REG_PROT_bm       = (1<<1);
+static uint8_t  constexpr N25Q256A_FLAG_STATUS_REG_4_BYTE_bm     = (1<<0);
+
+/* Power-on default of the volatile configuration register (1111b = 8
+ * dummy cycles for FAST READ in extended SPI mode).
+ */
+static uint8_t  constexpr N25Q256A_FAST_READ_DUMMY_CYCLES        = 8;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Sequential read path of the N25Q256A: an arbitrarily large range is read
+ * within a single command, i.e. the instruction, address and dummy overhead
+ * of 5 - 6 bytes is paid once per read() instead of once per small chunk.
+ * All reads use 4 address bytes and therefore reach the full 32 MB, either
+ * via the dedicated 4-BYTE READ/4-BYTE FAST READ commands or - once the
+ * device has been switched to 4-byte address mode - via READ/FAST READ.
+ *
+ * Dual and quad output reads are not provided, the SPI peripherals of the
+ * supported MCUs (ATMEGA328P, ATMEGA1284P, AT90CAN128) transfer one bit per
+ * clock only.
+ */
+class N25Q256AFastPath
+{
+
+public:
+
+           N25Q256AFastPath(SpiNorIo & io, N25Q256AReadMode const read_mode);
+  virtual ~N25Q256AFastPath();
+
+
+  bool     enter4ByteAddressMode();
+  bool     exit4ByteAddressMode ();
+  bool     is4ByteAddressMode   () const { return _is_4_byte_addr_mode; }
+  uint8_t  addrBytes            () const { return _is_4_byte_addr_mode ? 4 : 3; }
+
+  /* Returns the number of bytes read, 0 if the range exceeds the flash */
+  uint32_t read(uint32_t const addr, uint8_t * buf, uint32_t const size);
+
+  bool     isBusy();
+
+private:
+
+  SpiNorIo       & _io;
+  N25Q256AReadMode _read_mode;
+  bool             _is_4_byte_addr_mode;
+
+  bool setAddressMode(uint8_t const instr, bool const is_4_byte_addr_mode);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256AFASTPATH_H_ */
@@ -0,0 +1,162 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "N25Q256APageWriter.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+N25Q256APageWriter::N25Q256APageWriter(SpiNorIo & io, hal::interface::Delay & delay)
+: _io               (io                ),
+  _delay            (delay             ),
+  _page_addr        (0                 ),
+  _dirty_begin      (N25Q256A_PAGE_SIZE),
+  _dirty_end        (0                 ),
+  _is_busy          (true              ),
+  _num_page_programs(0                 ),
+  _num_status_polls (0                 )
+{
+  memset(_page_buf, 0xFF, sizeof(_page_buf));
+}
+
+N25Q256APageWriter::~N25Q256APageWriter()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t N25Q256APageWriter::prog(uint32_t const addr, uint8_t const * buf, uint32_t const size)
+{
+  if((addr >= N25Q256A_FLASH_SIZE) || (size > (N25Q256A_FLASH_SIZE - addr))) return 0;
+
+  for(uint32_t pos = 0; pos < size; )
+  {
+    uint32_t const page_addr = (addr + pos) & ~static_cast<uint32_t>(N25Q256A_PAGE_SIZE - 1);
+    uint16_t const offset    = static_cast<uint16_t>((addr + pos) - page_addr);
+    uint32_t const remaining = size - pos;
+    uint16_t const len       = (remaining < static_cast<uint32_t>(N25Q256A_PAGE_SIZE - offset)) ? static_cast<uint16_t>(remaining) : (N25Q256A_PAGE_SIZE - offset);
+
+    if(page_addr != _page_addr) {
+      flush();
+      _page_addr = page_addr;
+    }
+
+    /* Programming can only clear bits, repeated writes to the same location
+     * before the page is flushed therefore behave as if they were programmed
+     * one after the other.
+     */
+    for(uint16_t i = 0; i < len; i++) {
+      _page_buf[offset + i] &= buf[pos + i];
+    }
+
+    if(offset < _dirty_begin)       _dirty_begin = offset;
+    if((offset + len) > _dirty_end) _dirty_end   = offset + len;
+
+    if((_dirty_begin == 0) && (_dirty_end == N25Q256A_PAGE_SIZE)) {
+      flush();
+    }
+
+    pos += len;
+  }
+
+  return size;
+}
+
+void N25Q256APageWriter::flush()
+{
+  if(_dirty_begin >= _dirty_end) return;
+
+  uint16_t const len = _dirty_end - _dirty_begin;
+
+  waitReady();
+  _io.command(SPI_NOR_CMD_WRITE_ENABLE);
+  _io.write  (SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM, _page_addr + _dirty_begin, 4, _page_buf + _dirty_begin, len);
+
+  _is_busy = true;
+  _num_page_programs++;
+
+  memset(_page_buf + _dirty_begin, 0xFF, len);
+  _dirty_begin = N25Q256A_PAGE_SIZE;
+  _dirty_end   = 0;
+}
+
+bool N25Q256APageWriter::sync()
+{
+  flush();
+  waitReady();
+
+  /* The error flags are sticky and cover all operations since they were cleared last */
+  uint8_t flag_status = 0;
+  _io.readData(N25Q256A_CMD_READ_FLAG_STATUS_REG, &flag_status, 1);
+
+  if(flag_status & (N25Q256A_FLAG_STATUS_REG_PROG_bm | N25Q256A_FLAG_STATUS_REG_PROT_bm)) {
+    _io.command(N25Q256A_CMD_CLEAR_FLAG_STATUS_REG);
+    return false;
+  }
+
+  return true;
+}
+
+void N25Q256APageWriter::resetStatistics()
+{
+  _num_page_programs = 0;
+  _num_status_polls  = 0;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void N25Q256APageWriter::waitReady()
+{
+  if(!_is_busy) return;
+
+  for(uint16_t backoff_us = INITIAL_BACKOFF_us; ; )
+  {
+    _num_status_polls++;
+    if(!(_io.readStatusRegister() & SPI_NOR_STATUS_REG_WIP_bm)) break;
+
+    _delay.delay_us(backoff_us);
+    if(backoff_us < MAX_BACKOFF_us) backoff_us *= 2;
+  }
+
+  _is_busy = false;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
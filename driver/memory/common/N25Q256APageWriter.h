@@ -0,0 +1,109 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256APAGEWRITER_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256APAGEWRITER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/delay/Delay.h>
+
+#include "SpiNorIo.h"
+#include "N25Q256AFastPath.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Write combining for the N25Q256A: prog() only copies the data into a RAM
+ * page buffer, a PAGE PROGRAM is issued once the page is complete, a write
+ * to a different page arrives or flush()/sync() is called. Writes crossing
+ * page boundaries are split automatically. Bytes in between two writes to
+ * the same page are left 0xFF within the buffer and therefore keep their
+ * content when the dirty range is programmed as a whole.
+ *
+ * A page program is started without waiting for its completion, the status
+ * register is polled before the next command only - with a delay growing
+ * from INITIAL_BACKOFF_us up to MAX_BACKOFF_us between the polls instead of
+ * occupying the SPI bus with back-to-back status reads.
+ *
+ * Data which has been accepted by prog() is only guaranteed to be in the
+ * flash after sync() returned, reads of such data must be preceded by a
+ * call to sync().
+ */
+class N25Q256APageWriter
+{
+
+public:
+
+  static uint16_t constexpr INITIAL_BACKOFF_us = 16;
+  static uint16_t constexpr MAX_BACKOFF_us     = 64;
+
+
+           N25Q256APageWriter(SpiNorIo & io, hal::interface::Delay & delay);
+  virtual ~N25Q256APageWriter();
+
+
+  /* Returns the number of bytes accepted, 0 if the range exceeds the flash */
+  uint32_t prog (uint32_t const addr, uint8_t const * buf, uint32_t const size);
+
+  /* Starts programming of the buffered page (if any) */
+  void     flush();
+
+  /* Programs the buffered page and waits until the flash is idle. Returns
+   * false if any program operation since the last call to sync() failed.
+   */
+  bool     sync ();
+
+
+  void     resetStatistics ();
+  uint32_t numPagePrograms () const { return _num_page_programs; }
+  uint32_t numStatusPolls  () const { return _num_status_polls; }
+
+private:
+
+  SpiNorIo              & _io;
+  hal::interface::Delay & _delay;
+  uint8_t                 _page_buf[N25Q256A_PAGE_SIZE];
+  uint32_t                _page_addr;
+  uint16_t                _dirty_begin,
+                          _dirty_end;
+  bool                    _is_busy;
+  uint32_t                _num_page_programs,
+                          _num_status_polls;
+
+  void waitReady();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_N25Q256APAGEWRITER_H_ */
@@ -0,0 +1,69 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_NORFLASH_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_NORFLASH_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory::interface
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Block oriented NOR flash as described by memory::NorFlashInfo: erase()
+ * sets a whole erase block to 0xFF, prog() can only clear bits and must be
+ * aligned to progSize(). The same prog() may be used to clear additional
+ * bits of already programmed locations.
+ */
+class NorFlash
+{
+
+public:
+
+  virtual ~NorFlash() { }
+
+
+  virtual uint32_t readSize  () const = 0;
+  virtual uint32_t progSize  () const = 0;
+  virtual uint32_t eraseSize () const = 0;
+  virtual uint32_t blockCount() const = 0;
+
+  virtual bool     read      (uint32_t const block, uint32_t const off, uint8_t       * buf, uint32_t const size) = 0;
+  virtual bool     prog      (uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size) = 0;
+  virtual bool     erase     (uint32_t const block) = 0;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory::interface */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_NORFLASH_H_ */
@@ -0,0 +1,116 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_NORFLASHDRIVERADAPTER_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_NORFLASHDRIVERADAPTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "NorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Provides interface::NorFlash for the snowfox memory drivers sharing the
+ * read(block, off, buf, size)/prog(...)/erase(block) signatures, e.g.
+ * memory::N25Q256A::N25Q256A or memory::AT45DBX::AT45DBX. The geometry is
+ * taken from the memory::NorFlashInfo obtained via IOCTL_GET_FLASH_INFO:
+ *
+ *   memory::NorFlashInfo flash_info;
+ *   n25q256a.ioctl(memory::IOCTL_GET_FLASH_INFO, reinterpret_cast<void*>(&flash_info));
+ *   memory::NorFlashDriverAdapter flash(n25q256a, flash_info, N25Q256A_PAGE_SIZE);
+ *
+ * A page program of the N25Q256A wraps around at the end of its 256 byte
+ * program page, the drivers leave splitting to the caller. prog() therefore
+ * issues one driver prog() per page_size aligned page touched (page_size
+ * must divide the erase block size).
+ */
+template <typename Driver, typename FlashInfo>
+class NorFlashDriverAdapter : public interface::NorFlash
+{
+
+public:
+
+  NorFlashDriverAdapter(Driver & driver, FlashInfo const & flash_info, uint32_t const page_size)
+  : _driver     (driver                ),
+    _read_size  (flash_info.read_size  ),
+    _prog_size  (flash_info.prog_size  ),
+    _erase_size (flash_info.erase_size ),
+    _block_count(flash_info.block_count),
+    _page_size  (page_size             )
+  { }
+
+  virtual ~NorFlashDriverAdapter() { }
+
+
+  virtual uint32_t readSize  () const override { return _read_size; }
+  virtual uint32_t progSize  () const override { return _prog_size; }
+  virtual uint32_t eraseSize () const override { return _erase_size; }
+  virtual uint32_t blockCount() const override { return _block_count; }
+
+  virtual bool read(uint32_t const block, uint32_t const off, uint8_t * buf, uint32_t const size) override
+  {
+    return (static_cast<uint32_t>(_driver.read(block, off, buf, size)) == size);
+  }
+
+  virtual bool prog(uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size) override
+  {
+    for(uint32_t pos = 0; pos < size; )
+    {
+      uint32_t const page_remaining = _page_size - ((off + pos) % _page_size);
+      uint32_t const chunk_size     = ((size - pos) < page_remaining) ? (size - pos) : page_remaining;
+
+      if(static_cast<uint32_t>(_driver.prog(block, off + pos, buf + pos, chunk_size)) != chunk_size) return false;
+      pos += chunk_size;
+    }
+    return true;
+  }
+
+  virtual bool erase(uint32_t const block) override
+  {
+    return _driver.erase(block);
+  }
+
+private:
+
+  Driver   & _driver;
+  uint32_t   _read_size,
+             _prog_size,
+             _erase_size,
+             _block_count,
+             _page_size;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_NORFLASHDRIVERADAPTER_H_ */
@@ -0,0 +1,571 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "NorKvStore.h"
+
+#include <string.h>
+
+#include "Crc32.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* Block header:  | MAGIC (4) | SEQ (4) | CRC (4) |
+ * Record header: | KEY SIZE (1) | TYPE (1) | VALUE SIZE (2) | CRC (4) | KEY | VALUE |
+ *
+ * All fields are little endian, the CRC of a record covers the first four
+ * header bytes, the key and the value. Block headers and records start at
+ * progSize() aligned offsets.
+ */
+static uint32_t constexpr BLOCK_MAGIC           = 0x564B4653; /* 'SFKV' */
+static uint16_t constexpr BLOCK_HEADER_SIZE     = 12;
+static uint16_t constexpr RECORD_HEADER_SIZE    = 8;
+
+static uint8_t  constexpr RECORD_TYPE_VALUE     = 0x01;
+static uint8_t  constexpr RECORD_TYPE_TOMBSTONE = 0x02;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static void put32(uint8_t * buf, uint32_t const val)
+{
+  buf[0] = static_cast<uint8_t>(val);
+  buf[1] = static_cast<uint8_t>(val >> 8);
+  buf[2] = static_cast<uint8_t>(val >> 16);
+  buf[3] = static_cast<uint8_t>(val >> 24);
+}
+
+static uint32_t get32(uint8_t const * buf)
+{
+  return static_cast<uint32_t>(buf[0]) | (static_cast<uint32_t>(buf[1]) << 8) | (static_cast<uint32_t>(buf[2]) << 16) | (static_cast<uint32_t>(buf[3]) << 24);
+}
+
+static bool isAllErased(uint8_t const * buf, uint32_t const size)
+{
+  for(uint32_t i = 0; i < size; i++) {
+    if(buf[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+NorKvStore::NorKvStore(interface::NorFlash       & flash,
+                       uint32_t            const   first_block,
+                       uint16_t            const   num_blocks,
+                       NorKvIndexEntry           * index,
+                       uint16_t            const   index_capacity)
+: _flash          (flash                                  ),
+  _first_block    (first_block                            ),
+  _num_blocks     (num_blocks                             ),
+  _index          (index                                  ),
+  _index_capacity (index_capacity                         ),
+  _erase_size     (flash.eraseSize()                      ),
+  _prog_size      (static_cast<uint16_t>(flash.progSize())),
+  _header_size    (0                                      ),
+  _is_mounted     (false                                  ),
+  _is_compacting  (false                                  ),
+  _head           (NO_BLOCK                               ),
+  _tail           (NO_BLOCK                               ),
+  _num_used       (0                                      ),
+  _seq            (0                                      ),
+  _head_offset    (0                                      ),
+  _num_keys       (0                                      ),
+  _live_bytes     (0                                      ),
+  _num_compactions(0                                      )
+{
+  if(_prog_size == 0) _prog_size = 1;
+  _header_size = static_cast<uint16_t>(align(BLOCK_HEADER_SIZE));
+}
+
+NorKvStore::~NorKvStore()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool NorKvStore::format()
+{
+  _is_mounted = false;
+
+  for(uint16_t b = 0; b < _num_blocks; b++) {
+    if(!_flash.erase(_first_block + b)) return false;
+  }
+
+  return mount();
+}
+
+bool NorKvStore::mount()
+{
+  _is_mounted = false;
+
+  if(_num_blocks < 3 || _erase_size > 0x10000UL || _prog_size > CHUNK_SIZE || (_prog_size & (_prog_size - 1)) != 0) return false;
+  if(_erase_size < (_header_size + 2 * align(RECORD_HEADER_SIZE + MAX_KEY_SIZE + MAX_VALUE_SIZE))) return false;
+  if((_flash.blockCount() < _first_block) || (_flash.blockCount() - _first_block) < _num_blocks) return false;
+  if(_index_capacity < 2) return false;
+
+  clearIndex();
+  _head        = NO_BLOCK;
+  _tail        = NO_BLOCK;
+  _num_used    = 0;
+  _seq         = 0;
+  _head_offset = 0;
+
+  /* The newest block of the log carries the highest sequence number */
+  for(uint16_t b = 0; b < _num_blocks; b++)
+  {
+    uint32_t seq = 0;
+    if((readBlockHeader(b, seq) == BlockState::Valid) && ((_head == NO_BLOCK) || (seq > _seq))) {
+      _head = b;
+      _seq  = seq;
+    }
+  }
+
+  if(_head == NO_BLOCK) {
+    _is_mounted = true;
+    return true;
+  }
+
+  /* Blocks are allocated in circular order with consecutive sequence
+   * numbers, the log extends backwards from the head as long as this holds.
+   */
+  _tail     = _head;
+  _num_used = 1;
+  for(uint32_t tail_seq = _seq; _num_used < _num_blocks; tail_seq--)
+  {
+    uint16_t const prev = (_tail + _num_blocks - 1) % _num_blocks;
+    uint32_t       seq  = 0;
+    if((readBlockHeader(prev, seq) != BlockState::Valid) || (seq != (tail_seq - 1))) break;
+    _tail = prev;
+    _num_used++;
+  }
+
+  for(uint16_t b = _tail, n = 0; n < _num_used; b = next(b), n++)
+  {
+    uint32_t end = 0;
+    if(!scanBlock(b, end)) return false;
+
+    /* Only the head can contain a record torn by a power failure, it is not
+     * appended to unless the remainder of the block is still erased.
+     */
+    if(b == _head) {
+      _head_offset = isErased(b, end) ? end : _erase_size;
+    }
+  }
+
+  _is_mounted = true;
+  return true;
+}
+
+bool NorKvStore::put(char const * key, void const * value, uint16_t const size)
+{
+  size_t const key_size = strlen(key);
+  if(!_is_mounted || key_size == 0 || key_size > MAX_KEY_SIZE || size > MAX_VALUE_SIZE) return false;
+
+  uint8_t  const * key_buf   = reinterpret_cast<uint8_t const *>(key);
+  uint16_t const   hash      = hashOf(key_buf, static_cast<uint8_t>(key_size));
+  uint16_t const   rec_size  = static_cast<uint16_t>(align(RECORD_HEADER_SIZE + key_size + size));
+  uint16_t         slot      = 0;
+  bool     const   is_update = lookup(key_buf, static_cast<uint8_t>(key_size), hash, slot);
+
+  if(!is_update && (_num_keys + 1) >= _index_capacity) return false;
+
+  uint32_t const old_size = is_update ? _index[slot].size : 0;
+  if((_live_bytes - old_size + rec_size) > capacity()) return false;
+
+  uint16_t block = 0, offset = 0;
+  if(!writeRecord(RECORD_TYPE_VALUE, key_buf, static_cast<uint8_t>(key_size), reinterpret_cast<uint8_t const *>(value), size, block, offset)) return false;
+
+  /* Compaction only relocates entries, the slot is still valid */
+  _index[slot].hash   = hash;
+  _index[slot].block  = block;
+  _index[slot].offset = offset;
+  _index[slot].size   = rec_size;
+
+  _live_bytes = _live_bytes - old_size + rec_size;
+  if(!is_update) _num_keys++;
+
+  return true;
+}
+
+int32_t NorKvStore::get(char const * key, void * value, uint16_t const size)
+{
+  size_t const key_size = strlen(key);
+  if(!_is_mounted || key_size == 0 || key_size > MAX_KEY_SIZE) return -1;
+
+  uint8_t const * key_buf = reinterpret_cast<uint8_t const *>(key);
+  uint16_t        slot    = 0;
+  if(!lookup(key_buf, static_cast<uint8_t>(key_size), hashOf(key_buf, static_cast<uint8_t>(key_size)), slot)) return -1;
+
+  NorKvIndexEntry const & entry = _index[slot];
+
+  uint8_t hdr[RECORD_HEADER_SIZE];
+  if(!_flash.read(_first_block + entry.block, entry.offset, hdr, RECORD_HEADER_SIZE)) return -1;
+
+  uint16_t const value_size = static_cast<uint16_t>(hdr[2]) | (static_cast<uint16_t>(hdr[3]) << 8);
+  uint16_t const read_size  = (value_size < size) ? value_size : size;
+
+  if(read_size > 0) {
+    if(!_flash.read(_first_block + entry.block, entry.offset + RECORD_HEADER_SIZE + key_size, reinterpret_cast<uint8_t *>(value), read_size)) return -1;
+  }
+
+  return value_size;
+}
+
+bool NorKvStore::remove(char const * key)
+{
+  size_t const key_size = strlen(key);
+  if(!_is_mounted || key_size == 0 || key_size > MAX_KEY_SIZE) return false;
+
+  uint8_t  const * key_buf = reinterpret_cast<uint8_t const *>(key);
+  uint16_t const   hash    = hashOf(key_buf, static_cast<uint8_t>(key_size));
+  uint16_t         slot    = 0;
+  if(!lookup(key_buf, static_cast<uint8_t>(key_size), hash, slot)) return false;
+
+  /* The tombstone shadows older records of the key until they are compacted */
+  uint16_t block = 0, offset = 0;
+  if(!writeRecord(RECORD_TYPE_TOMBSTONE, key_buf, static_cast<uint8_t>(key_size), nullptr, 0, block, offset)) return false;
+
+  _live_bytes -= _index[slot].size;
+  _num_keys--;
+  eraseSlot(slot);
+
+  return true;
+}
+
+uint32_t NorKvStore::capacity() const
+{
+  /* Two blocks are kept free for compaction, the end of every block may
+   * remain unused if the next record does not fit anymore.
+   */
+  uint32_t const payload = _erase_size - _header_size - align(RECORD_HEADER_SIZE + MAX_KEY_SIZE + MAX_VALUE_SIZE);
+  return static_cast<uint32_t>(_num_blocks - MIN_FREE_BLOCKS) * payload;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+NorKvStore::BlockState NorKvStore::readBlockHeader(uint16_t const block, uint32_t & seq)
+{
+  uint8_t hdr[BLOCK_HEADER_SIZE];
+  if(!_flash.read(_first_block + block, 0, hdr, BLOCK_HEADER_SIZE)) return BlockState::Invalid;
+
+  if(isAllErased(hdr, BLOCK_HEADER_SIZE)) return BlockState::Erased;
+  if(get32(hdr) != BLOCK_MAGIC)           return BlockState::Invalid;
+  if(get32(hdr + 8) != crc32(CRC32_INIT, hdr, 8)) return BlockState::Invalid;
+
+  seq = get32(hdr + 4);
+  return BlockState::Valid;
+}
+
+bool NorKvStore::scanBlock(uint16_t const block, uint32_t & end)
+{
+  uint32_t offset = _header_size;
+
+  for(;;)
+  {
+    end = offset;
+    if((offset + RECORD_HEADER_SIZE) > _erase_size) return true;
+
+    uint8_t hdr[RECORD_HEADER_SIZE];
+    if(!_flash.read(_first_block + block, offset, hdr, RECORD_HEADER_SIZE)) return false;
+
+    if(isAllErased(hdr, RECORD_HEADER_SIZE)) return true;
+
+    uint8_t  const key_size   = hdr[0];
+    uint8_t  const type       = hdr[1];
+    uint16_t const value_size = static_cast<uint16_t>(hdr[2]) | (static_cast<uint16_t>(hdr[3]) << 8);
+    uint32_t const rec_size   = align(RECORD_HEADER_SIZE + key_size + value_size);
+
+    bool const is_header_valid = (key_size > 0) && (key_size <= MAX_KEY_SIZE) && (value_size <= MAX_VALUE_SIZE) &&
+                                 ((type == RECORD_TYPE_VALUE) || (type == RECORD_TYPE_TOMBSTONE && value_size == 0)) &&
+                                 ((offset + rec_size) <= _erase_size);
+
+    /* Nothing is ever appended behind a damaged record */
+    end = _erase_size;
+    if(!is_header_valid) return true;
+
+    uint8_t key[MAX_KEY_SIZE];
+    if(!_flash.read(_first_block + block, offset + RECORD_HEADER_SIZE, key, key_size)) return false;
+
+    uint32_t crc = crc32(CRC32_INIT, hdr, 4);
+    crc = crc32(crc, key, key_size);
+    for(uint16_t pos = 0; pos < value_size; )
+    {
+      uint8_t        chunk[CHUNK_SIZE];
+      uint16_t const chunk_size = ((value_size - pos) < CHUNK_SIZE) ? (value_size - pos) : CHUNK_SIZE;
+      if(!_flash.read(_first_block + block, offset + RECORD_HEADER_SIZE + key_size + pos, chunk, chunk_size)) return false;
+      crc = crc32(crc, chunk, chunk_size);
+      pos += chunk_size;
+    }
+
+    if(crc != get32(hdr + 4)) return true;
+
+    uint16_t const hash      = hashOf(key, key_size);
+    uint16_t       slot      = 0;
+    bool     const is_update = lookup(key, key_size, hash, slot);
+
+    if(type == RECORD_TYPE_TOMBSTONE)
+    {
+      if(is_update) {
+        _live_bytes -= _index[slot].size;
+        _num_keys--;
+        eraseSlot(slot);
+      }
+    }
+    else
+    {
+      if(is_update) {
+        _live_bytes -= _index[slot].size;
+      } else {
+        if((_num_keys + 1) >= _index_capacity) return false;
+        _num_keys++;
+      }
+      _index[slot].hash   = hash;
+      _index[slot].block  = block;
+      _index[slot].offset = static_cast<uint16_t>(offset);
+      _index[slot].size   = static_cast<uint16_t>(rec_size);
+      _live_bytes += rec_size;
+    }
+
+    offset += rec_size;
+  }
+}
+
+bool NorKvStore::isErased(uint16_t const block, uint32_t const offset)
+{
+  for(uint32_t pos = offset; pos < _erase_size; )
+  {
+    uint8_t        chunk[CHUNK_SIZE];
+    uint32_t const chunk_size = ((_erase_size - pos) < CHUNK_SIZE) ? (_erase_size - pos) : CHUNK_SIZE;
+    if(!_flash.read(_first_block + block, pos, chunk, chunk_size)) return false;
+    if(!isAllErased(chunk, chunk_size)) return false;
+    pos += chunk_size;
+  }
+  return true;
+}
+
+bool NorKvStore::openBlock()
+{
+  if(!_is_compacting)
+  {
+    for(uint16_t n = 0; (freeBlocks() < MIN_FREE_BLOCKS) && (n < _num_blocks); n++) {
+      if(!compactTail()) return false;
+    }
+    if(freeBlocks() < MIN_FREE_BLOCKS) return false;
+  }
+
+  if(freeBlocks() == 0) return false;
+
+  /* Compacted blocks have been erased already, reading a block is much
+   * cheaper than erasing it once more.
+   */
+  uint16_t const block = (_head == NO_BLOCK) ? 0 : next(_head);
+  if(!isErased(block, 0) && !_flash.erase(_first_block + block)) return false;
+
+  uint8_t hdr[CHUNK_SIZE];
+  memset(hdr, 0xFF, sizeof(hdr));
+  put32(hdr,     BLOCK_MAGIC);
+  put32(hdr + 4, _seq + 1);
+  put32(hdr + 8, crc32(CRC32_INIT, hdr, 8));
+  if(!_flash.prog(_first_block + block, 0, hdr, _header_size)) return false;
+
+  if(_head == NO_BLOCK) _tail = block;
+  _head        = block;
+  _head_offset = _header_size;
+  _seq++;
+  _num_used++;
+
+  return true;
+}
+
+bool NorKvStore::reserve(uint32_t const size)
+{
+  if((_head == NO_BLOCK) || ((_head_offset + size) > _erase_size)) {
+    return openBlock();
+  }
+  return true;
+}
+
+bool NorKvStore::compactTail()
+{
+  uint16_t const block = _tail;
+
+  _is_compacting = true;
+  for(uint16_t i = 0; i < _index_capacity; i++)
+  {
+    if((_index[i].block == block) && !copyRecord(_index[i])) {
+      _is_compacting = false;
+      return false;
+    }
+  }
+  _is_compacting = false;
+
+  /* Clearing the header first ensures that an interrupted erase never
+   * leaves a block behind which still looks like part of the log.
+   */
+  uint8_t zero[CHUNK_SIZE];
+  memset(zero, 0, sizeof(zero));
+  if(!_flash.prog (_first_block + block, 0, zero, _header_size)) return false;
+  if(!_flash.erase(_first_block + block)) return false;
+
+  _tail = next(block);
+  _num_used--;
+  _num_compactions++;
+
+  return true;
+}
+
+bool NorKvStore::writeRecord(uint8_t const flags, uint8_t const * key, uint8_t const key_size, uint8_t const * value, uint16_t const value_size, uint16_t & block, uint16_t & offset)
+{
+  uint32_t const rec_size = align(RECORD_HEADER_SIZE + key_size + value_size);
+  if(!reserve(rec_size)) return false;
+
+  uint8_t hdr[RECORD_HEADER_SIZE];
+  hdr[0] = key_size;
+  hdr[1] = flags;
+  hdr[2] = static_cast<uint8_t>(value_size);
+  hdr[3] = static_cast<uint8_t>(value_size >> 8);
+
+  uint32_t crc = crc32(CRC32_INIT, hdr, 4);
+  crc = crc32(crc, key, key_size);
+  crc = crc32(crc, value, value_size);
+  put32(hdr + 4, crc);
+
+  /* The record is assembled in RAM and programmed with a single prog() */
+  uint8_t rec[RECORD_BUF_SIZE];
+  memset(rec, 0xFF, rec_size);
+  memcpy(rec,                                 hdr,   RECORD_HEADER_SIZE);
+  memcpy(rec + RECORD_HEADER_SIZE,            key,   key_size);
+  if(value_size > 0) {
+    memcpy(rec + RECORD_HEADER_SIZE + key_size, value, value_size);
+  }
+
+  if(!_flash.prog(_first_block + _head, _head_offset, rec, rec_size)) return false;
+
+  block  = _head;
+  offset = static_cast<uint16_t>(_head_offset);
+
+  _head_offset += rec_size;
+  return true;
+}
+
+bool NorKvStore::copyRecord(NorKvIndexEntry & entry)
+{
+  if(!reserve(entry.size)) return false;
+
+  uint8_t rec[RECORD_BUF_SIZE];
+  if(!_flash.read(_first_block + entry.block, entry.offset, rec, entry.size)) return false;
+  if(!_flash.prog(_first_block + _head, _head_offset, rec, entry.size)) return false;
+
+  entry.block   = _head;
+  entry.offset  = static_cast<uint16_t>(_head_offset);
+  _head_offset += entry.size;
+
+  return true;
+}
+
+bool NorKvStore::lookup(uint8_t const * key, uint8_t const key_size, uint16_t const hash, uint16_t & slot)
+{
+  for(uint16_t n = 0, i = hash % _index_capacity; n < _index_capacity; n++, i = (i + 1) % _index_capacity)
+  {
+    NorKvIndexEntry const & entry = _index[i];
+
+    if(entry.block == NO_BLOCK) {
+      slot = i;
+      return false;
+    }
+
+    if(entry.hash != hash) continue;
+
+    uint8_t hdr[RECORD_HEADER_SIZE + MAX_KEY_SIZE];
+    if(!_flash.read(_first_block + entry.block, entry.offset, hdr, RECORD_HEADER_SIZE + key_size)) continue;
+
+    if((hdr[0] == key_size) && (memcmp(hdr + RECORD_HEADER_SIZE, key, key_size) == 0)) {
+      slot = i;
+      return true;
+    }
+  }
+
+  /* Unreachable as long as the index is never filled completely */
+  slot = 0;
+  return false;
+}
+
+void NorKvStore::eraseSlot(uint16_t slot)
+{
+  /* Backward shift deletion keeps the probe sequences intact without tombstones */
+  for(uint16_t i = (slot + 1) % _index_capacity; _index[i].block != NO_BLOCK; i = (i + 1) % _index_capacity)
+  {
+    uint16_t const home = _index[i].hash % _index_capacity;
+
+    bool const is_movable = (slot <= i) ? ((home <= slot) || (home > i))
+                                        : ((home <= slot) && (home > i));
+    if(is_movable) {
+      _index[slot] = _index[i];
+      slot         = i;
+    }
+  }
+
+  _index[slot].block = NO_BLOCK;
+}
+
+void NorKvStore::clearIndex()
+{
+  for(uint16_t i = 0; i < _index_capacity; i++) {
+    _index[i].block = NO_BLOCK;
+  }
+  _num_keys   = 0;
+  _live_bytes = 0;
+}
+
+uint16_t NorKvStore::hashOf(uint8_t const * key, uint8_t const key_size)
+{
+  /* FNV-1a, folded to 16 bit */
+  uint32_t hash = 2166136261UL;
+  for(uint8_t i = 0; i < key_size; i++) {
+    hash ^= key[i];
+    hash *= 16777619UL;
+  }
+  return static_cast<uint16_t>(hash ^ (hash >> 16));
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
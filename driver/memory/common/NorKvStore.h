@@ -0,0 +1,167 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_NORKVSTORE_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_NORKVSTORE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "NorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+/* Location of the most recent record of a key, the storage for the index
+ * is provided by the application (8 bytes per entry).
+ */
+typedef struct
+{
+  uint16_t hash;
+  uint16_t block;
+  uint16_t offset;
+  uint16_t size;
+} NorKvIndexEntry;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Log-structured key-value store within the erase blocks [first_block,
+ * first_block + num_blocks) of a NOR flash.
+ *
+ * Every put()/remove() appends a record (key, value and a CRC-32 over both)
+ * to the newest block of the log. A record is committed as soon as it has
+ * been programmed completely: a record torn by a power failure does not
+ * match its CRC and is ignored, like everything after it within the same
+ * block. The log wraps around the reserved blocks, once fewer than two
+ * blocks are free the oldest block is compacted - records still referenced
+ * by the index are copied to the head of the log, then the block is erased.
+ * As blocks are always allocated in the same circular order, every block
+ * is erased equally often (wear leveling), static data included.
+ *
+ * A RAM hash index (linear probing) maps the keys to their latest record,
+ * mount() rebuilds it by scanning the block headers and records from the
+ * oldest to the newest block. The index should be sized to about twice the
+ * number of keys.
+ *
+ * Limits: num_blocks >= 3, eraseSize() <= 64 kB, progSize() <= MAX_PROG_SIZE (power of 2).
+ */
+class NorKvStore
+{
+
+public:
+
+  static uint8_t  constexpr MAX_KEY_SIZE   = 32;
+  static uint16_t constexpr MAX_VALUE_SIZE = 128;
+  static uint16_t constexpr MAX_PROG_SIZE  = 32;
+
+
+           NorKvStore(interface::NorFlash       & flash,
+                      uint32_t            const   first_block,
+                      uint16_t            const   num_blocks,
+                      NorKvIndexEntry           * index,
+                      uint16_t            const   index_capacity);
+  virtual ~NorKvStore();
+
+
+  bool     format();
+  bool     mount ();
+
+  bool     put   (char const * key, void const * value, uint16_t const size);
+  /* Returns the size of the value (which may exceed size) or -1 if the key does not exist */
+  int32_t  get   (char const * key, void       * value, uint16_t const size);
+  bool     remove(char const * key);
+
+
+  inline uint16_t numKeys       () const { return _num_keys; }
+  inline uint32_t liveBytes     () const { return _live_bytes; }
+  inline uint32_t numCompactions() const { return _num_compactions; }
+         uint32_t capacity      () const;
+
+private:
+
+  static uint16_t constexpr NO_BLOCK        = 0xFFFF;
+  static uint16_t constexpr CHUNK_SIZE      = MAX_PROG_SIZE;
+  static uint16_t constexpr MIN_FREE_BLOCKS = 2;
+  static uint16_t constexpr RECORD_BUF_SIZE = (8 + MAX_KEY_SIZE + MAX_VALUE_SIZE + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1); /* largest record, aligned */
+
+  interface::NorFlash & _flash;
+  uint32_t              _first_block;
+  uint16_t              _num_blocks;
+  NorKvIndexEntry     * _index;
+  uint16_t              _index_capacity;
+  uint32_t              _erase_size;
+  uint16_t              _prog_size,
+                        _header_size;
+  bool                  _is_mounted,
+                        _is_compacting;
+  uint16_t              _head,
+                        _tail,
+                        _num_used;
+  uint32_t              _seq;
+  uint32_t              _head_offset;
+  uint16_t              _num_keys;
+  uint32_t              _live_bytes;
+  uint32_t              _num_compactions;
+
+  enum class BlockState
+  {
+    Erased,
+    Valid,
+    Invalid
+  };
+
+  inline uint16_t next      (uint16_t const block) const { return (block + 1) % _num_blocks; }
+  inline uint16_t freeBlocks() const { return _num_blocks - _num_used; }
+  inline uint32_t align     (uint32_t const size) const { return (size + _prog_size - 1) & ~static_cast<uint32_t>(_prog_size - 1); }
+
+  BlockState readBlockHeader(uint16_t const block, uint32_t & seq);
+  bool       scanBlock      (uint16_t const block, uint32_t & end);
+  bool       isErased       (uint16_t const block, uint32_t const offset);
+
+  bool       openBlock      ();
+  bool       reserve        (uint32_t const size);
+  bool       compactTail    ();
+  bool       writeRecord    (uint8_t const flags, uint8_t const * key, uint8_t const key_size, uint8_t const * value, uint16_t const value_size, uint16_t & block, uint16_t & offset);
+  bool       copyRecord     (NorKvIndexEntry & entry);
+
+  bool       lookup         (uint8_t const * key, uint8_t const key_size, uint16_t const hash, uint16_t & slot);
+  void       eraseSlot      (uint16_t slot);
+  void       clearIndex     ();
+
+  static uint16_t hashOf    (uint8_t const * key, uint8_t const key_size);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_NORKVSTORE_H_ */
@@ -0,0 +1,241 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "NorReadCache.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+NorReadCache::NorReadCache(interface::NorFlash       & flash,
+                           uint8_t                   * line_buffer,
+                           NorReadCacheTag           * tags,
+                           uint16_t            const   num_lines,
+                           uint16_t            const   line_size,
+                           uint16_t            const   prefetch_lines)
+: _flash          (flash                         ),
+  _line_buffer    (line_buffer                   ),
+  _tags           (tags                          ),
+  _num_lines      (num_lines                     ),
+  _line_size      (line_size                     ),
+  _prefetch_lines (prefetch_lines                ),
+  _lines_per_block(flash.eraseSize() / line_size ),
+  _stamp          (0                             ),
+  _next_addr      (NO_LINE                       )
+{
+  invalidate();
+  resetCounters();
+}
+
+NorReadCache::~NorReadCache()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool NorReadCache::read(uint32_t const block, uint32_t const off, uint8_t * buf, uint32_t const size)
+{
+  if(size == 0) return true;
+
+  uint32_t const addr       = block * _flash.eraseSize() + off;
+  uint32_t const first_line = addr / _line_size;
+  uint32_t const last_line  = (addr + size - 1) / _line_size;
+  bool     const is_seq     = (addr == _next_addr);
+
+  _next_addr = addr + size;
+
+  /* Large reads would only evict the cache */
+  if((last_line - first_line + 1) >= _num_lines) {
+    _num_flash_reads++;
+    return _flash.read(block, off, buf, size);
+  }
+
+  for(uint32_t line = first_line; line <= last_line; )
+  {
+    uint16_t slot      = 0;
+    uint32_t num_lines = 1;
+
+    int32_t const cached_slot = lookup(line);
+    if(cached_slot >= 0)
+    {
+      slot = static_cast<uint16_t>(cached_slot);
+      _tags[slot].stamp = ++_stamp;
+      _num_hits++;
+    }
+    else
+    {
+      /* Fetch all consecutive missing lines of the request within the same
+       * block at once, followed by the read-ahead for a sequential scan.
+       */
+      uint32_t const block_end_line = (line / _lines_per_block + 1) * _lines_per_block;
+
+      while(((line + num_lines) <= last_line) && ((line + num_lines) < block_end_line) && (lookup(line + num_lines) < 0)) {
+        num_lines++;
+      }
+
+      uint32_t num_prefetch = 0;
+      if(is_seq && ((line + num_lines) == (last_line + 1)))
+      {
+        while((num_prefetch < _prefetch_lines) &&
+              ((num_lines + num_prefetch) < _num_lines) &&
+              ((line + num_lines + num_prefetch) < block_end_line) &&
+              (lookup(line + num_lines + num_prefetch) < 0))
+        {
+          num_prefetch++;
+        }
+      }
+
+      if(!fill(line, static_cast<uint16_t>(num_lines + num_prefetch), slot)) return false;
+
+      _num_misses           += num_lines;
+      _num_prefetched_lines += num_prefetch;
+    }
+
+    /* Copy the requested part of the lines [line, line + num_lines) which are located in consecutive slots */
+    uint32_t const line_addr = line * _line_size;
+    uint32_t const from      = (addr > line_addr) ? addr : line_addr;
+    uint32_t const end_addr  = line_addr + num_lines * _line_size;
+    uint32_t const to        = ((addr + size) < end_addr) ? (addr + size) : end_addr;
+
+    memcpy(buf + (from - addr), lineData(slot) + (from - line_addr), to - from);
+
+    line += num_lines;
+  }
+
+  return true;
+}
+
+bool NorReadCache::prog(uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size)
+{
+  if(size > 0) {
+    uint32_t const addr = block * _flash.eraseSize() + off;
+    invalidateRange(addr / _line_size, (addr + size - 1) / _line_size);
+  }
+  return _flash.prog(block, off, buf, size);
+}
+
+bool NorReadCache::erase(uint32_t const block)
+{
+  invalidateRange(block * _lines_per_block, (block + 1) * _lines_per_block - 1);
+  return _flash.erase(block);
+}
+
+void NorReadCache::invalidate()
+{
+  for(uint16_t s = 0; s < _num_lines; s++) {
+    _tags[s].line  = NO_LINE;
+    _tags[s].stamp = 0;
+  }
+}
+
+void NorReadCache::resetCounters()
+{
+  _num_hits             = 0;
+  _num_misses           = 0;
+  _num_prefetched_lines = 0;
+  _num_flash_reads      = 0;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+int32_t NorReadCache::lookup(uint32_t const line) const
+{
+  for(uint16_t s = 0; s < _num_lines; s++) {
+    if(_tags[s].line == line) return s;
+  }
+  return -1;
+}
+
+uint16_t NorReadCache::victim(uint16_t const num_slots) const
+{
+  /* The window of adjacent slots whose most recent access is the oldest,
+   * invalid slots have a stamp of 0 and are therefore preferred.
+   */
+  uint16_t best_slot  = 0;
+  uint32_t best_stamp = 0xFFFFFFFF;
+
+  for(uint16_t s = 0; (s + num_slots) <= _num_lines; s++)
+  {
+    uint32_t max_stamp = 0;
+    for(uint16_t i = 0; i < num_slots; i++) {
+      if(_tags[s + i].stamp > max_stamp) max_stamp = _tags[s + i].stamp;
+    }
+    if(max_stamp < best_stamp) {
+      best_stamp = max_stamp;
+      best_slot  = s;
+    }
+  }
+
+  return best_slot;
+}
+
+bool NorReadCache::fill(uint32_t const line, uint16_t const num_slots, uint16_t & slot)
+{
+  slot = victim(num_slots);
+
+  for(uint16_t i = 0; i < num_slots; i++) {
+    _tags[slot + i].line  = NO_LINE;
+    _tags[slot + i].stamp = 0;
+  }
+
+  _num_flash_reads++;
+  if(!_flash.read(line / _lines_per_block, (line % _lines_per_block) * _line_size, lineData(slot), static_cast<uint32_t>(num_slots) * _line_size)) {
+    return false;
+  }
+
+  for(uint16_t i = 0; i < num_slots; i++) {
+    _tags[slot + i].line  = line + i;
+    _tags[slot + i].stamp = ++_stamp;
+  }
+
+  return true;
+}
+
+void NorReadCache::invalidateRange(uint32_t const first_line, uint32_t const last_line)
+{
+  for(uint16_t s = 0; s < _num_lines; s++) {
+    if((_tags[s].line >= first_line) && (_tags[s].line <= last_line)) {
+      _tags[s].line  = NO_LINE;
+      _tags[s].stamp = 0;
+    }
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,134 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_NORREADCACHE_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_NORREADCACHE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "NorFlash.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+/* Tag of a cache line, the storage for the tags is provided by the
+ * application (8 bytes per line).
+ */
+typedef struct
+{
+  uint32_t line;  /* (block * eraseSize() + offset) / line size */
+  uint32_t stamp; /* time of the last access, for LRU replacement */
+} NorReadCacheTag;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Read cache of num_lines lines of line_size bytes in front of a NOR
+ * flash, e.g. memory::N25Q256A::N25Q256A via NorFlashDriverAdapter. Reads
+ * are served from the cache, missing lines are fetched with a single read()
+ * per run of consecutive missing lines. The least recently used lines are
+ * replaced, a run of lines replaces the group of adjacent lines whose most
+ * recent access is oldest.
+ *
+ * A read() starting where the previous one ended is treated as sequential
+ * access: up to prefetch_lines lines beyond the requested ones are fetched
+ * with the same flash read (read-ahead), the next reads of the scan are
+ * then served from RAM. Reads spanning at least num_lines lines bypass the
+ * cache.
+ *
+ * prog() and erase() are passed through and invalidate the affected lines.
+ * line_size must be a multiple of readSize() dividing eraseSize(),
+ * prefetch_lines should be smaller than num_lines.
+ */
+class NorReadCache : public interface::NorFlash
+{
+
+public:
+
+           NorReadCache(interface::NorFlash       & flash,
+                        uint8_t                   * line_buffer,
+                        NorReadCacheTag           * tags,
+                        uint16_t            const   num_lines,
+                        uint16_t            const   line_size,
+                        uint16_t            const   prefetch_lines);
+  virtual ~NorReadCache();
+
+
+  virtual uint32_t readSize  () const override { return _flash.readSize(); }
+  virtual uint32_t progSize  () const override { return _flash.progSize(); }
+  virtual uint32_t eraseSize () const override { return _flash.eraseSize(); }
+  virtual uint32_t blockCount() const override { return _flash.blockCount(); }
+
+  virtual bool     read      (uint32_t const block, uint32_t const off, uint8_t       * buf, uint32_t const size) override;
+  virtual bool     prog      (uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size) override;
+  virtual bool     erase     (uint32_t const block) override;
+
+
+         void     invalidate        ();
+
+  inline uint32_t numHits           () const { return _num_hits; }
+  inline uint32_t numMisses         () const { return _num_misses; }
+  inline uint32_t numPrefetchedLines() const { return _num_prefetched_lines; }
+  inline uint32_t numFlashReads     () const { return _num_flash_reads; }
+         void     resetCounters     ();
+
+private:
+
+  static uint32_t constexpr NO_LINE = 0xFFFFFFFF;
+
+  interface::NorFlash & _flash;
+  uint8_t             * _line_buffer;
+  NorReadCacheTag     * _tags;
+  uint16_t              _num_lines,
+                        _line_size,
+                        _prefetch_lines;
+  uint32_t              _lines_per_block;
+  uint32_t              _stamp;
+  uint32_t              _next_addr;
+  uint32_t              _num_hits,
+                        _num_misses,
+                        _num_prefetched_lines,
+                        _num_flash_reads;
+
+  inline uint8_t * lineData(uint16_t const slot) { return _line_buffer + static_cast<uint32_t>(slot) * _line_size; }
+
+  int32_t  lookup         (uint32_t const line) const;
+  uint16_t victim         (uint16_t const num_slots) const;
+  bool     fill           (uint32_t const line, uint16_t const num_slots, uint16_t & slot);
+  void     invalidateRange(uint32_t const first_line, uint32_t const last_line);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_NORREADCACHE_H_ */
@@ -0,0 +1,88 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "PCF8570BlockIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+PCF8570BlockIo::PCF8570BlockIo(uint8_t                   const   i2c_address,
+                               hal::interface::I2cMaster       & i2c_master)
+: _i2c_address(i2c_address),
+  _i2c_master (i2c_master )
+{
+
+}
+
+PCF8570BlockIo::~PCF8570BlockIo()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool PCF8570BlockIo::read(uint8_t const addr, uint8_t * buf, uint16_t const size)
+{
+  if(size > (PCF8570_SIZE - addr)) return false;
+  if(size == 0)                    return true;
+
+  if(!_i2c_master.begin(_i2c_address, false) || !_i2c_master.write(addr)) {
+    _i2c_master.end();
+    return false;
+  }
+  return _i2c_master.requestFrom(_i2c_address, buf, size);
+}
+
+bool PCF8570BlockIo::write(uint8_t const addr, uint8_t const * buf, uint16_t const size)
+{
+  if(size > (PCF8570_SIZE - addr)) return false;
+  if(size == 0)                    return true;
+
+  if(!_i2c_master.begin(_i2c_address, false)) {
+    _i2c_master.end();
+    return false;
+  }
+
+  bool success = _i2c_master.write(addr);
+  for(uint16_t i = 0; success && (i < size); i++) {
+    success = _i2c_master.write(buf[i]);
+  }
+
+  _i2c_master.end();
+  return success;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,80 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_PCF8570BLOCKIO_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_PCF8570BLOCKIO_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/i2c/I2cMaster.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t constexpr PCF8570_SIZE = 256;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Block access to the 256 byte static RAM of the PCF8570. The PCF8570
+ * increments its word address after every byte, read() and write()
+ * therefore transfer any range [addr, addr + size) within a single I2C
+ * transaction - one word address byte followed by the data - instead of
+ * addressing each chunk separately.
+ */
+class PCF8570BlockIo
+{
+
+public:
+
+           PCF8570BlockIo(uint8_t                   const   i2c_address,
+                          hal::interface::I2cMaster       & i2c_master);
+  virtual ~PCF8570BlockIo();
+
+
+  /* Return false if the range exceeds the RAM or the PCF8570 does not acknowledge */
+  bool read (uint8_t const addr, uint8_t       * buf, uint16_t const size);
+  bool write(uint8_t const addr, uint8_t const * buf, uint16_t const size);
+
+private:
+
+  uint8_t                     _i2c_address;
+  hal::interface::I2cMaster & _i2c_master;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_PCF8570BLOCKIO_H_ */
@@ -0,0 +1,107 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "PCF8570Shadow.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+PCF8570Shadow::PCF8570Shadow(PCF8570BlockIo & io)
+: _io         (io),
+  _dirty_begin(0 ),
+  _dirty_end  (0 ),
+  _num_flushes(0 )
+{
+  memset(_shadow, 0, sizeof(_shadow));
+}
+
+PCF8570Shadow::~PCF8570Shadow()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool PCF8570Shadow::load()
+{
+  _dirty_begin = _dirty_end = 0;
+  return _io.read(0, _shadow, PCF8570_SIZE);
+}
+
+bool PCF8570Shadow::read(uint8_t const addr, uint8_t * buf, uint16_t const size) const
+{
+  if(size > (PCF8570_SIZE - addr)) return false;
+  memcpy(buf, _shadow + addr, size);
+  return true;
+}
+
+bool PCF8570Shadow::write(uint8_t const addr, uint8_t const * buf, uint16_t const size)
+{
+  if(size > (PCF8570_SIZE - addr)) return false;
+
+  for(uint16_t i = 0; i < size; i++)
+  {
+    uint16_t const pos = addr + i;
+    if(_shadow[pos] == buf[i]) continue;
+
+    _shadow[pos] = buf[i];
+
+    if(!isDirty()) {
+      _dirty_begin = pos;
+      _dirty_end   = pos + 1;
+    } else {
+      if(pos <  _dirty_begin) _dirty_begin = pos;
+      if(pos >= _dirty_end  ) _dirty_end   = pos + 1;
+    }
+  }
+
+  return true;
+}
+
+bool PCF8570Shadow::flush()
+{
+  if(!isDirty()) return true;
+
+  if(!_io.write(static_cast<uint8_t>(_dirty_begin), _shadow + _dirty_begin, _dirty_end - _dirty_begin)) return false;
+
+  _dirty_begin = _dirty_end = 0;
+  _num_flushes++;
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,82 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_PCF8570SHADOW_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_PCF8570SHADOW_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "PCF8570BlockIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Write-back copy of the PCF8570 RAM in MCU RAM: read() is served from the
+ * copy, write() only updates the copy and widens the dirty range by the
+ * bytes which actually changed. flush() writes the dirty range within a
+ * single I2C transaction, i.e. any number of small updates between two
+ * flushes costs one bus transaction. Unchanged bytes in between two
+ * updates are written as well, they are identical in both copies.
+ *
+ * load() must be called once before the first access in order to fetch
+ * the current content of the PCF8570.
+ */
+class PCF8570Shadow
+{
+
+public:
+
+           PCF8570Shadow(PCF8570BlockIo & io);
+  virtual ~PCF8570Shadow();
+
+
+  bool     load      ();
+  bool     read      (uint8_t const addr, uint8_t       * buf, uint16_t const size) const;
+  bool     write     (uint8_t const addr, uint8_t const * buf, uint16_t const size);
+  bool     flush     ();
+
+  bool     isDirty   () const { return _dirty_end > _dirty_begin; }
+  uint32_t numFlushes() const { return _num_flushes; }
+
+private:
+
+  PCF8570BlockIo & _io;
+  uint8_t          _shadow[PCF8570_SIZE];
+  uint16_t         _dirty_begin,
+                   _dirty_end;
+  uint32_t         _num_flushes;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_PCF8570SHADOW_H_ */
@@ -0,0 +1,397 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SfdpNorFlash.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t  constexpr SFDP_SIGNATURE[]                = {0x53, 0x46, 0x44, 0x50}; /* "SFDP" */
+static uint16_t constexpr SFDP_PARAM_ID_BFPT              = 0xFF00;
+static uint16_t constexpr SFDP_PARAM_ID_4_BYTE_ADDR_INSTR = 0xFF84;
+static uint8_t  constexpr SFDP_BFPT_MIN_DWORDS            = 9;
+static uint8_t  constexpr SFDP_FAST_READ_DUMMY_CYCLES     = 8;
+static uint32_t constexpr SFDP_3_BYTE_ADDR_LIMIT          = 16UL * 1024UL * 1024UL;
+
+/* BFPT DWORD1 */
+static uint32_t constexpr BFPT_4K_ERASE_bm                = 0x00000003;
+static uint32_t constexpr BFPT_4K_ERASE_SUPPORTED         = 0x00000001;
+static uint32_t constexpr BFPT_WRITE_GRANULARITY_bm       = (1UL<<2);
+static uint32_t constexpr BFPT_READ_1_1_2_bm              = (1UL<<16);
+static uint32_t constexpr BFPT_ADDR_BYTES_bp              = 17;
+static uint32_t constexpr BFPT_ADDR_BYTES_3               = 0;
+static uint32_t constexpr BFPT_ADDR_BYTES_4               = 2;
+static uint32_t constexpr BFPT_READ_DTR_bm                = (1UL<<19);
+static uint32_t constexpr BFPT_READ_1_2_2_bm              = (1UL<<20);
+static uint32_t constexpr BFPT_READ_1_4_4_bm              = (1UL<<21);
+static uint32_t constexpr BFPT_READ_1_1_4_bm              = (1UL<<22);
+/* BFPT DWORD2 */
+static uint32_t constexpr BFPT_DENSITY_POW2_bm            = (1UL<<31);
+/* BFPT DWORD16, bits 31:24 */
+static uint8_t  constexpr BFPT_ENTER_4_BYTE_B7_bm         = (1<<0);
+static uint8_t  constexpr BFPT_ENTER_4_BYTE_WREN_B7_bm    = (1<<1);
+
+/* 4-byte address instruction table DWORD1 */
+static uint32_t constexpr FOUR_BAIT_FAST_READ_bm          = (1UL<<1);
+static uint32_t constexpr FOUR_BAIT_PAGE_PROGRAM_bm       = (1UL<<6);
+static uint32_t constexpr FOUR_BAIT_ERASE_TYPE_bp         = 9;
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SfdpNorFlash::SfdpNorFlash(SpiNorIo & io, hal::interface::Delay & delay)
+: _io                (io   ),
+  _delay             (delay),
+  _is_open           (false),
+  _num_erase_commands(0    )
+{
+  memset(&_info, 0, sizeof(_info));
+}
+
+SfdpNorFlash::~SfdpNorFlash()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool SfdpNorFlash::open()
+{
+  _is_open = false;
+  memset(&_info, 0, sizeof(_info));
+
+  uint8_t header[8];
+  readSfdp(0, header, sizeof(header));
+  if(memcmp(header, SFDP_SIGNATURE, sizeof(SFDP_SIGNATURE)) != 0) return false;
+
+  _info.sfdp_minor_rev = header[4];
+  _info.sfdp_major_rev = header[5];
+
+  /* Locate the basic flash parameter table with the highest minor revision
+   * and the 4-byte address instruction table.
+   */
+  uint16_t const num_param_headers = static_cast<uint16_t>(header[6]) + 1;
+
+  uint32_t bfpt_ptr             = 0,
+           four_bait_ptr        = 0;
+  uint8_t  bfpt_minor_rev       = 0,
+           num_bfpt_dwords      = 0,
+           num_four_bait_dwords = 0;
+
+  for(uint16_t h = 0; h < num_param_headers; h++)
+  {
+    uint8_t param_header[8];
+    readSfdp(sizeof(header) + h * sizeof(param_header), param_header, sizeof(param_header));
+
+    uint16_t const id         = (static_cast<uint16_t>(param_header[7]) << 8) | param_header[0];
+    uint8_t  const minor_rev  = param_header[1];
+    uint8_t  const major_rev  = param_header[2];
+    uint8_t  const num_dwords = param_header[3];
+    uint32_t const ptr        = (static_cast<uint32_t>(param_header[6]) << 16) | (static_cast<uint32_t>(param_header[5]) << 8) | param_header[4];
+
+    if((id == SFDP_PARAM_ID_BFPT) && (major_rev == 1) && (num_dwords >= SFDP_BFPT_MIN_DWORDS) && ((num_bfpt_dwords == 0) || (minor_rev > bfpt_minor_rev)))
+    {
+      bfpt_ptr        = ptr;
+      bfpt_minor_rev  = minor_rev;
+      num_bfpt_dwords = (num_dwords < SFDP_BFPT_MAX_DWORDS) ? num_dwords : SFDP_BFPT_MAX_DWORDS;
+    }
+    else if((id == SFDP_PARAM_ID_4_BYTE_ADDR_INSTR) && (major_rev == 1) && (num_dwords >= 2))
+    {
+      four_bait_ptr        = ptr;
+      num_four_bait_dwords = 2;
+    }
+  }
+
+  if(num_bfpt_dwords == 0) return false;
+
+  uint32_t bfpt     [SFDP_BFPT_MAX_DWORDS];
+  uint32_t four_bait[2];
+
+  readDwords(bfpt_ptr,      bfpt,      num_bfpt_dwords);
+  readDwords(four_bait_ptr, four_bait, num_four_bait_dwords);
+
+  if(!parseBasicFlashParameterTable(bfpt, num_bfpt_dwords))                   return false;
+  if(!selectCommands(bfpt, num_bfpt_dwords, four_bait, num_four_bait_dwords)) return false;
+  sortEraseTypes();
+
+  _is_open = true;
+  return true;
+}
+
+bool SfdpNorFlash::eraseRange(uint32_t const addr, uint32_t const size)
+{
+  if(!_is_open)                                                        return false;
+  if((addr >= _info.flash_size) || (size > (_info.flash_size - addr))) return false;
+  if(((addr % eraseSize()) != 0) || ((size % eraseSize()) != 0))       return false;
+
+  for(uint32_t pos = 0; pos < size; )
+  {
+    /* Largest erase type aligned at the current position which does not exceed the range */
+    uint8_t type = 0;
+    for(uint8_t t = 1; t < _info.num_erase_types; t++)
+    {
+      uint32_t const type_size = _info.erase_type[t].size;
+      if((((addr + pos) % type_size) == 0) && ((size - pos) >= type_size)) type = t;
+    }
+
+    eraseType(type, addr + pos);
+    pos += _info.erase_type[type].size;
+  }
+
+  return true;
+}
+
+uint32_t SfdpNorFlash::eraseSize() const
+{
+  return _is_open ? _info.erase_type[0].size : 0;
+}
+
+uint32_t SfdpNorFlash::blockCount() const
+{
+  return _is_open ? (_info.flash_size / eraseSize()) : 0;
+}
+
+bool SfdpNorFlash::read(uint32_t const block, uint32_t const off, uint8_t * buf, uint32_t const size)
+{
+  if(!_is_open) return false;
+
+  uint32_t const addr = block * eraseSize() + off;
+  if((addr >= _info.flash_size) || (size > (_info.flash_size - addr))) return false;
+
+  _io.read(_info.read_instr, addr, _info.addr_bytes, SFDP_FAST_READ_DUMMY_CYCLES, buf, size);
+  return true;
+}
+
+bool SfdpNorFlash::prog(uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size)
+{
+  if(!_is_open) return false;
+
+  uint32_t const addr = block * eraseSize() + off;
+  if((addr >= _info.flash_size) || (size > (_info.flash_size - addr))) return false;
+
+  for(uint32_t pos = 0; pos < size; )
+  {
+    uint32_t const page_remaining = _info.page_size - ((addr + pos) % _info.page_size);
+    uint32_t const len            = ((size - pos) < page_remaining) ? (size - pos) : page_remaining;
+
+    _io.command(SPI_NOR_CMD_WRITE_ENABLE);
+    _io.write  (_info.prog_instr, addr + pos, _info.addr_bytes, buf + pos, len);
+    waitWhileBusy();
+
+    pos += len;
+  }
+
+  return true;
+}
+
+bool SfdpNorFlash::erase(uint32_t const block)
+{
+  if(!_is_open || (block >= blockCount())) return false;
+  eraseType(0, block * eraseSize());
+  return true;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool SfdpNorFlash::parseBasicFlashParameterTable(uint32_t const * dword, uint8_t const num_dwords)
+{
+  /* Density, either in bits - 1 or as 2^N bits */
+  if(dword[1] & BFPT_DENSITY_POW2_bm)
+  {
+    uint32_t const n = dword[1] & ~BFPT_DENSITY_POW2_bm;
+    if((n < 3) || (n > 34)) return false;
+    _info.flash_size = 1UL << (n - 3);
+  }
+  else
+  {
+    _info.flash_size = (dword[1] >> 3) + 1;
+  }
+
+  /* Page size, rev A and later, otherwise 256 bytes for a write granularity of 64 bytes or more */
+  if(num_dwords >= 11) {
+    _info.page_size = static_cast<uint16_t>(1U << ((dword[10] >> 4) & 0x0F));
+  } else {
+    _info.page_size = (dword[0] & BFPT_WRITE_GRANULARITY_bm) ? 256 : 1;
+  }
+
+  _info.read_modes = ((dword[0] & BFPT_READ_1_1_2_bm) ? SFDP_READ_1_1_2_bm : 0) |
+                     ((dword[0] & BFPT_READ_1_2_2_bm) ? SFDP_READ_1_2_2_bm : 0) |
+                     ((dword[0] & BFPT_READ_1_4_4_bm) ? SFDP_READ_1_4_4_bm : 0) |
+                     ((dword[0] & BFPT_READ_1_1_4_bm) ? SFDP_READ_1_1_4_bm : 0) |
+                     ((dword[0] & BFPT_READ_DTR_bm  ) ? SFDP_READ_DTR_bm   : 0);
+
+  /* Erase types 1 to 4 (DWORD8/9), unused types have a size exponent of 0
+   * and keep their slot until sortEraseTypes() so that the 4-byte address
+   * instruction table can refer to them by number.
+   */
+  for(uint8_t t = 0; t < SFDP_MAX_ERASE_TYPES; t++)
+  {
+    uint32_t const erase_dword   = dword[7 + t / 2];
+    uint8_t  const size_exponent = static_cast<uint8_t>(erase_dword >> (16 * (t % 2)));
+    uint8_t  const instr         = static_cast<uint8_t>(erase_dword >> (16 * (t % 2) + 8));
+
+    if((size_exponent != 0) && (size_exponent < 32)) {
+      _info.erase_type[t].size  = 1UL << size_exponent;
+      _info.erase_type[t].instr = instr;
+    }
+  }
+
+  if((_info.erase_type[0].size == 0) && (_info.erase_type[1].size == 0) && (_info.erase_type[2].size == 0) && (_info.erase_type[3].size == 0))
+  {
+    if((dword[0] & BFPT_4K_ERASE_bm) != BFPT_4K_ERASE_SUPPORTED) return false;
+    _info.erase_type[0].size  = 4096;
+    _info.erase_type[0].instr = static_cast<uint8_t>(dword[0] >> 8);
+  }
+
+  return (_info.page_size > 0);
+}
+
+bool SfdpNorFlash::selectCommands(uint32_t const * bfpt, uint8_t const num_bfpt_dwords, uint32_t const * four_bait, uint8_t const num_four_bait_dwords)
+{
+  uint32_t const addr_mode = (bfpt[0] >> BFPT_ADDR_BYTES_bp) & 0x03;
+
+  _info.read_instr = SPI_NOR_CMD_FAST_READ;
+  _info.prog_instr = SPI_NOR_CMD_PAGE_PROGRAM;
+
+  if((_info.flash_size <= SFDP_3_BYTE_ADDR_LIMIT) && (addr_mode != BFPT_ADDR_BYTES_4)) {
+    _info.addr_bytes = 3;
+    return true;
+  }
+
+  /* The upper part of the flash is not addressable */
+  if(addr_mode == BFPT_ADDR_BYTES_3) return false;
+
+  _info.addr_bytes = 4;
+
+  /* The 4-byte address instructions do not depend on the address mode of the device */
+  if(num_four_bait_dwords >= 2)
+  {
+    bool is_complete = (four_bait[0] & FOUR_BAIT_FAST_READ_bm) && (four_bait[0] & FOUR_BAIT_PAGE_PROGRAM_bm);
+    for(uint8_t t = 0; t < SFDP_MAX_ERASE_TYPES; t++) {
+      if((_info.erase_type[t].size != 0) && !(four_bait[0] & (1UL << (FOUR_BAIT_ERASE_TYPE_bp + t)))) is_complete = false;
+    }
+
+    if(is_complete)
+    {
+      _info.read_instr = SPI_NOR_CMD_4_BYTE_FAST_READ;
+      _info.prog_instr = SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM;
+      for(uint8_t t = 0; t < SFDP_MAX_ERASE_TYPES; t++) {
+        _info.erase_type[t].instr = static_cast<uint8_t>(four_bait[1] >> (8 * t));
+      }
+      return true;
+    }
+  }
+
+  if(addr_mode == BFPT_ADDR_BYTES_4) return true;
+
+  /* Rev B and later list the methods to enter the 4-byte address mode,
+   * WRITE ENABLE followed by ENTER 4-BYTE ADDRESS MODE works for devices
+   * with and without the need for a preceding WRITE ENABLE.
+   */
+  uint8_t const enter_4_byte = (num_bfpt_dwords >= 16) ? static_cast<uint8_t>(bfpt[15] >> 24) : BFPT_ENTER_4_BYTE_WREN_B7_bm;
+
+  if(enter_4_byte & BFPT_ENTER_4_BYTE_WREN_B7_bm) {
+    _io.command(SPI_NOR_CMD_WRITE_ENABLE);
+    _io.command(SPI_NOR_CMD_ENTER_4_BYTE_ADDR);
+  } else if(enter_4_byte & BFPT_ENTER_4_BYTE_B7_bm) {
+    _io.command(SPI_NOR_CMD_ENTER_4_BYTE_ADDR);
+  } else {
+    return false;
+  }
+
+  _info.is_4_byte_addr_mode = true;
+  return true;
+}
+
+void SfdpNorFlash::sortEraseTypes()
+{
+  SfdpEraseType erase_type[SFDP_MAX_ERASE_TYPES];
+  memcpy(erase_type, _info.erase_type, sizeof(erase_type));
+  memset(_info.erase_type, 0, sizeof(_info.erase_type));
+
+  _info.num_erase_types = 0;
+
+  for(uint8_t t = 0; t < SFDP_MAX_ERASE_TYPES; t++)
+  {
+    if(erase_type[t].size == 0) continue;
+
+    uint8_t pos = _info.num_erase_types++;
+    for(; (pos > 0) && (_info.erase_type[pos - 1].size > erase_type[t].size); pos--) {
+      _info.erase_type[pos] = _info.erase_type[pos - 1];
+    }
+    _info.erase_type[pos] = erase_type[t];
+  }
+}
+
+void SfdpNorFlash::readSfdp(uint32_t const addr, uint8_t * buf, uint32_t const size)
+{
+  /* READ SFDP always uses 3 address bytes and 8 dummy cycles */
+  _io.read(SPI_NOR_CMD_READ_SFDP, addr, 3, 8, buf, size);
+}
+
+void SfdpNorFlash::readDwords(uint32_t const addr, uint32_t * dword, uint8_t const num_dwords)
+{
+  for(uint8_t d = 0; d < num_dwords; d++)
+  {
+    uint8_t bytes[4];
+    readSfdp(addr + 4 * d, bytes, sizeof(bytes));
+    dword[d] = (static_cast<uint32_t>(bytes[3]) << 24) | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[1]) << 8) | bytes[0];
+  }
+}
+
+void SfdpNorFlash::eraseType(uint8_t const type, uint32_t const addr)
+{
+  _io.command       (SPI_NOR_CMD_WRITE_ENABLE);
+  _io.commandAddress(_info.erase_type[type].instr, addr, _info.addr_bytes);
+  _num_erase_commands++;
+  waitWhileBusy();
+}
+
+void SfdpNorFlash::waitWhileBusy()
+{
+  for(uint16_t backoff_us = INITIAL_BACKOFF_us; _io.readStatusRegister() & SPI_NOR_STATUS_REG_WIP_bm; )
+  {
+    _delay.delay_us(backoff_us);
+    if(backoff_us < MAX_BACKOFF_us) backoff_us *= 2;
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,157 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_SFDPNORFLASH_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_SFDPNORFLASH_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/delay/Delay.h>
+
+#include "NorFlash.h"
+#include "SpiNorIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr SFDP_MAX_ERASE_TYPES   = 4;
+
+/* Fast read modes announced by the basic flash parameter table */
+static uint8_t constexpr SFDP_READ_1_1_2_bm     = (1<<0);
+static uint8_t constexpr SFDP_READ_1_2_2_bm     = (1<<1);
+static uint8_t constexpr SFDP_READ_1_4_4_bm     = (1<<2);
+static uint8_t constexpr SFDP_READ_1_1_4_bm     = (1<<3);
+static uint8_t constexpr SFDP_READ_DTR_bm       = (1<<4);
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+typedef struct
+{
+  uint32_t size;
+  uint8_t  instr;
+} SfdpEraseType;
+
+typedef struct
+{
+  uint8_t       sfdp_major_rev,
+                sfdp_minor_rev;
+  uint32_t      flash_size;
+  uint16_t      page_size;
+  uint8_t       read_modes;
+  uint8_t       num_erase_types;
+  SfdpEraseType erase_type[SFDP_MAX_ERASE_TYPES]; /* Ascending size */
+  /* Commands selected by open() */
+  uint8_t       addr_bytes;
+  uint8_t       read_instr,
+                prog_instr;
+  bool          is_4_byte_addr_mode;
+} SfdpNorFlashInfo;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Generic serial NOR flash driver configured from the JESD216 Serial Flash
+ * Discoverable Parameters of the device: open() reads the basic flash
+ * parameter table and - if present - the 4-byte address instruction table
+ * and derives flash size, page size and the supported erase sizes and
+ * instructions from them.
+ *
+ * Only single I/O commands are issued, the multi I/O read modes of the
+ * device are reported via SfdpNorFlashInfo::read_modes. Reads use FAST
+ * READ which is valid up to the maximum SCK frequency of the device.
+ * Devices up to 16 MB are addressed with 3 address bytes. Larger devices
+ * use the dedicated 4-byte address instructions if the device lists all
+ * of them, otherwise the normal instructions with 4 address bytes - after
+ * switching to the 4-byte address mode if the device also supports 3-byte
+ * addressing.
+ *
+ * The smallest erase type forms the block of the NorFlash interface,
+ * eraseRange() uses the largest erase type fitting at each position.
+ */
+class SfdpNorFlash : public interface::NorFlash
+{
+
+public:
+
+  static uint16_t constexpr INITIAL_BACKOFF_us = 16;
+  static uint16_t constexpr MAX_BACKOFF_us     = 1024;
+
+
+           SfdpNorFlash(SpiNorIo & io, hal::interface::Delay & delay);
+  virtual ~SfdpNorFlash();
+
+
+  /* Returns false if the device provides no usable SFDP basic flash parameter table */
+  bool                     open            ();
+  SfdpNorFlashInfo const & info            () const { return _info; }
+
+  /* Erases [addr, addr + size) which must be aligned to the smallest erase type */
+  bool                     eraseRange      (uint32_t const addr, uint32_t const size);
+
+  uint32_t                 numEraseCommands() const { return _num_erase_commands; }
+
+
+  virtual uint32_t readSize  () const override { return 1; }
+  virtual uint32_t progSize  () const override { return 1; }
+  virtual uint32_t eraseSize () const override;
+  virtual uint32_t blockCount() const override;
+
+  virtual bool     read      (uint32_t const block, uint32_t const off, uint8_t       * buf, uint32_t const size) override;
+  virtual bool     prog      (uint32_t const block, uint32_t const off, uint8_t const * buf, uint32_t const size) override;
+  virtual bool     erase     (uint32_t const block) override;
+
+private:
+
+  static uint8_t  constexpr SFDP_BFPT_MAX_DWORDS = 16;
+
+  SpiNorIo              & _io;
+  hal::interface::Delay & _delay;
+  bool                    _is_open;
+  SfdpNorFlashInfo        _info;
+  uint32_t                _num_erase_commands;
+
+  bool parseBasicFlashParameterTable(uint32_t const * dword, uint8_t const num_dwords);
+  bool selectCommands               (uint32_t const * bfpt, uint8_t const num_bfpt_dwords, uint32_t const * four_bait, uint8_t const num_four_bait_dwords);
+  void sortEraseTypes               ();
+  void readSfdp                     (uint32_t const addr, uint8_t * buf, uint32_t const size);
+  void readDwords                   (uint32_t const addr, uint32_t * dword, uint8_t const num_dwords);
+  void eraseType                    (uint8_t const type, uint32_t const addr);
+  void waitWhileBusy                ();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_SFDPNORFLASH_H_ */
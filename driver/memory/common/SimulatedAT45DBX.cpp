@@ -0,0 +1,275 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedAT45DBX.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedAT45DBX::SimulatedAT45DBX(uint32_t const spi_clock_Hz, uint8_t const density, bool const is_binary_page_size)
+: _geometry            (                                                                                            ),
+  _status              ((density << AT45DBX_STATUS_REG_DENSITY_bp) | (is_binary_page_size ? AT45DBX_STATUS_REG_PAGE_SIZE_bm : 0)),
+  _data                (nullptr                                                                                     ),
+  _buffer              {nullptr, nullptr                                                                            },
+  _byte_time_ps        (8000000000000ULL / spi_clock_Hz                                                             ),
+  _now_ps              (0                                                                                           ),
+  _busy_until_ps       (0                                                                                           ),
+  _state               (State::Ignore                                                                               ),
+  _instr               (0                                                                                           ),
+  _addr                (0                                                                                           ),
+  _addr_bytes_received (0                                                                                           ),
+  _dummy_bytes_expected(0                                                                                           ),
+  _page                (0                                                                                           ),
+  _offset              (0                                                                                           ),
+  _read_pos            (0                                                                                           ),
+  _reg_pos             (0                                                                                           ),
+  _busy_buffer         (NO_BUFFER                                                                                   )
+{
+  AT45DBXBufferIo::geometryFromStatus(_status, _geometry);
+
+  uint32_t const size = static_cast<uint32_t>(_geometry.num_pages) * _geometry.page_size;
+
+  _data      = new uint8_t[size];
+  _buffer[0] = new uint8_t[_geometry.page_size];
+  _buffer[1] = new uint8_t[_geometry.page_size];
+
+  memset(_data,      0xFF, size);
+  memset(_buffer[0], 0xFF, _geometry.page_size);
+  memset(_buffer[1], 0xFF, _geometry.page_size);
+
+  resetCounters();
+}
+
+SimulatedAT45DBX::~SimulatedAT45DBX()
+{
+  delete[] _data;
+  delete[] _buffer[0];
+  delete[] _buffer[1];
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedAT45DBX::resetCounters()
+{
+  _num_page_programs    = 0;
+  _num_buffer_conflicts = 0;
+}
+
+uint8_t SimulatedAT45DBX::exchange(uint8_t const data)
+{
+  _now_ps += _byte_time_ps;
+
+  switch(_state)
+  {
+  case State::Instruction:
+  {
+    onInstruction(data);
+    return 0xFF;
+  }
+  case State::Address:
+  {
+    _addr = (_addr << 8) | data;
+    if(++_addr_bytes_received == 3) {
+      onAddressComplete();
+    }
+    return 0xFF;
+  }
+  case State::Dummy:
+  {
+    if(--_dummy_bytes_expected == 0) _state = State::Read;
+    return 0xFF;
+  }
+  case State::Read:
+  {
+    uint8_t const value = _data[_read_pos];
+    _read_pos = (_read_pos + 1) % (static_cast<uint32_t>(_geometry.num_pages) * _geometry.page_size);
+    return value;
+  }
+  case State::BufferWrite:
+  {
+    uint8_t const buffer = ((_instr == AT45DBX_CMD_BUFFER_1_WRITE) || (_instr == AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_1)) ? 0 : 1;
+    _buffer[buffer][_offset] = data;
+    _offset = (_offset + 1) % _geometry.page_size;
+    return 0xFF;
+  }
+  case State::Register:
+  {
+    return onRegisterRead();
+  }
+  default:
+  {
+    return 0xFF;
+  }
+  }
+}
+
+void SimulatedAT45DBX::set()
+{
+  execute();
+  _state = State::Ignore;
+}
+
+void SimulatedAT45DBX::clr()
+{
+  _state = State::Instruction;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedAT45DBX::onInstruction(uint8_t const instr)
+{
+  _instr               = instr;
+  _addr                = 0;
+  _addr_bytes_received = 0;
+  _reg_pos             = 0;
+
+  /* While busy only the status register and the buffer not being programmed are accessible */
+  if(isBusy() && (instr != AT45DBX_CMD_STATUS_REG_READ))
+  {
+    bool const is_buffer_write = (instr == AT45DBX_CMD_BUFFER_1_WRITE) || (instr == AT45DBX_CMD_BUFFER_2_WRITE);
+    uint8_t const buffer       = (instr == AT45DBX_CMD_BUFFER_1_WRITE) ? 0 : 1;
+
+    if(!is_buffer_write || (buffer == _busy_buffer))
+    {
+      if(is_buffer_write) _num_buffer_conflicts++;
+      _state = State::Ignore;
+      return;
+    }
+  }
+
+  switch(instr)
+  {
+  case AT45DBX_CMD_STATUS_REG_READ:
+  case SPI_NOR_CMD_READ_ID:                                                _state = State::Register; break;
+  case AT45DBX_CMD_CONTINUOUS_ARRAY_READ:        _dummy_bytes_expected = 1; _state = State::Address;  break;
+  case AT45DBX_CMD_BUFFER_1_WRITE:
+  case AT45DBX_CMD_BUFFER_2_WRITE:
+  case AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_1:
+  case AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_2:
+  case AT45DBX_CMD_BUFFER_1_TO_PAGE_WITH_ERASE:
+  case AT45DBX_CMD_BUFFER_2_TO_PAGE_WITH_ERASE:
+  case AT45DBX_CMD_BUFFER_1_TO_PAGE_NO_ERASE:
+  case AT45DBX_CMD_BUFFER_2_TO_PAGE_NO_ERASE:
+  case AT45DBX_CMD_PAGE_ERASE:                                             _state = State::Address;  break;
+  default:                                                                 _state = State::Ignore;   break;
+  }
+}
+
+void SimulatedAT45DBX::onAddressComplete()
+{
+  _page   = static_cast<uint16_t>((_addr >> _geometry.page_addr_shift) % _geometry.num_pages);
+  _offset = static_cast<uint16_t>((_addr & ((1UL << _geometry.page_addr_shift) - 1)) % _geometry.page_size);
+
+  switch(_instr)
+  {
+  case AT45DBX_CMD_CONTINUOUS_ARRAY_READ:
+    _read_pos = static_cast<uint32_t>(_page) * _geometry.page_size + _offset;
+    _state    = State::Dummy;
+    break;
+  case AT45DBX_CMD_BUFFER_1_WRITE:
+  case AT45DBX_CMD_BUFFER_2_WRITE:
+  case AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_1:
+  case AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_2:
+    _state = State::BufferWrite;
+    break;
+  default:
+    /* Program/erase, executed when CS is released */
+    _state = State::Command;
+    break;
+  }
+}
+
+uint8_t SimulatedAT45DBX::onRegisterRead()
+{
+  switch(_instr)
+  {
+  case AT45DBX_CMD_STATUS_REG_READ:
+    return (isBusy() ? 0 : AT45DBX_STATUS_REG_RDY_bm) | _status;
+  case SPI_NOR_CMD_READ_ID:
+  {
+    uint8_t const density = (_status & AT45DBX_STATUS_REG_DENSITY_bm) >> AT45DBX_STATUS_REG_DENSITY_bp;
+    uint8_t const id[]    = {AT45DBX_MANUFACTURER_ID, static_cast<uint8_t>((AT45DBX_FAMILY_CODE << 5) | ((density + 1) / 2)), 0x00, 0x00};
+    return (_reg_pos < sizeof(id)) ? id[_reg_pos++] : 0x00;
+  }
+  default:
+    return 0xFF;
+  }
+}
+
+void SimulatedAT45DBX::execute()
+{
+  if((_state != State::Command) && (_state != State::BufferWrite)) return;
+
+  switch(_instr)
+  {
+  case AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_1:
+  case AT45DBX_CMD_BUFFER_1_TO_PAGE_WITH_ERASE:   programPage(0, true ); break;
+  case AT45DBX_CMD_PAGE_PROGRAM_THROUGH_BUFFER_2:
+  case AT45DBX_CMD_BUFFER_2_TO_PAGE_WITH_ERASE:   programPage(1, true ); break;
+  case AT45DBX_CMD_BUFFER_1_TO_PAGE_NO_ERASE:     programPage(0, false); break;
+  case AT45DBX_CMD_BUFFER_2_TO_PAGE_NO_ERASE:     programPage(1, false); break;
+  case AT45DBX_CMD_PAGE_ERASE:
+  {
+    memset(_data + static_cast<uint32_t>(_page) * _geometry.page_size, 0xFF, _geometry.page_size);
+    _busy_until_ps = _now_ps + PAGE_ERASE_TIME_ns * 1000ULL;
+    _busy_buffer   = NO_BUFFER;
+  }
+  break;
+  default:
+    break;
+  }
+}
+
+void SimulatedAT45DBX::programPage(uint8_t const buffer, bool const is_erase)
+{
+  uint8_t * page_data = _data + static_cast<uint32_t>(_page) * _geometry.page_size;
+
+  if(is_erase) {
+    memcpy(page_data, _buffer[buffer], _geometry.page_size);
+  } else {
+    for(uint16_t i = 0; i < _geometry.page_size; i++) page_data[i] &= _buffer[buffer][i];
+  }
+
+  _busy_until_ps = _now_ps + (is_erase ? PAGE_ERASE_PROGRAM_TIME_ns : PAGE_PROGRAM_TIME_ns) * 1000ULL;
+  _busy_buffer   = buffer;
+  _num_page_programs++;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,143 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDAT45DBX_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDAT45DBX_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/delay/Delay.h>
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+#include <snowfox/hal/interface/spi/SpiMasterControl.h>
+
+#include "AT45DBXBufferIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Command level model of the AT45DB DataFlash (continuous array read,
+ * buffer write, buffer to main memory program with and without built-in
+ * erase, main memory program through buffer, page erase, status register,
+ * manufacturer and device ID) for running flash code on a Linux host. Like
+ * SimulatedN25Q256A it acts as SPI master, CS pin and delay and simulates
+ * time: every exchanged byte advances the clock by 8 SCK periods.
+ *
+ * While a page is programmed or erased RDY is cleared for the typical
+ * duration of the operation and only status reads and writes to the SRAM
+ * buffer not involved in the operation are accepted. Writes to the buffer
+ * being programmed are ignored and counted as buffer conflicts.
+ */
+class SimulatedAT45DBX : public hal::interface::SpiMasterControl,
+                         public hal::interface::DigitalOutPin,
+                         public hal::interface::Delay
+{
+
+public:
+
+  static uint64_t constexpr PAGE_ERASE_PROGRAM_TIME_ns = 17000000ULL; /* typ. 17 ms, AT45DB161D */
+  static uint64_t constexpr PAGE_PROGRAM_TIME_ns       =  3000000ULL; /* typ.  3 ms */
+  static uint64_t constexpr PAGE_ERASE_TIME_ns         = 15000000ULL; /* typ. 15 ms */
+
+
+           SimulatedAT45DBX(uint32_t const spi_clock_Hz, uint8_t const density, bool const is_binary_page_size);
+  virtual ~SimulatedAT45DBX();
+
+
+  uint8_t *               data              () { return _data; }
+  AT45DBXGeometry const & geometry          () const { return _geometry; }
+
+  void                    advance           (uint64_t const ns) { _now_ps += ns * 1000ULL; }
+  uint64_t                now_ns            () const { return _now_ps / 1000ULL; }
+  bool                    isBusy            () const { return _now_ps < _busy_until_ps; }
+
+  void                    resetCounters     ();
+  uint32_t                numPagePrograms   () const { return _num_page_programs; }
+  uint32_t                numBufferConflicts() const { return _num_buffer_conflicts; }
+
+
+  virtual uint8_t exchange(uint8_t const data) override;
+
+  virtual void    set() override;
+  virtual void    clr() override;
+
+  virtual void    delay_ms(uint32_t const ms) override { advance(ms * 1000000ULL); }
+  virtual void    delay_us(uint32_t const us) override { advance(us * 1000ULL); }
+
+private:
+
+  static uint8_t constexpr NO_BUFFER = 0xFF;
+
+  enum class State
+  {
+    Instruction,
+    Address,
+    Dummy,
+    Read,
+    BufferWrite,
+    Register,
+    Command,
+    Ignore
+  };
+
+  AT45DBXGeometry   _geometry;
+  uint8_t           _status;
+  uint8_t         * _data,
+                  * _buffer[2];
+  uint64_t          _byte_time_ps,
+                    _now_ps,
+                    _busy_until_ps;
+  State             _state;
+  uint8_t           _instr;
+  uint32_t          _addr;
+  uint8_t           _addr_bytes_received,
+                    _dummy_bytes_expected;
+  uint16_t          _page,
+                    _offset;
+  uint32_t          _read_pos;
+  uint8_t           _reg_pos;
+  uint8_t           _busy_buffer;
+  uint32_t          _num_page_programs,
+                    _num_buffer_conflicts;
+
+  void    onInstruction    (uint8_t const instr);
+  void    onAddressComplete();
+  uint8_t onRegisterRead   ();
+  void    execute          ();
+  void    programPage      (uint8_t const buffer, bool const is_erase);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDAT45DBX_H_ */
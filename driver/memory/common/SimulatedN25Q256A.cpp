@@ -0,0 +1,345 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedN25Q256A.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr JEDEC_ID[] = {0x20, 0xBA, 0x19};
+
+/* JESD216 SFDP header, parameter header and basic flash parameter table
+ * (9 DWORDs) describing the N25Q256A, the multi I/O read modes are listed
+ * for completeness only.
+ */
+static uint8_t constexpr N25Q256A_SFDP[] =
+{
+  /* SFDP header: signature, rev 1.0, 1 parameter header */
+  0x53, 0x46, 0x44, 0x50, 0x00, 0x01, 0x00, 0xFF,
+  /* Parameter header 0: basic flash parameter table, rev 1.0, 9 DWORDs at 0x000010 */
+  0x00, 0x00, 0x01, 0x09, 0x10, 0x00, 0x00, 0xFF,
+  /* DWORD1: 4 kB erase 0x20, 3- or 4-byte addressing, 1-1-2/1-2-2/1-4-4/1-1-4 fast read */
+  0xE5, 0x20, 0xF3, 0xFF,
+  /* DWORD2: 256 Mbit */
+  0xFF, 0xFF, 0xFF, 0x0F,
+  /* DWORD3: 1-4-4 EBh, 1-1-4 6Bh */
+  0x29, 0xEB, 0x08, 0x6B,
+  /* DWORD4: 1-1-2 3Bh, 1-2-2 BBh */
+  0x08, 0x3B, 0x27, 0xBB,
+  /* DWORD5-7: 2-2-2 and 4-4-4 fast read */
+  0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0x08, 0xBB,
+  0xFF, 0xFF, 0x0A, 0xEB,
+  /* DWORD8-9: erase type 1 = 4 kB 20h, erase type 2 = 64 kB D8h */
+  0x0C, 0x20, 0x10, 0xD8,
+  0x00, 0x00, 0x00, 0x00
+};
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedN25Q256A::SimulatedN25Q256A(uint32_t const spi_clock_Hz, uint32_t const flash_size)
+: _data                (new uint8_t[flash_size]          ),
+  _flash_size          (flash_size                       ),
+  _sfdp                (N25Q256A_SFDP                    ),
+  _sfdp_size           (sizeof(N25Q256A_SFDP)            ),
+  _byte_time_ps        (8000000000000ULL / spi_clock_Hz  ),
+  _now_ps              (0                                ),
+  _busy_until_ps       (0                                ),
+  _state               (State::Deselected                ),
+  _instr               (0                                ),
+  _addr                (0                                ),
+  _addr_bytes_expected (0                                ),
+  _addr_bytes_received (0                                ),
+  _dummy_bytes_expected(0                                ),
+  _reg_pos             (0                                ),
+  _is_write_enabled    (false                            ),
+  _is_4_byte_addr_mode (false                            ),
+  _is_erasing          (false                            ),
+  _is_erase_suspended  (false                            ),
+  _erase_remaining_ps  (0                                ),
+  _page_pos            (0                                )
+{
+  memset(_data, 0xFF, _flash_size);
+  resetCounters();
+}
+
+SimulatedN25Q256A::~SimulatedN25Q256A()
+{
+  delete[] _data;
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedN25Q256A::resetCounters()
+{
+  _num_transactions = 0;
+  _num_bytes        = 0;
+  _num_status_reads = 0;
+  _num_programs     = 0;
+  _num_erases       = 0;
+  _num_suspends     = 0;
+}
+
+uint8_t SimulatedN25Q256A::exchange(uint8_t const data)
+{
+  _num_bytes++;
+  _now_ps += _byte_time_ps;
+
+  switch(_state)
+  {
+  case State::Instruction:
+  {
+    onInstruction(data);
+    return 0xFF;
+  }
+  case State::Address:
+  {
+    _addr = (_addr << 8) | data;
+    if(++_addr_bytes_received == _addr_bytes_expected) {
+      onAddressComplete();
+    }
+    return 0xFF;
+  }
+  case State::Dummy:
+  {
+    if(--_dummy_bytes_expected == 0) _state = State::Read;
+    return 0xFF;
+  }
+  case State::Read:
+  {
+    uint8_t value = 0xFF;
+    if(_instr == SPI_NOR_CMD_READ_SFDP) {
+      if(_addr < _sfdp_size) value = _sfdp[_addr];
+    } else {
+      value = _data[_addr % _flash_size];
+    }
+    _addr++;
+    return value;
+  }
+  case State::Program:
+  {
+    _page_buf[(_addr + _page_pos) % N25Q256A_PAGE_SIZE] = data;
+    _page_pos++;
+    return 0xFF;
+  }
+  case State::Register:
+  {
+    return onRegisterRead();
+  }
+  default:
+  {
+    return 0xFF;
+  }
+  }
+}
+
+void SimulatedN25Q256A::set()
+{
+  if(_state != State::Deselected) {
+    execute();
+  }
+  _state = State::Deselected;
+}
+
+void SimulatedN25Q256A::clr()
+{
+  _num_transactions++;
+  _state = State::Instruction;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedN25Q256A::onInstruction(uint8_t const instr)
+{
+  _instr               = instr;
+  _addr                = 0;
+  _addr_bytes_received = 0;
+  _reg_pos             = 0;
+
+  uint8_t const addr_bytes = _is_4_byte_addr_mode ? 4 : 3;
+
+  bool const is_status_read   = (instr == SPI_NOR_CMD_READ_STATUS_REG) || (instr == N25Q256A_CMD_READ_FLAG_STATUS_REG);
+  bool const is_erase_suspend = (instr == N25Q256A_CMD_PROGRAM_ERASE_SUSPEND) && _is_erasing;
+  if(isBusy() && !is_status_read && !is_erase_suspend) {
+    _state = State::Ignore;
+    return;
+  }
+
+  switch(instr)
+  {
+  case SPI_NOR_CMD_READ_STATUS_REG:
+  case N25Q256A_CMD_READ_FLAG_STATUS_REG:  _num_status_reads++;                                          _state = State::Register; break;
+  case SPI_NOR_CMD_READ_ID:                                                                               _state = State::Register; break;
+  case SPI_NOR_CMD_WRITE_ENABLE:
+  case SPI_NOR_CMD_WRITE_DISABLE:
+  case SPI_NOR_CMD_ENTER_4_BYTE_ADDR:
+  case SPI_NOR_CMD_EXIT_4_BYTE_ADDR:
+  case N25Q256A_CMD_PROGRAM_ERASE_SUSPEND:
+  case N25Q256A_CMD_PROGRAM_ERASE_RESUME:                                                                 _state = State::Command;  break;
+  case SPI_NOR_CMD_READ:                   _addr_bytes_expected = addr_bytes; _dummy_bytes_expected = 0; _state = State::Address;  break;
+  case SPI_NOR_CMD_4_BYTE_READ:            _addr_bytes_expected = 4;          _dummy_bytes_expected = 0; _state = State::Address;  break;
+  case SPI_NOR_CMD_FAST_READ:              _addr_bytes_expected = addr_bytes; _dummy_bytes_expected = 1; _state = State::Address;  break;
+  case SPI_NOR_CMD_4_BYTE_FAST_READ:       _addr_bytes_expected = 4;          _dummy_bytes_expected = 1; _state = State::Address;  break;
+  case SPI_NOR_CMD_READ_SFDP:              _addr_bytes_expected = 3;          _dummy_bytes_expected = 1; _state = State::Address;  break;
+  case SPI_NOR_CMD_PAGE_PROGRAM:
+  case SPI_NOR_CMD_SUBSECTOR_ERASE:
+  case SPI_NOR_CMD_SECTOR_ERASE:           _addr_bytes_expected = addr_bytes;                            _state = State::Address;  break;
+  case SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM:
+  case SPI_NOR_CMD_4_BYTE_SUBSECTOR_ERASE:
+  case SPI_NOR_CMD_4_BYTE_SECTOR_ERASE:    _addr_bytes_expected = 4;                                     _state = State::Address;  break;
+  default:                                                                                                _state = State::Ignore;   break;
+  }
+}
+
+void SimulatedN25Q256A::onAddressComplete()
+{
+  switch(_instr)
+  {
+  case SPI_NOR_CMD_READ:
+  case SPI_NOR_CMD_4_BYTE_READ:
+  case SPI_NOR_CMD_FAST_READ:
+  case SPI_NOR_CMD_4_BYTE_FAST_READ:
+  case SPI_NOR_CMD_READ_SFDP:
+    _state = (_dummy_bytes_expected > 0) ? State::Dummy : State::Read;
+    break;
+  case SPI_NOR_CMD_PAGE_PROGRAM:
+  case SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM:
+    memset(_page_buf, 0xFF, sizeof(_page_buf));
+    _page_pos = 0;
+    _state    = State::Program;
+    break;
+  default:
+    /* Erase, executed when CS is released */
+    _state = State::Command;
+    break;
+  }
+}
+
+uint8_t SimulatedN25Q256A::onRegisterRead()
+{
+  switch(_instr)
+  {
+  case SPI_NOR_CMD_READ_STATUS_REG:
+    return (isBusy() ? SPI_NOR_STATUS_REG_WIP_bm : 0) | (_is_write_enabled ? SPI_NOR_STATUS_REG_WEL_bm : 0);
+  case N25Q256A_CMD_READ_FLAG_STATUS_REG:
+    return (isBusy()             ? 0                                      : N25Q256A_FLAG_STATUS_REG_READY_bm) |
+           (_is_erase_suspended  ? N25Q256A_FLAG_STATUS_REG_ERASE_SUSP_bm : 0                                ) |
+           (_is_4_byte_addr_mode ? N25Q256A_FLAG_STATUS_REG_4_BYTE_bm     : 0                                );
+  case SPI_NOR_CMD_READ_ID:
+    return (_reg_pos < sizeof(JEDEC_ID)) ? JEDEC_ID[_reg_pos++] : 0x00;
+  default:
+    return 0xFF;
+  }
+}
+
+void SimulatedN25Q256A::execute()
+{
+  if(_state != State::Command && _state != State::Program) return;
+
+  switch(_instr)
+  {
+  case SPI_NOR_CMD_WRITE_ENABLE:      _is_write_enabled = true;  break;
+  case SPI_NOR_CMD_WRITE_DISABLE:     _is_write_enabled = false; break;
+  case SPI_NOR_CMD_ENTER_4_BYTE_ADDR: if(_is_write_enabled) _is_4_byte_addr_mode = true;  break;
+  case SPI_NOR_CMD_EXIT_4_BYTE_ADDR:  if(_is_write_enabled) _is_4_byte_addr_mode = false; break;
+  case SPI_NOR_CMD_PAGE_PROGRAM:
+  case SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM:
+  {
+    if((_state != State::Program) || !_is_write_enabled || (_page_pos == 0)) break;
+
+    uint32_t const page_addr = (_addr % _flash_size) & ~static_cast<uint32_t>(N25Q256A_PAGE_SIZE - 1);
+    for(uint16_t i = 0; i < N25Q256A_PAGE_SIZE; i++) {
+      _data[page_addr + i] &= _page_buf[i];
+    }
+
+    _is_write_enabled = false;
+    _is_erasing       = false;
+    _busy_until_ps    = _now_ps + PAGE_PROGRAM_TIME_ns * 1000ULL;
+    _num_programs++;
+  }
+  break;
+  case SPI_NOR_CMD_SUBSECTOR_ERASE:
+  case SPI_NOR_CMD_4_BYTE_SUBSECTOR_ERASE:
+  case SPI_NOR_CMD_SECTOR_ERASE:
+  case SPI_NOR_CMD_4_BYTE_SECTOR_ERASE:
+  {
+    if(!_is_write_enabled || _is_erase_suspended) break;
+
+    bool     const is_subsector = (_instr == SPI_NOR_CMD_SUBSECTOR_ERASE) || (_instr == SPI_NOR_CMD_4_BYTE_SUBSECTOR_ERASE);
+    uint32_t const erase_size   = is_subsector ? N25Q256A_SUBSECTOR_SIZE : N25Q256A_SECTOR_SIZE;
+    uint32_t const erase_addr   = (_addr % _flash_size) & ~(erase_size - 1);
+
+    memset(_data + erase_addr, 0xFF, erase_size);
+
+    _is_write_enabled = false;
+    _is_erasing       = true;
+    _busy_until_ps    = _now_ps + (is_subsector ? SUBSECTOR_ERASE_TIME_ns : SECTOR_ERASE_TIME_ns) * 1000ULL;
+    _num_erases++;
+  }
+  break;
+  case N25Q256A_CMD_PROGRAM_ERASE_SUSPEND:
+  {
+    if(!isBusy() || !_is_erasing) break;
+
+    /* The erase makes no progress while it is suspended */
+    _erase_remaining_ps = _busy_until_ps - _now_ps;
+    _busy_until_ps      = _now_ps + ERASE_SUSPEND_TIME_ns * 1000ULL;
+    _is_erasing         = false;
+    _is_erase_suspended = true;
+    _num_suspends++;
+  }
+  break;
+  case N25Q256A_CMD_PROGRAM_ERASE_RESUME:
+  {
+    if(isBusy() || !_is_erase_suspended) break;
+
+    _busy_until_ps      = _now_ps + _erase_remaining_ps;
+    _is_erasing         = true;
+    _is_erase_suspended = false;
+  }
+  break;
+  default:
+    break;
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,158 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDN25Q256A_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDN25Q256A_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/delay/Delay.h>
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+#include <snowfox/hal/interface/spi/SpiMasterControl.h>
+
+#include "N25Q256AFastPath.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Command level model of the N25Q256A (single I/O commands, 3- and 4-byte
+ * addressing, page program, subsector/sector erase, SFDP) for running flash code
+ * on a Linux host. It acts as SPI master, CS pin and delay at the same
+ * time. Time is simulated: every exchanged byte advances the clock by 8 SCK
+ * periods, delay_ms()/delay_us() and advance() account for delays of the
+ * caller. Program and erase operations
+ * keep WIP set for their typical duration, commands other than status reads
+ * are ignored in the meantime. An erase can be suspended via PROGRAM/ERASE
+ * SUSPEND, reads and page programs are accepted once the suspend latency
+ * has elapsed, the erase continues with its remaining time after PROGRAM/
+ * ERASE RESUME. READ SERIAL FLASH DISCOVERY PARAMETER returns a JESD216
+ * table describing the N25Q256A unless a different table is installed via
+ * setSfdp() in order to model another device.
+ */
+class SimulatedN25Q256A : public hal::interface::SpiMasterControl,
+                          public hal::interface::DigitalOutPin,
+                          public hal::interface::Delay
+{
+
+public:
+
+  static uint64_t constexpr PAGE_PROGRAM_TIME_ns    =    500000ULL; /* typ. 0.5 ms  */
+  static uint64_t constexpr SUBSECTOR_ERASE_TIME_ns = 250000000ULL; /* typ. 0.25 s  */
+  static uint64_t constexpr SECTOR_ERASE_TIME_ns    = 700000000ULL; /* typ. 0.7 s   */
+  static uint64_t constexpr ERASE_SUSPEND_TIME_ns   =     15000ULL; /* typ. 15 us   */
+
+
+           SimulatedN25Q256A(uint32_t const spi_clock_Hz, uint32_t const flash_size);
+  virtual ~SimulatedN25Q256A();
+
+
+  uint8_t * data           () { return _data; }
+  uint32_t  size           () const { return _flash_size; }
+  void      setSfdp        (uint8_t const * sfdp, uint16_t const sfdp_size) { _sfdp = sfdp; _sfdp_size = sfdp_size; }
+  bool      is4ByteAddrMode() const { return _is_4_byte_addr_mode; }
+
+  void      advance        (uint64_t const ns) { _now_ps += ns * 1000ULL; }
+  uint64_t  now_ns         () const { return _now_ps / 1000ULL; }
+  bool      isBusy         () const { return _now_ps < _busy_until_ps; }
+
+  void      resetCounters  ();
+  uint32_t  numTransactions() const { return _num_transactions; }
+  uint64_t  numBytes       () const { return _num_bytes; }
+  uint32_t  numStatusReads () const { return _num_status_reads; }
+  uint32_t  numPrograms    () const { return _num_programs; }
+  uint32_t  numErases      () const { return _num_erases; }
+  uint32_t  numSuspends    () const { return _num_suspends; }
+
+
+  virtual uint8_t exchange(uint8_t const data) override;
+
+  virtual void    set() override;
+  virtual void    clr() override;
+
+  virtual void    delay_ms(uint32_t const ms) override { advance(ms * 1000000ULL); }
+  virtual void    delay_us(uint32_t const us) override { advance(us * 1000ULL); }
+
+private:
+
+  enum class State
+  {
+    Deselected,
+    Instruction,
+    Address,
+    Dummy,
+    Read,
+    Program,
+    Register,
+    Command,
+    Ignore
+  };
+
+  uint8_t       * _data;
+  uint32_t        _flash_size;
+  uint8_t const * _sfdp;
+  uint16_t        _sfdp_size;
+  uint64_t        _byte_time_ps,
+                  _now_ps,
+                  _busy_until_ps;
+  State           _state;
+  uint8_t         _instr;
+  uint32_t        _addr;
+  uint8_t         _addr_bytes_expected,
+                  _addr_bytes_received,
+                  _dummy_bytes_expected;
+  uint16_t        _reg_pos;
+  bool            _is_write_enabled,
+                  _is_4_byte_addr_mode,
+                  _is_erasing,
+                  _is_erase_suspended;
+  uint64_t        _erase_remaining_ps;
+  uint8_t         _page_buf[N25Q256A_PAGE_SIZE];
+  uint16_t        _page_pos;
+  uint32_t        _num_transactions;
+  uint64_t        _num_bytes;
+  uint32_t        _num_status_reads,
+                  _num_programs,
+                  _num_erases,
+                  _num_suspends;
+
+  void    onInstruction(uint8_t const instr);
+  void    onAddressComplete();
+  uint8_t onRegisterRead();
+  void    execute();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDN25Q256A_H_ */
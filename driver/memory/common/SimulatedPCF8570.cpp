@@ -0,0 +1,87 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedPCF8570.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedPCF8570::SimulatedPCF8570(uint8_t const i2c_address)
+: _i2c_address          (i2c_address),
+  _word_addr            (0          ),
+  _is_word_addr_expected(false      )
+{
+  memset(_mem, 0, sizeof(_mem));
+}
+
+SimulatedPCF8570::~SimulatedPCF8570()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedPCF8570::onStart(bool const is_read)
+{
+  _is_word_addr_expected = !is_read;
+}
+
+bool SimulatedPCF8570::onWrite(uint8_t const data)
+{
+  if(_is_word_addr_expected)
+  {
+    _word_addr             = data;
+    _is_word_addr_expected = false;
+    return true;
+  }
+
+  _mem[_word_addr++] = data;
+  return true;
+}
+
+uint8_t SimulatedPCF8570::onRead()
+{
+  return _mem[_word_addr++];
+}
+
+void SimulatedPCF8570::onStop()
+{
+  _is_word_addr_expected = false;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
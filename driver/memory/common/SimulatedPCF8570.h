@@ -0,0 +1,80 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDPCF8570_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDPCF8570_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "../../../hal/common/SimulatedI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* I2C model of the PCF8570 256 byte static RAM: the first byte written
+ * after START is the word address, the word address is incremented after
+ * each byte written or read and wraps around from 0xFF to 0x00.
+ */
+class SimulatedPCF8570 : public hal::i2c::interface::SimulatedI2cSlave
+{
+
+public:
+
+  static uint16_t constexpr SIZE = 256;
+
+
+           SimulatedPCF8570(uint8_t const i2c_address);
+  virtual ~SimulatedPCF8570();
+
+
+  uint8_t & mem(uint8_t const addr) { return _mem[addr]; }
+
+
+  virtual uint8_t address() const override { return _i2c_address; }
+
+  virtual void    onStart(bool const is_read) override;
+  virtual bool    onWrite(uint8_t const data) override;
+  virtual uint8_t onRead () override;
+  virtual void    onStop () override;
+
+private:
+
+  uint8_t _i2c_address;
+  uint8_t _mem[SIZE];
+  uint8_t _word_addr;
+  bool    _is_word_addr_expected;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_SIMULATEDPCF8570_H_ */
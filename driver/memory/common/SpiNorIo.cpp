@@ -0,0 +1,125 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SpiNorIo.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SpiNorIo::SpiNorIo(hal::interface::SpiMasterControl & spi_master,
+                   hal::interface::DigitalOutPin    & cs)
+: _spi_master(spi_master),
+  _cs        (cs        )
+{
+
+}
+
+SpiNorIo::~SpiNorIo()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SpiNorIo::command(uint8_t const instr)
+{
+  _cs.clr();
+  _spi_master.exchange(instr);
+  _cs.set();
+}
+
+void SpiNorIo::commandAddress(uint8_t const instr, uint32_t const addr, uint8_t const addr_bytes)
+{
+  _cs.clr();
+  _spi_master.exchange(instr);
+  sendAddress(addr, addr_bytes);
+  _cs.set();
+}
+
+void SpiNorIo::readData(uint8_t const instr, uint8_t * buf, uint32_t const size)
+{
+  read(instr, 0, 0, 0, buf, size);
+}
+
+void SpiNorIo::writeData(uint8_t const instr, uint8_t const * buf, uint32_t const size)
+{
+  write(instr, 0, 0, buf, size);
+}
+
+void SpiNorIo::read(uint8_t const instr, uint32_t const addr, uint8_t const addr_bytes, uint8_t const dummy_cycles, uint8_t * buf, uint32_t const size)
+{
+  _cs.clr();
+  _spi_master.exchange(instr);
+  sendAddress(addr, addr_bytes);
+  for(uint8_t d = 0; d < dummy_cycles; d += 8) {
+    _spi_master.exchange(0);
+  }
+  for(uint32_t i = 0; i < size; i++) {
+    buf[i] = _spi_master.exchange(0);
+  }
+  _cs.set();
+}
+
+void SpiNorIo::write(uint8_t const instr, uint32_t const addr, uint8_t const addr_bytes, uint8_t const * buf, uint32_t const size)
+{
+  _cs.clr();
+  _spi_master.exchange(instr);
+  sendAddress(addr, addr_bytes);
+  for(uint32_t i = 0; i < size; i++) {
+    _spi_master.exchange(buf[i]);
+  }
+  _cs.set();
+}
+
+uint8_t SpiNorIo::readStatusRegister()
+{
+  uint8_t status = 0;
+  readData(SPI_NOR_CMD_READ_STATUS_REG, &status, 1);
+  return status;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SpiNorIo::sendAddress(uint32_t const addr, uint8_t const addr_bytes)
+{
+  for(uint8_t b = addr_bytes; b > 0; b--) {
+    _spi_master.exchange(static_cast<uint8_t>(addr >> (8 * (b - 1))));
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
@@ -0,0 +1,108 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_MEMORY_COMMON_SPINORIO_H_
+#define EXAMPLES_DRIVER_MEMORY_COMMON_SPINORIO_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+#include <snowfox/hal/interface/spi/SpiMasterControl.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::memory
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* Commands common to the JEDEC compliant serial NOR flashes (single I/O) */
+static uint8_t constexpr SPI_NOR_CMD_WRITE_ENABLE           = 0x06;
+static uint8_t constexpr SPI_NOR_CMD_WRITE_DISABLE          = 0x04;
+static uint8_t constexpr SPI_NOR_CMD_READ_STATUS_REG        = 0x05;
+static uint8_t constexpr SPI_NOR_CMD_READ_ID                = 0x9F;
+static uint8_t constexpr SPI_NOR_CMD_READ_SFDP              = 0x5A;
+static uint8_t constexpr SPI_NOR_CMD_READ                   = 0x03;
+static uint8_t constexpr SPI_NOR_CMD_FAST_READ              = 0x0B;
+static uint8_t constexpr SPI_NOR_CMD_PAGE_PROGRAM           = 0x02;
+static uint8_t constexpr SPI_NOR_CMD_SUBSECTOR_ERASE        = 0x20;
+static uint8_t constexpr SPI_NOR_CMD_SECTOR_ERASE           = 0xD8;
+static uint8_t constexpr SPI_NOR_CMD_ENTER_4_BYTE_ADDR      = 0xB7;
+static uint8_t constexpr SPI_NOR_CMD_EXIT_4_BYTE_ADDR       = 0xE9;
+static uint8_t constexpr SPI_NOR_CMD_4_BYTE_READ            = 0x13;
+static uint8_t constexpr SPI_NOR_CMD_4_BYTE_FAST_READ       = 0x0C;
+static uint8_t constexpr SPI_NOR_CMD_4_BYTE_PAGE_PROGRAM    = 0x12;
+static uint8_t constexpr SPI_NOR_CMD_4_BYTE_SUBSECTOR_ERASE = 0x21;
+static uint8_t constexpr SPI_NOR_CMD_4_BYTE_SECTOR_ERASE    = 0xDC;
+
+static uint8_t constexpr SPI_NOR_STATUS_REG_WIP_bm          = (1<<0);
+static uint8_t constexpr SPI_NOR_STATUS_REG_WEL_bm          = (1<<1);
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Framing of serial NOR flash commands (instruction, address, dummy cycles
+ * and data phase) within a single CS assertion. The number of address
+ * bytes (3 or 4) and dummy cycles (multiple of 8, the SPI peripherals of
+ * the supported MCUs only transfer whole bytes) are chosen by the caller,
+ * there is no limit on the size of the data phase.
+ */
+class SpiNorIo
+{
+
+public:
+
+           SpiNorIo(hal::interface::SpiMasterControl & spi_master,
+                    hal::interface::DigitalOutPin    & cs);
+  virtual ~SpiNorIo();
+
+
+  void command       (uint8_t const instr);
+  void commandAddress(uint8_t const instr, uint32_t const addr, uint8_t const addr_bytes);
+  void readData      (uint8_t const instr,                                                                      uint8_t       * buf, uint32_t const size);
+  void writeData     (uint8_t const instr,                                                                      uint8_t const * buf, uint32_t const size);
+  void read          (uint8_t const instr, uint32_t const addr, uint8_t const addr_bytes, uint8_t const dummy_cycles, uint8_t       * buf, uint32_t const size);
+  void write         (uint8_t const instr, uint32_t const addr, uint8_t const addr_bytes,                           uint8_t const * buf, uint32_t const size);
+
+  uint8_t readStatusRegister();
+
+private:
+
+  hal::interface::SpiMasterControl & _spi_master;
+  hal::interface::DigitalOutPin    & _cs;
+
+  void sendAddress(uint32_t const addr, uint8_t const addr_bytes);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::memory */
+
+#endif /* EXAMPLES_DRIVER_MEMORY_COMMON_SPINORIO_H_ */
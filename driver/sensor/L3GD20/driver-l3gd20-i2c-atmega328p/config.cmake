@@ -3,6 +3,7 @@
 set(SNOWFOX_APPLICATON_TARGET "driver-l3gd20-i2c-atmega328p")
 set(SNOWFOX_APPLICATON_SRCS
   examples/driver/sensor/L3GD20/driver-l3gd20-i2c-atmega328p/driver-l3gd20-i2c-atmega328p.cpp
+  examples/driver/sensor/common/StSensorIoI2c.cpp
 )
 
 ##########################################################################
@@ -47,7 +48,7 @@ set(DRIVER_SENSOR_LIS3DSH no)
 set(DRIVER_SENSOR_LIS3MDL no)
 set(DRIVER_SENSOR_LSM6DSM no)
 
-set(DRIVER_SERIAL no)
+set(DRIVER_SERIAL yes)
 
 set(DRIVER_STEPPER_TMC26x no)
 
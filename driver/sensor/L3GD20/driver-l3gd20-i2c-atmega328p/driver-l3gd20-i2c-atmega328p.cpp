@@ -28,12 +28,22 @@
 #include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
 #include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
 
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
 #include <snowfox/blox/hal/avr/ATMEGA328P/I2cMaster.h>
 
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
 #include <snowfox/driver/sensor/L3GD20/L3GD20.h>
 #include <snowfox/driver/sensor/L3GD20/L3GD20_IoI2c.h>
 #include <snowfox/driver/sensor/L3GD20/L3GD20_Control.h>
 
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/StSensorIoI2c.h"
+
+#include "../../../../hal/common/I2cClockSetting.h"
+
 /**************************************************************************************
  * NAMESPACES
  **************************************************************************************/
@@ -46,8 +56,15 @@ using namespace snowfox::driver;
  * GLOBAL CONSTANTS
  **************************************************************************************/
 
-static uint8_t  const L3GD20_I2C_ADDR = (0x6B << 1);
-static uint32_t const LOOP_DELAY_ms   = 1000; /* 1 s */
+static uint16_t const UART_RX_BUFFER_SIZE = 0;
+static uint16_t const UART_TX_BUFFER_SIZE = 32;
+
+static uint8_t  const L3GD20_I2C_ADDR     = (0x6B << 1);
+static uint32_t const I2C_CLOCK_Hz        = hal::i2c::I2C_CLOCK_FAST_MODE_Hz;
+static uint32_t const LOOP_DELAY_ms       = 1000; /* 1 s */
+
+static_assert(I2C_CLOCK_Hz <= hal::i2c::i2cBusMaxClockHz(hal::i2c::I2cDevice::L3GD20), "I2C_CLOCK_Hz exceeds the L3GD20 limit");
+static_assert(hal::i2c::isAvrTwiClockSupported(F_CPU, I2C_CLOCK_Hz),                   "I2C_CLOCK_Hz can not be generated from F_CPU");
 
 /**************************************************************************************
  * MAIN
@@ -71,6 +88,19 @@ int snowfox_main()
                                                int_ctrl,
                                                hal::interface::I2cClock::F_100_kHz);
 
+  /* hal::interface::I2cClock does not know about Fast-mode, the
+   * bit rate is therefore overwritten after the TWI has been configured.
+   */
+  hal::i2c::avrSetTwiClock(&TWBR, &TWSR, hal::i2c::avrTwiClockSetting(F_CPU, I2C_CLOCK_Hz));
+
+  blox::ATMEGA328P::UART0         uart0       (&UDR0,
+                                               &UCSR0A,
+                                               &UCSR0B,
+                                               &UCSR0C,
+                                               &UBRR0,
+                                               int_ctrl,
+                                               F_CPU);
+
   /* GLOBAL INTERRUPT *****************************************************************/
   int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
 
@@ -79,11 +109,26 @@ int snowfox_main()
    * DRIVER
    ************************************************************************************/
 
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart   serial(crit_sec,
+                            uart0(),
+                            UART_RX_BUFFER_SIZE,
+                            UART_TX_BUFFER_SIZE,
+                            serial::interface::SerialBaudRate::B115200,
+                            serial::interface::SerialParity::None,
+                            serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output,trace::Level::Debug);
+
   /* L3GD20 ***************************************************************************/
   sensor::L3GD20::L3GD20_IoI2c      l3gd20_io_i2c (L3GD20_I2C_ADDR, i2c_master());
   sensor::L3GD20::L3GD20_Control    l3gd20_control(l3gd20_io_i2c                );
   sensor::L3GD20::L3GD20            l3gd20        (l3gd20_control               );
 
+  /* The angular rate is read via a single I2C burst transaction instead of six single register reads */
+  sensor::StSensorIoI2c             l3gd20_burst_io(L3GD20_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, i2c_master());
+
   uint8_t output_data_rate_and_bandwidth = static_cast<uint8_t>(sensor::L3GD20::interface::OutputDataRateAndBandwith::ODR_95_Hz_CutOff_12_5_Hz);
   uint8_t full_scale_range               = static_cast<uint8_t>(sensor::L3GD20::interface::FullScaleRange::FS_plus_minus_250_DPS              );
 
@@ -100,7 +145,12 @@ int snowfox_main()
 
   for(;;)
   {
-    /* TODO Read from sensor and write to serial debug interface */
+    int16_t xyz[3] = {0};
+    if(!l3gd20_burst_io.readXYZ(xyz)) {
+      trace.println(trace::Level::Error, "[ERR] L3GD20 read XYZ");
+    } else {
+      trace.println(trace::Level::Info, "X = %6d, Y = %6d, Z = %6d", xyz[0], xyz[1], xyz[2]);
+    }
     delay.delay_ms(LOOP_DELAY_ms);
   }
 
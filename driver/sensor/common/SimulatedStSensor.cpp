@@ -0,0 +1,93 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedStSensor.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::sensor
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedStSensor::SimulatedStSensor(uint8_t const i2c_address, uint8_t const auto_increment_bm)
+: _i2c_address         (i2c_address      ),
+  _auto_increment_bm   (auto_increment_bm),
+  _reg_ptr             (0                ),
+  _is_sub_addr_expected(false            ),
+  _is_auto_increment   (false            )
+{
+  memset(_reg, 0, sizeof(_reg));
+}
+
+SimulatedStSensor::~SimulatedStSensor()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedStSensor::onStart(bool const is_read)
+{
+  _is_sub_addr_expected = !is_read;
+}
+
+bool SimulatedStSensor::onWrite(uint8_t const data)
+{
+  if(_is_sub_addr_expected)
+  {
+    _reg_ptr              = data & 0x7F;
+    _is_auto_increment    = (_auto_increment_bm == 0) || (data & _auto_increment_bm);
+    _is_sub_addr_expected = false;
+    return true;
+  }
+
+  reg(_reg_ptr) = data;
+  if(_is_auto_increment) _reg_ptr++;
+  return true;
+}
+
+uint8_t SimulatedStSensor::onRead()
+{
+  uint8_t const data = reg(_reg_ptr);
+  if(_is_auto_increment) _reg_ptr++;
+  return data;
+}
+
+void SimulatedStSensor::onStop()
+{
+  _is_sub_addr_expected = false;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::sensor */
@@ -0,0 +1,83 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SENSOR_COMMON_SIMULATEDSTSENSOR_H_
+#define EXAMPLES_DRIVER_SENSOR_COMMON_SIMULATEDSTSENSOR_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "../../../hal/common/SimulatedI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::sensor
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* I2C register file behaving like a ST MEMS sensor: the first byte written
+ * after START is the sub-address, auto-increment is enabled either by the
+ * sub-address MSB or - if auto_increment_bm is ST_SENSOR_AUTO_INCREMENT_ADD_INC -
+ * unconditionally.
+ */
+class SimulatedStSensor : public hal::i2c::interface::SimulatedI2cSlave
+{
+
+public:
+
+  static uint8_t constexpr NUM_REGISTERS = 128;
+
+
+           SimulatedStSensor(uint8_t const i2c_address, uint8_t const auto_increment_bm);
+  virtual ~SimulatedStSensor();
+
+
+  uint8_t & reg(uint8_t const reg_addr) { return _reg[reg_addr % NUM_REGISTERS]; }
+
+
+  virtual uint8_t address() const override { return _i2c_address; }
+
+  virtual void    onStart(bool const is_read) override;
+  virtual bool    onWrite(uint8_t const data) override;
+  virtual uint8_t onRead () override;
+  virtual void    onStop () override;
+
+private:
+
+  uint8_t _i2c_address,
+          _auto_increment_bm;
+  uint8_t _reg[NUM_REGISTERS];
+  uint8_t _reg_ptr;
+  bool    _is_sub_addr_expected,
+          _is_auto_increment;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::sensor */
+
+#endif /* EXAMPLES_DRIVER_SENSOR_COMMON_SIMULATEDSTSENSOR_H_ */
@@ -0,0 +1,110 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "StSensorIoI2c.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::sensor
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+StSensorIoI2c::StSensorIoI2c(uint8_t                   const   i2c_address,
+                             uint8_t                   const   auto_increment_bm,
+                             hal::interface::I2cMaster       & i2c_master)
+: _i2c_address      (i2c_address      ),
+  _auto_increment_bm(auto_increment_bm),
+  _i2c_master       (i2c_master       )
+{
+
+}
+
+StSensorIoI2c::~StSensorIoI2c()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool StSensorIoI2c::readRegister(uint8_t const reg_addr, uint8_t * data)
+{
+  if(!_i2c_master.begin(_i2c_address, false) || !_i2c_master.write(reg_addr)) {
+    _i2c_master.end();
+    return false;
+  }
+  return _i2c_master.requestFrom(_i2c_address, data, 1);
+}
+
+bool StSensorIoI2c::writeRegister(uint8_t const reg_addr, uint8_t const data)
+{
+  return writeRegisters(reg_addr, &data, 1);
+}
+
+bool StSensorIoI2c::readRegisters(uint8_t const reg_addr, uint8_t * data, uint16_t const num_bytes)
+{
+  if(!_i2c_master.begin(_i2c_address, false) || !_i2c_master.write(reg_addr | _auto_increment_bm)) {
+    _i2c_master.end();
+    return false;
+  }
+  return _i2c_master.requestFrom(_i2c_address, data, num_bytes);
+}
+
+bool StSensorIoI2c::writeRegisters(uint8_t const reg_addr, uint8_t const * data, uint16_t const num_bytes)
+{
+  if(!_i2c_master.begin(_i2c_address, false)) {
+    _i2c_master.end();
+    return false;
+  }
+
+  bool success = _i2c_master.write(reg_addr | _auto_increment_bm);
+  for(uint16_t i = 0; success && (i < num_bytes); i++) {
+    success = _i2c_master.write(data[i]);
+  }
+
+  _i2c_master.end();
+  return success;
+}
+
+bool StSensorIoI2c::readXYZ(int16_t * xyz)
+{
+  uint8_t out[6];
+  if(!readRegisters(ST_SENSOR_REG_OUT_X_L, out, sizeof(out))) return false;
+
+  for(uint8_t axis = 0; axis < 3; axis++) {
+    xyz[axis] = static_cast<int16_t>((static_cast<uint16_t>(out[2*axis + 1]) << 8) | out[2*axis]);
+  }
+
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::sensor */
@@ -0,0 +1,97 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SENSOR_COMMON_STSENSORIOI2C_H_
+#define EXAMPLES_DRIVER_SENSOR_COMMON_STSENSORIOI2C_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/i2c/I2cMaster.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::sensor
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* L3GD20 and LIS3MDL increment the register address during multi-byte
+ * accesses if the MSB of the sub-address is set. LIS3DSH and LIS2DSH
+ * ignore the sub-address MSB and auto-increment as long as ADD_INC in
+ * CTRL_REG6 is set (which is its reset value).
+ */
+static uint8_t constexpr ST_SENSOR_AUTO_INCREMENT_SUB_MSB = 0x80;
+static uint8_t constexpr ST_SENSOR_AUTO_INCREMENT_ADD_INC = 0x00;
+
+/* OUT_X_L, OUT_X_H, OUT_Y_L, ... OUT_Z_H are located at the same
+ * addresses for L3GD20, LIS3MDL, LIS3DSH and LIS2DSH.
+ */
+static uint8_t constexpr ST_SENSOR_REG_OUT_X_L            = 0x28;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Register access for ST MEMS sensors via I2C. readRegisters/writeRegisters
+ * access a range of consecutive registers within a single I2C transaction
+ * instead of paying START, device address and sub-address for every byte,
+ * e.g. reading all three axes takes one transaction instead of six.
+ */
+class StSensorIoI2c
+{
+
+public:
+
+           StSensorIoI2c(uint8_t                   const   i2c_address,
+                         uint8_t                   const   auto_increment_bm,
+                         hal::interface::I2cMaster       & i2c_master);
+  virtual ~StSensorIoI2c();
+
+
+  bool readRegister  (uint8_t const reg_addr, uint8_t       * data);
+  bool writeRegister (uint8_t const reg_addr, uint8_t const   data);
+
+  bool readRegisters (uint8_t const reg_addr, uint8_t       * data, uint16_t const num_bytes);
+  bool writeRegisters(uint8_t const reg_addr, uint8_t const * data, uint16_t const num_bytes);
+
+  /* Reads OUT_X_L ... OUT_Z_H within one transaction */
+  bool readXYZ       (int16_t * xyz);
+
+private:
+
+  uint8_t                     _i2c_address,
+                              _auto_increment_bm;
+  hal::interface::I2cMaster & _i2c_master;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::sensor */
+
+#endif /* EXAMPLES_DRIVER_SENSOR_COMMON_STSENSORIOI2C_H_ */
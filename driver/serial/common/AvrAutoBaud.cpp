@@ -0,0 +1,123 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AvrAutoBaud.h"
+
+#include "UartBaudRate.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AvrAutoBaud::AvrAutoBaud(volatile uint8_t  * rx_pin,
+                         uint8_t     const   rx_pin_number,
+                         volatile uint8_t  * tccr1a,
+                         volatile uint8_t  * tccr1b,
+                         volatile uint16_t * tcnt1,
+                         uint32_t    const   f_cpu)
+: _PIN      (rx_pin                                  ),
+  _rx_pin_bm(static_cast<uint8_t>(1 << rx_pin_number)),
+  _TCCR1A   (tccr1a                                  ),
+  _TCCR1B   (tccr1b                                  ),
+  _TCNT1    (tcnt1                                   ),
+  _f_cpu    (f_cpu                                   )
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t AvrAutoBaud::detect(uint16_t const timeout_ms)
+{
+  /* TIMER1 overflows every 65536 / F_CPU, i.e. every 4.096 ms @ 16 MHz */
+  uint32_t const max_overflows = ((_f_cpu / 1000UL) * timeout_ms) >> 16;
+
+  uint8_t const tccr1a = *_TCCR1A;
+  uint8_t const tccr1b = *_TCCR1B;
+
+  /* Normal mode, no prescaler */
+  *_TCCR1A = 0;
+  *_TCCR1B = (1 << 0);
+
+  /* Line idle (high) -> start bit (falling edge) */
+  uint32_t num_overflows = 0;
+  bool success = waitForLevel(true,  num_overflows, max_overflows) &&
+                 waitForLevel(false, num_overflows, max_overflows);
+  uint16_t const start = *_TCNT1;
+
+  /* The full character must fit into one TIMER1 period */
+  for(uint8_t rising_edge = 0; success && (rising_edge < 5); rising_edge++)
+  {
+    success = waitForLevel(true, start, 0xFF00);
+    if(success && (rising_edge < 4)) {
+      success = waitForLevel(false, start, 0xFF00);
+    }
+  }
+  uint16_t const ticks = *_TCNT1 - start;
+
+  *_TCCR1A = tccr1a;
+  *_TCCR1B = tccr1b;
+
+  if(!success || (ticks == 0)) return 0;
+
+  return toStandardBaudRate((_f_cpu * SYNC_CHAR_NUM_BITS) / ticks);
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool AvrAutoBaud::waitForLevel(bool const level, uint16_t const start, uint16_t const max_ticks)
+{
+  while(static_cast<bool>(*_PIN & _rx_pin_bm) != level)
+  {
+    if(static_cast<uint16_t>(*_TCNT1 - start) > max_ticks) return false;
+  }
+  return true;
+}
+
+bool AvrAutoBaud::waitForLevel(bool const level, uint32_t & num_overflows, uint32_t const max_overflows)
+{
+  uint16_t prev = *_TCNT1;
+  while(static_cast<bool>(*_PIN & _rx_pin_bm) != level)
+  {
+    uint16_t const now = *_TCNT1;
+    if((now < prev) && (++num_overflows > max_overflows)) return false;
+    prev = now;
+  }
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
@@ -0,0 +1,90 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_AVRAUTOBAUD_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_AVRAUTOBAUD_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Detects the baud rate of the remote side by measuring the bit time of a
+ * received synchronisation character 'U' (0x55). Together with start and
+ * stop bit 0x55 forms an alternating bit pattern, the time between the first
+ * falling edge (start bit) and the fifth rising edge (stop bit) equals 9 bit
+ * times. The RXD pin is polled while TIMER1 runs at F_CPU, the measurement
+ * therefore must take place with interrupts disabled and before the UART
+ * receiver is enabled. The previous TIMER1 configuration is restored.
+ *
+ * The polling loop limits the usable range to approx. 2400 - 250000 baud
+ * @ 16 MHz, the result is rounded to the closest standard baud rate.
+ */
+class AvrAutoBaud
+{
+
+public:
+
+  AvrAutoBaud(volatile uint8_t  * rx_pin,
+              uint8_t     const   rx_pin_number,
+              volatile uint8_t  * tccr1a,
+              volatile uint8_t  * tccr1b,
+              volatile uint16_t * tcnt1,
+              uint32_t    const   f_cpu);
+
+
+  /* Waits up to timeout_ms for a sync character, returns the detected
+   * standard baud rate or 0 if none was received or the measurement failed.
+   */
+  uint32_t detect(uint16_t const timeout_ms);
+
+private:
+
+  static uint8_t constexpr SYNC_CHAR_NUM_BITS = 9;
+
+  volatile uint8_t  * _PIN;
+  uint8_t             _rx_pin_bm;
+  volatile uint8_t  * _TCCR1A;
+  volatile uint8_t  * _TCCR1B;
+  volatile uint16_t * _TCNT1;
+  uint32_t            _f_cpu;
+
+  bool waitForLevel(bool const level, uint16_t const start, uint16_t const max_ticks);
+  bool waitForLevel(bool const level, uint32_t & num_overflows, uint32_t const max_overflows);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_AVRAUTOBAUD_H_ */
@@ -0,0 +1,144 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_BULKUARTRECEIVER_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_BULKUARTRECEIVER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <string.h>
+
+#include <snowfox/hal/interface/uart/UART.h>
+#include <snowfox/hal/interface/uart/UARTCallback.h>
+
+#include "../../../hal/common/SpscRingBuffer.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Received bytes are stored by the UART interrupt within a lock-free ring
+ * buffer, the application accesses whatever has arrived so far in bulk.
+ * As opposed to blox::SerialUart::read() no critical section is entered,
+ * neither per byte nor per call, and the data can be parsed in place via
+ * peek()/consume():
+ *
+ *   uint8_t const * data = nullptr;
+ *   uint16_t const num_bytes = bulk_rx.peek(data);
+ *   ... parse data[0 .. num_bytes - 1] ...
+ *   bulk_rx.consume(num_bytes);
+ *
+ * This class takes the place of blox::SerialUart and must be registered as
+ * the UART callback, i.e. uart1().registerUARTCallback(&bulk_rx). Transmit
+ * interrupts are forwarded to the optional tx_callback (e.g. a
+ * serial::UartScatterGatherTransmitter).
+ */
+template <uint16_t RX_BUFFER_SIZE>
+class BulkUartReceiver : public hal::interface::UARTCallback
+{
+
+public:
+
+  BulkUartReceiver(hal::interface::UART         & uart,
+                   hal::interface::UARTCallback * tx_callback)
+  : _uart       (uart       ),
+    _tx_callback(tx_callback),
+    _overruns   (0          )
+  {
+
+  }
+
+  virtual ~BulkUartReceiver()
+  {
+
+  }
+
+
+  inline uint16_t available() const                      { return _rx_buffer.available(); }
+  inline uint16_t peek     (uint8_t const * & data) const { return _rx_buffer.peek(data);  }
+  inline void     consume  (uint16_t const num_bytes)     { _rx_buffer.consume(num_bytes); }
+
+
+  /* Never blocks, copies all available bytes (up to max_num_bytes). */
+  uint16_t readAvailable(uint8_t * buf, uint16_t const max_num_bytes)
+  {
+    uint16_t bytes_read = 0;
+
+    /* At most two contiguous regions due to the wrap-around */
+    for(uint8_t region = 0; (region < 2) && (bytes_read < max_num_bytes); region++)
+    {
+      uint8_t const * data      = nullptr;
+      uint16_t        num_bytes = _rx_buffer.peek(data);
+
+      if(num_bytes == 0) break;
+      if(num_bytes > (max_num_bytes - bytes_read)) num_bytes = max_num_bytes - bytes_read;
+
+      memcpy(buf + bytes_read, data, num_bytes);
+      _rx_buffer.consume(num_bytes);
+      bytes_read += num_bytes;
+    }
+
+    return bytes_read;
+  }
+
+
+  virtual void onReceiveComplete() override
+  {
+    uint8_t data = 0;
+    _uart.receive(data);
+
+    if(!_rx_buffer.push(&data, 1)) {
+      _overruns++;
+    }
+  }
+
+  virtual void onTransmitRegisterEmpty() override
+  {
+    if(_tx_callback) {
+      _tx_callback->onTransmitRegisterEmpty();
+    }
+  }
+
+
+  inline uint16_t overruns() const { return _overruns; }
+
+private:
+
+  hal::interface::UART                  & _uart;
+  hal::interface::UARTCallback          * _tx_callback;
+  hal::SpscRingBuffer<RX_BUFFER_SIZE>     _rx_buffer;
+  uint16_t                       volatile _overruns;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_BULKUARTRECEIVER_H_ */
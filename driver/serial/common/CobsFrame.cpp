@@ -0,0 +1,173 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "CobsFrame.h"
+
+#include "Crc16.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * PUBLIC FUNCTIONS
+ **************************************************************************************/
+
+uint16_t cobsEncodeFrame(uint8_t const * payload, uint16_t const payload_size, uint8_t * frame, uint16_t const frame_size)
+{
+  if(frame_size < cobsFrameMaxSize(payload_size)) return 0;
+
+  uint16_t const crc = crc16(CRC16_INIT, payload, payload_size);
+  uint8_t  const crc_bytes[COBS_FRAME_CRC_SIZE] = {static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc)};
+
+  uint16_t code_pos  = 0;
+  uint16_t frame_pos = 1;
+  uint8_t  code      = 1;
+
+  for(uint16_t i = 0; i < (payload_size + COBS_FRAME_CRC_SIZE); i++)
+  {
+    uint8_t const data = (i < payload_size) ? payload[i] : crc_bytes[i - payload_size];
+
+    if(data != 0) {
+      frame[frame_pos++] = data;
+      code++;
+    }
+
+    /* A zero byte as well as a block of 254 non-zero bytes terminate the
+     * current block, the code byte is the distance to the next zero.
+     */
+    if((data == 0) || (code == 0xFF)) {
+      frame[code_pos] = code;
+      code_pos        = frame_pos++;
+      code            = 1;
+    }
+  }
+
+  frame[code_pos]    = code;
+  frame[frame_pos++] = COBS_FRAME_DELIMITER;
+
+  return frame_pos;
+}
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+CobsFrameDecoder::CobsFrameDecoder(uint8_t * payload, uint16_t const payload_buffer_size)
+: _payload            (payload            ),
+  _payload_buffer_size(payload_buffer_size),
+  _payload_size       (0                  ),
+  _buffer_pos         (0                  ),
+  _code               (0xFF               ),
+  _remaining          (0                  ),
+  _error              (false              ),
+  _crc_errors         (0                  ),
+  _framing_errors     (0                  )
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool CobsFrameDecoder::decode(uint8_t const data)
+{
+  if(data == COBS_FRAME_DELIMITER)
+  {
+    bool const is_empty = (_buffer_pos == 0) && (_code == 0xFF) && !_error;
+    bool const is_valid = !_error && (_remaining == 0) && (_buffer_pos >= COBS_FRAME_CRC_SIZE);
+    uint16_t const size = _buffer_pos;
+
+    reset();
+
+    /* Consecutive delimiters are allowed, e.g. for flushing the
+     * receiver before the first frame, and are silently ignored.
+     */
+    if(is_empty) return false;
+
+    if(!is_valid) {
+      _framing_errors++;
+      return false;
+    }
+
+    if(crc16(CRC16_INIT, _payload, size) != 0) {
+      _crc_errors++;
+      return false;
+    }
+
+    _payload_size = size - COBS_FRAME_CRC_SIZE;
+    return true;
+  }
+
+  if(_error) return false;
+
+  if(_remaining == 0)
+  {
+    /* Start of a new block - the implicit zero at the end of the previous
+     * block is only stored once it is clear that it is not the last one.
+     */
+    if(_code != 0xFF) {
+      if(!store(0)) return false;
+    }
+    _code      = data;
+    _remaining = data - 1;
+  }
+  else
+  {
+    if(!store(data)) return false;
+    _remaining--;
+  }
+
+  return false;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool CobsFrameDecoder::store(uint8_t const data)
+{
+  if(_buffer_pos == _payload_buffer_size) {
+    _error = true;
+    return false;
+  }
+  _payload[_buffer_pos++] = data;
+  return true;
+}
+
+void CobsFrameDecoder::reset()
+{
+  _buffer_pos = 0;
+  _code       = 0xFF;
+  _remaining  = 0;
+  _error      = false;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
@@ -0,0 +1,118 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_COBSFRAME_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_COBSFRAME_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* Frame layout:
+ *
+ *   | COBS(PAYLOAD | CRC16_HI | CRC16_LO) | 0x00 |
+ *
+ * Consistent overhead byte stuffing (COBS) removes all zero bytes from the
+ * payload, a zero byte therefore unambiguously marks the end of a frame and
+ * the receiver can resynchronise after any transmission error. The CRC is a
+ * CRC-16/CCITT-FALSE calculated over the payload.
+ */
+static uint8_t  constexpr COBS_FRAME_DELIMITER = 0x00;
+static uint16_t constexpr COBS_FRAME_CRC_SIZE  = 2;
+
+/**************************************************************************************
+ * FUNCTION DECLARATION
+ **************************************************************************************/
+
+/* Worst case size of an encoded frame containing payload_size bytes. */
+constexpr uint16_t cobsFrameMaxSize(uint16_t const payload_size)
+{
+  return (payload_size + COBS_FRAME_CRC_SIZE) + ((payload_size + COBS_FRAME_CRC_SIZE) / 254) + 1 + 1;
+}
+
+/* Returns the number of bytes of the encoded frame or 0 if the
+ * frame does not fit into the provided buffer.
+ */
+uint16_t cobsEncodeFrame(uint8_t const * payload, uint16_t const payload_size, uint8_t * frame, uint16_t const frame_size);
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Decodes a COBS frame byte by byte as it is received, no intermediate
+ * copy of the encoded frame is required. Frames which are malformed, have
+ * a wrong CRC or do not fit into the payload buffer are discarded. The
+ * payload buffer needs to hold the CRC too, i.e. its size must be at least
+ * the maximum payload size + COBS_FRAME_CRC_SIZE.
+ */
+class CobsFrameDecoder
+{
+
+public:
+
+  CobsFrameDecoder(uint8_t * payload, uint16_t const payload_buffer_size);
+
+
+  /* Returns true as soon as a complete and valid frame has been received,
+   * the payload remains valid until the next call to decode().
+   */
+  bool decode(uint8_t const data);
+
+  inline uint8_t  const * payload       () const { return _payload;       }
+  inline uint16_t         payloadSize   () const { return _payload_size;  }
+
+  inline uint16_t         crcErrors     () const { return _crc_errors;    }
+  inline uint16_t         framingErrors () const { return _framing_errors; }
+
+private:
+
+  uint8_t  * _payload;
+  uint16_t   _payload_buffer_size;
+  uint16_t   _payload_size;
+  uint16_t   _buffer_pos;
+  uint8_t    _code;
+  uint8_t    _remaining;
+  bool       _error;
+  uint16_t   _crc_errors;
+  uint16_t   _framing_errors;
+
+  bool store(uint8_t const data);
+  void reset();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_COBSFRAME_H_ */
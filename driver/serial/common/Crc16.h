@@ -0,0 +1,68 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_CRC16_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_CRC16_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t constexpr CRC16_INIT = 0xFFFF;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+/* CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), calculated
+ * bitwise in order to avoid spending 512 bytes of flash on a lookup table.
+ * Appending the CRC in big endian order results in a CRC of 0 over the
+ * complete message.
+ */
+inline uint16_t crc16(uint16_t crc, uint8_t const * data, uint16_t const size)
+{
+  for(uint16_t i = 0; i < size; i++)
+  {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for(uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_CRC16_H_ */
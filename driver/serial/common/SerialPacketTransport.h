@@ -0,0 +1,132 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_SERIALPACKETTRANSPORT_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_SERIALPACKETTRANSPORT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <string.h>
+
+#include <snowfox/driver/serial/interface/Serial.h>
+
+#include "CobsFrame.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Packet transport on top of a byte stream (i.e. blox::SerialUart) using
+ * COBS framing and a CRC-16 (see CobsFrame.h). Received bytes are fetched
+ * from the serial driver in chunks and decoded on the fly, the application
+ * only ever sees complete and valid packets.
+ */
+template <uint16_t MAX_PAYLOAD_SIZE>
+class SerialPacketTransport
+{
+
+public:
+
+  SerialPacketTransport(interface::Serial & serial)
+  : _serial      (serial                                             ),
+    _decoder     (_rx_payload, MAX_PAYLOAD_SIZE + COBS_FRAME_CRC_SIZE),
+    _rx_chunk_pos(0                                                  ),
+    _rx_chunk_len(0                                                  )
+  {
+
+  }
+
+
+  /* Blocks until the complete frame has been passed to the serial driver. */
+  bool send(uint8_t const * payload, uint16_t const payload_size)
+  {
+    uint16_t const frame_size = cobsEncodeFrame(payload, payload_size, _tx_frame, sizeof(_tx_frame));
+    if(frame_size == 0) return false;
+
+    for(ssize_t bytes_written = 0; bytes_written != frame_size; )
+    {
+      bytes_written += _serial.write(_tx_frame + bytes_written, frame_size - bytes_written);
+    }
+
+    return true;
+  }
+
+  /* Never blocks, returns the size of a received packet which has been
+   * copied to payload or 0 if no complete packet is available yet.
+   */
+  uint16_t receive(uint8_t * payload, uint16_t const max_payload_size)
+  {
+    for(;;)
+    {
+      if(_rx_chunk_pos == _rx_chunk_len)
+      {
+        ssize_t const bytes_read = _serial.read(_rx_chunk, RX_CHUNK_SIZE);
+        if(bytes_read <= 0) return 0;
+        _rx_chunk_pos = 0;
+        _rx_chunk_len = static_cast<uint8_t>(bytes_read);
+      }
+
+      /* Bytes following the end of a frame are retained within
+       * the chunk and decoded during the next call of receive().
+       */
+      while(_rx_chunk_pos < _rx_chunk_len)
+      {
+        if(_decoder.decode(_rx_chunk[_rx_chunk_pos++]))
+        {
+          if(_decoder.payloadSize() > max_payload_size) continue;
+          memcpy(payload, _decoder.payload(), _decoder.payloadSize());
+          return _decoder.payloadSize();
+        }
+      }
+    }
+  }
+
+
+  inline uint16_t crcErrors    () const { return _decoder.crcErrors();     }
+  inline uint16_t framingErrors() const { return _decoder.framingErrors(); }
+
+private:
+
+  static uint8_t constexpr RX_CHUNK_SIZE = 16;
+
+  interface::Serial & _serial;
+  uint8_t             _tx_frame  [cobsFrameMaxSize(MAX_PAYLOAD_SIZE)];
+  uint8_t             _rx_payload[MAX_PAYLOAD_SIZE + COBS_FRAME_CRC_SIZE];
+  CobsFrameDecoder    _decoder;
+  uint8_t             _rx_chunk  [RX_CHUNK_SIZE];
+  uint8_t             _rx_chunk_pos;
+  uint8_t             _rx_chunk_len;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_SERIALPACKETTRANSPORT_H_ */
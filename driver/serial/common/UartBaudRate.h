@@ -0,0 +1,249 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_UARTBAUDRATE_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_UARTBAUDRATE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+typedef struct
+{
+  uint32_t baud;
+  uint16_t ubrr;
+  bool     u2x;
+  int32_t  error_ppm;
+} AvrBaudSetting;
+
+typedef struct
+{
+  uint32_t baud;
+  uint16_t div;
+  int32_t  error_ppm;
+} Fe310BaudSetting;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* Baud rates above B115200 (the highest serial::interface::SerialBaudRate)
+ * are configured by overwriting the divisor registers after the UART has
+ * been set up by blox::SerialUart, see avrSetBaudRate/fe310SetBaudRate.
+ */
+static uint32_t constexpr STANDARD_BAUD_RATES[] =
+{
+  2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 250000, 460800, 500000, 921600, 1000000, 2000000
+};
+static uint8_t  constexpr NUM_STANDARD_BAUD_RATES = sizeof(STANDARD_BAUD_RATES) / sizeof(STANDARD_BAUD_RATES[0]);
+
+/* The AVR datasheets recommend a maximum receiver error of 2 % (8N1), the
+ * B115200 @ 16 MHz used by all examples is at +2.1 % and works fine with
+ * the (accurate) USB serial converters, hence the slightly higher limit.
+ */
+static int32_t  constexpr MAX_BAUD_ERROR_ppm = 25000;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+constexpr int32_t baudErrorPpm(uint32_t const actual_baud, uint32_t const baud)
+{
+  return static_cast<int32_t>((static_cast<int64_t>(actual_baud) - baud) * 1000000 / baud);
+}
+
+constexpr int32_t absErrorPpm(int32_t const error_ppm)
+{
+  return (error_ppm < 0) ? -error_ppm : error_ppm;
+}
+
+/* AVR USART: baud = f_cpu / (16 * (UBRR + 1)) or with U2X set
+ * baud = f_cpu / (8 * (UBRR + 1)), UBRR is 12 bit wide.
+ */
+constexpr AvrBaudSetting avrBaudSetting(uint32_t const f_cpu, uint32_t const baud, bool const u2x)
+{
+  uint32_t const divisor = (u2x ? 8UL : 16UL) * baud;
+  uint32_t const ubrr_1  = (f_cpu + divisor / 2) / divisor;
+  uint32_t const ubrr    = (ubrr_1 == 0) ? 0 : ((ubrr_1 > 4096) ? 4095 : (ubrr_1 - 1));
+  uint32_t const actual  = f_cpu / ((u2x ? 8UL : 16UL) * (ubrr + 1));
+
+  return AvrBaudSetting{baud, static_cast<uint16_t>(ubrr), u2x, baudErrorPpm(actual, baud)};
+}
+
+/* Selects U2X only if it results in a smaller error, the normal mode
+ * samples with 16x oversampling and is more robust against noise.
+ */
+constexpr AvrBaudSetting avrBaudSetting(uint32_t const f_cpu, uint32_t const baud)
+{
+  AvrBaudSetting const normal     = avrBaudSetting(f_cpu, baud, false);
+  AvrBaudSetting const double_spd = avrBaudSetting(f_cpu, baud, true );
+
+  return (absErrorPpm(double_spd.error_ppm) < absErrorPpm(normal.error_ppm)) ? double_spd : normal;
+}
+
+/* FE310 UART: baud = f_in / (div + 1), div is 16 bit wide. */
+constexpr Fe310BaudSetting fe310BaudSetting(uint32_t const f_in, uint32_t const baud)
+{
+  uint32_t const div_1  = (f_in + baud / 2) / baud;
+  uint32_t const div    = (div_1 == 0) ? 0 : ((div_1 > 65536) ? 65535 : (div_1 - 1));
+  uint32_t const actual = f_in / (div + 1);
+
+  return Fe310BaudSetting{baud, static_cast<uint16_t>(div), baudErrorPpm(actual, baud)};
+}
+
+constexpr bool isBaudRateUsable(int32_t const error_ppm)
+{
+  return absErrorPpm(error_ppm) <= MAX_BAUD_ERROR_ppm;
+}
+
+/* Returns the standard baud rate closest to a measured baud rate or 0
+ * if the measured rate deviates more than 5 % from any standard rate.
+ */
+constexpr uint32_t toStandardBaudRate(uint32_t const measured_baud)
+{
+  uint32_t best     = 0;
+  int32_t  best_err = 50000;
+
+  for(uint8_t i = 0; i < NUM_STANDARD_BAUD_RATES; i++)
+  {
+    int32_t const err = absErrorPpm(baudErrorPpm(measured_baud, STANDARD_BAUD_RATES[i]));
+    if(err < best_err) {
+      best     = STANDARD_BAUD_RATES[i];
+      best_err = err;
+    }
+  }
+
+  return best;
+}
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Baud rate error table calculated at compile time, e.g.
+ *
+ *   typedef AvrBaudTable<F_CPU> BaudTable;
+ *   static_assert(BaudTable::isSupported(1000000), "");
+ *   avrSetBaudRate(&UBRR0, &UCSR0A, BaudTable::setting(1000000));
+ */
+template <uint32_t F_CPU_Hz>
+struct AvrBaudTable
+{
+  static constexpr AvrBaudSetting SETTING[NUM_STANDARD_BAUD_RATES] =
+  {
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 0]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 1]),
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 2]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 3]),
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 4]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 5]),
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 6]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 7]),
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 8]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[ 9]),
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[10]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[11]),
+    avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[12]), avrBaudSetting(F_CPU_Hz, STANDARD_BAUD_RATES[13])
+  };
+
+  static constexpr uint8_t index(uint32_t const baud)
+  {
+    for(uint8_t i = 0; i < NUM_STANDARD_BAUD_RATES; i++) {
+      if(STANDARD_BAUD_RATES[i] == baud) return i;
+    }
+    return NUM_STANDARD_BAUD_RATES;
+  }
+
+  /* False for non-standard baud rates as well as for baud rates which
+   * can not be generated from F_CPU within MAX_BAUD_ERROR_ppm.
+   */
+  static constexpr bool isSupported(uint32_t const baud)
+  {
+    return (index(baud) < NUM_STANDARD_BAUD_RATES) && isBaudRateUsable(SETTING[index(baud)].error_ppm);
+  }
+
+  static constexpr AvrBaudSetting setting(uint32_t const baud)
+  {
+    return SETTING[index(baud)];
+  }
+};
+
+template <uint32_t F_IN_Hz>
+struct Fe310BaudTable
+{
+  static constexpr Fe310BaudSetting SETTING[NUM_STANDARD_BAUD_RATES] =
+  {
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 0]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 1]),
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 2]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 3]),
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 4]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 5]),
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 6]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 7]),
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 8]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[ 9]),
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[10]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[11]),
+    fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[12]), fe310BaudSetting(F_IN_Hz, STANDARD_BAUD_RATES[13])
+  };
+
+  static constexpr uint8_t index(uint32_t const baud)
+  {
+    return AvrBaudTable<F_IN_Hz>::index(baud);
+  }
+
+  static constexpr bool isSupported(uint32_t const baud)
+  {
+    return (index(baud) < NUM_STANDARD_BAUD_RATES) && isBaudRateUsable(SETTING[index(baud)].error_ppm);
+  }
+
+  static constexpr Fe310BaudSetting setting(uint32_t const baud)
+  {
+    return SETTING[index(baud)];
+  }
+};
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+/* Register access, the U2X bit is bit 1 of UCSRnA on all supported AVRs. */
+inline void avrSetBaudRate(volatile uint16_t * ubrr, volatile uint8_t * ucsra, AvrBaudSetting const & setting)
+{
+  static uint8_t constexpr U2X_bm = (1 << 1);
+
+  if(setting.u2x) *ucsra |=  U2X_bm;
+  else            *ucsra &= ~U2X_bm;
+
+  *ubrr = setting.ubrr;
+}
+
+inline void fe310SetBaudRate(volatile uint32_t * uart_div, Fe310BaudSetting const & setting)
+{
+  *uart_div = setting.div;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_UARTBAUDRATE_H_ */
@@ -0,0 +1,132 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "UartScatterGatherTransmitter.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+UartScatterGatherTransmitter::UartScatterGatherTransmitter(hal::interface::UART         & uart,
+                                                           hal::interface::UARTCallback * rx_callback)
+: _uart        (uart       ),
+  _rx_callback (rx_callback),
+  _num_segments(0          ),
+  _segment_idx (0          ),
+  _segment_pos (0          ),
+  _callback    (nullptr    ),
+  _busy        (false      )
+{
+
+}
+
+UartScatterGatherTransmitter::~UartScatterGatherTransmitter()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool UartScatterGatherTransmitter::write(UartTxSegment                          const * segments,
+                                         uint8_t                                const   num_segments,
+                                         interface::UartTransmitCompleteCallback      * callback)
+{
+  if(_busy)                           return false;
+  if(num_segments > MAX_NUM_SEGMENTS) return false;
+
+  /* Only the segment descriptors are copied, never the data itself. */
+  for(uint8_t s = 0; s < num_segments; s++) {
+    _segment[s] = segments[s];
+  }
+
+  _num_segments = num_segments;
+  _segment_idx  = 0;
+  _segment_pos  = 0;
+  _callback     = callback;
+
+  /* The transmitter is idle, so no UART interrupt can fire before
+   * the first byte is written by transmitNext(). From then on the
+   * interrupt may preempt transmitNext() at any time, which is why
+   * the position is advanced before the byte is handed to the UART.
+   */
+  _busy = true;
+  transmitNext();
+
+  return true;
+}
+
+void UartScatterGatherTransmitter::onTransmitRegisterEmpty()
+{
+  transmitNext();
+}
+
+void UartScatterGatherTransmitter::onReceiveComplete()
+{
+  if(_rx_callback) {
+    _rx_callback->onReceiveComplete();
+  }
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void UartScatterGatherTransmitter::transmitNext()
+{
+  /* Skip exhausted (or empty) segments */
+  while((_segment_idx < _num_segments) && (_segment_pos == _segment[_segment_idx].size))
+  {
+    _segment_idx++;
+    _segment_pos = 0;
+  }
+
+  if(_segment_idx < _num_segments)
+  {
+    uint8_t const data = _segment[_segment_idx].data[_segment_pos];
+    _segment_pos++;
+    _uart.transmit(data);
+  }
+  else
+  {
+    interface::UartTransmitCompleteCallback * callback = _callback;
+    _callback = nullptr;
+    _busy     = false;
+    if(callback) {
+      callback->onTransmitComplete();
+    }
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
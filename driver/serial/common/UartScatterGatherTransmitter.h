@@ -0,0 +1,113 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_UARTSCATTERGATHERTRANSMITTER_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_UARTSCATTERGATHERTRANSMITTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/uart/UART.h>
+#include <snowfox/hal/interface/uart/UARTCallback.h>
+
+#include "UartTransmitCompleteCallback.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+typedef struct
+{
+  uint8_t  const * data;
+  uint16_t         size;
+} UartTxSegment;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Transmits caller owned buffers directly from within the UART interrupt
+ * without copying them into an intermediate TX buffer as blox::SerialUart
+ * does. A transmission consists of up to MAX_NUM_SEGMENTS segments (i.e.
+ * header, payload, trailer) which are sent back-to-back. The segments and
+ * the data they point to must remain valid until the completion callback
+ * has been invoked or isBusy() returns false.
+ *
+ * This class takes the place of blox::SerialUart and must be registered as
+ * the UART callback, i.e. uart0().registerUARTCallback(&uart_tx). Receive
+ * interrupts are forwarded to the optional rx_callback.
+ */
+class UartScatterGatherTransmitter : public hal::interface::UARTCallback
+{
+
+public:
+
+  static uint8_t constexpr MAX_NUM_SEGMENTS = 4;
+
+
+           UartScatterGatherTransmitter(hal::interface::UART         & uart,
+                                        hal::interface::UARTCallback * rx_callback);
+  virtual ~UartScatterGatherTransmitter();
+
+
+  /* Returns false if a transmission is still ongoing or if the number of
+   * segments exceeds MAX_NUM_SEGMENTS, the callback may be a nullptr.
+   */
+  bool write(UartTxSegment                          const * segments,
+             uint8_t                                const   num_segments,
+             interface::UartTransmitCompleteCallback      * callback);
+
+  inline bool isBusy() const { return _busy; }
+
+
+  virtual void onTransmitRegisterEmpty() override;
+  virtual void onReceiveComplete      () override;
+
+private:
+
+  hal::interface::UART                             & _uart;
+  hal::interface::UARTCallback                     * _rx_callback;
+  UartTxSegment                                      _segment[MAX_NUM_SEGMENTS];
+  /* Shared with the UART interrupt */
+  uint8_t                                   volatile _num_segments;
+  uint8_t                                   volatile _segment_idx;
+  uint16_t                                  volatile _segment_pos;
+  interface::UartTransmitCompleteCallback * volatile _callback;
+  bool                                      volatile _busy;
+
+  void transmitNext();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_UARTSCATTERGATHERTRANSMITTER_H_ */
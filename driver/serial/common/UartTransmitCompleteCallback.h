@@ -0,0 +1,55 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_DRIVER_SERIAL_COMMON_UARTTRANSMITCOMPLETECALLBACK_H_
+#define EXAMPLES_DRIVER_SERIAL_COMMON_UARTTRANSMITCOMPLETECALLBACK_H_
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::driver::serial::interface
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+class UartTransmitCompleteCallback
+{
+
+public:
+
+  virtual ~UartTransmitCompleteCallback() { }
+
+
+  /* Invoked from within the UART interrupt as soon as the last byte of
+   * a transmission has been handed to the UART, the buffers passed to
+   * write() are no longer accessed and are returned to the caller.
+   */
+  virtual void onTransmitComplete() = 0;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::driver::serial::interface */
+
+#endif /* EXAMPLES_DRIVER_SERIAL_COMMON_UARTTRANSMITCOMPLETECALLBACK_H_ */
@@ -0,0 +1,280 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Linux host counterpart of driver/serial/common/SerialPacketTransport.h. Sends
+ * COBS/CRC-16 framed packets to a device running the packet echo example (e.g.
+ * driver/serial/uart1-at90can128-packet-echo), waits for every echo and reports
+ * round trip latency and throughput.
+ *
+ * With --pty the device is simulated by a child process on the other end of a
+ * pseudo-terminal pair, this allows to benchmark the framing without hardware.
+ *
+ * Build
+ *   mkdir build && cd build && cmake .. && make
+ *
+ * Usage
+ *   serial-packet-host [--count N] [--size BYTES] /dev/ttyUSB0
+ *   serial-packet-host [--count N] [--size BYTES] --pty
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <poll.h>
+#include <time.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+
+#include "../common/CobsFrame.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const MAX_PAYLOAD_SIZE = 64;
+static int      const RX_TIMEOUT_ms    = 1000;
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+class PacketLink
+{
+public:
+
+  PacketLink(int const fd)
+  : _fd     (fd                               ),
+    _decoder(_rx_payload, sizeof(_rx_payload))
+  { }
+
+  bool send(uint8_t const * payload, uint16_t const payload_size)
+  {
+    uint16_t const frame_size = serial::cobsEncodeFrame(payload, payload_size, _tx_frame, sizeof(_tx_frame));
+    if(frame_size == 0) return false;
+
+    for(uint16_t pos = 0; pos < frame_size; )
+    {
+      ssize_t const bytes_written = ::write(_fd, _tx_frame + pos, frame_size - pos);
+      if(bytes_written < 0) return false;
+      pos += bytes_written;
+    }
+    return true;
+  }
+
+  /* Returns the payload size, 0 upon a timeout and -1 upon an error. */
+  ssize_t receive(uint8_t * payload, int const timeout_ms)
+  {
+    for(;;)
+    {
+      while(_rx_pos < _rx_len)
+      {
+        if(_decoder.decode(_rx_buf[_rx_pos++])) {
+          memcpy(payload, _decoder.payload(), _decoder.payloadSize());
+          return _decoder.payloadSize();
+        }
+      }
+
+      pollfd pfd = {_fd, POLLIN, 0};
+      int const rc = poll(&pfd, 1, timeout_ms);
+      if(rc == 0) return 0;
+      if(rc <  0) return -1;
+
+      ssize_t const bytes_read = ::read(_fd, _rx_buf, sizeof(_rx_buf));
+      if(bytes_read <= 0) return -1;
+      _rx_pos = 0;
+      _rx_len = bytes_read;
+    }
+  }
+
+  inline uint16_t crcErrors    () const { return _decoder.crcErrors();     }
+  inline uint16_t framingErrors() const { return _decoder.framingErrors(); }
+
+private:
+
+  int                      _fd;
+  uint8_t                  _tx_frame  [serial::cobsFrameMaxSize(MAX_PAYLOAD_SIZE)];
+  uint8_t                  _rx_payload[MAX_PAYLOAD_SIZE + serial::COBS_FRAME_CRC_SIZE];
+  serial::CobsFrameDecoder _decoder;
+  uint8_t                  _rx_buf[256];
+  ssize_t                  _rx_pos = 0;
+  ssize_t                  _rx_len = 0;
+};
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static double now_us()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static bool configure_raw(int const fd, speed_t const baud)
+{
+  termios tio;
+  if(tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, baud);
+  cfsetospeed(&tio, baud);
+  return (tcsetattr(fd, TCSANOW, &tio) == 0);
+}
+
+/* Simulates the packet echo example on the device side of the pty pair. */
+static void echo_device(int const fd)
+{
+  PacketLink link(fd);
+  uint8_t    packet[MAX_PAYLOAD_SIZE];
+
+  for(;;)
+  {
+    ssize_t const packet_size = link.receive(packet, -1);
+    if(packet_size < 0) _exit(EXIT_FAILURE);
+    link.send(packet, packet_size);
+  }
+}
+
+static int benchmark(int const fd, unsigned int const count, uint16_t const size)
+{
+  PacketLink link(fd);
+  uint8_t    tx_packet[MAX_PAYLOAD_SIZE];
+  uint8_t    rx_packet[MAX_PAYLOAD_SIZE];
+
+  double       min_us = 1e12, max_us = 0, sum_us = 0;
+  unsigned int lost = 0, corrupt = 0;
+
+  double const start_us = now_us();
+
+  for(unsigned int i = 0; i < count; i++)
+  {
+    /* Zero bytes are included on purpose in order to exercise the stuffing */
+    for(uint16_t b = 0; b < size; b++) {
+      tx_packet[b] = static_cast<uint8_t>((i + b) % 7 == 0 ? 0 : (i * 31 + b));
+    }
+
+    double const t0_us = now_us();
+    if(!link.send(tx_packet, size)) {
+      perror("write");
+      return EXIT_FAILURE;
+    }
+
+    ssize_t const rx_size = link.receive(rx_packet, RX_TIMEOUT_ms);
+    if(rx_size < 0) {
+      perror("read");
+      return EXIT_FAILURE;
+    }
+
+    double const rtt_us = now_us() - t0_us;
+
+    if     (rx_size == 0)                                                   lost++;
+    else if((rx_size != size) || (memcmp(tx_packet, rx_packet, size) != 0)) corrupt++;
+
+    if(rtt_us < min_us) min_us = rtt_us;
+    if(rtt_us > max_us) max_us = rtt_us;
+    sum_us += rtt_us;
+  }
+
+  double const total_s = (now_us() - start_us) / 1e6;
+
+  printf("packets          : %u x %u bytes\n", count, size);
+  printf("lost / corrupt   : %u / %u\n", lost, corrupt);
+  printf("crc / framing err: %u / %u\n", link.crcErrors(), link.framingErrors());
+  printf("round trip       : min %.1f us, avg %.1f us, max %.1f us\n", min_us, sum_us / count, max_us);
+  printf("throughput       : %.1f packets/s, %.1f kB/s payload (both directions)\n", count / total_s, 2.0 * count * size / total_s / 1000.0);
+
+  return (lost == 0 && corrupt == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main(int argc, char ** argv)
+{
+  unsigned int count  = 1000;
+  unsigned int size   = 32;
+  bool         pty    = false;
+  char const * device = nullptr;
+
+  for(int arg = 1; arg < argc; arg++)
+  {
+    if     (strcmp(argv[arg], "--count") == 0 && (arg + 1) < argc) count  = strtoul(argv[++arg], nullptr, 0);
+    else if(strcmp(argv[arg], "--size")  == 0 && (arg + 1) < argc) size   = strtoul(argv[++arg], nullptr, 0);
+    else if(strcmp(argv[arg], "--pty")   == 0)                     pty    = true;
+    else                                                           device = argv[arg];
+  }
+
+  if((!pty && !device) || (count == 0) || (size > MAX_PAYLOAD_SIZE)) {
+    fprintf(stderr, "usage: %s [--count N] [--size BYTES (<= %u)] (DEVICE | --pty)\n", argv[0], MAX_PAYLOAD_SIZE);
+    return EXIT_FAILURE;
+  }
+
+  if(!pty)
+  {
+    int const fd = open(device, O_RDWR | O_NOCTTY);
+    if(fd < 0 || !configure_raw(fd, B115200)) {
+      perror(device);
+      return EXIT_FAILURE;
+    }
+    int const rc = benchmark(fd, count, size);
+    close(fd);
+    return rc;
+  }
+
+  int const master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if(master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0) {
+    perror("posix_openpt");
+    return EXIT_FAILURE;
+  }
+
+  int const slave_fd = open(ptsname(master_fd), O_RDWR | O_NOCTTY);
+  if(slave_fd < 0 || !configure_raw(slave_fd, B115200)) {
+    perror("ptsname");
+    return EXIT_FAILURE;
+  }
+
+  pid_t const pid = fork();
+  if(pid == 0) {
+    close(master_fd);
+    echo_device(slave_fd);
+  }
+  close(slave_fd);
+
+  int const rc = benchmark(master_fd, count, size);
+
+  kill(pid, SIGTERM);
+  waitpid(pid, nullptr, 0);
+  close(master_fd);
+
+  return rc;
+}
@@ -0,0 +1,130 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno
+ *
+ * After a reset the baud rate is detected from a 'U' (0x55) sent by the host, i.e.
+ *   stty -F /dev/ttyACM0 250000 raw && printf U > /dev/ttyACM0
+ * If no 'U' arrives within 5 s or the detected baud rate can not be generated from
+ * F_CPU the UART falls back to 1 MBaud. Afterwards all received data is echoed back.
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:driver-serial-uart0-atmega328p-high-speed
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include "../common/AvrAutoBaud.h"
+#include "../common/UartBaudRate.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const UART_RX_BUFFER_SIZE  = 64;
+static uint16_t const UART_TX_BUFFER_SIZE  = 64;
+static uint32_t const UART_DEFAULT_BAUD    = 1000000;
+static uint16_t const AUTO_BAUD_TIMEOUT_ms = 5000;
+
+/* The baud rate error table is calculated at compile time from F_CPU, an
+ * unreachable default baud rate therefore fails the build.
+ */
+typedef serial::AvrBaudTable<F_CPU> BaudTable;
+
+static_assert(BaudTable::isSupported(UART_DEFAULT_BAUD), "UART_DEFAULT_BAUD can not be generated from F_CPU");
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /* HAL ******************************************************************************/
+
+  /* The auto baud detection polls RXD = PD0 and needs to take place before the
+   * UART receiver is enabled and before interrupts are enabled globally.
+   */
+  serial::AvrAutoBaud auto_baud(&PIND, 0, &TCCR1A, &TCCR1B, &TCNT1, F_CPU);
+
+  uint32_t baud = auto_baud.detect(AUTO_BAUD_TIMEOUT_ms);
+  if((baud == 0) || !serial::isBaudRateUsable(serial::avrBaudSetting(F_CPU, baud).error_ppm)) {
+    baud = UART_DEFAULT_BAUD;
+  }
+
+  ATMEGA328P::InterruptController int_ctrl(&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  blox::ATMEGA328P::UART0         uart0   (&UDR0, &UCSR0A, &UCSR0B, &UCSR0C, &UBRR0, int_ctrl, F_CPU);
+
+
+  /* DRIVER ***************************************************************************/
+
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  /* serial::interface::SerialBaudRate ends at B115200, the divisor
+   * is therefore overwritten after the UART has been configured.
+   */
+  serial::avrSetBaudRate(&UBRR0, &UCSR0A, serial::avrBaudSetting(F_CPU, baud));
+
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /* APPLICATION **********************************************************************/
+
+  uint8_t buf[16] = {0};
+  for(;;)
+  {
+    ssize_t const bytes_received = serial().read(buf, 16);
+
+    for(ssize_t bytes_written = 0; bytes_written != bytes_received; )
+    {
+      bytes_written += serial().write(buf + bytes_written, bytes_received - bytes_written);
+    }
+  }
+
+  return 0;
+}
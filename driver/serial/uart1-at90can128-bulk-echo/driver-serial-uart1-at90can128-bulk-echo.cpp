@@ -0,0 +1,107 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Olimex AVR-CAN
+ *
+ * Echoes all data received via UART1. Whatever has arrived is transmitted in one go
+ * directly out of the RX ring buffer, the bytes are only consumed after they have been
+ * sent. Neither a critical section nor a copy is required per transfer.
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/AT90CAN128/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/AT90CAN128/UART1.h>
+
+#include "../common/BulkUartReceiver.h"
+#include "../common/UartScatterGatherTransmitter.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const UART_RX_BUFFER_SIZE = 128;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /* HAL ******************************************************************************/
+
+  AT90CAN128::InterruptController int_ctrl(&EIMSK, &TIMSK2, &TIMSK1, &TIMSK0, &CANGIE, &SPCR, &UCSR0B, &ACSR, &ADCSRA, &EECR, &TIMSK3, &UCSR1B, &TWCR, &SPMCSR);
+
+  blox::AT90CAN128::UART1         uart1   (&UDR1, &UCSR1A, &UCSR1B, &UCSR1C, &UBRR1, int_ctrl, F_CPU);
+
+
+  /* DRIVER ***************************************************************************/
+
+  uart1().setBaudRate(hal::interface::UartBaudRate::B115200);
+  uart1().setParity  (hal::interface::UartParity::None     );
+  uart1().setStopBit (hal::interface::UartStopBit::_1      );
+
+  serial::UartScatterGatherTransmitter          uart_tx(uart1(), nullptr  );
+  serial::BulkUartReceiver<UART_RX_BUFFER_SIZE> uart_rx(uart1(), &uart_tx);
+
+  /* Receive interrupts are handled by uart_rx which
+   * forwards the transmit interrupts to uart_tx.
+   */
+  uart1().registerUARTCallback(&uart_rx);
+
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+
+  int_ctrl.enableInterrupt(AT90CAN32_64_128::toIntNum(AT90CAN128::Interrupt::GLOBAL));
+
+
+  /* APPLICATION **********************************************************************/
+
+  for(;;)
+  {
+    uint8_t const * data      = nullptr;
+    uint16_t const  num_bytes = uart_rx.peek(data);
+
+    if(num_bytes == 0) continue;
+
+    serial::UartTxSegment const echo = {data, num_bytes};
+    uart_tx.write(&echo, 1, nullptr);
+
+    /* The region must not be consumed before it has been transmitted,
+     * meanwhile further bytes pile up for the next (larger) transfer.
+     */
+    while(uart_tx.isBusy()) { }
+    uart_rx.consume(num_bytes);
+  }
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Olimex AVR-CAN
+ *
+ * Every packet received via UART1 is sent back unchanged. Packets are COBS framed and
+ * protected by a CRC-16 (see driver/serial/common/CobsFrame.h). Measure throughput and
+ * latency on the host via
+ *   serial-packet-host /dev/ttyUSB0
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/AT90CAN128/CriticalSection.h>
+#include <snowfox/hal/avr/AT90CAN128/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/AT90CAN128/UART1.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include "../common/SerialPacketTransport.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const UART_RX_BUFFER_SIZE = 64;
+static uint16_t const UART_TX_BUFFER_SIZE = 64;
+static uint16_t const MAX_PAYLOAD_SIZE    = 64;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /* HAL ******************************************************************************/
+
+  AT90CAN128::InterruptController int_ctrl(&EIMSK, &TIMSK2, &TIMSK1, &TIMSK0, &CANGIE, &SPCR, &UCSR0B, &ACSR, &ADCSRA, &EECR, &TIMSK3, &UCSR1B, &TWCR, &SPMCSR);
+  AT90CAN128::CriticalSection     crit_sec;
+
+  blox::AT90CAN128::UART1         uart1   (&UDR1, &UCSR1A, &UCSR1B, &UCSR1C, &UBRR1, int_ctrl, F_CPU);
+
+
+  /* DRIVER ***************************************************************************/
+
+  blox::SerialUart serial(crit_sec,
+                          uart1(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+
+  int_ctrl.enableInterrupt(AT90CAN32_64_128::toIntNum(AT90CAN128::Interrupt::GLOBAL));
+
+
+  /* APPLICATION **********************************************************************/
+
+  serial::SerialPacketTransport<MAX_PAYLOAD_SIZE> packet_transport(serial());
+
+  uint8_t packet[MAX_PAYLOAD_SIZE] = {0};
+  for(;;)
+  {
+    uint16_t const packet_size = packet_transport.receive(packet, MAX_PAYLOAD_SIZE);
+
+    if(packet_size > 0) {
+      packet_transport.send(packet, packet_size);
+    }
+  }
+
+  return 0;
+}
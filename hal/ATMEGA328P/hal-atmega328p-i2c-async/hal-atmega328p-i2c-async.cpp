@@ -0,0 +1,192 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example reads the angular rate of a L3GD20 and the magnetic field of a
+ * LIS3MDL connected to the same I2C bus via the interrupt driven transaction
+ * queue. Both write-then-read transactions are submitted back-to-back and
+ * executed from within the TWI interrupt while the main loop keeps counting
+ * its iterations, the counter value printed together with the readings shows
+ * how much CPU time remained available during the transfer.
+ *
+ * Electrical interface:
+ *   SCL = A5 = L3GD20_SCL = LIS3MDL_SCL
+ *   SDA = A4 = L3GD20_SDA = LIS3MDL_SDA
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/I2cMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/I2cClockSetting.h"
+#include "../../common/AvrTwiAsyncI2cMaster.h"
+#include "../../../driver/sensor/common/StSensorIoI2c.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * GLOBAL CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const UART_RX_BUFFER_SIZE     = 0;
+static uint16_t const UART_TX_BUFFER_SIZE     = 64;
+
+static uint8_t  const L3GD20_I2C_ADDR         = (0x6B << 1);
+static uint8_t  const LIS3MDL_I2C_ADDR        = (0x1E << 1);
+static uint32_t const I2C_CLOCK_Hz            = hal::i2c::i2cBusMaxClockHz(hal::i2c::I2cDevice::L3GD20, hal::i2c::I2cDevice::LIS3MDL);
+
+static uint8_t  const L3GD20_REG_CTRL_REG1    = 0x20;
+static uint8_t  const L3GD20_CTRL_REG1_ENABLE = 0x0F; /* PD = 1, Zen = Yen = Xen = 1 */
+static uint8_t  const LIS3MDL_REG_CTRL_REG3   = 0x22;
+static uint8_t  const LIS3MDL_CTRL_REG3_CONT  = 0x00; /* MD = 00 - continuous conversion */
+
+static uint32_t const LOOP_DELAY_ms           = 1000; /* 1 s */
+
+static_assert(hal::i2c::isAvrTwiClockSupported(F_CPU, I2C_CLOCK_Hz), "I2C_CLOCK_Hz can not be generated from F_CPU");
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl    (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  blox::ATMEGA328P::I2cMaster     i2c_master  (&TWCR,
+                                               &TWDR,
+                                               &TWSR,
+                                               &TWBR,
+                                               int_ctrl,
+                                               hal::interface::I2cClock::F_100_kHz);
+
+  hal::i2c::avrSetTwiClock(&TWBR, &TWSR, hal::i2c::avrTwiClockSetting(F_CPU, I2C_CLOCK_Hz));
+
+  blox::ATMEGA328P::UART0         uart0       (&UDR0,
+                                               &UCSR0A,
+                                               &UCSR0B,
+                                               &UCSR0C,
+                                               &UBRR0,
+                                               int_ctrl,
+                                               F_CPU);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart   serial(crit_sec,
+                            uart0(),
+                            UART_RX_BUFFER_SIZE,
+                            UART_TX_BUFFER_SIZE,
+                            serial::interface::SerialBaudRate::B115200,
+                            serial::interface::SerialParity::None,
+                            serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output,trace::Level::Debug);
+
+  /* SENSOR CONFIGURATION *************************************************************/
+
+  /* The one-time configuration is performed with blocking transfers
+   * before the TWI is handed over to the asynchronous engine.
+   */
+  sensor::StSensorIoI2c l3gd20_io (L3GD20_I2C_ADDR,  sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, i2c_master());
+  sensor::StSensorIoI2c lis3mdl_io(LIS3MDL_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB, i2c_master());
+
+  if(!l3gd20_io.writeRegister (L3GD20_REG_CTRL_REG1,  L3GD20_CTRL_REG1_ENABLE)) trace.println(trace::Level::Error, "[ERR] L3GD20 configuration");
+  if(!lis3mdl_io.writeRegister(LIS3MDL_REG_CTRL_REG3, LIS3MDL_CTRL_REG3_CONT )) trace.println(trace::Level::Error, "[ERR] LIS3MDL configuration");
+
+  /* ASYNC I2C ************************************************************************/
+  hal::i2c::AvrTwiAsyncI2cMaster async_i2c_master(&TWCR, &TWDR, &TWSR, crit_sec);
+
+  int_ctrl.registerInterruptCallback(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::TWO_WIRE_INT), &async_i2c_master);
+
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  uint8_t const out_xyz_cmd[] = {sensor::ST_SENSOR_REG_OUT_X_L | sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB};
+
+  int16_t l3gd20_xyz [3] = {0};
+  int16_t lis3mdl_xyz[3] = {0};
+
+  hal::i2c::I2cTransaction l3gd20_read  = {L3GD20_I2C_ADDR,  out_xyz_cmd, sizeof(out_xyz_cmd), reinterpret_cast<uint8_t *>(l3gd20_xyz),  sizeof(l3gd20_xyz),  nullptr};
+  hal::i2c::I2cTransaction lis3mdl_read = {LIS3MDL_I2C_ADDR, out_xyz_cmd, sizeof(out_xyz_cmd), reinterpret_cast<uint8_t *>(lis3mdl_xyz), sizeof(lis3mdl_xyz), nullptr};
+
+  for(;;)
+  {
+    async_i2c_master.submit(l3gd20_read);
+    async_i2c_master.submit(lis3mdl_read);
+
+    /* Useful work would take place here instead of counting */
+    uint32_t num_loop_iterations = 0;
+    while(!l3gd20_read.complete || !lis3mdl_read.complete) {
+      num_loop_iterations++;
+    }
+
+    if(!l3gd20_read.success) {
+      trace.println(trace::Level::Error, "[ERR] L3GD20 read XYZ");
+    } else {
+      trace.println(trace::Level::Info, "L3GD20  X = %6d, Y = %6d, Z = %6d", l3gd20_xyz[0], l3gd20_xyz[1], l3gd20_xyz[2]);
+    }
+
+    if(!lis3mdl_read.success) {
+      trace.println(trace::Level::Error, "[ERR] LIS3MDL read XYZ");
+    } else {
+      trace.println(trace::Level::Info, "LIS3MDL X = %6d, Y = %6d, Z = %6d", lis3mdl_xyz[0], lis3mdl_xyz[1], lis3mdl_xyz[2]);
+    }
+
+    trace.println(trace::Level::Debug, "Main loop iterations during transfer: %lu", num_loop_iterations);
+
+    delay.delay_ms(LOOP_DELAY_ms);
+  }
+
+  return 0;
+}
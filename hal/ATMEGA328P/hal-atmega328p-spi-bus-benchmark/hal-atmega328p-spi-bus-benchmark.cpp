@@ -0,0 +1,288 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno, Seedstudio CAN Bus
+ * Shield V2.0 and Digilent Pmod SF3 32 MB serial NOR flash N25Q256A breakout board
+ * sharing a single SPI bus.
+ *
+ * Both devices are attached to the bus via hal::spi::AvrSpiBus, every device
+ * brings its own SPI mode, bit order and maximum SPI clock. The benchmark reads
+ * flash pages and polls a MCP2515 register in an interleaved fashion, first
+ * with both devices limited to the 1 MHz SPI clock used by all other examples,
+ * then with every device running at the fastest SPI clock it allows:
+ *
+ *   [shared 1 MHz   ] flash ... Hz, mcp2515 ... Hz: <bytes> in <TIMER1 ticks> = <kB/s>, <n> reconfigurations
+ *   [per-device clk ] flash ... Hz, mcp2515 ... Hz: <bytes> in <TIMER1 ticks> = <kB/s>, <n> reconfigurations
+ *
+ * At 1 MHz every byte occupies the bus for 128 CPU cycles, at 8 MHz (the
+ * fastest AVR SPI clock, f_cpu / 2) for 16 CPU cycles, from there on the
+ * throughput is limited by the software overhead per byte in blox::SpiMaster.
+ *
+ * Both caps of the datasheets (54 MHz, 10 MHz) would clamp to the same 8 MHz.
+ * The MCP2515 is therefore deliberately limited to 4 MHz (f_cpu / 4), so that
+ * in the second run the devices need different SPI configurations and every
+ * switch between them reconfigures the bus (counted as reconfigurations).
+ * In the first run both configurations are identical, the bus is configured once.
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   MCP2515  CS = D10 = PB2
+ *   N25Q256A CS = D7  = PD7
+ *   SCK         = D13 = PB5
+ *   MISO        = D12 = PB4
+ *   MOSI        = D11 = PB3
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:hal-atmega328p-spi-bus-benchmark
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/hal/interface/spi/SpiMasterControl.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../../common/AvrSpiBus.h"
+#include "../../../trace/common/AvrTimer1TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE         = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE         = 128;
+
+static uint32_t                    const SHARED_SPI_CLOCK_Hz         =  1000000UL; /* SPI prescaler 16 as used by all other examples  */
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE           = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER      = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_MAX_SPI_CLOCK_Hz   = 54000000UL; /* READ (0x03) is specified up to 54 MHz           */
+
+static hal::interface::SpiMode     const MCP2515_SPI_MODE            = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const MCP2515_SPI_BIT_ORDER       = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const MCP2515_MAX_SPI_CLOCK_Hz    =  4000000UL; /* specified up to 10 MHz, limited on purpose     */
+
+static uint8_t                     const MCP2515_CMD_READ            = 0x03;
+static uint8_t                     const MCP2515_REG_CANSTAT         = 0x0E;
+
+static uint16_t                    const BENCHMARK_NUM_ROUNDS        = 32;
+static uint16_t                    const BENCHMARK_PAGE_SIZE         = 256;
+static uint16_t                    const BENCHMARK_NUM_REG_READS     = 8;     /* MCP2515 status polls per flash page */
+
+static trace::AvrTimer1Prescaler   const TIMER1_PRESCALER            = trace::AvrTimer1Prescaler::P_8; /* 16 MHz / 8 = 2 MHz */
+
+/**************************************************************************************
+ * FUNCTION DECLARATION
+ **************************************************************************************/
+
+uint8_t mcp2515_read_register(hal::interface::SpiMasterControl & spi_master, hal::interface::DigitalOutPin & cs, uint8_t const addr);
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* As the datasheet state: 'If SS is configured as an input and is driven low
+   * while MSTR is set, MSTR will be cleared.'. This means that in this special
+   * case where the CS pin is equal with SS pin we need to set it before configuring
+   * the SPI interface.
+   */
+  ATMEGA328P::DigitalOutPin       mcp2515_cs (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs(&DDRD, &PORTD,        7); /* CS   = D7  = PD7 */
+  ATMEGA328P::DigitalOutPin       spi_sck    (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        spi_miso   (&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       spi_mosi   (&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  mcp2515_cs.set();
+  n25q256a_cs.set();
+  spi_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  /* The initial configuration is overwritten by spi_bus as soon as a device is selected */
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             hal::interface::SpiMode::MODE_0,
+                                             hal::interface::SpiBitOrder::MSB_FIRST,
+                                             16);
+
+  /* SPI BUS **************************************************************************/
+  spi::AvrSpiBus                  spi_bus   (&SPCR, &SPSR);
+  spi::AvrSpiBusDevice            n25q256a_dev(spi_bus, n25q256a_cs, N25Q256A_SPI_MODE, N25Q256A_SPI_BIT_ORDER, F_CPU, N25Q256A_MAX_SPI_CLOCK_Hz);
+  spi::AvrSpiBusDevice            mcp2515_dev (spi_bus, mcp2515_cs,  MCP2515_SPI_MODE,  MCP2515_SPI_BIT_ORDER,  F_CPU, MCP2515_MAX_SPI_CLOCK_Hz );
+
+  /* TIMER1 as timestamp source *******************************************************/
+  trace::AvrTimer1TimestampSource timestamp_source(&TCCR1A, &TCCR1B, &TCNT1, F_CPU, TIMER1_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  trace::SerialTraceOutput serial_trace_output(serial());
+  trace::Trace             trace              (serial_trace_output, trace::Level::Debug);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_dev);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  if(!n25q256a.open()) {
+    trace.println(trace::Level::Error, "N25Q256A::open() ERROR");
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  for(uint8_t run = 0; run < 2; run++)
+  {
+    bool const is_per_device_clock = (run == 1);
+
+    n25q256a_dev.setMaxSpiClock(is_per_device_clock ? N25Q256A_MAX_SPI_CLOCK_Hz : SHARED_SPI_CLOCK_Hz);
+    mcp2515_dev.setMaxSpiClock (is_per_device_clock ? MCP2515_MAX_SPI_CLOCK_Hz  : SHARED_SPI_CLOCK_Hz);
+
+    uint8_t  page_buf[BENCHMARK_PAGE_SIZE];
+    uint32_t num_bytes        = 0;
+    uint32_t num_ticks        = 0;
+    uint32_t num_reconfig_old = spi_bus.numReconfigurations();
+    bool     is_error         = false;
+
+    for(uint16_t round = 0; round < BENCHMARK_NUM_ROUNDS; round++)
+    {
+      /* Each round takes less than one TIMER1 period (32.8 ms) */
+      uint32_t const start = timestamp_source.now();
+
+      if(n25q256a.read(0, round * BENCHMARK_PAGE_SIZE, page_buf, BENCHMARK_PAGE_SIZE) != BENCHMARK_PAGE_SIZE) {
+        is_error = true;
+      }
+      num_bytes += BENCHMARK_PAGE_SIZE;
+
+      for(uint16_t r = 0; r < BENCHMARK_NUM_REG_READS; r++) {
+        mcp2515_read_register(spi_master(), mcp2515_dev, MCP2515_REG_CANSTAT);
+        num_bytes++;
+      }
+
+      num_ticks += timestamp_source.now() - start;
+    }
+
+    uint32_t const kB_per_sec = (num_bytes * (timestamp_source.tickFreqHz() / 1000UL)) / num_ticks;
+
+    trace.println(trace::Level::Info,
+                  "[%s] flash %lu Hz, mcp2515 %lu Hz: %5lu bytes in %6lu ticks = %5lu kB/s, %lu reconfigurations%s",
+                  is_per_device_clock ? "per-device clk " : "shared 1 MHz   ",
+                  n25q256a_dev.spiClockHz(),
+                  mcp2515_dev.spiClockHz(),
+                  num_bytes,
+                  num_ticks,
+                  kB_per_sec,
+                  spi_bus.numReconfigurations() - num_reconfig_old,
+                  is_error ? " [ERR] READ" : "");
+  }
+
+  /************************************************************************************
+   * CLEANUP
+   ************************************************************************************/
+
+  n25q256a.close();
+
+  /* Loop forever */
+  for(;;) { delay.delay_ms(1); }
+
+  return 0;
+}
+
+/**************************************************************************************
+ * FUNCTION IMPLEMENTATION
+ **************************************************************************************/
+
+uint8_t mcp2515_read_register(hal::interface::SpiMasterControl & spi_master, hal::interface::DigitalOutPin & cs, uint8_t const addr)
+{
+  cs.clr();
+  spi_master.exchange(MCP2515_CMD_READ);
+  spi_master.exchange(addr);
+  uint8_t const data = spi_master.exchange(0);
+  cs.set();
+  return data;
+}
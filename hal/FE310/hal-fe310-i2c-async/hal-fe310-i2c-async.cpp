@@ -0,0 +1,152 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with SiFive HiFive 1 Rev. B which i
+ * connected with a ST X-NUCLEO-NFC02A1 Arduino Shield which contains a M24LR04E-R
+ * NFC EEPROM.
+ *
+ * The IC reference register of the M24LR is read via a queued write-then-read
+ * transaction. FE310::I2cMaster configures prescaler and pin multiplexing, the
+ * transaction itself is advanced by calling process() from the main loop
+ * which never waits for a byte transfer to complete.
+ *
+ * Electrical interface:
+ *   I2C_SCL = GPIO13 = M24LR_SCL
+ *   I2C_SDA = GPIO12 = M24LR_SDA
+ *   D5      = GPIO21 = MCU_LED1
+ *   D4      = GPIO20 = MCU_LED2
+ *   D2      = GPIO18 = MCU_LED3
+ *
+ * Program via
+ *   JLinkExe -device FE310 -if JTAG -speed 4000 -jtagconf -1,-1 -autoconnect 1
+ *   > loadfile hal-fe310-i2c-async.hex
+ *   > exit
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/riscv64/FE310/Io.h>
+#include <snowfox/hal/riscv64/FE310/Clock.h>
+#include <snowfox/hal/riscv64/FE310/Delay.h>
+#include <snowfox/hal/riscv64/FE310/I2cMaster.h>
+#include <snowfox/hal/riscv64/FE310/DigitalOutPin.h>
+#include <snowfox/hal/riscv64/FE310/CriticalSection.h>
+
+#include "../../common/I2cClockSetting.h"
+#include "../../common/Fe310AsyncI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox::hal;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const HFXOSCIN_FREQ_Hz     =  16000000UL;
+static uint32_t const CORECLK_FREQ_Hz      = 200000000UL;
+
+static uint8_t  const M24LR_ADDRESS_SYSTEM = (0x57 << 1);
+static uint16_t const M24LR_REG_ICREF      = 0x091C;
+static uint8_t  const M24LR_IC_REF         = 0x5A;
+
+static uint32_t const I2C_CLOCK_Hz         = i2c::i2cBusMaxClockHz(i2c::I2cDevice::M24LR);
+
+static_assert(i2c::isFe310I2cClockSupported(CORECLK_FREQ_Hz, I2C_CLOCK_Hz), "I2C_CLOCK_Hz can not be generated from CORECLK_FREQ_Hz");
+
+static uint8_t  const MCU_LED1_GPIO_NUMBER = 21;
+static uint8_t  const MCU_LED2_GPIO_NUMBER = 20;
+static uint8_t  const MCU_LED3_GPIO_NUMBER = 18;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+FE310::Delay              delay;
+FE310::Clock              clock     (&PRCI_HFXOSCCFG, &PRCI_PLLCFG, &PRCI_PLLOUTDIV, HFXOSCIN_FREQ_Hz);
+FE310::CriticalSection    crit_sec;
+FE310::I2cMaster          i2c_master(&I2C0_PRESC_LOW, &I2C0_PRESC_HIGH, &I2C0_CONTROL, &I2C0_DATA, &I2C0_CMD_STATUS, &GPIO0_IOF_EN, &GPIO0_IOF_SEL, CORECLK_FREQ_Hz);
+i2c::Fe310AsyncI2cMaster  async_i2c (&I2C0_DATA, &I2C0_CMD_STATUS, crit_sec);
+FE310::DigitalOutPin      led_green (&GPIO0_INPUT_EN, &GPIO0_OUTPUT_EN, &GPIO0_IOF_EN, &GPIO0_OUTPUT_VAL, MCU_LED1_GPIO_NUMBER);
+FE310::DigitalOutPin      led_blue  (&GPIO0_INPUT_EN, &GPIO0_OUTPUT_EN, &GPIO0_IOF_EN, &GPIO0_OUTPUT_VAL, MCU_LED2_GPIO_NUMBER);
+FE310::DigitalOutPin      led_orange(&GPIO0_INPUT_EN, &GPIO0_OUTPUT_EN, &GPIO0_IOF_EN, &GPIO0_OUTPUT_VAL, MCU_LED3_GPIO_NUMBER);
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  clock.setClockFreq(static_cast<uint8_t>(FE310::ClockId::coreclk), CORECLK_FREQ_Hz);
+
+  led_blue.set();
+
+  i2c_master.setI2cClock(interface::I2cClock::F_100_kHz);
+  i2c::fe310SetI2cClock(&I2C0_PRESC_LOW, &I2C0_PRESC_HIGH, &I2C0_CONTROL, i2c::fe310I2cClockSetting(CORECLK_FREQ_Hz, I2C_CLOCK_Hz));
+
+  uint8_t const icref_addr[] = {static_cast<uint8_t>(M24LR_REG_ICREF >> 8), static_cast<uint8_t>(M24LR_REG_ICREF & 0x00FF)};
+  uint8_t       m24lr_ref_id = 0;
+
+  i2c::I2cTransaction icref_read = {M24LR_ADDRESS_SYSTEM, icref_addr, sizeof(icref_addr), &m24lr_ref_id, 1, nullptr};
+
+  async_i2c.submit(icref_read);
+
+  /* The blue LED is toggled as long as the transaction is
+   * in progress, the CPU is never stalled by the I2C bus.
+   */
+  while(!icref_read.complete)
+  {
+    async_i2c.process();
+    led_blue.clr();
+    led_blue.set();
+  }
+
+  /* If we were able to read the correct ID, than the green LED
+   * of the X-NUCLEO-NFC02A1 blinks green, otherwise the orange
+   * LED is blinking.
+   */
+  if(icref_read.success && m24lr_ref_id == M24LR_IC_REF)
+  {
+    for(;;)
+    {
+      led_green.set();
+      delay.delay_ms(250);
+      led_green.clr();
+      delay.delay_ms(250);
+    }
+  }
+  else
+  {
+    for(;;)
+    {
+      led_orange.set();
+      delay.delay_ms(250);
+      led_orange.clr();
+      delay.delay_ms(250);
+    }
+  }
+
+  for(;;) { }
+
+  return 0;
+}
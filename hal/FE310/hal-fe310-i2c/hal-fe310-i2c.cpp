@@ -46,6 +46,8 @@
 #include <snowfox/hal/riscv64/FE310/I2cMaster.h>
 #include <snowfox/hal/riscv64/FE310/DigitalOutPin.h>
 
+#include "../../common/I2cClockSetting.h"
+
 /**************************************************************************************
  * NAMESPACES
  **************************************************************************************/
@@ -64,6 +66,10 @@ static uint8_t  const M24LR_ADDRESS_DATA   = (0x53 << 1);
 static uint16_t const M24LR_REG_ICREF      = 0x091C;
 static uint8_t  const M24LR_IC_REF         = 0x5A;
 
+static uint32_t const I2C_CLOCK_Hz         = i2c::i2cBusMaxClockHz(i2c::I2cDevice::M24LR);
+
+static_assert(i2c::isFe310I2cClockSupported(CORECLK_FREQ_Hz, I2C_CLOCK_Hz), "I2C_CLOCK_Hz can not be generated from CORECLK_FREQ_Hz");
+
 static uint8_t  const MCU_LED1_GPIO_NUMBER = 21;
 static uint8_t  const MCU_LED2_GPIO_NUMBER = 20;
 static uint8_t  const MCU_LED3_GPIO_NUMBER = 18;
@@ -96,6 +102,7 @@ int snowfox_main()
   led_blue.set();
 
   i2c_master.setI2cClock(interface::I2cClock::F_100_kHz);
+  i2c::fe310SetI2cClock(&I2C0_PRESC_LOW, &I2C0_PRESC_HIGH, &I2C0_CONTROL, i2c::fe310I2cClockSetting(CORECLK_FREQ_Hz, I2C_CLOCK_Hz));
 
   uint8_t const m24lr_ref_id = m24lr_readByte(M24LR_REG_ICREF);
   
@@ -0,0 +1,116 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AsyncI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AsyncI2cMaster::AsyncI2cMaster(hal::interface::CriticalSection & crit_sec)
+: _crit_sec     (crit_sec),
+  _head         (nullptr ),
+  _tail         (nullptr ),
+  _is_completing(false   )
+{
+
+}
+
+AsyncI2cMaster::~AsyncI2cMaster()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool AsyncI2cMaster::submit(I2cTransaction & transaction)
+{
+  _crit_sec.lock();
+
+  bool const is_pending = (_head == &transaction) || (transaction.next != nullptr) || (_tail == &transaction);
+  if(is_pending) {
+    _crit_sec.unlock();
+    return false;
+  }
+
+  transaction.next     = nullptr;
+  transaction.complete = false;
+  transaction.success  = false;
+
+  bool const is_idle = (_head == nullptr);
+
+  if(is_idle) _head       = &transaction;
+  else        _tail->next = &transaction;
+  _tail = &transaction;
+
+  if(is_idle && !_is_completing) {
+    start();
+  }
+
+  _crit_sec.unlock();
+
+  return true;
+}
+
+bool AsyncI2cMaster::isIdle()
+{
+  return (_head == nullptr);
+}
+
+/**************************************************************************************
+ * PROTECTED MEMBER FUNCTIONS
+ **************************************************************************************/
+
+I2cTransaction * AsyncI2cMaster::complete(bool const success)
+{
+  I2cTransaction * transaction = _head;
+
+  _head = transaction->next;
+  if(_head == nullptr) _tail = nullptr;
+  transaction->next     = nullptr;
+  transaction->success  = success;
+  transaction->complete = true;
+
+  if(transaction->callback)
+  {
+    _is_completing = true;
+    transaction->callback->onI2cTransactionComplete(*transaction);
+    _is_completing = false;
+  }
+
+  return _head;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
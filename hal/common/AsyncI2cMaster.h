@@ -0,0 +1,93 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_ASYNCI2CMASTER_H_
+#define EXAMPLES_HAL_COMMON_ASYNCI2CMASTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/locking/CriticalSection.h>
+
+#include "I2cTransaction.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Transaction queue shared by the MCU specific asynchronous I2C engines.
+ * Transactions are executed in the order of submission, the queue is an
+ * intrusive linked list, therefore there is no upper limit on the number
+ * of pending transactions. The engine implements start() which kicks off
+ * the transaction at the head of the queue on an idle bus and calls
+ * complete() once it is done.
+ */
+class AsyncI2cMaster
+{
+
+public:
+
+  virtual ~AsyncI2cMaster();
+
+
+  /* Returns false if the transaction is still pending. */
+  bool submit(I2cTransaction & transaction);
+
+  bool isIdle();
+
+protected:
+
+  AsyncI2cMaster(hal::interface::CriticalSection & crit_sec);
+
+
+  I2cTransaction * head() { return _head; }
+
+  /* Dequeues the transaction at the head of the queue, invokes its callback
+   * and returns the next transaction to be executed (if any). Transactions
+   * submitted from within the callback are not started by submit(), instead
+   * the engine starts the returned transaction - this allows to combine
+   * STOP and START of the next transaction.
+   */
+  I2cTransaction * complete(bool const success);
+
+  virtual void start() = 0;
+
+private:
+
+  hal::interface::CriticalSection &          _crit_sec;
+  I2cTransaction                  * volatile _head;
+  I2cTransaction                  *          _tail;
+  bool                                       _is_completing;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_ASYNCI2CMASTER_H_ */
@@ -0,0 +1,180 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AsyncSpiMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AsyncSpiMaster::AsyncSpiMaster(interface::SpiPort              & spi_port,
+                               hal::interface::CriticalSection & crit_sec)
+: _spi_port   (spi_port),
+  _crit_sec   (crit_sec),
+  _active     (nullptr ),
+  _head       (nullptr ),
+  _tail       (nullptr ),
+  _selected_cs(nullptr ),
+  _pos        (0       )
+{
+
+}
+
+AsyncSpiMaster::~AsyncSpiMaster()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool AsyncSpiMaster::submit(SpiTransaction & transaction)
+{
+  /* An empty transaction would transfer tx_buf[0]/rx_buf[0] */
+  if(transaction.size == 0) return false;
+
+  _crit_sec.lock();
+
+  bool const is_pending = (_active == &transaction) || (_head == &transaction) || (transaction.next != nullptr) || (_tail == &transaction);
+  if(is_pending) {
+    _crit_sec.unlock();
+    return false;
+  }
+
+  transaction.next     = nullptr;
+  transaction.complete = false;
+
+  if(_head == nullptr) _head       = &transaction;
+  else                 _tail->next = &transaction;
+  _tail = &transaction;
+
+  /* Only a transaction submitted to an idle (or stalled) engine
+   * needs to be kicked off, all others are started from within
+   * the interrupt handler.
+   */
+  if(_active == nullptr) {
+    startNext();
+  }
+
+  _crit_sec.unlock();
+
+  return true;
+}
+
+bool AsyncSpiMaster::isIdle()
+{
+  return (_active == nullptr) && (_head == nullptr);
+}
+
+void AsyncSpiMaster::interruptServiceRoutine()
+{
+  SpiTransaction * transaction = _active;
+  if(!transaction) return;
+
+  uint8_t const data = _spi_port.received();
+  if(transaction->rx_buf) {
+    transaction->rx_buf[_pos] = data;
+  }
+  _pos++;
+
+  if(_pos < transaction->size) {
+    transferNext();
+    return;
+  }
+
+  /* Transaction complete - release it before the callback is invoked
+   * so that it can be resubmitted from within the callback.
+   */
+  if(transaction->keep_selected) {
+    _selected_cs = transaction->cs;
+  } else {
+    transaction->cs->set();
+    _selected_cs = nullptr;
+  }
+
+  _active               = nullptr;
+  transaction->complete = true;
+
+  if(transaction->callback) {
+    transaction->callback->onSpiTransactionComplete(*transaction);
+  }
+
+  /* A transaction submitted from within the callback has
+   * already been started by submit().
+   */
+  if(_active == nullptr) {
+    startNext();
+  }
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AsyncSpiMaster::startNext()
+{
+  /* While a CS is kept selected only transactions for that
+   * very device may be started, all others remain queued.
+   */
+  SpiTransaction * prev        = nullptr,
+                 * transaction = _head;
+
+  if(_selected_cs)
+  {
+    while(transaction && (transaction->cs != _selected_cs)) {
+      prev        = transaction;
+      transaction = transaction->next;
+    }
+  }
+
+  if(!transaction) return;
+
+  if(prev) prev->next = transaction->next;
+  else     _head      = transaction->next;
+  if(_tail == transaction) _tail = prev;
+  transaction->next = nullptr;
+
+  _active = transaction;
+  _pos    = 0;
+  _active->cs->clr();
+  transferNext();
+}
+
+void AsyncSpiMaster::transferNext()
+{
+  uint8_t const data = _active->tx_buf ? _active->tx_buf[_pos] : 0xFF;
+  _spi_port.transfer(data);
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
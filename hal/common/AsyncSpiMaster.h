@@ -0,0 +1,98 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_ASYNCSPIMASTER_H_
+#define EXAMPLES_HAL_COMMON_ASYNCSPIMASTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/locking/CriticalSection.h>
+#include <snowfox/hal/interface/interrupt/InterruptCallback.h>
+
+#include "SpiPort.h"
+#include "SpiTransaction.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Executes queued SPI transactions from within the SPI transfer complete
+ * interrupt, the CPU is only involved once per byte for a few cycles
+ * instead of spinning on SPIF. Transactions are executed in the order of
+ * submission, the queue is an intrusive linked list, therefore there is no
+ * upper limit on the number of pending transactions.
+ *
+ * This class must be registered as the callback for the SPI interrupt,
+ * blocking transfers (e.g. via blox::SpiMaster) must not take place while
+ * the SPI interrupt is enabled.
+ *
+ * A transaction with keep_selected set reserves the bus for its CS:
+ * queued transactions of other devices are held back until a transaction
+ * for the same CS without keep_selected has completed, transactions for
+ * the selected device are executed first even if submitted later. The
+ * bus stalls if that follow-up transaction is never submitted.
+ */
+class AsyncSpiMaster : public hal::interface::InterruptCallback
+{
+
+public:
+
+           AsyncSpiMaster(interface::SpiPort              & spi_port,
+                          hal::interface::CriticalSection & crit_sec);
+  virtual ~AsyncSpiMaster();
+
+
+  /* Returns false if the transaction is still pending or has a size of 0. */
+  bool submit(SpiTransaction & transaction);
+
+  bool isIdle();
+
+
+  virtual void interruptServiceRoutine() override;
+
+private:
+
+  interface::SpiPort              &          _spi_port;
+  hal::interface::CriticalSection &          _crit_sec;
+  SpiTransaction                  * volatile _active;
+  SpiTransaction                  * volatile _head;
+  SpiTransaction                  *          _tail;
+  hal::interface::DigitalOutPin   *          _selected_cs;
+  uint16_t                                   _pos;
+
+  void startNext();
+  void transferNext();
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
+
+#endif /* EXAMPLES_HAL_COMMON_ASYNCSPIMASTER_H_ */
@@ -0,0 +1,160 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AvrSpiBus.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr SPCR_DORD_bm   = (1<<5);
+static uint8_t constexpr SPCR_CPOL_bm   = (1<<3);
+static uint8_t constexpr SPCR_CPHA_bm   = (1<<2);
+static uint8_t constexpr SPCR_SPR1_bm   = (1<<1);
+static uint8_t constexpr SPCR_SPR0_bm   = (1<<0);
+static uint8_t constexpr SPCR_CONFIG_bm = SPCR_DORD_bm | SPCR_CPOL_bm | SPCR_CPHA_bm | SPCR_SPR1_bm | SPCR_SPR0_bm;
+
+static uint8_t constexpr SPSR_SPI2X_bm  = (1<<0);
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AvrSpiBus::AvrSpiBus(volatile uint8_t * spcr,
+                     volatile uint8_t * spsr)
+: _SPCR                (spcr ),
+  _SPSR                (spsr ),
+  _is_configured       (false),
+  _spcr_config         (0    ),
+  _spsr_config         (0    ),
+  _num_reconfigurations(0    )
+{
+
+}
+
+AvrSpiBus::~AvrSpiBus()
+{
+
+}
+
+AvrSpiBusDevice::AvrSpiBusDevice(AvrSpiBus                         & bus,
+                                 hal::interface::DigitalOutPin     & cs,
+                                 hal::interface::SpiMode     const   spi_mode,
+                                 hal::interface::SpiBitOrder const   spi_bit_order,
+                                 uint32_t                    const   f_cpu,
+                                 uint32_t                    const   max_spi_clock_Hz)
+: _bus              (bus  ),
+  _cs               (cs   ),
+  _f_cpu            (f_cpu),
+  _spi_clock_divider(0    ),
+  _spcr_config      (0    ),
+  _spsr_config      (0    )
+{
+  switch(spi_mode)
+  {
+  case hal::interface::SpiMode::MODE_0: _spcr_config = 0;                             break;
+  case hal::interface::SpiMode::MODE_1: _spcr_config = SPCR_CPHA_bm;                  break;
+  case hal::interface::SpiMode::MODE_2: _spcr_config = SPCR_CPOL_bm;                  break;
+  case hal::interface::SpiMode::MODE_3: _spcr_config = SPCR_CPOL_bm | SPCR_CPHA_bm;   break;
+  }
+
+  if(spi_bit_order == hal::interface::SpiBitOrder::LSB_FIRST) {
+    _spcr_config |= SPCR_DORD_bm;
+  }
+
+  setMaxSpiClock(max_spi_clock_Hz);
+}
+
+AvrSpiBusDevice::~AvrSpiBusDevice()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AvrSpiBus::activate(uint8_t const spcr_config, uint8_t const spsr_config)
+{
+  if(_is_configured && (spcr_config == _spcr_config) && (spsr_config == _spsr_config)) {
+    return;
+  }
+
+  *_SPCR = (*_SPCR & ~SPCR_CONFIG_bm) | spcr_config;
+  *_SPSR = (*_SPSR & ~SPSR_SPI2X_bm ) | spsr_config;
+
+  _is_configured = true;
+  _spcr_config   = spcr_config;
+  _spsr_config   = spsr_config;
+  _num_reconfigurations++;
+}
+
+void AvrSpiBusDevice::setMaxSpiClock(uint32_t const max_spi_clock_Hz)
+{
+  _spi_clock_divider = avrSpiClockDivider(_f_cpu, max_spi_clock_Hz);
+
+  /* SPR1:0 select f_cpu / 4, 16, 64, 128 - SPI2X doubles the SPI clock */
+  uint8_t spr = 0;
+  uint8_t spi2x = 0;
+  switch(_spi_clock_divider)
+  {
+  case   2: spr = 0;                           spi2x = SPSR_SPI2X_bm; break;
+  case   4: spr = 0;                                                  break;
+  case   8: spr = SPCR_SPR0_bm;                spi2x = SPSR_SPI2X_bm; break;
+  case  16: spr = SPCR_SPR0_bm;                                       break;
+  case  32: spr = SPCR_SPR1_bm;                spi2x = SPSR_SPI2X_bm; break;
+  case  64: spr = SPCR_SPR1_bm;                                       break;
+  default : spr = SPCR_SPR1_bm | SPCR_SPR0_bm;                        break;
+  }
+
+  _spcr_config = (_spcr_config & ~(SPCR_SPR1_bm | SPCR_SPR0_bm)) | spr;
+  _spsr_config = spi2x;
+}
+
+uint32_t AvrSpiBusDevice::spiClockHz() const
+{
+  return _f_cpu / _spi_clock_divider;
+}
+
+void AvrSpiBusDevice::set()
+{
+  _cs.set();
+}
+
+void AvrSpiBusDevice::clr()
+{
+  _bus.activate(_spcr_config, _spsr_config);
+  _cs.clr();
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
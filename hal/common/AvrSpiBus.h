@@ -0,0 +1,134 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_AVRSPIBUS_H_
+#define EXAMPLES_HAL_COMMON_AVRSPIBUS_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+#include <snowfox/hal/interface/spi/SpiMasterConfiguration.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+/* Returns the smallest AVR SPI clock divider (2, 4, ..., 128) which keeps
+ * the SPI clock at or below max_spi_clock_Hz, 128 if none does.
+ */
+constexpr uint8_t avrSpiClockDivider(uint32_t const f_cpu, uint32_t const max_spi_clock_Hz)
+{
+  uint8_t divider = 2;
+  while((divider < 128) && (f_cpu / divider > max_spi_clock_Hz)) {
+    divider *= 2;
+  }
+  return divider;
+}
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Arbitrates the SPI peripheral of the AVR family between several devices
+ * which differ in SPI mode, bit order and maximum SPI clock. Every device is
+ * represented by a AvrSpiBusDevice which takes the place of the device's CS
+ * pin when constructing the driver, i.e.
+ *
+ *   N25Q256A_IoSpi n25q256a_spi(spi_master(), n25q256a_dev);
+ *
+ * Asserting CS of a device first applies its configuration - SPCR/SPSR are
+ * only written if it differs from the one currently active. Therefore the
+ * bus is reconfigured while no device is selected and only once per device
+ * switch. blox::SpiMaster remains responsible for enabling the SPI master
+ * and for the actual data exchange. All devices must be accessed from the
+ * same execution context.
+ */
+class AvrSpiBus
+{
+
+public:
+
+           AvrSpiBus(volatile uint8_t * spcr,
+                     volatile uint8_t * spsr);
+  virtual ~AvrSpiBus();
+
+
+  void     activate           (uint8_t const spcr_config, uint8_t const spsr_config);
+  uint32_t numReconfigurations() const { return _num_reconfigurations; }
+
+private:
+
+  volatile uint8_t * _SPCR,
+                   * _SPSR;
+  bool               _is_configured;
+  uint8_t            _spcr_config,
+                     _spsr_config;
+  uint32_t           _num_reconfigurations;
+
+};
+
+class AvrSpiBusDevice : public hal::interface::DigitalOutPin
+{
+
+public:
+
+           AvrSpiBusDevice(AvrSpiBus                         & bus,
+                           hal::interface::DigitalOutPin     & cs,
+                           hal::interface::SpiMode     const   spi_mode,
+                           hal::interface::SpiBitOrder const   spi_bit_order,
+                           uint32_t                    const   f_cpu,
+                           uint32_t                    const   max_spi_clock_Hz);
+  virtual ~AvrSpiBusDevice();
+
+
+  void     setMaxSpiClock(uint32_t const max_spi_clock_Hz);
+  uint32_t spiClockHz    () const;
+
+
+  virtual void set() override;
+  virtual void clr() override;
+
+private:
+
+  AvrSpiBus                     & _bus;
+  hal::interface::DigitalOutPin & _cs;
+  uint32_t                        _f_cpu;
+  uint8_t                         _spi_clock_divider,
+                                  _spcr_config,
+                                  _spsr_config;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
+
+#endif /* EXAMPLES_HAL_COMMON_AVRSPIBUS_H_ */
@@ -0,0 +1,68 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_AVRSPIPORT_H_
+#define EXAMPLES_HAL_COMMON_AVRSPIPORT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SpiPort.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* SPI port of the AVR family (ATMEGA328P, ATMEGA1284P, AT90CAN128, ...).
+ * Mode, bit order and prescaler are configured via blox::SpiMaster and the
+ * SPI transfer complete interrupt is enabled via the InterruptController,
+ * this class only accesses the data register.
+ */
+class AvrSpiPort : public interface::SpiPort
+{
+
+public:
+
+           AvrSpiPort(volatile uint8_t * spdr);
+  virtual ~AvrSpiPort();
+
+
+  virtual void    transfer(uint8_t const data) override;
+  virtual uint8_t received() override;
+
+private:
+
+  volatile uint8_t * _SPDR;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
+
+#endif /* EXAMPLES_HAL_COMMON_AVRSPIPORT_H_ */
@@ -0,0 +1,215 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AvrTwiAsyncI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr TWCR_TWINT_bm = (1<<7);
+static uint8_t constexpr TWCR_TWEA_bm  = (1<<6);
+static uint8_t constexpr TWCR_TWSTA_bm = (1<<5);
+static uint8_t constexpr TWCR_TWSTO_bm = (1<<4);
+static uint8_t constexpr TWCR_TWEN_bm  = (1<<2);
+static uint8_t constexpr TWCR_TWIE_bm  = (1<<0);
+
+static uint8_t constexpr TWSR_STATUS_bm            = 0xF8;
+
+static uint8_t constexpr TW_START                  = 0x08;
+static uint8_t constexpr TW_REP_START              = 0x10;
+static uint8_t constexpr TW_MT_SLA_ACK             = 0x18;
+static uint8_t constexpr TW_MT_SLA_NACK            = 0x20;
+static uint8_t constexpr TW_MT_DATA_ACK            = 0x28;
+static uint8_t constexpr TW_MT_DATA_NACK           = 0x30;
+static uint8_t constexpr TW_ARB_LOST               = 0x38;
+static uint8_t constexpr TW_MR_SLA_ACK             = 0x40;
+static uint8_t constexpr TW_MR_SLA_NACK            = 0x48;
+static uint8_t constexpr TW_MR_DATA_ACK            = 0x50;
+static uint8_t constexpr TW_MR_DATA_NACK           = 0x58;
+
+static uint8_t constexpr TWCR_CONTINUE             = TWCR_TWINT_bm | TWCR_TWEN_bm | TWCR_TWIE_bm;
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AvrTwiAsyncI2cMaster::AvrTwiAsyncI2cMaster(volatile uint8_t                * twcr,
+                                           volatile uint8_t                * twdr,
+                                           volatile uint8_t                * twsr,
+                                           hal::interface::CriticalSection & crit_sec)
+: AsyncI2cMaster(crit_sec),
+  _TWCR         (twcr    ),
+  _TWDR         (twdr    ),
+  _TWSR         (twsr    ),
+  _tx_pos       (0       ),
+  _rx_pos       (0       ),
+  _is_reading   (false   )
+{
+
+}
+
+AvrTwiAsyncI2cMaster::~AvrTwiAsyncI2cMaster()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AvrTwiAsyncI2cMaster::interruptServiceRoutine()
+{
+  I2cTransaction * transaction = head();
+  if(!transaction) {
+    *_TWCR = TWCR_TWINT_bm | TWCR_TWEN_bm;
+    return;
+  }
+
+  switch(*_TWSR & TWSR_STATUS_bm)
+  {
+  case TW_START:
+  case TW_REP_START:
+  {
+    *_TWDR = transaction->address | (_is_reading ? 1 : 0);
+    *_TWCR = TWCR_CONTINUE;
+  }
+  break;
+
+  case TW_MT_SLA_ACK:
+  case TW_MT_DATA_ACK:
+  {
+    if(_tx_pos < transaction->tx_size) {
+      *_TWDR = transaction->tx_buf[_tx_pos++];
+      *_TWCR = TWCR_CONTINUE;
+    }
+    else if(transaction->rx_size > 0) {
+      _is_reading = true;
+      *_TWCR = TWCR_CONTINUE | TWCR_TWSTA_bm;
+    }
+    else {
+      finish(true);
+    }
+  }
+  break;
+
+  case TW_MR_SLA_ACK:
+  {
+    ackNextByte(*transaction);
+  }
+  break;
+
+  case TW_MR_DATA_ACK:
+  {
+    transaction->rx_buf[_rx_pos++] = *_TWDR;
+    ackNextByte(*transaction);
+  }
+  break;
+
+  case TW_MR_DATA_NACK:
+  {
+    transaction->rx_buf[_rx_pos++] = *_TWDR;
+    finish(_rx_pos == transaction->rx_size);
+  }
+  break;
+
+  case TW_ARB_LOST:
+  {
+    /* The bus is released, the next transaction (if any) is
+     * started as soon as the bus becomes free again.
+     */
+    I2cTransaction * next = complete(false);
+    if(next) {
+      prepare(*next);
+      *_TWCR = TWCR_CONTINUE | TWCR_TWSTA_bm;
+    } else {
+      *_TWCR = TWCR_TWINT_bm | TWCR_TWEN_bm;
+    }
+  }
+  break;
+
+  case TW_MT_SLA_NACK:
+  case TW_MT_DATA_NACK:
+  case TW_MR_SLA_NACK:
+  default:
+  {
+    finish(false);
+  }
+  break;
+  }
+}
+
+/**************************************************************************************
+ * PROTECTED MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AvrTwiAsyncI2cMaster::start()
+{
+  prepare(*head());
+  *_TWCR = TWCR_CONTINUE | TWCR_TWSTA_bm;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void AvrTwiAsyncI2cMaster::prepare(I2cTransaction const & transaction)
+{
+  _tx_pos     = 0;
+  _rx_pos     = 0;
+  _is_reading = (transaction.tx_size == 0) && (transaction.rx_size > 0);
+}
+
+void AvrTwiAsyncI2cMaster::finish(bool const success)
+{
+  I2cTransaction * next = complete(success);
+
+  /* Setting TWSTO and TWSTA at the same time transmits a
+   * STOP condition immediately followed by a START condition.
+   */
+  if(next) {
+    prepare(*next);
+    *_TWCR = TWCR_CONTINUE | TWCR_TWSTO_bm | TWCR_TWSTA_bm;
+  } else {
+    *_TWCR = TWCR_TWINT_bm | TWCR_TWEN_bm | TWCR_TWSTO_bm;
+  }
+}
+
+void AvrTwiAsyncI2cMaster::ackNextByte(I2cTransaction const & transaction)
+{
+  /* All but the last byte are acknowledged by the master */
+  bool const is_last_byte = (_rx_pos + 1) >= transaction.rx_size;
+  *_TWCR = TWCR_CONTINUE | (is_last_byte ? 0 : TWCR_TWEA_bm);
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
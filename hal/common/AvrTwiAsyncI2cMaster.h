@@ -0,0 +1,92 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_AVRTWIASYNCI2CMASTER_H_
+#define EXAMPLES_HAL_COMMON_AVRTWIASYNCI2CMASTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/interrupt/InterruptCallback.h>
+
+#include "AsyncI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Executes queued I2C transactions via the TWI of the AVR family (ATMEGA328P,
+ * ATMEGA1284P, AT90CAN128, ...) from within the TWI interrupt, the CPU is
+ * only involved once per transferred byte. The bit rate is configured via
+ * blox::I2cMaster, this class takes over TWCR/TWDR and must be registered
+ * as the callback for the TWI interrupt. Blocking transfers via
+ * blox::I2cMaster must not take place while transactions are pending.
+ *
+ * The STOP condition of a completed transaction and the START condition
+ * of the next one are requested with a single TWCR write, therefore
+ * queued transactions are executed back-to-back.
+ */
+class AvrTwiAsyncI2cMaster : public AsyncI2cMaster,
+                             public hal::interface::InterruptCallback
+{
+
+public:
+
+           AvrTwiAsyncI2cMaster(volatile uint8_t                * twcr,
+                                volatile uint8_t                * twdr,
+                                volatile uint8_t                * twsr,
+                                hal::interface::CriticalSection & crit_sec);
+  virtual ~AvrTwiAsyncI2cMaster();
+
+
+  virtual void interruptServiceRoutine() override;
+
+protected:
+
+  virtual void start() override;
+
+private:
+
+  volatile uint8_t * _TWCR,
+                   * _TWDR,
+                   * _TWSR;
+  uint16_t           _tx_pos,
+                     _rx_pos;
+  bool               _is_reading;
+
+  void prepare(I2cTransaction const & transaction);
+  void finish (bool const success);
+  void ackNextByte(I2cTransaction const & transaction);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_AVRTWIASYNCI2CMASTER_H_ */
@@ -0,0 +1,93 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "CountingI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+CountingI2cMaster::CountingI2cMaster(hal::interface::I2cMaster & i2c_master)
+: _i2c_master      (i2c_master),
+  _num_transactions(0         ),
+  _num_bytes       (0         )
+{
+
+}
+
+CountingI2cMaster::~CountingI2cMaster()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void CountingI2cMaster::reset()
+{
+  _num_transactions = 0;
+  _num_bytes        = 0;
+}
+
+void CountingI2cMaster::setI2cClock(hal::interface::I2cClock const i2c_clock)
+{
+  _i2c_master.setI2cClock(i2c_clock);
+}
+
+bool CountingI2cMaster::begin(uint8_t const address, bool const is_repeated_start)
+{
+  _num_transactions++;
+  _num_bytes++;
+  return _i2c_master.begin(address, is_repeated_start);
+}
+
+void CountingI2cMaster::end()
+{
+  _i2c_master.end();
+}
+
+bool CountingI2cMaster::write(uint8_t const data)
+{
+  _num_bytes++;
+  return _i2c_master.write(data);
+}
+
+bool CountingI2cMaster::requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes)
+{
+  _num_transactions++;
+  _num_bytes += 1 + num_bytes;
+  return _i2c_master.requestFrom(address, data, num_bytes);
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
@@ -0,0 +1,80 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_COUNTINGI2CMASTER_H_
+#define EXAMPLES_HAL_COMMON_COUNTINGI2CMASTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/i2c/I2cMaster.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Decorator for any I2cMaster which counts the bus activity caused by
+ * a driver: every START condition (begin() as well as requestFrom())
+ * counts as one transaction and each address byte as one transferred
+ * byte, i.e. numBytes() approximates the bus occupation in units of
+ * 9 SCL cycles.
+ */
+class CountingI2cMaster : public hal::interface::I2cMaster
+{
+
+public:
+
+           CountingI2cMaster(hal::interface::I2cMaster & i2c_master);
+  virtual ~CountingI2cMaster();
+
+
+  void     reset          ();
+  uint32_t numTransactions() const { return _num_transactions; }
+  uint32_t numBytes       () const { return _num_bytes; }
+
+
+  virtual void setI2cClock(hal::interface::I2cClock const i2c_clock) override;
+
+  virtual bool begin      (uint8_t const address, bool const is_repeated_start) override;
+  virtual void end        () override;
+  virtual bool write      (uint8_t const data) override;
+  virtual bool requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes) override;
+
+private:
+
+  hal::interface::I2cMaster & _i2c_master;
+  uint32_t                    _num_transactions,
+                              _num_bytes;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_COUNTINGI2CMASTER_H_ */
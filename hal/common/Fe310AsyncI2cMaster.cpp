@@ -0,0 +1,204 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "Fe310AsyncI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* Command register (write) */
+static uint32_t constexpr I2C_CMD_STA_bm      = (1<<7);
+static uint32_t constexpr I2C_CMD_STO_bm      = (1<<6);
+static uint32_t constexpr I2C_CMD_RD_bm       = (1<<5);
+static uint32_t constexpr I2C_CMD_WR_bm       = (1<<4);
+static uint32_t constexpr I2C_CMD_NACK_bm     = (1<<3);
+static uint32_t constexpr I2C_CMD_IACK_bm     = (1<<0);
+
+/* Status register (read) */
+static uint32_t constexpr I2C_STATUS_RXNACK_bm = (1<<7);
+static uint32_t constexpr I2C_STATUS_AL_bm     = (1<<5);
+static uint32_t constexpr I2C_STATUS_TIP_bm    = (1<<1);
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+Fe310AsyncI2cMaster::Fe310AsyncI2cMaster(volatile uint32_t               * i2c_data,
+                                         volatile uint32_t               * i2c_cmd_status,
+                                         hal::interface::CriticalSection & crit_sec)
+: AsyncI2cMaster (crit_sec      ),
+  _I2C_DATA      (i2c_data      ),
+  _I2C_CMD_STATUS(i2c_cmd_status),
+  _state         (State::Idle   ),
+  _tx_pos        (0             ),
+  _rx_pos        (0             ),
+  _is_reading    (false         ),
+  _success       (false         )
+{
+
+}
+
+Fe310AsyncI2cMaster::~Fe310AsyncI2cMaster()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void Fe310AsyncI2cMaster::process()
+{
+  if(_state == State::Idle) return;
+
+  uint32_t const status = *_I2C_CMD_STATUS;
+  if(status & I2C_STATUS_TIP_bm) return;
+
+  I2cTransaction * transaction = head();
+
+  /* The master has already released the bus */
+  if(status & I2C_STATUS_AL_bm) {
+    finish(false);
+    return;
+  }
+
+  switch(_state)
+  {
+  case State::Address:
+  {
+    if     (status & I2C_STATUS_RXNACK_bm)        stop(false);
+    else if(_is_reading)                          receive(*transaction);
+    else if(_tx_pos < transaction->tx_size)       transmit(*transaction);
+    else                                          stop(true);
+  }
+  break;
+
+  case State::Transmit:
+  {
+    if(status & I2C_STATUS_RXNACK_bm) {
+      stop(false);
+    }
+    else if(_tx_pos < transaction->tx_size) {
+      transmit(*transaction);
+    }
+    else if(transaction->rx_size > 0) {
+      _is_reading = true;
+      sendAddress(*transaction);
+    }
+    else {
+      stop(true);
+    }
+  }
+  break;
+
+  case State::Receive:
+  {
+    transaction->rx_buf[_rx_pos++] = static_cast<uint8_t>(*_I2C_DATA);
+    /* The last byte has been read with NACK + STOP */
+    if(_rx_pos < transaction->rx_size) receive(*transaction);
+    else                               finish(true);
+  }
+  break;
+
+  case State::Stop:
+  {
+    finish(_success);
+  }
+  break;
+
+  case State::Idle: break;
+  }
+}
+
+void Fe310AsyncI2cMaster::interruptServiceRoutine()
+{
+  process();
+}
+
+/**************************************************************************************
+ * PROTECTED MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void Fe310AsyncI2cMaster::start()
+{
+  I2cTransaction * transaction = head();
+
+  _tx_pos     = 0;
+  _rx_pos     = 0;
+  _is_reading = (transaction->tx_size == 0) && (transaction->rx_size > 0);
+
+  sendAddress(*transaction);
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void Fe310AsyncI2cMaster::sendAddress(I2cTransaction const & transaction)
+{
+  *_I2C_DATA       = transaction.address | (_is_reading ? 1 : 0);
+  *_I2C_CMD_STATUS = I2C_CMD_STA_bm | I2C_CMD_WR_bm | I2C_CMD_IACK_bm;
+  _state           = State::Address;
+}
+
+void Fe310AsyncI2cMaster::transmit(I2cTransaction const & transaction)
+{
+  *_I2C_DATA       = transaction.tx_buf[_tx_pos++];
+  *_I2C_CMD_STATUS = I2C_CMD_WR_bm | I2C_CMD_IACK_bm;
+  _state           = State::Transmit;
+}
+
+void Fe310AsyncI2cMaster::receive(I2cTransaction const & transaction)
+{
+  bool const is_last_byte = (_rx_pos + 1) >= transaction.rx_size;
+  *_I2C_CMD_STATUS = I2C_CMD_RD_bm | I2C_CMD_IACK_bm | (is_last_byte ? (I2C_CMD_NACK_bm | I2C_CMD_STO_bm) : 0);
+  _state           = State::Receive;
+}
+
+void Fe310AsyncI2cMaster::stop(bool const success)
+{
+  *_I2C_CMD_STATUS = I2C_CMD_STO_bm | I2C_CMD_IACK_bm;
+  _success         = success;
+  _state           = State::Stop;
+}
+
+void Fe310AsyncI2cMaster::finish(bool const success)
+{
+  _state = State::Idle;
+  if(complete(success)) {
+    start();
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
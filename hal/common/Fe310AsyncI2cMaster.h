@@ -0,0 +1,105 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_FE310ASYNCI2CMASTER_H_
+#define EXAMPLES_HAL_COMMON_FE310ASYNCI2CMASTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/interrupt/InterruptCallback.h>
+
+#include "AsyncI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Executes queued I2C transactions via the I2C master of the FE310 with the
+ * same queue semantics as AvrTwiAsyncI2cMaster. Prescaler, enable and pin
+ * multiplexing are configured via FE310::I2cMaster, this class only accesses
+ * the data and command/status register.
+ *
+ * process() never waits for the bus - it returns immediately as long as a
+ * byte transfer is in progress and otherwise issues the next command. It
+ * is either called periodically from the main loop or, with IEN set in the
+ * control register, from the PLIC I2C interrupt (interruptServiceRoutine()).
+ */
+class Fe310AsyncI2cMaster : public AsyncI2cMaster,
+                            public hal::interface::InterruptCallback
+{
+
+public:
+
+           Fe310AsyncI2cMaster(volatile uint32_t               * i2c_data,
+                               volatile uint32_t               * i2c_cmd_status,
+                               hal::interface::CriticalSection & crit_sec);
+  virtual ~Fe310AsyncI2cMaster();
+
+
+  void process();
+
+
+  virtual void interruptServiceRoutine() override;
+
+protected:
+
+  virtual void start() override;
+
+private:
+
+  enum class State
+  {
+    Idle,
+    Address,
+    Transmit,
+    Receive,
+    Stop
+  };
+
+  volatile uint32_t * _I2C_DATA,
+                    * _I2C_CMD_STATUS;
+  State               _state;
+  uint16_t            _tx_pos,
+                      _rx_pos;
+  bool                _is_reading,
+                      _success;
+
+  void sendAddress(I2cTransaction const & transaction);
+  void transmit   (I2cTransaction const & transaction);
+  void receive    (I2cTransaction const & transaction);
+  void stop       (bool const success);
+  void finish     (bool const success);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_FE310ASYNCI2CMASTER_H_ */
@@ -0,0 +1,205 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_I2CCLOCKSETTING_H_
+#define EXAMPLES_HAL_COMMON_I2CCLOCKSETTING_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+typedef struct
+{
+  uint32_t scl_Hz;
+  uint8_t  twbr;
+  uint8_t  twps;
+  uint32_t actual_scl_Hz;
+} AvrTwiClockSetting;
+
+typedef struct
+{
+  uint32_t scl_Hz;
+  uint16_t prescale;
+  uint32_t actual_scl_Hz;
+} Fe310I2cClockSetting;
+
+/* I2C devices for which drivers exist, see i2cDeviceMaxClockHz. */
+enum class I2cDevice
+{
+  AD7151,
+  AS5600,
+  BMG160,
+  BMP388,
+  DRV2605,
+  INA220,
+  L3GD20,
+  LIS2DSH,
+  LIS3DSH,
+  LIS3MDL,
+  LSM6DSM,
+  M24LR,
+  MCP23017,
+  PCA9547,
+  PCF8570
+};
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* hal::interface::I2cClock lives in the library and only knows the standard
+ * mode clock used by all examples. Faster clocks are configured by
+ * overwriting the prescaler registers after blox::I2cMaster/FE310::I2cMaster
+ * has been set up, see avrSetTwiClock/fe310SetI2cClock.
+ */
+static uint32_t constexpr I2C_CLOCK_STANDARD_MODE_Hz  =  100000UL;
+static uint32_t constexpr I2C_CLOCK_FAST_MODE_Hz      =  400000UL;
+static uint32_t constexpr I2C_CLOCK_FAST_MODE_PLUS_Hz = 1000000UL;
+
+/* The TWI of ATMEGA328P, ATMEGA1284P and AT90CAN128 is specified for
+ * SCL frequencies up to 400 kHz.
+ */
+static uint32_t constexpr AVR_TWI_MAX_SCL_Hz = I2C_CLOCK_FAST_MODE_Hz;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+/* SCL limits according to the datasheets. Devices which support Hs-mode
+ * (BMP388, INA220, MCP23017) are listed with their Fast-mode limit since
+ * switching to Hs-mode requires a master code neither the AVR TWI nor the
+ * FE310 I2C master can send.
+ */
+constexpr uint32_t i2cDeviceMaxClockHz(I2cDevice const device)
+{
+  switch(device)
+  {
+  case I2cDevice::AS5600 : return I2C_CLOCK_FAST_MODE_PLUS_Hz;
+  case I2cDevice::PCF8570: return I2C_CLOCK_STANDARD_MODE_Hz;
+  default:                 return I2C_CLOCK_FAST_MODE_Hz;
+  }
+}
+
+/* Returns the highest SCL frequency all devices on a bus can handle. */
+constexpr uint32_t i2cBusMaxClockHz(I2cDevice const device)
+{
+  return i2cDeviceMaxClockHz(device);
+}
+
+template <typename... Devices>
+constexpr uint32_t i2cBusMaxClockHz(I2cDevice const device, Devices... devices)
+{
+  uint32_t const max_clock_Hz = i2cBusMaxClockHz(devices...);
+  return (i2cDeviceMaxClockHz(device) < max_clock_Hz) ? i2cDeviceMaxClockHz(device) : max_clock_Hz;
+}
+
+/* The divisors are always rounded up, the SCL frequency generated is
+ * therefore never above the requested one. A clock is considered usable
+ * if it is generated with no more than 10 % below the requested frequency.
+ */
+constexpr bool isI2cClockUsable(uint32_t const actual_scl_Hz, uint32_t const scl_Hz)
+{
+  return (actual_scl_Hz <= scl_Hz) && (static_cast<uint64_t>(actual_scl_Hz) * 10 >= static_cast<uint64_t>(scl_Hz) * 9);
+}
+
+/* AVR TWI: SCL = f_cpu / (16 + 2 * TWBR * 4^TWPS), TWBR is 8 bit wide and
+ * the smallest prescaler which allows the divisor is selected.
+ */
+constexpr AvrTwiClockSetting avrTwiClockSetting(uint32_t const f_cpu, uint32_t const scl_Hz)
+{
+  uint32_t const ratio = (f_cpu + scl_Hz - 1) / scl_Hz;
+  uint32_t const n     = (ratio <= 16) ? 0 : ((ratio - 16 + 1) / 2);
+
+  uint8_t  twps = 0;
+  uint32_t twbr = n;
+  while((twps < 3) && (twbr > 255)) {
+    twps++;
+    twbr = (n + (1UL << (2 * twps)) - 1) >> (2 * twps);
+  }
+  if(twbr > 255) twbr = 255;
+
+  uint32_t const actual = f_cpu / (16 + 2 * twbr * (1UL << (2 * twps)));
+
+  return AvrTwiClockSetting{scl_Hz, static_cast<uint8_t>(twbr), twps, actual};
+}
+
+constexpr bool isAvrTwiClockSupported(uint32_t const f_cpu, uint32_t const scl_Hz)
+{
+  return (scl_Hz <= AVR_TWI_MAX_SCL_Hz) && isI2cClockUsable(avrTwiClockSetting(f_cpu, scl_Hz).actual_scl_Hz, scl_Hz);
+}
+
+/* FE310 I2C: SCL = f_in / (5 * (prescale + 1)), prescale is 16 bit wide. */
+constexpr Fe310I2cClockSetting fe310I2cClockSetting(uint32_t const f_in, uint32_t const scl_Hz)
+{
+  uint32_t const divisor    = 5 * scl_Hz;
+  uint32_t const prescale_1 = (f_in + divisor - 1) / divisor;
+  uint32_t const prescale   = (prescale_1 == 0) ? 0 : ((prescale_1 > 65536) ? 65535 : (prescale_1 - 1));
+  uint32_t const actual     = f_in / (5 * (prescale + 1));
+
+  return Fe310I2cClockSetting{scl_Hz, static_cast<uint16_t>(prescale), actual};
+}
+
+constexpr bool isFe310I2cClockSupported(uint32_t const f_in, uint32_t const scl_Hz)
+{
+  return (scl_Hz <= I2C_CLOCK_FAST_MODE_PLUS_Hz) && isI2cClockUsable(fe310I2cClockSetting(f_in, scl_Hz).actual_scl_Hz, scl_Hz);
+}
+
+/* Register access, TWPS occupies bits 0 and 1 of TWSR on all supported AVRs. */
+inline void avrSetTwiClock(volatile uint8_t * twbr, volatile uint8_t * twsr, AvrTwiClockSetting const & setting)
+{
+  static uint8_t constexpr TWPS_bm = (1 << 1) | (1 << 0);
+
+  *twsr = (*twsr & ~TWPS_bm) | setting.twps;
+  *twbr = setting.twbr;
+}
+
+/* The prescaler of the FE310 I2C master may only be changed while the
+ * core is disabled (EN = bit 7 of the control register).
+ */
+inline void fe310SetI2cClock(volatile uint32_t * i2c_presc_low, volatile uint32_t * i2c_presc_high, volatile uint32_t * i2c_control, Fe310I2cClockSetting const & setting)
+{
+  static uint32_t constexpr EN_bm = (1 << 7);
+
+  uint32_t const control = *i2c_control;
+
+  *i2c_control    = control & ~EN_bm;
+  *i2c_presc_low  = (setting.prescale >> 0) & 0xFF;
+  *i2c_presc_high = (setting.prescale >> 8) & 0xFF;
+  *i2c_control    = control;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_I2CCLOCKSETTING_H_ */
@@ -0,0 +1,102 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_I2CTRANSACTION_H_
+#define EXAMPLES_HAL_COMMON_I2CTRANSACTION_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * FORWARD DECLARATION
+ **************************************************************************************/
+
+struct I2cTransaction;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+namespace interface
+{
+
+class I2cTransactionCallback
+{
+
+public:
+
+  virtual ~I2cTransactionCallback() { }
+
+
+  /* Invoked from within the I2C interrupt (or I2C poll function) after the
+   * transaction has been completed, transaction.success tells whether all
+   * bytes have been acknowledged. The transaction may be resubmitted from
+   * within here.
+   */
+  virtual void onI2cTransactionComplete(I2cTransaction & transaction) = 0;
+
+};
+
+} /* interface */
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+/* Describes one I2C transaction with the slave at address (8 bit address as
+ * used by I2cMaster::begin()):
+ *
+ *   write          : tx_size > 0, rx_size = 0 - START, SLA+W, tx_buf,                     STOP
+ *   read           : tx_size = 0, rx_size > 0 - START, SLA+R, rx_buf,                     STOP
+ *   write-then-read: tx_size > 0, rx_size > 0 - START, SLA+W, tx_buf, REP START, SLA+R, rx_buf, STOP
+ *
+ * The transaction as well as the buffers are owned by the caller and must
+ * remain valid until complete is set.
+ */
+struct I2cTransaction
+{
+  uint8_t                                   address;
+  uint8_t                           const * tx_buf;
+  uint16_t                                  tx_size;
+  uint8_t                                 * rx_buf;
+  uint16_t                                  rx_size;
+  interface::I2cTransactionCallback       * callback;
+
+  /* Managed by i2c::AsyncI2cMaster */
+  I2cTransaction                          * next     = nullptr;
+  bool                            volatile  complete = false;
+  bool                            volatile  success  = false;
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_I2CTRANSACTION_H_ */
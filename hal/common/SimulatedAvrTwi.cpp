@@ -0,0 +1,147 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedAvrTwi.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t constexpr TWCR_TWINT_bm = (1<<7);
+static uint8_t constexpr TWCR_TWEA_bm  = (1<<6);
+static uint8_t constexpr TWCR_TWSTA_bm = (1<<5);
+static uint8_t constexpr TWCR_TWSTO_bm = (1<<4);
+static uint8_t constexpr TWCR_TWIE_bm  = (1<<0);
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedAvrTwi::SimulatedAvrTwi(SimulatedI2cMaster & bus)
+: _bus       (bus        ),
+  _isr       (nullptr    ),
+  _TWCR      (0          ),
+  _TWDR      (0          ),
+  _TWSR      (0xF8       ),
+  _state     (State::Idle),
+  _slave     (nullptr    ),
+  _num_starts(0          ),
+  _num_stops (0          )
+{
+
+}
+
+SimulatedAvrTwi::~SimulatedAvrTwi()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedAvrTwi::registerInterruptCallback(hal::interface::InterruptCallback * isr)
+{
+  _isr = isr;
+}
+
+bool SimulatedAvrTwi::step()
+{
+  uint8_t const cmd = _TWCR;
+  if(!(cmd & TWCR_TWINT_bm)) return false;
+  _TWCR = 0;
+
+  if(cmd & TWCR_TWSTO_bm)
+  {
+    if(_slave) _slave->onStop();
+    _slave = nullptr;
+    _state = State::Idle;
+    _num_stops++;
+    /* No interrupt is raised after a STOP condition */
+    if(!(cmd & TWCR_TWSTA_bm)) return true;
+  }
+
+  if(cmd & TWCR_TWSTA_bm)
+  {
+    _TWSR  = (_state == State::Idle) ? 0x08 : 0x10;
+    _state = State::Started;
+    _num_starts++;
+  }
+  else
+  {
+    switch(_state)
+    {
+    case State::Started:
+    {
+      bool const is_read = (_TWDR & 1);
+      interface::SimulatedI2cSlave * slave = _bus.find(_TWDR & 0xFE);
+      if(_slave && _slave != slave) _slave->onStop();
+      _slave = slave;
+      if(_slave) {
+        _slave->onStart(is_read);
+        _TWSR  = is_read ? 0x40 : 0x18;
+        _state = is_read ? State::MasterReceive : State::MasterTransmit;
+      } else {
+        _TWSR  = is_read ? 0x48 : 0x20;
+      }
+    }
+    break;
+
+    case State::MasterTransmit:
+      _TWSR = _slave->onWrite(_TWDR) ? 0x28 : 0x30;
+      break;
+
+    case State::MasterReceive:
+      _TWDR = _slave->onRead();
+      _TWSR = (cmd & TWCR_TWEA_bm) ? 0x50 : 0x58;
+      break;
+
+    case State::Idle:
+      _TWSR = 0x00; /* Bus error */
+      break;
+    }
+  }
+
+  if((cmd & TWCR_TWIE_bm) && _isr) {
+    _isr->interruptServiceRoutine();
+  }
+
+  return true;
+}
+
+void SimulatedAvrTwi::run()
+{
+  while(step()) { }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
@@ -0,0 +1,96 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SIMULATEDAVRTWI_H_
+#define EXAMPLES_HAL_COMMON_SIMULATEDAVRTWI_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/interrupt/InterruptCallback.h>
+
+#include "SimulatedI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Register level model of the AVR TWI in master mode for running TWI code on
+ * a Linux host. Every TWCR write with TWINT set is a command which is executed
+ * by step() against the slaves attached to the SimulatedI2cMaster, afterwards
+ * TWSR carries the resulting status code and the TWI interrupt callback is
+ * invoked if TWIE was set.
+ */
+class SimulatedAvrTwi
+{
+
+public:
+
+           SimulatedAvrTwi(SimulatedI2cMaster & bus);
+  virtual ~SimulatedAvrTwi();
+
+
+  volatile uint8_t * twcr() { return &_TWCR; }
+  volatile uint8_t * twdr() { return &_TWDR; }
+  volatile uint8_t * twsr() { return &_TWSR; }
+
+  void registerInterruptCallback(hal::interface::InterruptCallback * isr);
+
+  /* Returns false if no command is pending */
+  bool     step();
+  void     run();
+  uint32_t numStarts() const { return _num_starts; }
+  uint32_t numStops () const { return _num_stops; }
+
+private:
+
+  enum class State
+  {
+    Idle,
+    Started,
+    MasterTransmit,
+    MasterReceive
+  };
+
+  SimulatedI2cMaster                 & _bus;
+  hal::interface::InterruptCallback  * _isr;
+  volatile uint8_t                     _TWCR,
+                                       _TWDR,
+                                       _TWSR;
+  State                                _state;
+  interface::SimulatedI2cSlave       * _slave;
+  uint32_t                             _num_starts,
+                                       _num_stops;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_SIMULATEDAVRTWI_H_ */
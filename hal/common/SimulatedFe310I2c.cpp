@@ -0,0 +1,123 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedFe310I2c.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t constexpr I2C_CMD_STA_bm       = (1<<7);
+static uint32_t constexpr I2C_CMD_STO_bm       = (1<<6);
+static uint32_t constexpr I2C_CMD_RD_bm        = (1<<5);
+static uint32_t constexpr I2C_CMD_WR_bm        = (1<<4);
+
+static uint32_t constexpr I2C_STATUS_RXNACK_bm = (1<<7);
+static uint32_t constexpr I2C_STATUS_IF_bm     = (1<<0);
+static uint32_t constexpr I2C_STATUS_SIM_bm    = (1<<8);
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedFe310I2c::SimulatedFe310I2c(SimulatedI2cMaster & bus)
+: _bus       (bus              ),
+  _DATA      (0                ),
+  _CMD_STATUS(I2C_STATUS_SIM_bm),
+  _state     (State::Idle      ),
+  _slave     (nullptr          ),
+  _num_starts(0                )
+{
+
+}
+
+SimulatedFe310I2c::~SimulatedFe310I2c()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool SimulatedFe310I2c::step()
+{
+  uint32_t const cmd = _CMD_STATUS;
+  if(cmd & I2C_STATUS_SIM_bm) return false;
+
+  bool is_nack = false;
+
+  if(cmd & I2C_CMD_STA_bm) {
+    _state = State::Started;
+    _num_starts++;
+  }
+
+  if(cmd & I2C_CMD_WR_bm)
+  {
+    if(_state == State::Started)
+    {
+      bool const is_read = (_DATA & 1);
+      interface::SimulatedI2cSlave * slave = _bus.find(_DATA & 0xFE);
+      if(_slave && _slave != slave) _slave->onStop();
+      _slave = slave;
+      if(_slave) {
+        _slave->onStart(is_read);
+        _state = is_read ? State::MasterReceive : State::MasterTransmit;
+      } else {
+        is_nack = true;
+      }
+    }
+    else if(_state == State::MasterTransmit) {
+      is_nack = !_slave->onWrite(static_cast<uint8_t>(_DATA));
+    }
+    else {
+      is_nack = true;
+    }
+  }
+
+  if((cmd & I2C_CMD_RD_bm) && (_state == State::MasterReceive)) {
+    _DATA = _slave->onRead();
+  }
+
+  if(cmd & I2C_CMD_STO_bm) {
+    if(_slave) _slave->onStop();
+    _slave = nullptr;
+    _state = State::Idle;
+  }
+
+  _CMD_STATUS = I2C_STATUS_SIM_bm | I2C_STATUS_IF_bm | (is_nack ? I2C_STATUS_RXNACK_bm : 0);
+
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
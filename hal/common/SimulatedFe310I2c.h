@@ -0,0 +1,85 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SIMULATEDFE310I2C_H_
+#define EXAMPLES_HAL_COMMON_SIMULATEDFE310I2C_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Register level model of the FE310 I2C master for running I2C code on a
+ * Linux host. Command and status share one register, the model marks every
+ * status it writes with bit 8 (unused by the hardware) so that step() can
+ * distinguish a newly written command from the last status.
+ */
+class SimulatedFe310I2c
+{
+
+public:
+
+           SimulatedFe310I2c(SimulatedI2cMaster & bus);
+  virtual ~SimulatedFe310I2c();
+
+
+  volatile uint32_t * data      () { return &_DATA; }
+  volatile uint32_t * cmd_status() { return &_CMD_STATUS; }
+
+  /* Returns false if no command is pending */
+  bool     step();
+  uint32_t numStarts() const { return _num_starts; }
+
+private:
+
+  enum class State
+  {
+    Idle,
+    Started,
+    MasterTransmit,
+    MasterReceive
+  };
+
+  SimulatedI2cMaster           & _bus;
+  volatile uint32_t              _DATA,
+                                 _CMD_STATUS;
+  State                          _state;
+  interface::SimulatedI2cSlave * _slave;
+  uint32_t                       _num_starts;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_SIMULATEDFE310I2C_H_ */
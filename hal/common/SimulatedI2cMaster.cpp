@@ -0,0 +1,138 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedI2cMaster.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedI2cMaster::SimulatedI2cMaster()
+: _num_slaves     (0      ),
+  _active_slave   (nullptr),
+  _nack_next_write(false  )
+{
+
+}
+
+SimulatedI2cMaster::~SimulatedI2cMaster()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool SimulatedI2cMaster::attach(interface::SimulatedI2cSlave & slave)
+{
+  if(_num_slaves == MAX_NUM_SLAVES) return false;
+  _slave[_num_slaves++] = &slave;
+  return true;
+}
+
+interface::SimulatedI2cSlave * SimulatedI2cMaster::find(uint8_t const address)
+{
+  interface::SimulatedI2cSlave * slave = nullptr;
+
+  for(uint8_t s = 0; s < _num_slaves; s++)
+  {
+    if((_slave[s]->address() != address) || !_slave[s]->isConnected()) continue;
+    if(slave) return nullptr;
+    slave = _slave[s];
+  }
+
+  return slave;
+}
+
+void SimulatedI2cMaster::setI2cClock(hal::interface::I2cClock const /* i2c_clock */)
+{
+
+}
+
+bool SimulatedI2cMaster::begin(uint8_t const address, bool const is_repeated_start)
+{
+  if(_active_slave && !is_repeated_start) {
+    _active_slave->onStop();
+  }
+
+  _active_slave = find(address);
+  if(!_active_slave) return false;
+
+  _active_slave->onStart(false);
+  return true;
+}
+
+void SimulatedI2cMaster::end()
+{
+  if(_active_slave) {
+    _active_slave->onStop();
+    _active_slave = nullptr;
+  }
+}
+
+bool SimulatedI2cMaster::write(uint8_t const data)
+{
+  if(!_active_slave) return false;
+
+  if(_nack_next_write) {
+    _nack_next_write = false;
+    return false;
+  }
+
+  return _active_slave->onWrite(data);
+}
+
+bool SimulatedI2cMaster::requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes)
+{
+  /* requestFrom() issues a (repeated) START, reads and terminates
+   * the transfer with a STOP condition.
+   */
+  interface::SimulatedI2cSlave * slave = find(address);
+  if(_active_slave && _active_slave != slave) {
+    _active_slave->onStop();
+  }
+  _active_slave = nullptr;
+
+  if(!slave) return false;
+
+  slave->onStart(true);
+  for(uint16_t i = 0; i < num_bytes; i++) {
+    data[i] = slave->onRead();
+  }
+  slave->onStop();
+
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
@@ -0,0 +1,117 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SIMULATEDI2CMASTER_H_
+#define EXAMPLES_HAL_COMMON_SIMULATEDI2CMASTER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/i2c/I2cMaster.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::i2c
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+namespace interface
+{
+
+class SimulatedI2cSlave
+{
+
+public:
+
+  virtual ~SimulatedI2cSlave() { }
+
+
+  /* address is the 8 bit address as passed to I2cMaster::begin() */
+  virtual uint8_t address() const = 0;
+
+  /* False if the slave is currently cut off from the bus, e.g. by an I2C mux */
+  virtual bool    isConnected() const { return true; }
+
+  virtual void    onStart(bool const is_read) = 0;
+  virtual bool    onWrite(uint8_t const data) = 0;
+  virtual uint8_t onRead () = 0;
+  virtual void    onStop () = 0;
+
+};
+
+} /* interface */
+
+/* Software model of an I2C bus for running the I2C code of the examples
+ * on a Linux host, up to MAX_NUM_SLAVES slave models can be attached.
+ * Addressing a slave which is not attached or not connected fails the
+ * same way as a missing ACK on a real bus, so does addressing two
+ * connected slaves with the same address (which would corrupt each
+ * other's data). The slaves attached here are also used by
+ * the register level models of the MCU I2C peripherals.
+ *
+ * nackNextWrite() lets the next written byte fail as if the slave did not
+ * acknowledge it, isIdle() tells whether a STOP has released the bus.
+ */
+class SimulatedI2cMaster : public hal::interface::I2cMaster
+{
+
+public:
+
+  static uint8_t constexpr MAX_NUM_SLAVES = 16;
+
+
+           SimulatedI2cMaster();
+  virtual ~SimulatedI2cMaster();
+
+
+  bool                           attach(interface::SimulatedI2cSlave & slave);
+  interface::SimulatedI2cSlave * find  (uint8_t const address);
+
+  void                           nackNextWrite()       { _nack_next_write = true; }
+  bool                           isIdle       () const { return _active_slave == nullptr; }
+
+
+  virtual void setI2cClock(hal::interface::I2cClock const i2c_clock) override;
+
+  virtual bool begin      (uint8_t const address, bool const is_repeated_start) override;
+  virtual void end        () override;
+  virtual bool write      (uint8_t const data) override;
+  virtual bool requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes) override;
+
+private:
+
+  interface::SimulatedI2cSlave * _slave[MAX_NUM_SLAVES];
+  uint8_t                        _num_slaves;
+  interface::SimulatedI2cSlave * _active_slave;
+  bool                           _nack_next_write;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::i2c */
+
+#endif /* EXAMPLES_HAL_COMMON_SIMULATEDI2CMASTER_H_ */
@@ -0,0 +1,96 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedSpiPort.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedSpiPort::SimulatedSpiPort(interface::SimulatedSpiSlave & slave)
+: _slave              (slave  ),
+  _isr                (nullptr),
+  _is_transfer_pending(false  ),
+  _tx_data            (0      ),
+  _rx_data            (0      ),
+  _num_transfers      (0      )
+{
+
+}
+
+SimulatedSpiPort::~SimulatedSpiPort()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SimulatedSpiPort::registerInterruptCallback(hal::interface::InterruptCallback * isr)
+{
+  _isr = isr;
+}
+
+bool SimulatedSpiPort::step()
+{
+  if(!_is_transfer_pending) return false;
+
+  _rx_data             = _slave.exchange(_tx_data);
+  _is_transfer_pending = false;
+  _num_transfers++;
+
+  if(_isr) {
+    _isr->interruptServiceRoutine();
+  }
+
+  return true;
+}
+
+void SimulatedSpiPort::run()
+{
+  while(step()) { }
+}
+
+void SimulatedSpiPort::transfer(uint8_t const data)
+{
+  _tx_data             = data;
+  _is_transfer_pending = true;
+}
+
+uint8_t SimulatedSpiPort::received()
+{
+  return _rx_data;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
@@ -0,0 +1,103 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SIMULATEDSPIPORT_H_
+#define EXAMPLES_HAL_COMMON_SIMULATEDSPIPORT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/hal/interface/interrupt/InterruptCallback.h>
+
+#include "SpiPort.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+namespace interface
+{
+
+class SimulatedSpiSlave
+{
+
+public:
+
+  virtual ~SimulatedSpiSlave() { }
+
+
+  /* Returns the byte shifted out by the slave while data is shifted in */
+  virtual uint8_t exchange(uint8_t const data) = 0;
+
+};
+
+} /* interface */
+
+/* Software model of a SPI peripheral for running the SPI code of the
+ * examples on a Linux host. A transfer is completed by calling step()
+ * which exchanges the byte with the slave and then invokes the registered
+ * interrupt callback, i.e. the host program plays the role of the SPI
+ * clock and can interleave its own activities with the interrupts.
+ */
+class SimulatedSpiPort : public interface::SpiPort
+{
+
+public:
+
+           SimulatedSpiPort(interface::SimulatedSpiSlave & slave);
+  virtual ~SimulatedSpiPort();
+
+
+  void registerInterruptCallback(hal::interface::InterruptCallback * isr);
+
+  /* Returns false if no transfer is pending */
+  bool     step();
+  void     run();
+  bool     isTransferPending() const { return _is_transfer_pending; }
+  uint32_t numTransfers     () const { return _num_transfers; }
+
+
+  virtual void    transfer(uint8_t const data) override;
+  virtual uint8_t received() override;
+
+private:
+
+  interface::SimulatedSpiSlave      & _slave;
+  hal::interface::InterruptCallback * _isr;
+  bool                                _is_transfer_pending;
+  uint8_t                             _tx_data,
+                                      _rx_data;
+  uint32_t                            _num_transfers;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
+
+#endif /* EXAMPLES_HAL_COMMON_SIMULATEDSPIPORT_H_ */
@@ -0,0 +1,63 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SPIPORT_H_
+#define EXAMPLES_HAL_COMMON_SPIPORT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi::interface
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Minimal access to a SPI peripheral operated in master mode: transfer()
+ * starts the exchange of one byte, once it is complete the peripheral
+ * raises the SPI transfer complete interrupt and received() returns the
+ * byte clocked in.
+ */
+class SpiPort
+{
+
+public:
+
+  virtual ~SpiPort() { }
+
+
+  virtual void    transfer(uint8_t const data) = 0;
+  virtual uint8_t received() = 0;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi::interface */
+
+#endif /* EXAMPLES_HAL_COMMON_SPIPORT_H_ */
@@ -0,0 +1,105 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SPITRANSACTION_H_
+#define EXAMPLES_HAL_COMMON_SPITRANSACTION_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+#include <snowfox/hal/interface/gpio/DigitalOutPin.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::spi
+{
+
+/**************************************************************************************
+ * FORWARD DECLARATION
+ **************************************************************************************/
+
+struct SpiTransaction;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+namespace interface
+{
+
+class SpiTransactionCallback
+{
+
+public:
+
+  virtual ~SpiTransactionCallback() { }
+
+
+  /* Invoked from within the SPI interrupt after the transaction has
+   * been completed (and CS has been deasserted unless keep_selected
+   * is set), the transaction may be resubmitted from within here.
+   */
+  virtual void onSpiTransactionComplete(SpiTransaction & transaction) = 0;
+
+};
+
+} /* interface */
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+/* Describes one SPI transfer of size bytes. tx_buf may be a nullptr in
+ * which case 0xFF is clocked out, rx_buf may be a nullptr in which case
+ * the received bytes are discarded. The transaction as well as the buffers
+ * are owned by the caller and must remain valid until complete is set.
+ *
+ * With keep_selected set CS remains asserted after the transfer, i.e. a
+ * command header and a caller provided 256 byte flash page can be sent
+ * back-to-back as two transactions without copying them together.
+ * Transactions for other devices are not started until the selected
+ * device has been deselected, see spi::AsyncSpiMaster.
+ *
+ * Transactions with a size of 0 are rejected.
+ */
+struct SpiTransaction
+{
+  hal::interface::DigitalOutPin               * cs;
+  uint8_t                               const * tx_buf;
+  uint8_t                                     * rx_buf;
+  uint16_t                                      size;
+  bool                                          keep_selected;
+  interface::SpiTransactionCallback           * callback;
+
+  /* Managed by spi::AsyncSpiMaster */
+  SpiTransaction                              * next     = nullptr;
+  bool                                volatile  complete = false;
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::spi */
+
+#endif /* EXAMPLES_HAL_COMMON_SPITRANSACTION_H_ */
@@ -0,0 +1,146 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_SPSCRINGBUFFER_H_
+#define EXAMPLES_HAL_COMMON_SPSCRINGBUFFER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+/* The index written by one context is read by the other one without any
+ * locking, therefore it must be accessible with a single load/store. On
+ * 8-bit MCUs this limits the buffer size to 128 bytes (free running 8-bit
+ * indices need one bit more than the buffer size to distinguish between
+ * full and empty).
+ */
+template <bool IS_SMALL> struct SpscRingBufferIndex        { typedef uint8_t  Type; };
+template <>              struct SpscRingBufferIndex<false> { typedef uint16_t Type; };
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Single-producer/single-consumer byte ring buffer, the producer
+ * (e.g. the application) only ever writes _head, the consumer (e.g.
+ * an interrupt service routine) only ever writes _tail.
+ */
+template <uint16_t SIZE>
+class SpscRingBuffer
+{
+
+  static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SpscRingBuffer SIZE must be a power of 2");
+  static_assert(SIZE <= 128 || sizeof(void *) >= 4,   "SpscRingBuffer SIZE must not exceed 128 bytes on 8/16-bit MCUs");
+
+public:
+
+  SpscRingBuffer()
+  : _head(0),
+    _tail(0)
+  {
+
+  }
+
+
+  inline uint16_t available() const { return static_cast<IndexType>(_head - _tail); }
+  inline uint16_t free     () const { return SIZE - available(); }
+
+
+  /* Producer side - either all bytes are stored or none at all. */
+  bool push(uint8_t const * data, uint16_t const num_bytes)
+  {
+    if(num_bytes > free()) return false;
+
+    IndexType head = _head;
+    for(uint16_t i = 0; i < num_bytes; i++, head++) {
+      _buffer[head & MASK] = data[i];
+    }
+    barrier();
+    _head = head;
+
+    return true;
+  }
+
+  /* Consumer side */
+  bool pop(uint8_t & data)
+  {
+    IndexType const tail = _tail;
+    if(tail == _head) return false;
+
+    data = _buffer[tail & MASK];
+    barrier();
+    _tail = tail + 1;
+
+    return true;
+  }
+
+  /* Consumer side - provides direct access to the contiguous readable
+   * region starting at the oldest byte without copying it. If the data
+   * wraps around the end of the buffer a second peek() after consume()
+   * returns the remainder.
+   */
+  uint16_t peek(uint8_t const * & data) const
+  {
+    IndexType const tail      = _tail;
+    uint16_t  const num_bytes = available();
+    uint16_t  const to_end    = SIZE - (tail & MASK);
+
+    data = &_buffer[tail & MASK];
+    return (num_bytes < to_end) ? num_bytes : to_end;
+  }
+
+  void consume(uint16_t const num_bytes)
+  {
+    barrier();
+    _tail = _tail + num_bytes;
+  }
+
+private:
+
+  typedef typename SpscRingBufferIndex<SIZE <= 128>::Type IndexType;
+
+  static IndexType constexpr MASK = SIZE - 1;
+
+  static inline void barrier() { asm volatile("" ::: "memory"); }
+
+  uint8_t            _buffer[SIZE];
+  IndexType volatile _head;
+  IndexType volatile _tail;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal */
+
+#endif /* EXAMPLES_HAL_COMMON_SPSCRINGBUFFER_H_ */
@@ -0,0 +1,67 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_HOST_HOSTSIMCHECK_H_
+#define EXAMPLES_HAL_COMMON_HOST_HOSTSIMCHECK_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::host
+{
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+/* PASS/FAIL reporting shared by the host simulation programs, every check
+ * prints one line, checkResult() prints the overall verdict and returns
+ * the exit code of the program.
+ */
+inline int & numFailures()
+{
+  static int num_failures = 0;
+  return num_failures;
+}
+
+inline void check(char const * name, bool const condition)
+{
+  printf("%s: %s\n", condition ? "PASS" : "FAIL", name);
+  if(!condition) numFailures()++;
+}
+
+inline int checkResult()
+{
+  printf("%s\n", (numFailures() == 0) ? "OK" : "FAILED");
+  return (numFailures() == 0) ? 0 : 1;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::host */
+
+#endif /* EXAMPLES_HAL_COMMON_HOST_HOSTSIMCHECK_H_ */
@@ -0,0 +1,80 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_HAL_COMMON_HOST_SNOWFOX_HAL_INTERFACE_I2C_I2CMASTER_H_
+#define EXAMPLES_HAL_COMMON_HOST_SNOWFOX_HAL_INTERFACE_I2C_I2CMASTER_H_
+
+/**************************************************************************************
+ * NOTE
+ **************************************************************************************/
+
+/* Host stand-in for the snowfox HAL interface of the same name, only used
+ * for building the simulations of the examples on a Linux host.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::hal::interface
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+enum class I2cClock
+{
+  F_100_kHz,
+  F_400_kHz
+};
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+class I2cMaster
+{
+
+public:
+
+  virtual ~I2cMaster() { }
+
+
+  virtual void setI2cClock(I2cClock const i2c_clock) = 0;
+
+  virtual bool begin      (uint8_t const address, bool const is_repeated_start) = 0;
+  virtual void end        () = 0;
+  virtual bool write      (uint8_t const data) = 0;
+  virtual bool requestFrom(uint8_t const address, uint8_t * data, uint16_t const num_bytes) = 0;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::hal::interface */
+
+#endif /* EXAMPLES_HAL_COMMON_HOST_SNOWFOX_HAL_INTERFACE_I2C_I2CMASTER_H_ */
@@ -0,0 +1,214 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../common/host/HostSimCheck.h"
+
+#include "../common/AvrTwiAsyncI2cMaster.h"
+#include "../common/Fe310AsyncI2cMaster.h"
+#include "../common/SimulatedAvrTwi.h"
+#include "../common/SimulatedFe310I2c.h"
+
+#include "../../driver/sensor/common/StSensorIoI2c.h"
+#include "../../driver/sensor/common/SimulatedStSensor.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint8_t const L3GD20_I2C_ADDR  = (0x6B << 1);
+static uint8_t const LIS3MDL_I2C_ADDR = (0x1E << 1);
+static uint8_t const MISSING_I2C_ADDR = (0x50 << 1);
+
+static size_t  const MAX_NUM_STEPS    = 100000;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+class HostCriticalSection : public hal::interface::CriticalSection
+{
+public:
+  virtual void lock  () override { }
+  virtual void unlock() override { }
+};
+
+/* Records the order of completion and optionally resubmits a
+ * transaction once from within the callback.
+ */
+class LoggingCallback : public hal::i2c::interface::I2cTransactionCallback
+{
+public:
+  LoggingCallback() : _engine(nullptr), _resubmit(nullptr), _num_completed(0) { }
+  void reset() { _num_completed = 0; }
+  void resubmitOnce(hal::i2c::AsyncI2cMaster & engine, hal::i2c::I2cTransaction & transaction) { _engine = &engine; _resubmit = &transaction; }
+  virtual void onI2cTransactionComplete(hal::i2c::I2cTransaction & transaction) override
+  {
+    if(_num_completed < MAX_LOG_SIZE) _log[_num_completed++] = &transaction;
+    if(_resubmit) {
+      hal::i2c::I2cTransaction * t = _resubmit;
+      _resubmit = nullptr;
+      _engine->submit(*t);
+    }
+  }
+  bool hasLogged(hal::i2c::I2cTransaction const * const * expected, size_t const size) const
+  {
+    if(size != _num_completed) return false;
+    for(size_t i = 0; i < size; i++) {
+      if(_log[i] != expected[i]) return false;
+    }
+    return true;
+  }
+private:
+  static size_t constexpr MAX_LOG_SIZE = 8;
+  hal::i2c::AsyncI2cMaster * _engine;
+  hal::i2c::I2cTransaction * _resubmit;
+  hal::i2c::I2cTransaction * _log[MAX_LOG_SIZE];
+  size_t                     _num_completed;
+};
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static void check(char const * engine, char const * name, bool const condition)
+{
+  char engine_name[64];
+  snprintf(engine_name, sizeof(engine_name), "[%s] %s", engine, name);
+  host::check(engine_name, condition);
+}
+
+template <typename RunFunc>
+static void test(char const * engine_name, hal::i2c::AsyncI2cMaster & engine, RunFunc run, sensor::SimulatedStSensor & l3gd20, sensor::SimulatedStSensor & lis3mdl)
+{
+  LoggingCallback callback;
+
+  int16_t const l3gd20_xyz [3] = { 100, -200,  300};
+  int16_t const lis3mdl_xyz[3] = {-400,  500, -600};
+  memcpy(&l3gd20.reg (sensor::ST_SENSOR_REG_OUT_X_L), l3gd20_xyz,  sizeof(l3gd20_xyz));
+  memcpy(&lis3mdl.reg(sensor::ST_SENSOR_REG_OUT_X_L), lis3mdl_xyz, sizeof(lis3mdl_xyz));
+  l3gd20.reg(0x2E) = 0x5A;
+  lis3mdl.reg(0x22) = 0x03;
+
+  uint8_t const out_xyz_cmd[] = {sensor::ST_SENSOR_REG_OUT_X_L | sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB};
+  uint8_t const lis3mdl_cfg[] = {0x22, 0x00};
+  uint8_t const missing_cmd[] = {0x77};
+
+  int16_t l3gd20_rx[3] = {0}, lis3mdl_rx[3] = {0};
+  uint8_t read_only_rx = 0;
+
+  /* Several sensors serviced back-to-back */
+  {
+    hal::i2c::I2cTransaction t1 = {L3GD20_I2C_ADDR,  out_xyz_cmd,  1, reinterpret_cast<uint8_t *>(l3gd20_rx),  6, &callback};
+    hal::i2c::I2cTransaction t2 = {LIS3MDL_I2C_ADDR, lis3mdl_cfg,     2, nullptr,                                 0, &callback};
+    hal::i2c::I2cTransaction t3 = {LIS3MDL_I2C_ADDR, out_xyz_cmd,  1, reinterpret_cast<uint8_t *>(lis3mdl_rx), 6, &callback};
+    hal::i2c::I2cTransaction t4 = {MISSING_I2C_ADDR, missing_cmd,     1, nullptr,                                 0, &callback};
+    hal::i2c::I2cTransaction t5 = {L3GD20_I2C_ADDR,  nullptr,         0, &read_only_rx,                           1, &callback};
+
+    engine.submit(t1);
+    engine.submit(t2);
+    engine.submit(t3);
+    engine.submit(t4);
+    engine.submit(t5);
+    check(engine_name, "reject pending resubmit", !engine.submit(t3));
+
+    run();
+
+    hal::i2c::I2cTransaction const * expected_order[] = {&t1, &t2, &t3, &t4, &t5};
+    check(engine_name, "completion order",          callback.hasLogged(expected_order, sizeof(expected_order) / sizeof(expected_order[0])));
+    check(engine_name, "write-then-read (L3GD20)",  t1.complete && t1.success && memcmp(l3gd20_rx, l3gd20_xyz, sizeof(l3gd20_xyz)) == 0);
+    check(engine_name, "write (LIS3MDL)",           t2.complete && t2.success && lis3mdl.reg(0x22) == 0x00);
+    check(engine_name, "write-then-read (LIS3MDL)", t3.complete && t3.success && memcmp(lis3mdl_rx, lis3mdl_xyz, sizeof(lis3mdl_xyz)) == 0);
+    check(engine_name, "NACK from missing device",  t4.complete && !t4.success);
+    check(engine_name, "read (L3GD20)",             t5.complete && t5.success && read_only_rx == 0x5A);
+    check(engine_name, "engine idle",               engine.isIdle());
+  }
+
+  /* Resubmission from within the callback */
+  {
+    callback.reset();
+    memset(l3gd20_rx, 0, sizeof(l3gd20_rx));
+
+    hal::i2c::I2cTransaction t1 = {L3GD20_I2C_ADDR, out_xyz_cmd, 1, reinterpret_cast<uint8_t *>(l3gd20_rx), 6, &callback};
+
+    callback.resubmitOnce(engine, t1);
+    engine.submit(t1);
+    run();
+
+    hal::i2c::I2cTransaction const * expected_order[] = {&t1, &t1};
+    check(engine_name, "resubmission from callback", callback.hasLogged(expected_order, sizeof(expected_order) / sizeof(expected_order[0])) && t1.success && engine.isIdle());
+  }
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  HostCriticalSection          crit_sec;
+  hal::i2c::SimulatedI2cMaster bus;
+  sensor::SimulatedStSensor    l3gd20 (L3GD20_I2C_ADDR,  sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB);
+  sensor::SimulatedStSensor    lis3mdl(LIS3MDL_I2C_ADDR, sensor::ST_SENSOR_AUTO_INCREMENT_SUB_MSB);
+
+  bus.attach(l3gd20);
+  bus.attach(lis3mdl);
+
+  /* ATMEGA328P TWI ******************************************************************/
+  {
+    hal::i2c::SimulatedAvrTwi      twi   (bus);
+    hal::i2c::AvrTwiAsyncI2cMaster engine(twi.twcr(), twi.twdr(), twi.twsr(), crit_sec);
+
+    twi.registerInterruptCallback(&engine);
+
+    test("AVR TWI", engine, [&]() { twi.run(); }, l3gd20, lis3mdl);
+
+    /* 5 + 2 transactions, each write-then-read requires an additional repeated START */
+    check("AVR TWI", "number of START conditions", twi.numStarts() == (5 + 2) + (1 + 1) * 2);
+  }
+
+  /* FE310 I2C ***********************************************************************/
+  {
+    hal::i2c::SimulatedFe310I2c   i2c   (bus);
+    hal::i2c::Fe310AsyncI2cMaster engine(i2c.data(), i2c.cmd_status(), crit_sec);
+
+    test("FE310 I2C", engine, [&]()
+    {
+      for(size_t s = 0; (s < MAX_NUM_STEPS) && !engine.isIdle(); s++) {
+        i2c.step();
+        engine.process();
+      }
+    }, l3gd20, lis3mdl);
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,348 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../common/host/HostSimCheck.h"
+
+#include "../common/AsyncSpiMaster.h"
+#include "../common/SimulatedSpiPort.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static size_t constexpr EVENT_LOG_SIZE = 1024;
+
+/**************************************************************************************
+ * GLOBAL VARIABLES
+ **************************************************************************************/
+
+/* Every observable bus event is appended to a single log in order of
+ * occurrence: 'L'/'H' followed by the CS id for CS transitions, 'T'
+ * followed by the byte for every transfer and 'C' followed by the
+ * transaction id for completions.
+ */
+static uint8_t event_log[EVENT_LOG_SIZE];
+static size_t  event_log_size = 0;
+
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+class LoggingCsPin : public hal::interface::DigitalOutPin
+{
+public:
+  LoggingCsPin(uint8_t const id) : _id(id), _is_selected(false) { }
+  virtual void set() override { log('H', _id); _is_selected = false; }
+  virtual void clr() override { log('L', _id); _is_selected = true;  }
+  bool isSelected() const { return _is_selected; }
+  static void log(uint8_t const type, uint8_t const val)
+  {
+    if(event_log_size + 2 <= EVENT_LOG_SIZE) {
+      event_log[event_log_size++] = type;
+      event_log[event_log_size++] = val;
+    }
+  }
+private:
+  uint8_t _id;
+  bool    _is_selected;
+};
+
+/* Returns the byte received within the previous transfer incremented by one,
+ * therefore the received data depends on the order of the transferred bytes.
+ */
+class LoggingSlave : public hal::spi::interface::SimulatedSpiSlave
+{
+public:
+  LoggingSlave() : _prev(0) { }
+  virtual uint8_t exchange(uint8_t const data) override
+  {
+    LoggingCsPin::log('T', data);
+    uint8_t const rx = _prev + 1;
+    _prev = data;
+    return rx;
+  }
+  void reset() { _prev = 0; }
+private:
+  uint8_t _prev;
+};
+
+class HostCriticalSection : public hal::interface::CriticalSection
+{
+public:
+  HostCriticalSection() : _depth(0), _max_depth(0) { }
+  virtual void lock  () override { _depth++; if(_depth > _max_depth) _max_depth = _depth; }
+  virtual void unlock() override { _depth--; }
+  int depth() const { return _depth; }
+private:
+  int _depth, _max_depth;
+};
+
+class LoggingCallback : public hal::spi::interface::SpiTransactionCallback
+{
+public:
+  LoggingCallback() : _resubmit(nullptr), _engine(nullptr) { }
+  void resubmitOnce(hal::spi::AsyncSpiMaster & engine, hal::spi::SpiTransaction & transaction)
+  {
+    _engine   = &engine;
+    _resubmit = &transaction;
+  }
+  virtual void onSpiTransactionComplete(hal::spi::SpiTransaction & transaction) override
+  {
+    LoggingCsPin::log('C', transaction.tx_buf ? transaction.tx_buf[0] : 0xFF);
+    if(_resubmit) {
+      hal::spi::SpiTransaction * t = _resubmit;
+      _resubmit = nullptr;
+      if(!_engine->submit(*t)) {
+        check("resubmission from within the callback", false);
+      }
+    }
+  }
+private:
+  hal::spi::SpiTransaction  * _resubmit;
+  hal::spi::AsyncSpiMaster  * _engine;
+};
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+static void resetLog()
+{
+  event_log_size = 0;
+}
+
+static bool checkLog(uint8_t const * expected, size_t const expected_size)
+{
+  if(expected_size != event_log_size || memcmp(expected, event_log, expected_size) != 0)
+  {
+    printf("  expected:");
+    for(size_t i = 0; i < expected_size; i += 2) printf(" %c%02X", expected[i], expected[i+1]);
+    printf("\n  actual:  ");
+    for(size_t i = 0; i < event_log_size; i += 2) printf(" %c%02X", event_log[i], event_log[i+1]);
+    printf("\n");
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  LoggingSlave                slave;
+  HostCriticalSection         crit_sec;
+  hal::spi::SimulatedSpiPort  spi_port(slave);
+  hal::spi::AsyncSpiMaster    engine  (spi_port, crit_sec);
+  LoggingCsPin                cs_a    (0xA),
+                              cs_b    (0xB);
+  LoggingCallback             callback;
+
+  spi_port.registerInterruptCallback(&engine);
+
+  /* Queued transactions for different devices are executed in order
+   * of submission, CS is asserted/deasserted around each of them.
+   */
+  {
+    resetLog(); slave.reset();
+
+    uint8_t const tx_1[] = {0x10, 0x11, 0x12};
+    uint8_t const tx_2[] = {0x20};
+    uint8_t const tx_3[] = {0x30, 0x31};
+    uint8_t       rx_1[3] = {0}, rx_3[2] = {0};
+
+    hal::spi::SpiTransaction t1 = {&cs_a, tx_1, rx_1,    sizeof(tx_1), false, &callback};
+    hal::spi::SpiTransaction t2 = {&cs_b, tx_2, nullptr, sizeof(tx_2), false, &callback};
+    hal::spi::SpiTransaction t3 = {&cs_a, tx_3, rx_3,    sizeof(tx_3), false, nullptr  };
+
+    check("submit to idle engine",   engine.submit(t1));
+    check("submit while busy",       engine.submit(t2));
+    check("submit while busy",       engine.submit(t3));
+    check("reject pending resubmit", !engine.submit(t2));
+    check("engine busy",             !engine.isIdle());
+
+    spi_port.run();
+
+    uint8_t const expected[] = {'L',0xA, 'T',0x10, 'T',0x11, 'T',0x12, 'H',0xA, 'C',0x10,
+                                'L',0xB, 'T',0x20,                     'H',0xB, 'C',0x20,
+                                'L',0xA, 'T',0x30, 'T',0x31,           'H',0xA};
+    check("ordering of queued transactions", checkLog(expected, sizeof(expected)));
+    check("received data", rx_1[0] == 0x01 && rx_1[1] == 0x11 && rx_1[2] == 0x12 && rx_3[0] == 0x21 && rx_3[1] == 0x31);
+    check("completion flags", t1.complete && t2.complete && t3.complete);
+    check("engine idle", engine.isIdle() && !cs_a.isSelected() && !cs_b.isSelected());
+  }
+
+  /* A command header kept selected followed by a read-only
+   * payload transaction without tx buffer (0xFF is sent).
+   */
+  {
+    resetLog(); slave.reset();
+
+    uint8_t const cmd[] = {0x03, 0x00, 0x01, 0x00};
+    uint8_t       data[3];
+
+    hal::spi::SpiTransaction t_cmd  = {&cs_a, cmd,     nullptr, sizeof(cmd),  true,  nullptr};
+    hal::spi::SpiTransaction t_data = {&cs_a, nullptr, data,    sizeof(data), false, nullptr};
+
+    engine.submit(t_cmd);
+    engine.submit(t_data);
+    spi_port.run();
+
+    uint8_t const expected[] = {'L',0xA, 'T',0x03, 'T',0x00, 'T',0x01, 'T',0x00,
+                                'L',0xA, 'T',0xFF, 'T',0xFF, 'T',0xFF, 'H',0xA};
+    check("keep_selected / rx only transaction", checkLog(expected, sizeof(expected)));
+    check("rx only data", data[0] == 0x01 && data[1] == 0x00 && data[2] == 0x00);
+  }
+
+  /* A transaction for another device queued between a header kept
+   * selected and its payload is held back until CS has been released,
+   * the payload submitted later is executed first.
+   */
+  {
+    resetLog(); slave.reset();
+
+    uint8_t const cmd[]     = {0x02, 0x00, 0x02, 0x00};
+    uint8_t const payload[] = {0xD0, 0xD1};
+    uint8_t const other[]   = {0x70};
+
+    hal::spi::SpiTransaction t_cmd     = {&cs_a, cmd,     nullptr, sizeof(cmd),     true,  nullptr};
+    hal::spi::SpiTransaction t_other   = {&cs_b, other,   nullptr, sizeof(other),   false, nullptr};
+    hal::spi::SpiTransaction t_payload = {&cs_a, payload, nullptr, sizeof(payload), false, nullptr};
+
+    engine.submit(t_cmd);
+    engine.submit(t_other);
+    spi_port.run();
+
+    check("other device held back while CS is kept selected", !t_other.complete && !cs_b.isSelected() && cs_a.isSelected() && !engine.isIdle());
+
+    engine.submit(t_payload);
+    spi_port.run();
+
+    uint8_t const expected[] = {'L',0xA, 'T',0x02, 'T',0x00, 'T',0x02, 'T',0x00,
+                                'L',0xA, 'T',0xD0, 'T',0xD1, 'H',0xA,
+                                'L',0xB, 'T',0x70, 'H',0xB};
+    check("keep_selected with different CS queued in between", checkLog(expected, sizeof(expected)));
+    check("engine idle", engine.isIdle() && t_other.complete && !cs_a.isSelected() && !cs_b.isSelected());
+  }
+
+  /* Transactions without any data are rejected */
+  {
+    uint8_t const tx[] = {0x80};
+
+    hal::spi::SpiTransaction t_empty = {&cs_a, tx, nullptr, 0, false, nullptr};
+
+    check("reject empty transaction", !engine.submit(t_empty) && engine.isIdle());
+  }
+
+  /* Resubmission from within the completion callback while another
+   * transaction is still queued - the resubmitted one goes last.
+   */
+  {
+    resetLog(); slave.reset();
+
+    uint8_t const tx_1[] = {0x40};
+    uint8_t const tx_2[] = {0x50};
+
+    hal::spi::SpiTransaction t1 = {&cs_a, tx_1, nullptr, sizeof(tx_1), false, &callback};
+    hal::spi::SpiTransaction t2 = {&cs_b, tx_2, nullptr, sizeof(tx_2), false, &callback};
+
+    callback.resubmitOnce(engine, t1);
+    engine.submit(t1);
+    engine.submit(t2);
+    spi_port.run();
+
+    uint8_t const expected[] = {'L',0xA, 'T',0x40, 'H',0xA, 'C',0x40,
+                                'L',0xB, 'T',0x50, 'H',0xB, 'C',0x50,
+                                'L',0xA, 'T',0x40, 'H',0xA, 'C',0x40};
+    check("resubmission from callback (queue not empty)", checkLog(expected, sizeof(expected)));
+  }
+
+  /* Resubmission from within the completion callback of the last
+   * transaction, i.e. the engine is restarted from within the ISR.
+   */
+  {
+    resetLog(); slave.reset();
+
+    uint8_t const tx_1[] = {0x60, 0x61};
+
+    hal::spi::SpiTransaction t1 = {&cs_b, tx_1, nullptr, sizeof(tx_1), false, &callback};
+
+    callback.resubmitOnce(engine, t1);
+    engine.submit(t1);
+    spi_port.run();
+
+    uint8_t const expected[] = {'L',0xB, 'T',0x60, 'T',0x61, 'H',0xB, 'C',0x60,
+                                'L',0xB, 'T',0x60, 'T',0x61, 'H',0xB, 'C',0x60};
+    check("resubmission from callback (queue empty)", checkLog(expected, sizeof(expected)));
+    check("engine idle", engine.isIdle() && crit_sec.depth() == 0);
+  }
+
+  /* Submissions interleaved with interrupts, as it happens when
+   * the main loop submits while a transfer is in progress.
+   */
+  {
+    resetLog(); slave.reset();
+
+    static size_t constexpr NUM_TRANSACTIONS = 32;
+
+    uint8_t                  tx[NUM_TRANSACTIONS][2];
+    hal::spi::SpiTransaction t [NUM_TRANSACTIONS] = {};
+
+    for(size_t i = 0; i < NUM_TRANSACTIONS; i++)
+    {
+      tx[i][0] = static_cast<uint8_t>(i);
+      tx[i][1] = static_cast<uint8_t>(0x80 | i);
+      t[i]     = {(i % 2) ? &cs_b : &cs_a, tx[i], nullptr, 2, false, nullptr};
+    }
+
+    size_t next = 0;
+    do
+    {
+      if(next < NUM_TRANSACTIONS) engine.submit(t[next++]);
+      if(next < NUM_TRANSACTIONS) engine.submit(t[next++]);
+    } while(spi_port.step() || next < NUM_TRANSACTIONS);
+
+    bool is_ordered = (event_log_size == NUM_TRANSACTIONS * 8);
+    for(size_t i = 0; is_ordered && i < NUM_TRANSACTIONS; i++)
+    {
+      uint8_t const * e  = event_log + i * 8;
+      uint8_t const   id = (i % 2) ? 0xB : 0xA;
+      is_ordered = e[0] == 'L' && e[1] == id && e[3] == i && e[5] == (0x80 | i) && e[6] == 'H' && e[7] == id;
+    }
+    check("submission interleaved with interrupts", is_ordered);
+    check("number of transfers", spi_port.numTransfers() > 0);
+  }
+
+  return checkResult();
+}
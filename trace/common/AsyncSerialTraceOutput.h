@@ -0,0 +1,127 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_ASYNCSERIALTRACEOUTPUT_H_
+#define EXAMPLES_TRACE_COMMON_ASYNCSERIALTRACEOUTPUT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <string.h>
+
+#include <snowfox/trace/interface/TraceOutput.h>
+
+#include <snowfox/hal/interface/uart/UART.h>
+#include <snowfox/hal/interface/uart/UARTCallback.h>
+
+#include "../../hal/common/SpscRingBuffer.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Trace records are copied into a ring buffer which is drained from within
+ * the UART interrupt, a call to write() therefore never waits for the UART.
+ * If a record does not fit into the ring buffer it is discarded as a whole
+ * and accounted for in the drop counter.
+ *
+ * This class takes the place of blox::SerialUart and must be registered as
+ * the UART callback, i.e. uart0().registerUARTCallback(&async_trace_output).
+ */
+template <uint16_t TX_BUFFER_SIZE>
+class AsyncSerialTraceOutput : public interface::TraceOutput,
+                               public hal::interface::UARTCallback
+{
+
+public:
+
+  AsyncSerialTraceOutput(hal::interface::UART & uart)
+  : _uart     (uart ),
+    _tx_active(false),
+    _dropped  (0    )
+  {
+
+  }
+
+  virtual ~AsyncSerialTraceOutput()
+  {
+
+  }
+
+
+  virtual void write(char const * buffer) override
+  {
+    uint16_t const len = strlen(buffer);
+
+    if(!_tx_buffer.push(reinterpret_cast<uint8_t const *>(buffer), len)) {
+      _dropped++;
+      return;
+    }
+
+    /* The UART interrupt only fires while a byte is in flight, so
+     * if the transmitter is idle there is no ISR to race with.
+     */
+    if(!_tx_active) {
+      _tx_active = true;
+      transmitNext();
+    }
+  }
+
+
+  virtual void onTransmitRegisterEmpty() override { transmitNext(); }
+  virtual void onReceiveComplete      () override { }
+
+
+  inline uint16_t dropped() const { return _dropped; }
+  /* True once the ring buffer has been handed over to the UART completely */
+  inline bool     isIdle () const { return !_tx_active; }
+
+private:
+
+  hal::interface::UART                & _uart;
+  hal::SpscRingBuffer<TX_BUFFER_SIZE>   _tx_buffer;
+  bool                         volatile _tx_active;
+  uint16_t                              _dropped;
+
+  void transmitNext()
+  {
+    uint8_t data = 0;
+    if(_tx_buffer.pop(data)) {
+      _uart.transmit(data);
+    } else {
+      _tx_active = false;
+    }
+  }
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_ASYNCSERIALTRACEOUTPUT_H_ */
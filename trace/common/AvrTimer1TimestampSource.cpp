@@ -0,0 +1,99 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "AvrTimer1TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+AvrTimer1TimestampSource::AvrTimer1TimestampSource(volatile uint8_t         * tccr1a,
+                                                   volatile uint8_t         * tccr1b,
+                                                   volatile uint16_t        * tcnt1,
+                                                   uint32_t           const   f_cpu,
+                                                   AvrTimer1Prescaler const   prescaler)
+: _TCNT1       (tcnt1                       ),
+  _tick_freq_Hz(f_cpu / toDivisor(prescaler)),
+  _last_cnt    (0                           ),
+  _overflow_cnt(0                           )
+{
+  /* Normal mode, clock select bits CS12:0 = prescaler */
+  *tccr1a = 0;
+  *tccr1b = static_cast<uint8_t>(prescaler);
+  *_TCNT1 = 0;
+}
+
+AvrTimer1TimestampSource::~AvrTimer1TimestampSource()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t AvrTimer1TimestampSource::now()
+{
+  uint16_t const cnt = *_TCNT1;
+
+  if(cnt < _last_cnt) {
+    _overflow_cnt++;
+  }
+  _last_cnt = cnt;
+
+  return (static_cast<uint32_t>(_overflow_cnt) << 16) | cnt;
+}
+
+uint32_t AvrTimer1TimestampSource::tickFreqHz() const
+{
+  return _tick_freq_Hz;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint16_t AvrTimer1TimestampSource::toDivisor(AvrTimer1Prescaler const prescaler)
+{
+  switch(prescaler)
+  {
+  case AvrTimer1Prescaler::P_1   : return 1;    break;
+  case AvrTimer1Prescaler::P_8   : return 8;    break;
+  case AvrTimer1Prescaler::P_64  : return 64;   break;
+  case AvrTimer1Prescaler::P_256 : return 256;  break;
+  case AvrTimer1Prescaler::P_1024: return 1024; break;
+  }
+  return 1;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
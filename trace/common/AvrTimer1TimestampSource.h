@@ -0,0 +1,91 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_AVRTIMER1TIMESTAMPSOURCE_H_
+#define EXAMPLES_TRACE_COMMON_AVRTIMER1TIMESTAMPSOURCE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+enum class AvrTimer1Prescaler : uint8_t
+{
+  P_1    = 1,
+  P_8    = 2,
+  P_64   = 3,
+  P_256  = 4,
+  P_1024 = 5
+};
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* TIMER1 is used as a free running 16-bit counter which is extended to 32 bit
+ * in software whenever now() is called. TIMER1 has the same register layout on
+ * ATMEGA328P, ATMEGA1284P and AT90CAN128. No interrupt is required, however
+ * now() must be called at least once per TIMER1 period (65536 ticks, i.e.
+ * 32.8 ms @ F_CPU = 16 MHz / P_8) for the software extension to be correct.
+ */
+class AvrTimer1TimestampSource : public interface::TimestampSource
+{
+
+public:
+
+           AvrTimer1TimestampSource(volatile uint8_t         * tccr1a,
+                                    volatile uint8_t         * tccr1b,
+                                    volatile uint16_t        * tcnt1,
+                                    uint32_t           const   f_cpu,
+                                    AvrTimer1Prescaler const   prescaler);
+  virtual ~AvrTimer1TimestampSource();
+
+
+  virtual uint32_t now       ()       override;
+  virtual uint32_t tickFreqHz() const override;
+
+private:
+
+  volatile uint16_t * _TCNT1;
+  uint32_t            _tick_freq_Hz;
+  uint16_t            _last_cnt;
+  uint16_t            _overflow_cnt;
+
+  static uint16_t toDivisor(AvrTimer1Prescaler const prescaler);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_AVRTIMER1TIMESTAMPSOURCE_H_ */
@@ -0,0 +1,84 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_BINARYTRACE_H_
+#define EXAMPLES_TRACE_COMMON_BINARYTRACE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/trace/Trace.h>
+
+#include "BinaryTraceOutput.h"
+#include "BinaryTraceEncoder.h"
+#include "BinaryTraceMessage.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+class BinaryTrace
+{
+
+public:
+
+  BinaryTrace(interface::BinaryTraceOutput & trace_output, Level const trace_level);
+
+
+  /* Instead of formatting the message on the MCU only the message ID
+   * and the raw arguments are transmitted, e.g.
+   *
+   *   trace.log<HELLO>(trace::Level::Debug, cnt);
+   */
+  template <typename Message, typename... Args>
+  void log(Level const trace_level, Args const... args)
+  {
+    if(trace_level < _trace_level) return;
+
+    uint8_t frame[FRAME_BUFFER_SIZE];
+    uint16_t const frame_size = BinaryTraceEncoder<typename Message::Signature>::encode(frame, FRAME_BUFFER_SIZE, Message::ID, args...);
+
+    if(frame_size > 0) {
+      _trace_output.write(frame, frame_size);
+    }
+  }
+
+private:
+
+  static uint16_t constexpr FRAME_BUFFER_SIZE = 32;
+
+  interface::BinaryTraceOutput & _trace_output;
+  Level                          _trace_level;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_BINARYTRACE_H_ */
@@ -0,0 +1,125 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_BINARYTRACEENCODER_H_
+#define EXAMPLES_TRACE_COMMON_BINARYTRACEENCODER_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+/* Binary trace frame layout:
+ *
+ *   | SYNC | ID | LEN | PAYLOAD (LEN bytes) | CHK |
+ *
+ * CHK is the XOR of ID, LEN and all payload bytes. Integer and floating
+ * point arguments are stored in their native (little endian) representation
+ * with the width given by the message signature, strings are stored with a
+ * one byte length prefix and without the terminating zero.
+ */
+static uint8_t  constexpr BINARY_TRACE_FRAME_SYNC     = 0xA5;
+static uint16_t constexpr BINARY_TRACE_FRAME_OVERHEAD = 4;
+static uint16_t constexpr BINARY_TRACE_MAX_PAYLOAD    = 0xFF;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+template <typename Signature>
+class BinaryTraceEncoder;
+
+template <typename... Args>
+class BinaryTraceEncoder<void(Args...)>
+{
+
+public:
+
+  /* Returns the number of bytes of the encoded frame or 0 if the
+   * frame does not fit into the provided buffer.
+   */
+  static uint16_t encode(uint8_t * frame, uint16_t const frame_size, uint8_t const id, Args... args)
+  {
+    if(frame_size < BINARY_TRACE_FRAME_OVERHEAD) return 0;
+
+                     uint8_t       * payload     = frame + 3;
+    [[maybe_unused]] uint8_t const * payload_end = frame + frame_size - 1;
+
+    bool const success = (encodeArg(payload, payload_end, args) && ... && true);
+    if(!success) return 0;
+
+    uint16_t const payload_size = static_cast<uint16_t>(payload - (frame + 3));
+    if(payload_size > BINARY_TRACE_MAX_PAYLOAD) return 0;
+
+    frame[0] = BINARY_TRACE_FRAME_SYNC;
+    frame[1] = id;
+    frame[2] = static_cast<uint8_t>(payload_size);
+
+    uint8_t chk = 0;
+    for(uint16_t i = 1; i < (3 + payload_size); i++) {
+      chk ^= frame[i];
+    }
+    frame[3 + payload_size] = chk;
+
+    return payload_size + BINARY_TRACE_FRAME_OVERHEAD;
+  }
+
+private:
+
+  template <typename T>
+  static bool encodeArg(uint8_t * & payload, uint8_t const * payload_end, T const arg)
+  {
+    if((payload + sizeof(T)) > payload_end) return false;
+    memcpy(payload, &arg, sizeof(T));
+    payload += sizeof(T);
+    return true;
+  }
+
+  static bool encodeArg(uint8_t * & payload, uint8_t const * payload_end, char const * arg)
+  {
+    size_t const len = strlen(arg);
+    if(len > 0xFF) return false;
+    if((payload + 1 + len) > payload_end) return false;
+    *payload = static_cast<uint8_t>(len);
+    memcpy(payload + 1, arg, len);
+    payload += 1 + len;
+    return true;
+  }
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_BINARYTRACEENCODER_H_ */
@@ -0,0 +1,63 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_BINARYTRACEMESSAGE_H_
+#define EXAMPLES_TRACE_COMMON_BINARYTRACEMESSAGE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * DEFINE
+ **************************************************************************************/
+
+/* An application lists all its trace messages within a single X-macro, e.g.
+ *
+ *   #define TRACE_MESSAGES(TRACE_MSG) \
+ *     TRACE_MSG(HELLO,   "( %08X ) Hello ATMEGA328P", uint32_t) \
+ *     TRACE_MSG(STARTUP, "Startup complete")
+ *
+ *   BINARY_TRACE_DECLARE_MESSAGES(TRACE_MESSAGES)
+ *
+ * Every message is assigned an ID in the order of declaration and becomes
+ * a type carrying the ID as well as the argument signature. The format
+ * strings never reach the MCU flash - they are only parsed by the host
+ * side decoder (trace/tools/binary-trace-decode.py) which reads the very
+ * same header file, therefore MCU and decoder can not run out of sync.
+ */
+
+#define BINARY_TRACE_MESSAGE_ID(name, fmt, ...) name,
+
+#define BINARY_TRACE_MESSAGE_TYPE(name, fmt, ...)                         \
+  struct name                                                             \
+  {                                                                       \
+    static uint8_t constexpr ID = static_cast<uint8_t>(MessageId::name);  \
+    typedef void Signature(__VA_ARGS__);                                  \
+  };
+
+#define BINARY_TRACE_DECLARE_MESSAGES(MESSAGES)                           \
+  enum class MessageId : uint8_t                                          \
+  {                                                                       \
+    MESSAGES(BINARY_TRACE_MESSAGE_ID)                                     \
+  };                                                                      \
+  MESSAGES(BINARY_TRACE_MESSAGE_TYPE)
+
+#endif /* EXAMPLES_TRACE_COMMON_BINARYTRACEMESSAGE_H_ */
@@ -0,0 +1,67 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "Fe310MtimeTimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+Fe310MtimeTimestampSource::Fe310MtimeTimestampSource(volatile uint32_t * mtime_lo,
+                                                     uint32_t const      lfclk_freq_Hz)
+: _MTIME_LO     (mtime_lo     ),
+  _lfclk_freq_Hz(lfclk_freq_Hz)
+{
+
+}
+
+Fe310MtimeTimestampSource::~Fe310MtimeTimestampSource()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t Fe310MtimeTimestampSource::now()
+{
+  return *_MTIME_LO;
+}
+
+uint32_t Fe310MtimeTimestampSource::tickFreqHz() const
+{
+  return _lfclk_freq_Hz;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
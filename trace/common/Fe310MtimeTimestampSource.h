@@ -0,0 +1,69 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_FE310MTIMETIMESTAMPSOURCE_H_
+#define EXAMPLES_TRACE_COMMON_FE310MTIMETIMESTAMPSOURCE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* The FE310 CLINT mtime counter is clocked by the low frequency clock (32.768 kHz
+ * on the HiFive 1 Rev. B) and keeps running independently of the core clock. Only
+ * the lower 32 bit are used which wrap around after ~36 hours.
+ */
+class Fe310MtimeTimestampSource : public interface::TimestampSource
+{
+
+public:
+
+           Fe310MtimeTimestampSource(volatile uint32_t * mtime_lo,
+                                     uint32_t const      lfclk_freq_Hz);
+  virtual ~Fe310MtimeTimestampSource();
+
+
+  virtual uint32_t now       ()       override;
+  virtual uint32_t tickFreqHz() const override;
+
+private:
+
+  volatile uint32_t * _MTIME_LO;
+  uint32_t            _lfclk_freq_Hz;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_FE310MTIMETIMESTAMPSOURCE_H_ */
@@ -0,0 +1,91 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "N25Q256ATraceStorage.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+N25Q256ATraceStorage::N25Q256ATraceStorage(driver::memory::N25Q256A::N25Q256A & n25q256a,
+                                           driver::memory::NorFlashInfo const & flash_info,
+                                           uint32_t                     const   first_block,
+                                           uint32_t                     const   num_blocks,
+                                           uint16_t                     const   page_size)
+: _n25q256a   (n25q256a             ),
+  _erase_size (flash_info.erase_size),
+  _first_block(first_block          ),
+  _num_blocks (num_blocks           ),
+  _page_size  (page_size            )
+{
+
+}
+
+N25Q256ATraceStorage::~N25Q256ATraceStorage()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t N25Q256ATraceStorage::capacity() const
+{
+  return _num_blocks * _erase_size;
+}
+
+uint16_t N25Q256ATraceStorage::pageSize() const
+{
+  return _page_size;
+}
+
+bool N25Q256ATraceStorage::beginPage(uint32_t const addr)
+{
+  if((addr % _erase_size) != 0) return true;
+  return _n25q256a.erase(_first_block + addr / _erase_size);
+}
+
+bool N25Q256ATraceStorage::write(uint32_t const addr, uint8_t const * buf, uint16_t const size)
+{
+  if((addr + size) > capacity()) return false;
+  return (_n25q256a.prog(_first_block + addr / _erase_size, addr % _erase_size, buf, size) == size);
+}
+
+bool N25Q256ATraceStorage::read(uint32_t const addr, uint8_t * buf, uint16_t const size)
+{
+  if((addr + size) > capacity()) return false;
+  return (_n25q256a.read(_first_block + addr / _erase_size, addr % _erase_size, buf, size) == size);
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
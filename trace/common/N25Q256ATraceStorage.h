@@ -0,0 +1,83 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_N25Q256ATRACESTORAGE_H_
+#define EXAMPLES_TRACE_COMMON_N25Q256ATRACESTORAGE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+
+#include "TraceStorage.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Reserves the erase blocks [first_block, first_block + num_blocks) of a
+ * N25Q256A serial NOR flash for trace storage. An erase block is erased
+ * when the first trace page located within it is started, the page size
+ * must therefore evenly divide the erase block size and should not exceed
+ * the 256 byte program page of the N25Q256A.
+ */
+class N25Q256ATraceStorage : public interface::TraceStorage
+{
+
+public:
+
+           N25Q256ATraceStorage(driver::memory::N25Q256A::N25Q256A & n25q256a,
+                                driver::memory::NorFlashInfo const & flash_info,
+                                uint32_t                     const   first_block,
+                                uint32_t                     const   num_blocks,
+                                uint16_t                     const   page_size);
+  virtual ~N25Q256ATraceStorage();
+
+
+  virtual uint32_t capacity () const override;
+  virtual uint16_t pageSize () const override;
+
+  virtual bool     beginPage(uint32_t const addr) override;
+  virtual bool     write    (uint32_t const addr, uint8_t const * buf, uint16_t const size) override;
+  virtual bool     read     (uint32_t const addr, uint8_t       * buf, uint16_t const size) override;
+
+private:
+
+  driver::memory::N25Q256A::N25Q256A & _n25q256a;
+  uint32_t                             _erase_size;
+  uint32_t                             _first_block;
+  uint32_t                             _num_blocks;
+  uint16_t                             _page_size;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_N25Q256ATRACESTORAGE_H_ */
@@ -0,0 +1,115 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "Pcf8570TraceStorage.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+Pcf8570TraceStorage::Pcf8570TraceStorage(driver::memory::PCF8570::PCF8570 & pcf8570, uint16_t const page_size)
+: _pcf8570  (pcf8570  ),
+  _page_size(page_size)
+{
+
+}
+
+Pcf8570TraceStorage::~Pcf8570TraceStorage()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t Pcf8570TraceStorage::capacity() const
+{
+  return PCF8570_CAPACITY;
+}
+
+uint16_t Pcf8570TraceStorage::pageSize() const
+{
+  return _page_size;
+}
+
+bool Pcf8570TraceStorage::beginPage(uint32_t const /* addr */)
+{
+  /* RAM can be overwritten without prior erasing. */
+  return true;
+}
+
+bool Pcf8570TraceStorage::write(uint32_t const addr, uint8_t const * buf, uint16_t const size)
+{
+  if((addr + size) > PCF8570_CAPACITY) return false;
+
+  /* The first byte of the buffer passed to PCF8570::write/read
+   * holds the memory address, the data follows directly after it.
+   */
+  uint8_t chunk[1 + MAX_CHUNK_SIZE];
+
+  for(uint16_t offset = 0; offset < size; offset += MAX_CHUNK_SIZE)
+  {
+    uint16_t const chunk_size = ((size - offset) < MAX_CHUNK_SIZE) ? (size - offset) : MAX_CHUNK_SIZE;
+
+    chunk[0] = static_cast<uint8_t>(addr + offset);
+    memcpy(chunk + 1, buf + offset, chunk_size);
+
+    if(_pcf8570.write(chunk, 1 + chunk_size) != (1 + chunk_size)) return false;
+  }
+
+  return true;
+}
+
+bool Pcf8570TraceStorage::read(uint32_t const addr, uint8_t * buf, uint16_t const size)
+{
+  if((addr + size) > PCF8570_CAPACITY) return false;
+
+  uint8_t chunk[1 + MAX_CHUNK_SIZE];
+
+  for(uint16_t offset = 0; offset < size; offset += MAX_CHUNK_SIZE)
+  {
+    uint16_t const chunk_size = ((size - offset) < MAX_CHUNK_SIZE) ? (size - offset) : MAX_CHUNK_SIZE;
+
+    chunk[0] = static_cast<uint8_t>(addr + offset);
+
+    if(_pcf8570.read(chunk, 1 + chunk_size) != (1 + chunk_size)) return false;
+    memcpy(buf + offset, chunk + 1, chunk_size);
+  }
+
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
@@ -0,0 +1,76 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_PCF8570TRACESTORAGE_H_
+#define EXAMPLES_TRACE_COMMON_PCF8570TRACESTORAGE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/driver/memory/PCF8570/PCF8570.h>
+
+#include "TraceStorage.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Uses the 256 byte static RAM of a PCF8570 as trace storage. The content
+ * survives a reset of the MCU as long as the PCF8570 remains powered.
+ */
+class Pcf8570TraceStorage : public interface::TraceStorage
+{
+
+public:
+
+           Pcf8570TraceStorage(driver::memory::PCF8570::PCF8570 & pcf8570, uint16_t const page_size);
+  virtual ~Pcf8570TraceStorage();
+
+
+  virtual uint32_t capacity () const override;
+  virtual uint16_t pageSize () const override;
+
+  virtual bool     beginPage(uint32_t const addr) override;
+  virtual bool     write    (uint32_t const addr, uint8_t const * buf, uint16_t const size) override;
+  virtual bool     read     (uint32_t const addr, uint8_t       * buf, uint16_t const size) override;
+
+private:
+
+  static uint32_t constexpr PCF8570_CAPACITY = 256;
+  static uint16_t constexpr MAX_CHUNK_SIZE   = 16;
+
+  driver::memory::PCF8570::PCF8570 & _pcf8570;
+  uint16_t                           _page_size;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_PCF8570TRACESTORAGE_H_ */
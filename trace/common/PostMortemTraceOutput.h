@@ -0,0 +1,236 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_POSTMORTEMTRACEOUTPUT_H_
+#define EXAMPLES_TRACE_COMMON_POSTMORTEMTRACEOUTPUT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <string.h>
+
+#include "TraceStorage.h"
+#include "BinaryTraceOutput.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Records binary trace frames (see trace::BinaryTrace) into a ring of pages
+ * within non-volatile memory. Frames are collected in RAM and written one
+ * page at a time, flush() writes a partially filled page. Each page starts
+ * with a 32-bit sequence number which allows open() to locate the most
+ * recent page after a reset.
+ *
+ * Usage after reset:
+ *   open()  - locate the newest page
+ *   dump()  - output the retained trace history (oldest record first)
+ *   write() - continue recording, this overwrites the oldest pages
+ *
+ * Nothing is recorded unless open() succeeded. A page which can not be
+ * written by write() is skipped and accounted for in numWriteErrors().
+ */
+template <uint16_t PAGE_SIZE>
+class PostMortemTraceOutput : public interface::BinaryTraceOutput
+{
+
+  static_assert(PAGE_SIZE > 4, "PostMortemTraceOutput PAGE_SIZE too small");
+
+public:
+
+  PostMortemTraceOutput(interface::TraceStorage & storage)
+  : _storage         (storage                       ),
+    _num_pages       (storage.capacity() / PAGE_SIZE),
+    _head_page       (0                             ),
+    _seq             (0                             ),
+    _page_fill       (0                             ),
+    _page_written    (0                             ),
+    _page_begun      (false                         ),
+    _is_open         (false                         ),
+    _num_write_errors(0                             )
+  {
+    resetPage();
+  }
+
+  virtual ~PostMortemTraceOutput()
+  {
+
+  }
+
+
+  bool open()
+  {
+    _is_open = false;
+
+    if(_storage.pageSize() != PAGE_SIZE) return false;
+    if(_num_pages < 2)                   return false;
+
+    bool     found      = false;
+    uint32_t newest_seq = 0;
+    uint32_t newest     = 0;
+
+    for(uint32_t page = 0; page < _num_pages; page++)
+    {
+      uint32_t seq = 0;
+      if(!readSeq(page, seq)) return false;
+      if(seq == INVALID_SEQ)  continue;
+
+      if(!found || seq > newest_seq) {
+        found      = true;
+        newest_seq = seq;
+        newest     = page;
+      }
+    }
+
+    _head_page = found ? ((newest + 1) % _num_pages) : 0;
+    _seq       = found ? (newest_seq + 1)            : 0;
+    resetPage();
+    _is_open = true;
+
+    return true;
+  }
+
+  virtual void write(uint8_t const * frame, uint16_t const frame_size) override
+  {
+    if(!_is_open) return;
+
+    for(uint16_t pos = 0; pos < frame_size; )
+    {
+      uint16_t const num_bytes = ((PAGE_SIZE - _page_fill) < (frame_size - pos)) ? (PAGE_SIZE - _page_fill) : (frame_size - pos);
+
+      memcpy(_page + _page_fill, frame + pos, num_bytes);
+      _page_fill += num_bytes;
+      pos        += num_bytes;
+
+      if(_page_fill == PAGE_SIZE)
+      {
+        if(!flush()) _num_write_errors++;
+        _head_page = (_head_page + 1) % _num_pages;
+        _seq++;
+        resetPage();
+      }
+    }
+  }
+
+  bool flush()
+  {
+    if(!_is_open)                   return false;
+    if(_page_fill == _page_written) return true;
+
+    uint32_t const addr = _head_page * PAGE_SIZE;
+
+    /* The first write of a page covers the whole page including the 0xFF
+     * padding which discards stale records from the previous lap. Later on
+     * only the bytes added since the last flush are written, flash based
+     * storages can therefore program the same page repeatedly.
+     */
+    if(!_page_begun)
+    {
+      if(!_storage.beginPage(addr))               return false;
+      if(!_storage.write(addr, _page, PAGE_SIZE)) return false;
+      _page_begun = true;
+    }
+    else
+    {
+      if(!_storage.write(addr + _page_written, _page + _page_written, _page_fill - _page_written)) return false;
+    }
+
+    _page_written = _page_fill;
+
+    return true;
+  }
+
+  bool dump(interface::BinaryTraceOutput & trace_output)
+  {
+    if(!_is_open) return false;
+
+    static uint16_t constexpr CHUNK_SIZE = 32;
+    uint8_t chunk[CHUNK_SIZE];
+
+    /* Starting at the current head the pages are in chronological order. */
+    for(uint32_t i = 0; i < _num_pages; i++)
+    {
+      uint32_t const page = (_head_page + i) % _num_pages;
+
+      uint32_t seq = 0;
+      if(!readSeq(page, seq)) return false;
+      if(seq == INVALID_SEQ)  continue;
+
+      for(uint16_t offset = HEADER_SIZE; offset < PAGE_SIZE; offset += CHUNK_SIZE)
+      {
+        uint16_t const chunk_size = ((PAGE_SIZE - offset) < CHUNK_SIZE) ? (PAGE_SIZE - offset) : CHUNK_SIZE;
+        if(!_storage.read(page * PAGE_SIZE + offset, chunk, chunk_size)) return false;
+        trace_output.write(chunk, chunk_size);
+      }
+    }
+
+    return true;
+  }
+
+  inline uint32_t numWriteErrors() const { return _num_write_errors; }
+
+private:
+
+  static uint16_t constexpr HEADER_SIZE = sizeof(uint32_t);
+  static uint32_t constexpr INVALID_SEQ = 0xFFFFFFFF;
+
+  interface::TraceStorage & _storage;
+  uint32_t                  _num_pages;
+  uint32_t                  _head_page;
+  uint32_t                  _seq;
+  uint8_t                   _page[PAGE_SIZE];
+  uint16_t                  _page_fill;
+  uint16_t                  _page_written;
+  bool                      _page_begun;
+  bool                      _is_open;
+  uint32_t                  _num_write_errors;
+
+  void resetPage()
+  {
+    memset(_page, 0xFF, PAGE_SIZE);
+    memcpy(_page, &_seq, HEADER_SIZE);
+    _page_fill    = HEADER_SIZE;
+    _page_written = 0;
+    _page_begun   = false;
+  }
+
+  bool readSeq(uint32_t const page, uint32_t & seq)
+  {
+    uint8_t header[HEADER_SIZE];
+    if(!_storage.read(page * PAGE_SIZE, header, HEADER_SIZE)) return false;
+    memcpy(&seq, header, HEADER_SIZE);
+    return true;
+  }
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_POSTMORTEMTRACEOUTPUT_H_ */
@@ -0,0 +1,112 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_RAMRINGTRACEOUTPUT_H_
+#define EXAMPLES_TRACE_COMMON_RAMRINGTRACEOUTPUT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <snowfox/trace/interface/TraceOutput.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Keeps the most recent SIZE bytes of trace output in RAM, older output is
+ * overwritten. After a fault the history can be written to another trace
+ * output via dump().
+ */
+template <uint16_t SIZE>
+class RamRingTraceOutput : public interface::TraceOutput
+{
+
+public:
+
+  RamRingTraceOutput()
+  : _head (0),
+    _count(0)
+  {
+
+  }
+
+  virtual ~RamRingTraceOutput()
+  {
+
+  }
+
+
+  virtual void write(char const * buffer) override
+  {
+    for(; *buffer != '\0'; buffer++)
+    {
+      _buffer[_head] = *buffer;
+      _head = (_head + 1) % SIZE;
+      if(_count < SIZE) _count++;
+    }
+  }
+
+
+  void dump(interface::TraceOutput & trace_output) const
+  {
+    static uint16_t constexpr CHUNK_SIZE = 32;
+
+    char     chunk[CHUNK_SIZE + 1];
+    uint16_t pos = (_head + SIZE - _count) % SIZE;
+
+    for(uint16_t remaining = _count; remaining > 0; )
+    {
+      uint16_t const chunk_size = (remaining < CHUNK_SIZE) ? remaining : CHUNK_SIZE;
+      for(uint16_t i = 0; i < chunk_size; i++) {
+        chunk[i] = _buffer[pos];
+        pos = (pos + 1) % SIZE;
+      }
+      chunk[chunk_size] = '\0';
+      trace_output.write(chunk);
+      remaining -= chunk_size;
+    }
+  }
+
+  inline void clear() { _count = 0; }
+
+private:
+
+  char     _buffer[SIZE];
+  uint16_t _head;
+  uint16_t _count;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_RAMRINGTRACEOUTPUT_H_ */
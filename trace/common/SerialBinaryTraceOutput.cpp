@@ -0,0 +1,66 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SerialBinaryTraceOutput.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SerialBinaryTraceOutput::SerialBinaryTraceOutput(driver::serial::interface::Serial & serial)
+: _serial(serial)
+{
+
+}
+
+SerialBinaryTraceOutput::~SerialBinaryTraceOutput()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void SerialBinaryTraceOutput::write(uint8_t const * frame, uint16_t const frame_size)
+{
+  /* Binary frames may contain zero bytes, therefore they can not be
+   * passed through the string based trace::SerialTraceOutput.
+   */
+  for(ssize_t bytes_written = 0; bytes_written != frame_size; )
+  {
+    bytes_written += _serial.write(frame + bytes_written, frame_size - bytes_written);
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
@@ -0,0 +1,64 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_SERIALBINARYTRACEOUTPUT_H_
+#define EXAMPLES_TRACE_COMMON_SERIALBINARYTRACEOUTPUT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/driver/serial/interface/Serial.h>
+
+#include "BinaryTraceOutput.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+class SerialBinaryTraceOutput : public interface::BinaryTraceOutput
+{
+
+public:
+
+           SerialBinaryTraceOutput(driver::serial::interface::Serial & serial);
+  virtual ~SerialBinaryTraceOutput();
+
+
+  virtual void write(uint8_t const * frame, uint16_t const frame_size) override;
+
+private:
+
+  driver::serial::interface::Serial & _serial;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_SERIALBINARYTRACEOUTPUT_H_ */
@@ -0,0 +1,109 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "SimulatedTraceStorage.h"
+
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+SimulatedTraceStorage::SimulatedTraceStorage(uint8_t        * mem,
+                                             uint32_t const   capacity,
+                                             uint16_t const   page_size,
+                                             uint32_t const   erase_size)
+: _mem       (mem       ),
+  _capacity  (capacity  ),
+  _page_size (page_size ),
+  _erase_size(erase_size),
+  _num_writes(0         ),
+  _num_erases(0         )
+{
+
+}
+
+SimulatedTraceStorage::~SimulatedTraceStorage()
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint32_t SimulatedTraceStorage::capacity() const
+{
+  return _capacity;
+}
+
+uint16_t SimulatedTraceStorage::pageSize() const
+{
+  return _page_size;
+}
+
+bool SimulatedTraceStorage::beginPage(uint32_t const addr)
+{
+  if(_erase_size == 0)                 return true;
+  if((addr % _erase_size) != 0)        return true;
+  if((addr + _erase_size) > _capacity) return false;
+
+  memset(_mem + addr, 0xFF, _erase_size);
+  _num_erases++;
+  return true;
+}
+
+bool SimulatedTraceStorage::write(uint32_t const addr, uint8_t const * buf, uint16_t const size)
+{
+  if((addr + size) > _capacity) return false;
+
+  if(_erase_size == 0) {
+    memcpy(_mem + addr, buf, size);
+  } else {
+    for(uint16_t i = 0; i < size; i++) {
+      _mem[addr + i] &= buf[i];
+    }
+  }
+
+  _num_writes++;
+  return true;
+}
+
+bool SimulatedTraceStorage::read(uint32_t const addr, uint8_t * buf, uint16_t const size)
+{
+  if((addr + size) > _capacity) return false;
+  memcpy(buf, _mem + addr, size);
+  return true;
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
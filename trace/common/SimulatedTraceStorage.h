@@ -0,0 +1,85 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_SIMULATEDTRACESTORAGE_H_
+#define EXAMPLES_TRACE_COMMON_SIMULATEDTRACESTORAGE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "TraceStorage.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Trace storage on top of a plain memory buffer, e.g. for running the
+ * post-mortem trace on a Linux host. With an erase_size of 0 the buffer
+ * behaves like RAM (PCF8570), otherwise it follows NOR flash semantics
+ * (N25Q256A): erasing sets a whole erase block to 0xFF and writing can only
+ * clear bits. The number of transactions is counted for benchmarking.
+ */
+class SimulatedTraceStorage : public interface::TraceStorage
+{
+
+public:
+
+           SimulatedTraceStorage(uint8_t        * mem,
+                                 uint32_t const   capacity,
+                                 uint16_t const   page_size,
+                                 uint32_t const   erase_size);
+  virtual ~SimulatedTraceStorage();
+
+
+  virtual uint32_t capacity () const override;
+  virtual uint16_t pageSize () const override;
+
+  virtual bool     beginPage(uint32_t const addr) override;
+  virtual bool     write    (uint32_t const addr, uint8_t const * buf, uint16_t const size) override;
+  virtual bool     read     (uint32_t const addr, uint8_t       * buf, uint16_t const size) override;
+
+
+  inline uint32_t numWrites() const { return _num_writes; }
+  inline uint32_t numErases() const { return _num_erases; }
+
+private:
+
+  uint8_t  * _mem;
+  uint32_t   _capacity;
+  uint16_t   _page_size;
+  uint32_t   _erase_size;
+  uint32_t   _num_writes;
+  uint32_t   _num_erases;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_SIMULATEDTRACESTORAGE_H_ */
@@ -0,0 +1,106 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_STATICTRACELEVEL_H_
+#define EXAMPLES_TRACE_COMMON_STATICTRACELEVEL_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/trace/Trace.h>
+
+/**************************************************************************************
+ * DEFINE
+ **************************************************************************************/
+
+/* The minimum trace level is configured at build time, i.e. within the
+ * config.cmake of an application:
+ *
+ *   set(TRACE_LEVEL_MIN Info)
+ *   add_definitions(-DSNOWFOX_TRACE_LEVEL_MIN=${TRACE_LEVEL_MIN})
+ *
+ * Trace calls below that level issued via the TRACE_... macros are
+ * removed by the compiler - neither the format string nor the argument
+ * evaluation remain within the firmware.
+ */
+#ifndef SNOWFOX_TRACE_LEVEL_MIN
+#  define SNOWFOX_TRACE_LEVEL_MIN Debug
+#endif
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static Level constexpr TRACE_LEVEL_MIN = Level::SNOWFOX_TRACE_LEVEL_MIN;
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+inline constexpr bool isTraceLevelEnabled(Level const trace_level)
+{
+  return (trace_level >= TRACE_LEVEL_MIN);
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+/**************************************************************************************
+ * DEFINE
+ **************************************************************************************/
+
+/* 'if constexpr' enforces that the trace level is known at compile time. */
+#define TRACE_PRINT(tracer, trace_level, ...)                                  \
+  do {                                                                         \
+    if constexpr(snowfox::trace::isTraceLevelEnabled(trace_level)) {           \
+      (tracer).print(trace_level, ##__VA_ARGS__);                              \
+    }                                                                          \
+  } while(0)
+
+#define TRACE_PRINTLN(tracer, trace_level, ...)                                \
+  do {                                                                         \
+    if constexpr(snowfox::trace::isTraceLevelEnabled(trace_level)) {           \
+      (tracer).println(trace_level, ##__VA_ARGS__);                            \
+    }                                                                          \
+  } while(0)
+
+#define TRACE_DEBUG(tracer, ...)   TRACE_PRINTLN(tracer, snowfox::trace::Level::Debug,   __VA_ARGS__)
+#define TRACE_INFO(tracer, ...)    TRACE_PRINTLN(tracer, snowfox::trace::Level::Info,    __VA_ARGS__)
+#define TRACE_WARNING(tracer, ...) TRACE_PRINTLN(tracer, snowfox::trace::Level::Warning, __VA_ARGS__)
+#define TRACE_ERROR(tracer, ...)   TRACE_PRINTLN(tracer, snowfox::trace::Level::Error,   __VA_ARGS__)
+
+/* Same for trace::BinaryTrace, e.g. BINARY_TRACE_LOG(trace, Level::Debug, msg::HELLO, cnt) */
+#define BINARY_TRACE_LOG(tracer, trace_level, message, ...)                    \
+  do {                                                                         \
+    if constexpr(snowfox::trace::isTraceLevelEnabled(trace_level)) {           \
+      (tracer).template log<message>(trace_level, ##__VA_ARGS__);              \
+    }                                                                          \
+  } while(0)
+
+#endif /* EXAMPLES_TRACE_COMMON_STATICTRACELEVEL_H_ */
@@ -0,0 +1,84 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_TIMESTAMPEDTRACE_H_
+#define EXAMPLES_TRACE_COMMON_TIMESTAMPEDTRACE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <snowfox/trace/Trace.h>
+
+#include "TimestampSource.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Prefixes every trace record with the current tick count of the
+ * timestamp source, i.e. "[    123456] Hello".
+ */
+class TimestampedTrace
+{
+
+public:
+
+  TimestampedTrace(Trace & trace, interface::TimestampSource & timestamp_source);
+
+
+  template <typename... Args>
+  void println(Level const trace_level, char const * fmt, Args const... args)
+  {
+    printTimestamp(trace_level, _timestamp_source.now());
+    _trace.println(trace_level, fmt, args...);
+  }
+
+  template <typename... Args>
+  void printlnAt(Level const trace_level, uint32_t const timestamp, char const * fmt, Args const... args)
+  {
+    printTimestamp(trace_level, timestamp);
+    _trace.println(trace_level, fmt, args...);
+  }
+
+
+  inline interface::TimestampSource & timestampSource() { return _timestamp_source; }
+
+private:
+
+  Trace                      & _trace;
+  interface::TimestampSource & _timestamp_source;
+
+  void printTimestamp(Level const trace_level, uint32_t const timestamp);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_TIMESTAMPEDTRACE_H_ */
@@ -0,0 +1,122 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "TraceFanOut.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+TraceFanOut::TraceFanOut()
+: _num_outputs(0)
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool TraceFanOut::addOutput(interface::TraceOutput & trace_output, Level const trace_level)
+{
+  if(_num_outputs == MAX_NUM_OUTPUTS) return false;
+
+  _output[_num_outputs].output      = &trace_output;
+  _output[_num_outputs].trace_level = trace_level;
+  _num_outputs++;
+
+  return true;
+}
+
+void TraceFanOut::print(Level const trace_level, char const * fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  vprint(trace_level, fmt, args, false);
+  va_end(args);
+}
+
+void TraceFanOut::println(Level const trace_level, char const * fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  vprint(trace_level, fmt, args, true);
+  va_end(args);
+}
+
+void TraceFanOut::println(Level const trace_level)
+{
+  if(!isEnabled(trace_level)) return;
+  write(trace_level, "\r\n");
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+bool TraceFanOut::isEnabled(Level const trace_level) const
+{
+  for(uint8_t i = 0; i < _num_outputs; i++) {
+    if(trace_level >= _output[i].trace_level) return true;
+  }
+  return false;
+}
+
+void TraceFanOut::vprint(Level const trace_level, char const * fmt, va_list args, bool const append_newline)
+{
+  if(!isEnabled(trace_level)) return;
+
+  char buffer[TRACE_BUFFER_SIZE];
+
+  /* Reserve space for the line ending so that it is never truncated. */
+  vsnprintf(buffer, TRACE_BUFFER_SIZE - 2, fmt, args);
+  if(append_newline) {
+    strcat(buffer, "\r\n");
+  }
+
+  write(trace_level, buffer);
+}
+
+void TraceFanOut::write(Level const trace_level, char const * buffer)
+{
+  for(uint8_t i = 0; i < _num_outputs; i++) {
+    if(trace_level >= _output[i].trace_level) {
+      _output[i].output->write(buffer);
+    }
+  }
+}
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
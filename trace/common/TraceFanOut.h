@@ -0,0 +1,89 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_TRACEFANOUT_H_
+#define EXAMPLES_TRACE_COMMON_TRACEFANOUT_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/interface/TraceOutput.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Drop-in replacement for trace::Trace which distributes every trace record
+ * to multiple outputs, each one with its own minimum trace level. A message
+ * is formatted only once, regardless of the number of outputs, and not at all
+ * if no output is interested in it.
+ */
+class TraceFanOut
+{
+
+public:
+
+  TraceFanOut();
+
+
+  bool addOutput(interface::TraceOutput & trace_output, Level const trace_level);
+
+
+  void print  (Level const trace_level, char const * fmt, ...);
+  void println(Level const trace_level, char const * fmt, ...);
+  void println(Level const trace_level);
+
+private:
+
+  static uint8_t  constexpr MAX_NUM_OUTPUTS   = 4;
+  static uint16_t constexpr TRACE_BUFFER_SIZE = 128;
+
+  typedef struct
+  {
+    interface::TraceOutput * output;
+    Level                    trace_level;
+  } FanOutEntry;
+
+  FanOutEntry _output[MAX_NUM_OUTPUTS];
+  uint8_t     _num_outputs;
+
+  bool isEnabled(Level const trace_level) const;
+  void vprint   (Level const trace_level, char const * fmt, va_list args, bool const append_newline);
+  void write    (Level const trace_level, char const * buffer);
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+#endif /* EXAMPLES_TRACE_COMMON_TRACEFANOUT_H_ */
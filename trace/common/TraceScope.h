@@ -0,0 +1,110 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_TRACESCOPE_H_
+#define EXAMPLES_TRACE_COMMON_TRACESCOPE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "TimestampedTrace.h"
+#include "StaticTraceLevel.h"
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Emits a begin record when constructed and an end record containing the
+ * number of elapsed ticks when destroyed. The time spent for emitting the
+ * begin record is not accounted for.
+ */
+template <bool ENABLED>
+class TraceScope
+{
+
+public:
+
+  TraceScope(TimestampedTrace & trace, Level const trace_level, char const * name)
+  : _trace      (trace      ),
+    _trace_level(trace_level),
+    _name       (name       )
+  {
+    _trace.println(_trace_level, "> %s", _name);
+    _start = _trace.timestampSource().now();
+  }
+
+  ~TraceScope()
+  {
+    uint32_t const stop = _trace.timestampSource().now();
+    _trace.printlnAt(_trace_level, stop, "< %s ( %lu ticks )", _name, static_cast<unsigned long>(stop - _start));
+  }
+
+private:
+
+  TimestampedTrace & _trace;
+  Level              _trace_level;
+  char const       * _name;
+  uint32_t           _start;
+
+};
+
+template <>
+class TraceScope<false>
+{
+
+public:
+
+  TraceScope(TimestampedTrace & /* trace */, Level const /* trace_level */, char const * /* name */) { }
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace */
+
+/**************************************************************************************
+ * DEFINE
+ **************************************************************************************/
+
+#define TRACE_SCOPE_CONCAT_(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b)  TRACE_SCOPE_CONCAT_(a, b)
+
+/* Times the enclosing scope, e.g.
+ *
+ *   {
+ *     TRACE_SCOPE(trace, trace::Level::Debug, "can.read");
+ *     can.read(...);
+ *   }
+ *
+ * Scopes below SNOWFOX_TRACE_LEVEL_MIN are removed at compile time.
+ */
+#define TRACE_SCOPE(tracer, trace_level, name)                                 \
+  snowfox::trace::TraceScope<snowfox::trace::isTraceLevelEnabled(trace_level)> \
+    TRACE_SCOPE_CONCAT(_trace_scope_, __LINE__)(tracer, trace_level, name)
+
+#endif /* EXAMPLES_TRACE_COMMON_TRACESCOPE_H_ */
@@ -0,0 +1,68 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_COMMON_TRACESTORAGE_H_
+#define EXAMPLES_TRACE_COMMON_TRACESTORAGE_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdint.h>
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace::interface
+{
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Non-volatile memory used for retaining trace records across a reset.
+ * The memory is organised in pages of pageSize() bytes, beginPage() is
+ * called exactly once before a page is written for the first time since
+ * its previous use (i.e. flash based storages erase there), write() may be
+ * called multiple times for the same page with a growing amount of data.
+ */
+class TraceStorage
+{
+
+public:
+
+  virtual ~TraceStorage() { }
+
+
+  virtual uint32_t capacity () const = 0;
+  virtual uint16_t pageSize () const = 0;
+
+  virtual bool     beginPage(uint32_t const addr) = 0;
+  virtual bool     write    (uint32_t const addr, uint8_t const * buf, uint16_t const size) = 0;
+  virtual bool     read     (uint32_t const addr, uint8_t       * buf, uint16_t const size) = 0;
+
+};
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace::interface */
+
+#endif /* EXAMPLES_TRACE_COMMON_TRACESTORAGE_H_ */
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+##########################################################################
+#
+# Snowfox is a modular RTOS with extensive IO support.
+# Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+##########################################################################
+#
+# Decodes the output of trace::BinaryTrace (trace/common/BinaryTrace.h).
+#
+# The message table is taken directly from the application header which
+# declares the TRACE_MSG(...) entries, message IDs are assigned in order
+# of declaration - exactly as BINARY_TRACE_DECLARE_MESSAGES does.
+#
+# Usage:
+#   stty -F /dev/ttyACM0 115200 raw
+#   binary-trace-decode.py [--target avr|riscv] TraceMessages.h /dev/ttyACM0
+#   binary-trace-decode.py TraceMessages.h < trace.bin
+#
+##########################################################################
+
+import argparse
+import re
+import struct
+import sys
+
+##########################################################################
+
+FRAME_SYNC = 0xA5
+
+TYPE_FORMAT = {
+  'bool'     : '?',
+  'char'     : 'b',
+  'int8_t'   : 'b',
+  'uint8_t'  : 'B',
+  'int16_t'  : 'h',
+  'uint16_t' : 'H',
+  'int32_t'  : 'i',
+  'uint32_t' : 'I',
+  'int64_t'  : 'q',
+  'uint64_t' : 'Q',
+  'float'    : 'f',
+}
+
+TARGET_TYPE_FORMAT = {
+  'avr'   : { 'int' : 'h', 'unsigned int' : 'H', 'long' : 'i', 'unsigned long' : 'I', 'double' : 'f' },
+  'riscv' : { 'int' : 'i', 'unsigned int' : 'I', 'long' : 'i', 'unsigned long' : 'I', 'double' : 'd' },
+}
+
+STRING_TYPES = ('char const *', 'const char *', 'char const*', 'const char*')
+
+##########################################################################
+
+def load_messages(header, target):
+  type_format = dict(TYPE_FORMAT, **TARGET_TYPE_FORMAT[target])
+  pattern = re.compile(r'TRACE_MSG\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*(?:,([^)]*))?\)')
+  messages = []
+  with open(header) as f:
+    for name, fmt, args in pattern.findall(f.read()):
+      arg_types = [a.strip() for a in args.split(',')] if args.strip() else []
+      for a in arg_types:
+        if a not in type_format and a not in STRING_TYPES:
+          sys.exit('%s: unsupported argument type "%s" in message %s' % (header, a, name))
+      fmt = fmt.encode().decode('unicode_escape')
+      fmt = re.sub(r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|j|t)?([diouxXeEfFgGcs])', r'%\1\2', fmt)
+      messages.append((name, fmt, arg_types))
+  return messages, type_format
+
+
+def decode_payload(payload, arg_types, type_format):
+  values = []
+  pos = 0
+  for a in arg_types:
+    if a in STRING_TYPES:
+      length = payload[pos]
+      values.append(payload[pos + 1:pos + 1 + length].decode(errors='replace'))
+      pos += 1 + length
+    else:
+      fmt = '<' + type_format[a]
+      values.append(struct.unpack_from(fmt, payload, pos)[0])
+      pos += struct.calcsize(fmt)
+  if pos != len(payload):
+    raise ValueError('payload size mismatch')
+  return tuple(values)
+
+
+def frames(stream):
+  buf = bytearray()
+  while True:
+    chunk = stream.read1(256) if hasattr(stream, 'read1') else stream.read(256)
+    if not chunk:
+      return
+    buf += chunk
+    while True:
+      start = buf.find(FRAME_SYNC)
+      if start < 0:
+        buf.clear()
+        break
+      del buf[:start]
+      if len(buf) < 4 or len(buf) < 4 + buf[2]:
+        break
+      length = buf[2]
+      chk = 0
+      for b in buf[1:3 + length]:
+        chk ^= b
+      if chk != buf[3 + length]:
+        del buf[:1]
+        continue
+      yield buf[1], bytes(buf[3:3 + length])
+      del buf[:4 + length]
+
+##########################################################################
+
+def main():
+  parser = argparse.ArgumentParser(description='Decode snowfox binary trace output.')
+  parser.add_argument('--target', choices=TARGET_TYPE_FORMAT.keys(), default='avr')
+  parser.add_argument('header', help='header file containing the TRACE_MSG(...) declarations')
+  parser.add_argument('input', nargs='?', help='serial device or recorded trace file (default: stdin)')
+  args = parser.parse_args()
+
+  messages, type_format = load_messages(args.header, args.target)
+  stream = open(args.input, 'rb', buffering=0) if args.input else sys.stdin.buffer
+
+  for msg_id, payload in frames(stream):
+    if msg_id >= len(messages):
+      print('<unknown message id %d>' % msg_id)
+      continue
+    name, fmt, arg_types = messages[msg_id]
+    try:
+      print(fmt % decode_payload(payload, arg_types, type_format), flush=True)
+    except (ValueError, IndexError, struct.error, TypeError):
+      print('<malformed %s payload: %s>' % (name, payload.hex()), flush=True)
+
+
+if __name__ == '__main__':
+  main()
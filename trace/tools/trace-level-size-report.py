@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+##########################################################################
+#
+# Snowfox is a modular RTOS with extensive IO support.
+# Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+##########################################################################
+#
+# Reports the flash/RAM usage of an application for each compile-time
+# trace level (trace/common/StaticTraceLevel.h).
+#
+# The build directory must already be configured for the application,
+# whose config.cmake has to take TRACE_LEVEL_MIN from the cache if it is
+# defined (see trace-static-level-atmega328p-uart0/config.cmake). For
+# every level the build directory is reconfigured with
+# -DTRACE_LEVEL_MIN=<level>, rebuilt and the resulting ELF is measured
+# with avr-size. Afterwards the cache entry is removed again.
+#
+# Usage:
+#   trace-level-size-report.py BUILD_DIR trace-static-level-atmega328p-uart0
+#   trace-level-size-report.py --levels Debug Error BUILD_DIR TARGET
+#
+##########################################################################
+
+import argparse
+import os
+import subprocess
+import sys
+
+##########################################################################
+
+LEVELS = ['Debug', 'Info', 'Warning', 'Error']
+
+##########################################################################
+
+def run(cmd):
+    result = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout)
+        sys.exit('failed: ' + ' '.join(cmd))
+    return result.stdout
+
+
+def find_elf(build_dir, target):
+    for root, _, files in os.walk(build_dir):
+        if 'CMakeFiles' in root:
+            continue
+        for name in (target, target + '.elf'):
+            if name in files:
+                return os.path.join(root, name)
+    sys.exit('no ELF named %s found within %s' % (target, build_dir))
+
+
+def measure(size_tool, elf):
+    # Berkeley format: text data bss dec hex filename
+    line = run([size_tool, elf]).splitlines()[1].split()
+    text, data, bss = int(line[0]), int(line[1]), int(line[2])
+    return text + data, data + bss
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Flash/RAM usage per compile-time trace level')
+    parser.add_argument('--levels',    nargs='+', default=LEVELS, choices=LEVELS)
+    parser.add_argument('--size-tool', default='avr-size')
+    parser.add_argument('build_dir')
+    parser.add_argument('target')
+    args = parser.parse_args()
+
+    results = []
+    try:
+        for level in args.levels:
+            run(['cmake', '-DTRACE_LEVEL_MIN=' + level, args.build_dir])
+            run(['cmake', '--build', args.build_dir])
+            results.append((level,) + measure(args.size_tool, find_elf(args.build_dir, args.target)))
+    finally:
+        run(['cmake', '-UTRACE_LEVEL_MIN', args.build_dir])
+
+    ref_flash, ref_ram = results[0][1], results[0][2]
+
+    print('%-8s %8s %8s %8s %8s' % ('LEVEL', 'FLASH', 'DELTA', 'RAM', 'DELTA'))
+    for level, flash, ram in results:
+        print('%-8s %8d %+8d %8d %+8d' % (level, flash, flash - ref_flash, ram, ram - ref_ram))
+
+##########################################################################
+
+if __name__ == '__main__':
+    main()
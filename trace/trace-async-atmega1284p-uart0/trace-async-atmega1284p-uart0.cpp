@@ -0,0 +1,149 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Moteino-Mega-USB
+ *
+ * Bursts of trace messages are written both via the synchronous trace::SerialTraceOutput
+ * (UART1) and via the interrupt-drained trace::AsyncSerialTraceOutput (UART0). The time
+ * the application spends within println() is measured with TIMER1 and reported on UART0.
+ * A burst fits completely into the ring buffer of the asynchronous output, the report
+ * is written once the burst has been transmitted so that it is not dropped.
+ *
+ * Upload via avrdude (and the USB connection of the Moteino-Mega-USB)
+ *   avrdude -p atmega1284p -c arduino -P /dev/ttyUSB0 -e -U flash:w:trace-async-atmega1284p-uart0
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA1284P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA1284P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA1284P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA1284P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA1284P/UART1.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/trace/Trace.h>
+#include <snowfox/trace/SerialTraceOutput.h>
+
+#include "../common/AsyncSerialTraceOutput.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t const UART_RX_BUFFER_SIZE       =   0;
+static uint16_t const UART_TX_BUFFER_SIZE       =  16;
+static uint16_t const ASYNC_TRACE_BUFFER_SIZE   = 128;
+
+static uint8_t  const TRACE_BURST_SIZE          =   3; /* 3 x approx. 31 bytes fit into ASYNC_TRACE_BUFFER_SIZE */
+static uint32_t const TIMER1_TICK_us            =   4; /* 16 MHz / 64 = 250 kHz */
+static uint32_t const LOOP_DELAY_ms             = 1000;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /* HAL ******************************************************************************/
+
+  ATMEGA1284P::Delay               delay;
+
+  ATMEGA1284P::InterruptController int_ctrl(&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &PCMSK3, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &UCSR1B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA1284P::CriticalSection     crit_sec;
+
+  blox::ATMEGA1284P::UART0         uart0   (&UDR0, &UCSR0A, &UCSR0B, &UCSR0C, &UBRR0, int_ctrl, F_CPU);
+  blox::ATMEGA1284P::UART1         uart1   (&UDR1, &UCSR1A, &UCSR1B, &UCSR1C, &UBRR1, int_ctrl, F_CPU);
+
+  /* TIMER1 free running with a prescaler of 64 - used for measuring only */
+  TCCR1A = 0;
+  TCCR1B = (1 << CS11) | (1 << CS10);
+
+
+  /* DRIVER ***************************************************************************/
+
+  blox::SerialUart serial(crit_sec,
+                          uart1(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  uart0().setBaudRate(hal::interface::UartBaudRate::B115200);
+  uart0().setParity  (hal::interface::UartParity::None     );
+  uart0().setStopBit (hal::interface::UartStopBit::_1      );
+
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+
+  int_ctrl.enableInterrupt(ATMEGA164P_324P_644P_1284P::toIntNum(ATMEGA1284P::Interrupt::GLOBAL));
+
+
+  /* APPLICATION **********************************************************************/
+
+  trace::SerialTraceOutput                               sync_trace_output (serial());
+  trace::Trace                                           sync_trace        (sync_trace_output, trace::Level::Debug);
+
+  trace::AsyncSerialTraceOutput<ASYNC_TRACE_BUFFER_SIZE> async_trace_output(uart0());
+  trace::Trace                                           async_trace       (async_trace_output, trace::Level::Debug);
+
+  uart0().registerUARTCallback(&async_trace_output);
+
+  for(uint32_t cnt = 0;; cnt++)
+  {
+    uint16_t const sync_start = TCNT1;
+    for(uint8_t i = 0; i < TRACE_BURST_SIZE; i++) {
+      sync_trace.println(trace::Level::Debug, "( %08lX ) Hello ATMEGA1284P", cnt);
+    }
+    uint16_t const sync_ticks = TCNT1 - sync_start;
+
+    uint16_t const async_start = TCNT1;
+    for(uint8_t i = 0; i < TRACE_BURST_SIZE; i++) {
+      async_trace.println(trace::Level::Debug, "( %08lX ) Hello ATMEGA1284P", cnt);
+    }
+    uint16_t const async_ticks = TCNT1 - async_start;
+
+    while(!async_trace_output.isIdle()) { }
+
+    async_trace.println(trace::Level::Info,
+                        "sync = %lu us, async = %lu us, dropped = %u",
+                        static_cast<uint32_t>(sync_ticks ) * TIMER1_TICK_us,
+                        static_cast<uint32_t>(async_ticks) * TIMER1_TICK_us,
+                        async_trace_output.dropped());
+
+    delay.delay_ms(LOOP_DELAY_ms);
+  }
+
+  return 0;
+}
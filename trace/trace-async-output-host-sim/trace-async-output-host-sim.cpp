@@ -0,0 +1,222 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Host test of hal::SpscRingBuffer and trace::AsyncSerialTraceOutput.
+ *
+ * The ring buffer is exercised across the wrap-around of its storage and of
+ * its free running 8-bit and 16-bit indices. The asynchronous trace output
+ * is connected to a simulated UART whose transmit register empty interrupt
+ * is raised by step(), i.e. records are written while the transmission of
+ * previous ones is still in progress.
+ *
+ * Build and run:
+ *   cmake -S . -B build && cmake --build build && ./build/trace-async-output-host-sim
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hal/common/host/HostSimCheck.h"
+
+#include "../../hal/common/SpscRingBuffer.h"
+#include "../common/AsyncSerialTraceOutput.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::host;
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* Records every transmitted byte, one byte is in flight until step()
+ * raises the transmit register empty interrupt for it.
+ */
+class SimulatedUart : public hal::interface::UART
+{
+public:
+  SimulatedUart() : _callback(nullptr), _is_busy(false), _num_tx(0), _num_overwrites(0) { }
+  virtual void transmit(uint8_t const data) override
+  {
+    if(_is_busy) _num_overwrites++;
+    if(_num_tx < sizeof(_tx)) _tx[_num_tx++] = data;
+    _is_busy = true;
+  }
+  virtual void receive(uint8_t & data) override { data = 0; }
+  virtual void registerUARTCallback(hal::interface::UARTCallback * uart_callback) override { _callback = uart_callback; }
+  bool step()
+  {
+    if(!_is_busy) return false;
+    _is_busy = false;
+    if(_callback) _callback->onTransmitRegisterEmpty();
+    return true;
+  }
+  void run() { while(step()) { } }
+  bool isBusy() const { return _is_busy; }
+  bool sent(char const * expected) const { return (_num_tx == strlen(expected)) && (memcmp(_tx, expected, _num_tx) == 0); }
+  size_t numOverwrites() const { return _num_overwrites; }
+private:
+  hal::interface::UARTCallback * _callback;
+  bool                           _is_busy;
+  uint8_t                        _tx[256];
+  size_t                         _num_tx,
+                                 _num_overwrites;
+};
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+template <uint16_t SIZE>
+static bool streamThrough(uint16_t const chunk, uint32_t const num_bytes)
+{
+  hal::SpscRingBuffer<SIZE> ring;
+
+  uint8_t  tx[SIZE];
+  uint32_t pushed = 0, popped = 0;
+
+  while(popped < num_bytes)
+  {
+    uint16_t const len = ((num_bytes - pushed) < chunk) ? static_cast<uint16_t>(num_bytes - pushed) : chunk;
+    for(uint16_t i = 0; i < len; i++) tx[i] = static_cast<uint8_t>(pushed + i);
+    if((len > 0) && ring.push(tx, len)) pushed += len;
+
+    /* Drain half of the time via pop(), otherwise via peek()/consume() */
+    if((popped / SIZE) % 2)
+    {
+      uint8_t data = 0;
+      while(ring.pop(data)) {
+        if(data != static_cast<uint8_t>(popped++)) return false;
+      }
+    }
+    else
+    {
+      uint8_t const * data = nullptr;
+      for(uint16_t n = ring.peek(data); n > 0; n = ring.peek(data))
+      {
+        for(uint16_t i = 0; i < n; i++) {
+          if(data[i] != static_cast<uint8_t>(popped++)) return false;
+        }
+        ring.consume(n);
+      }
+    }
+  }
+
+  return (ring.available() == 0) && (ring.free() == SIZE);
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main()
+{
+  /* SpscRingBuffer: push/pop/peek/consume across the end of the storage ***********/
+  {
+    hal::SpscRingBuffer<8> ring;
+
+    uint8_t const a[] = {1, 2, 3, 4, 5};
+    uint8_t const b[] = {6, 7, 8, 9, 10};
+    uint8_t       data = 0;
+
+    check("empty", (ring.available() == 0) && (ring.free() == 8) && !ring.pop(data));
+    check("push",  ring.push(a, sizeof(a)) && (ring.available() == 5));
+
+    bool is_ok = true;
+    for(uint8_t i = 0; i < 3; i++) is_ok &= ring.pop(data) && (data == a[i]);
+    check("pop", is_ok && (ring.available() == 2));
+
+    check("push wrapping around", ring.push(b, sizeof(b)) && (ring.available() == 7) && (ring.free() == 1));
+
+    uint8_t const * region = nullptr;
+    uint16_t        n      = ring.peek(region);
+    check("peek up to end of storage", (n == 5) && (region[0] == 4) && (region[1] == 5) && (region[2] == 6) && (region[4] == 8));
+    ring.consume(n);
+
+    n = ring.peek(region);
+    check("peek remainder after consume", (n == 2) && (region[0] == 9) && (region[1] == 10));
+    ring.consume(n);
+    check("empty after consume", (ring.available() == 0) && (ring.peek(region) == 0));
+  }
+
+  /* SpscRingBuffer: push is all-or-nothing ****************************************/
+  {
+    hal::SpscRingBuffer<8> ring;
+
+    uint8_t const a[] = {1, 2, 3, 4, 5, 6};
+    uint8_t const b[] = {7, 8, 9};
+    uint8_t const c[] = {7, 8};
+
+    ring.push(a, sizeof(a));
+    check("push exceeding free space rejected", !ring.push(b, sizeof(b)) && (ring.available() == 6));
+    check("push filling buffer completely",     ring.push(c, sizeof(c)) && (ring.available() == 8) && (ring.free() == 0));
+    check("push into full buffer rejected",     !ring.push(c, 1) && (ring.available() == 8));
+
+    bool    is_ok = true;
+    uint8_t data  = 0;
+    for(uint8_t i = 1; i <= 8; i++) is_ok &= ring.pop(data) && (data == i);
+    check("rejected push left content untouched", is_ok && !ring.pop(data));
+  }
+
+  /* SpscRingBuffer: wrap-around of the free running indices ************************/
+  check("8-bit index wrap-around (SIZE 128)",  streamThrough<128>(37, 100000));
+  check("8-bit index wrap-around (SIZE 2)",    streamThrough<2>  ( 1,   1000));
+  check("16-bit index wrap-around (SIZE 256)", streamThrough<256>(91, 200000));
+
+  /* AsyncSerialTraceOutput: drain via interrupt, drop counter ***********************/
+  {
+    SimulatedUart                         uart;
+    trace::AsyncSerialTraceOutput<16>     trace_output(uart);
+
+    uart.registerUARTCallback(&trace_output);
+
+    check("idle before first write", trace_output.isIdle());
+    trace_output.write("hello ");
+    check("first byte sent immediately", uart.isBusy() && !trace_output.isIdle());
+
+    uart.step();
+    uart.step();
+    trace_output.write("world\n");
+    trace_output.write("this record is too long\n");
+    check("record exceeding free space dropped", trace_output.dropped() == 1);
+
+    uart.run();
+    check("records sent in order", uart.sent("hello world\n") && trace_output.isIdle());
+
+    trace_output.write("again\n");
+    uart.run();
+    check("restart after idle", uart.sent("hello world\nagain\n") && (trace_output.dropped() == 1));
+
+    /* Fill the buffer completely while the transmitter is busy */
+    trace_output.write("0123456789ABCDEF");
+    trace_output.write("0123456789ABCDEF");
+    check("drop counter increments per record", trace_output.dropped() == 2);
+    uart.run();
+    check("full buffer drained", uart.sent("hello world\nagain\n0123456789ABCDEF") && (uart.numOverwrites() == 0));
+  }
+
+  return checkResult();
+}
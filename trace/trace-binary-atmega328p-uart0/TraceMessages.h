@@ -0,0 +1,55 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXAMPLES_TRACE_TRACE_BINARY_ATMEGA328P_UART0_TRACEMESSAGES_H_
+#define EXAMPLES_TRACE_TRACE_BINARY_ATMEGA328P_UART0_TRACEMESSAGES_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "../common/BinaryTraceMessage.h"
+
+/**************************************************************************************
+ * DEFINE
+ **************************************************************************************/
+
+#define TRACE_MESSAGES(TRACE_MSG)                                   \
+  TRACE_MSG(STARTUP, "Binary trace on ATMEGA328P started"         ) \
+  TRACE_MSG(HELLO,   "( %08X ) Hello ATMEGA328P",         uint32_t)
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+namespace snowfox::trace::msg
+{
+
+/**************************************************************************************
+ * MESSAGES
+ **************************************************************************************/
+
+BINARY_TRACE_DECLARE_MESSAGES(TRACE_MESSAGES)
+
+/**************************************************************************************
+ * NAMESPACE
+ **************************************************************************************/
+
+} /* snowfox::trace::msg */
+
+#endif /* EXAMPLES_TRACE_TRACE_BINARY_ATMEGA328P_UART0_TRACEMESSAGES_H_ */
@@ -0,0 +1,180 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * Runs the post-mortem trace on a Linux host on top of a simulated PCF8570 (RAM) or
+ * N25Q256A (NOR flash) stored within an image file. Every invocation corresponds to
+ * one boot of the target: the retained trace history is dumped to stdout, then new
+ * records are appended and the image is written back - a reset is simulated by
+ * omitting the final flush.
+ *
+ * Build
+ *   mkdir build && cd build && cmake .. && make
+ *
+ * Usage
+ *   trace-postmortem-host-sim [--pcf8570] [--no-flush] IMAGE NUM_RECORDS \
+ *     | trace/tools/binary-trace-decode.py ../../trace-postmortem-n25q256a-atmega328p/TraceMessages.h
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/BinaryTraceEncoder.h"
+#include "../common/SimulatedTraceStorage.h"
+#include "../common/PostMortemTraceOutput.h"
+
+#include "../trace-postmortem-n25q256a-atmega328p/TraceMessages.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint32_t const PCF8570_CAPACITY    = 256;
+static uint16_t const PCF8570_PAGE_SIZE   = 32;
+
+static uint32_t const N25Q256A_CAPACITY   = 4 * 4096;
+static uint16_t const N25Q256A_PAGE_SIZE  = 256;
+static uint32_t const N25Q256A_ERASE_SIZE = 4096;
+
+/**************************************************************************************
+ * TYPEDEF
+ **************************************************************************************/
+
+class StdoutBinaryTraceOutput : public trace::interface::BinaryTraceOutput
+{
+public:
+  virtual void write(uint8_t const * frame, uint16_t const frame_size) override
+  {
+    fwrite(frame, 1, frame_size, stdout);
+  }
+};
+
+/**************************************************************************************
+ * FUNCTION DEFINITION
+ **************************************************************************************/
+
+template <typename Message, typename... Args>
+void log(trace::interface::BinaryTraceOutput & output, Args const... args)
+{
+  uint8_t frame[32];
+  uint16_t const frame_size = trace::BinaryTraceEncoder<typename Message::Signature>::encode(frame, sizeof(frame), Message::ID, args...);
+  if(frame_size > 0) {
+    output.write(frame, frame_size);
+  }
+}
+
+template <uint16_t PAGE_SIZE>
+int boot(trace::SimulatedTraceStorage & storage, uint32_t const num_records, bool const flush)
+{
+  StdoutBinaryTraceOutput                 stdout_output;
+  trace::PostMortemTraceOutput<PAGE_SIZE> postmortem_output(storage);
+
+  log<trace::msg::HISTORY_BEGIN>(stdout_output);
+  if(!postmortem_output.open() || !postmortem_output.dump(stdout_output)) {
+    log<trace::msg::STORAGE_ERROR>(stdout_output);
+    return EXIT_FAILURE;
+  }
+  log<trace::msg::HISTORY_END>(stdout_output);
+
+  log<trace::msg::STARTUP>(postmortem_output);
+  for(uint32_t cnt = 0; cnt < num_records; cnt++) {
+    log<trace::msg::ALIVE>(postmortem_output, cnt);
+  }
+
+  if(flush && !postmortem_output.flush()) {
+    return EXIT_FAILURE;
+  }
+
+  if(postmortem_output.numWriteErrors() > 0) {
+    fprintf(stderr, "%u pages could not be written\n", postmortem_output.numWriteErrors());
+    return EXIT_FAILURE;
+  }
+
+  fprintf(stderr, "%u records, %u storage writes, %u erases\n", num_records + 1, storage.numWrites(), storage.numErases());
+  return EXIT_SUCCESS;
+}
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int main(int argc, char ** argv)
+{
+  bool pcf8570 = false;
+  bool flush   = true;
+
+  int arg = 1;
+  for(; arg < argc && argv[arg][0] == '-'; arg++)
+  {
+    if     (strcmp(argv[arg], "--pcf8570")  == 0) pcf8570 = true;
+    else if(strcmp(argv[arg], "--no-flush") == 0) flush   = false;
+  }
+
+  if((argc - arg) != 2) {
+    fprintf(stderr, "usage: %s [--pcf8570] [--no-flush] IMAGE NUM_RECORDS\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  char     const * image       = argv[arg];
+  uint32_t const   num_records = strtoul(argv[arg + 1], nullptr, 0);
+  uint32_t const   capacity    = pcf8570 ? PCF8570_CAPACITY : N25Q256A_CAPACITY;
+
+  /* A missing image corresponds to an erased flash / uninitialised RAM. */
+  static uint8_t mem[N25Q256A_CAPACITY];
+  memset(mem, 0xFF, capacity);
+
+  FILE * f = fopen(image, "rb");
+  if(f) {
+    size_t const bytes_read = fread(mem, 1, capacity, f);
+    fclose(f);
+    if(bytes_read != capacity) {
+      fprintf(stderr, "%s: image size mismatch\n", image);
+      return EXIT_FAILURE;
+    }
+  }
+
+  int rc = EXIT_SUCCESS;
+
+  if(pcf8570) {
+    trace::SimulatedTraceStorage storage(mem, PCF8570_CAPACITY, PCF8570_PAGE_SIZE, 0);
+    rc = boot<PCF8570_PAGE_SIZE>(storage, num_records, flush);
+  } else {
+    trace::SimulatedTraceStorage storage(mem, N25Q256A_CAPACITY, N25Q256A_PAGE_SIZE, N25Q256A_ERASE_SIZE);
+    rc = boot<N25Q256A_PAGE_SIZE>(storage, num_records, flush);
+  }
+
+  f = fopen(image, "wb");
+  if(!f || fwrite(mem, 1, capacity, f) != capacity) {
+    fprintf(stderr, "%s: failed to write image\n", image);
+    return EXIT_FAILURE;
+  }
+  fclose(f);
+
+  return rc;
+}
@@ -0,0 +1,216 @@
+/**
+ * Snowfox is a modular RTOS with extensive IO support.
+ * Copyright (C) 2017 - 2020 Alexander Entinger / LXRobotics GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**************************************************************************************
+ * This example program is tailored for usage with Arduino Uno and Digilent
+ * Pmod SF3 32 MB serial NOR flash N25Q256A breakout board.
+ *
+ * All binary trace records are retained within the last erase blocks of the N25Q256A.
+ * After a reset the recorded trace history is dumped via UART0 before recording
+ * continues. Decode the output on the host via
+ *   trace/tools/binary-trace-decode.py trace/trace-postmortem-n25q256a-atmega328p/TraceMessages.h /dev/ttyACM0
+ *
+ * ATTENTION: The N25Q256A must be operated at 3V3! (Seeeduino_v3.0 has an ATMEGA328P
+ * + Arduino compatible pinout + can be operated either at 5V or at 3V3).
+ *
+ * Electrical interface:
+ *   Pmod SF3 Pin (1) = ~CS  = D10 = PB2
+ *   Pmod SF3 Pin (3) = MISO = D12 = PB4
+ *   Pmod SF3 Pin (2) = MOSI = D11 = PB3
+ *   Pmod SF3 Pin (4) = SCK  = D13 = PB5
+ *
+ * Upload via avrdude
+ *   avrdude -p atmega328p -c avrisp2 -e -U flash:w:trace-postmortem-n25q256a-atmega328p
+ **************************************************************************************/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <avr/io.h>
+
+#include <snowfox/hal/avr/ATMEGA328P/Delay.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalInPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/DigitalOutPin.h>
+#include <snowfox/hal/avr/ATMEGA328P/CriticalSection.h>
+#include <snowfox/hal/avr/ATMEGA328P/InterruptController.h>
+
+#include <snowfox/blox/hal/avr/ATMEGA328P/UART0.h>
+#include <snowfox/blox/hal/avr/ATMEGA328P/SpiMaster.h>
+
+#include <snowfox/blox/driver/serial/SerialUart.h>
+
+#include <snowfox/driver/memory/N25Q256A/N25Q256A.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_IoSpi.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Status.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Control.h>
+#include <snowfox/driver/memory/N25Q256A/N25Q256A_Configuration.h>
+
+#include "../common/BinaryTrace.h"
+#include "../common/N25Q256ATraceStorage.h"
+#include "../common/PostMortemTraceOutput.h"
+#include "../common/SerialBinaryTraceOutput.h"
+
+#include "TraceMessages.h"
+
+/**************************************************************************************
+ * NAMESPACES
+ **************************************************************************************/
+
+using namespace snowfox;
+using namespace snowfox::hal;
+using namespace snowfox::driver;
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static uint16_t                    const UART_RX_BUFFER_SIZE    = 0;
+static uint16_t                    const UART_TX_BUFFER_SIZE    = 64;
+
+static hal::interface::SpiMode     const N25Q256A_SPI_MODE      = hal::interface::SpiMode::MODE_0;
+static hal::interface::SpiBitOrder const N25Q256A_SPI_BIT_ORDER = hal::interface::SpiBitOrder::MSB_FIRST;
+static uint32_t                    const N25Q256A_SPI_PRESCALER = 16;       /* Arduino Uno Clk = 16 MHz -> SPI Clk = 1 MHz */
+
+/* Trace records are collected in RAM and written to the N25Q256A one
+ * program page (256 bytes) at a time. The last TRACE_NUM_ERASE_BLOCKS
+ * erase blocks of the flash are reserved for the post-mortem trace.
+ */
+static uint16_t                    const TRACE_PAGE_SIZE        = 256;
+static uint32_t                    const TRACE_NUM_ERASE_BLOCKS = 2;
+static uint32_t                    const TRACE_FLUSH_INTERVAL   = 16;
+
+/**************************************************************************************
+ * MAIN
+ **************************************************************************************/
+
+int snowfox_main()
+{
+  /************************************************************************************
+   * HAL
+   ************************************************************************************/
+
+  ATMEGA328P::Delay               delay;
+
+  ATMEGA328P::InterruptController int_ctrl  (&EIMSK, &PCICR, &PCMSK0, &PCMSK1, &PCMSK2, &WDTCSR, &TIMSK0, &TIMSK1, &TIMSK2, &UCSR0B, &SPCR, &TWCR, &EECR, &SPMCSR, &ACSR, &ADCSRA);
+  ATMEGA328P::CriticalSection     crit_sec;
+
+  /* CS equals SS, therefore it needs to be set before configuring the SPI interface. */
+  ATMEGA328P::DigitalOutPin       n25q256a_cs  (&DDRB, &PORTB,        2); /* CS   = D10 = PB2 */
+  ATMEGA328P::DigitalOutPin       n25q256a_sck (&DDRB, &PORTB,        5); /* SCK  = D13 = PB5 */
+  ATMEGA328P::DigitalInPin        n25q256a_miso(&DDRB, &PORTB, &PINB, 4); /* MISO = D12 = PB4 */
+  ATMEGA328P::DigitalOutPin       n25q256a_mosi(&DDRB, &PORTB,        3); /* MOSI = D11 = PB3 */
+
+  n25q256a_cs.set();
+  n25q256a_miso.setPullUpMode(hal::interface::PullUpMode::PULL_UP);
+
+  blox::ATMEGA328P::UART0         uart0     (&UDR0,
+                                             &UCSR0A,
+                                             &UCSR0B,
+                                             &UCSR0C,
+                                             &UBRR0,
+                                             int_ctrl,
+                                             F_CPU);
+
+  blox::ATMEGA328P::SpiMaster     spi_master(&SPCR,
+                                             &SPSR,
+                                             &SPDR,
+                                             int_ctrl,
+                                             N25Q256A_SPI_MODE,
+                                             N25Q256A_SPI_BIT_ORDER,
+                                             N25Q256A_SPI_PRESCALER);
+
+  /* GLOBAL INTERRUPT *****************************************************************/
+  int_ctrl.enableInterrupt(ATMEGA328P::toIntNum(ATMEGA328P::Interrupt::GLOBAL));
+
+
+  /************************************************************************************
+   * DRIVER
+   ************************************************************************************/
+
+  /* SERIAL ***************************************************************************/
+  blox::SerialUart serial(crit_sec,
+                          uart0(),
+                          UART_RX_BUFFER_SIZE,
+                          UART_TX_BUFFER_SIZE,
+                          serial::interface::SerialBaudRate::B115200,
+                          serial::interface::SerialParity::None,
+                          serial::interface::SerialStopBit::_1);
+
+  /* N25Q256A *************************************************************************/
+  memory::N25Q256A::N25Q256A_IoSpi         n25q256a_spi    (spi_master(), n25q256a_cs);
+  memory::N25Q256A::N25Q256A_Configuration n25q256a_config (n25q256a_spi);
+  memory::N25Q256A::N25Q256A_Control       n25q256a_control(n25q256a_spi, delay);
+  memory::N25Q256A::N25Q256A_Status        n25q256a_status (n25q256a_spi);
+  memory::N25Q256A::N25Q256A               n25q256a        (n25q256a_config, n25q256a_control, n25q256a_status);
+
+
+  /************************************************************************************
+   * APPLICATION
+   ************************************************************************************/
+
+  trace::SerialBinaryTraceOutput serial_trace_output(serial());
+  trace::BinaryTrace             serial_trace       (serial_trace_output, trace::Level::Debug);
+
+  memory::NorFlashInfo n25q256a_flash_info;
+
+  if(!n25q256a.open() || !n25q256a.ioctl(memory::IOCTL_GET_FLASH_INFO, reinterpret_cast<void*>(&n25q256a_flash_info))) {
+    serial_trace.log<trace::msg::STORAGE_ERROR>(trace::Level::Error);
+    for(;;) { delay.delay_ms(1); }
+  }
+
+  trace::N25Q256ATraceStorage                    trace_storage       (n25q256a,
+                                                                      n25q256a_flash_info,
+                                                                      n25q256a_flash_info.block_count - TRACE_NUM_ERASE_BLOCKS,
+                                                                      TRACE_NUM_ERASE_BLOCKS,
+                                                                      TRACE_PAGE_SIZE);
+  trace::PostMortemTraceOutput<TRACE_PAGE_SIZE>  postmortem_output   (trace_storage);
+  trace::BinaryTrace                             postmortem_trace    (postmortem_output, trace::Level::Debug);
+
+  /* The history needs to be dumped before recording continues
+   * as the first new record overwrites the oldest page.
+   */
+  serial_trace.log<trace::msg::HISTORY_BEGIN>(trace::Level::Info);
+  if(!postmortem_output.open() || !postmortem_output.dump(serial_trace_output)) {
+    serial_trace.log<trace::msg::STORAGE_ERROR>(trace::Level::Error);
+  }
+  serial_trace.log<trace::msg::HISTORY_END>(trace::Level::Info);
+
+  postmortem_trace.log<trace::msg::STARTUP>(trace::Level::Info);
+
+  uint32_t num_write_errors = 0;
+
+  for(uint32_t cnt = 0;; cnt++)
+  {
+    postmortem_trace.log<trace::msg::ALIVE>(trace::Level::Debug, cnt);
+
+    /* A complete page is written automatically, flushing in between
+     * limits the amount of trace records lost upon a reset.
+     */
+    if((cnt % TRACE_FLUSH_INTERVAL) == 0) {
+      if(!postmortem_output.flush() || (postmortem_output.numWriteErrors() != num_write_errors)) {
+        num_write_errors = postmortem_output.numWriteErrors();
+        serial_trace.log<trace::msg::STORAGE_ERROR>(trace::Level::Error);
+      }
+    }
+
+    delay.delay_ms(100);
+  }
+
+  return 0;
+}